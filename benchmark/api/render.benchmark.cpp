@@ -4,11 +4,13 @@
 #include <mbgl/map/map_observer.hpp>
 #include <mbgl/map/map_options.hpp>
 #include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/recording/headless_backend.hpp>
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/image.hpp>
 #include <mbgl/storage/resource_options.hpp>
 #include <mbgl/storage/network_status.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -38,6 +40,15 @@ static void prepare(Map& map, optional<std::string> json = {}) {
     map.getStyle().addImage(std::make_unique<style::Image>("test-icon", std::move(image), 1.0));
 }
 
+// Reports the commands that the frames recorded, per frame.
+static void reportStatistics(::benchmark::State& state, const recording::Statistics& statistics) {
+    const double frames = state.iterations();
+    state.counters["draws/frame"] = statistics.drawCalls / frames;
+    state.counters["state changes/frame"] = statistics.stateChanges / frames;
+    state.counters["buffer uploads/frame"] = statistics.bufferUploads / frames;
+    state.counters["upload bytes/frame"] = (statistics.bufferUploadBytes + statistics.textureUploadBytes) / frames;
+}
+
 } // end namespace
 
 static void API_renderStill_reuse_map(::benchmark::State& state) {
@@ -53,6 +64,25 @@ static void API_renderStill_reuse_map(::benchmark::State& state) {
     }
 }
 
+// Like API_renderStill_reuse_map, with a backend that records the draw calls instead of issuing
+// them to the GPU, so that only the CPU side of the frames is measured.
+static void API_renderStill_reuse_map_recording(::benchmark::State& state) {
+    RenderBenchmark bench;
+    auto backend = std::make_unique<recording::HeadlessBackend>();
+    const recording::HeadlessBackend& recorder = *backend;
+    HeadlessFrontend frontend { size, pixelRatio, std::move(backend) };
+    Map map { frontend, MapObserver::nullObserver(),
+              MapOptions().withMapMode(MapMode::Static).withSize(size).withPixelRatio(pixelRatio),
+              ResourceOptions().withCachePath(cachePath).withAccessToken("foobar") };
+    prepare(map);
+
+    const recording::Statistics start = recorder.getStatistics();
+    while (state.KeepRunning()) {
+        frontend.render(map);
+    }
+    reportStatistics(state, recorder.getStatistics() - start);
+}
+
 static void API_renderStill_reuse_map_formatted_labels(::benchmark::State& state) {
     RenderBenchmark bench;
     HeadlessFrontend frontend { size, pixelRatio };
@@ -94,7 +124,85 @@ static void API_renderStill_recreate_map(::benchmark::State& state) {
     }
 }
 
+// Like API_renderStill_recreate_map, with the process-wide shaping cache disabled or enabled. Every
+// new map lays out its symbols again, so the difference is the time saved shaping labels.
+static void API_renderStill_recreate_map_shaping_cache(::benchmark::State& state) {
+    RenderBenchmark bench;
+    ShapingCache& cache = ShapingCache::get();
+    cache.clear();
+    cache.setMaximumSize(state.range(0) ? ShapingCache::DefaultMaximumSize : 0);
+
+    while (state.KeepRunning()) {
+        HeadlessFrontend frontend { size, pixelRatio };
+        Map map { frontend, MapObserver::nullObserver(),
+                  MapOptions().withMapMode(MapMode::Static).withSize(size).withPixelRatio(pixelRatio),
+                  ResourceOptions().withCachePath(cachePath).withAccessToken("foobar") };
+        prepare(map);
+        frontend.render(map);
+    }
+
+    const auto statistics = cache.getStatistics();
+    const std::size_t lookups = statistics.hits + statistics.misses;
+    state.counters["hit rate"] = lookups ? double(statistics.hits) / lookups : 0.0;
+    state.counters["shapings/map"] = double(lookups) / state.iterations();
+
+    cache.clear();
+    cache.setMaximumSize(ShapingCache::DefaultMaximumSize);
+}
+
+// Frames of a pitched camera that rotates by one degree per frame. Most of them only move the line
+// labels, between placements.
+static void API_renderContinuous_pitched_rotating(::benchmark::State& state) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { size, pixelRatio };
+    Map map { frontend, MapObserver::nullObserver(),
+              MapOptions().withMapMode(MapMode::Continuous).withSize(size).withPixelRatio(pixelRatio),
+              ResourceOptions().withCachePath(cachePath).withAccessToken("foobar") };
+    prepare(map);
+    map.jumpTo(CameraOptions().withPitch(60.0));
+
+    while (!map.isFullyLoaded()) {
+        bench.loop.runOnce();
+    }
+
+    double bearing = 0;
+    while (state.KeepRunning()) {
+        bearing += 1.0;
+        map.jumpTo(CameraOptions().withBearing(bearing));
+        bench.loop.runOnce();
+    }
+}
+
+static void API_renderContinuous_pitched_rotating_recording(::benchmark::State& state) {
+    RenderBenchmark bench;
+    auto backend = std::make_unique<recording::HeadlessBackend>();
+    const recording::HeadlessBackend& recorder = *backend;
+    HeadlessFrontend frontend { size, pixelRatio, std::move(backend) };
+    Map map { frontend, MapObserver::nullObserver(),
+              MapOptions().withMapMode(MapMode::Continuous).withSize(size).withPixelRatio(pixelRatio),
+              ResourceOptions().withCachePath(cachePath).withAccessToken("foobar") };
+    prepare(map);
+    map.jumpTo(CameraOptions().withPitch(60.0));
+
+    while (!map.isFullyLoaded()) {
+        bench.loop.runOnce();
+    }
+
+    const recording::Statistics start = recorder.getStatistics();
+    double bearing = 0;
+    while (state.KeepRunning()) {
+        bearing += 1.0;
+        map.jumpTo(CameraOptions().withBearing(bearing));
+        bench.loop.runOnce();
+    }
+    reportStatistics(state, recorder.getStatistics() - start);
+}
+
 BENCHMARK(API_renderStill_reuse_map);
+BENCHMARK(API_renderStill_reuse_map_recording);
 BENCHMARK(API_renderStill_reuse_map_formatted_labels);
 BENCHMARK(API_renderStill_reuse_map_switch_styles);
 BENCHMARK(API_renderStill_recreate_map);
+BENCHMARK(API_renderStill_recreate_map_shaping_cache)->Arg(false)->Arg(true);
+BENCHMARK(API_renderContinuous_pitched_rotating);
+BENCHMARK(API_renderContinuous_pitched_rotating_recording);
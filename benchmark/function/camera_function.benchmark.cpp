@@ -52,10 +52,80 @@ static void Evaluate_CameraFunction(benchmark::State& state) {
     state.SetLabel(std::to_string(stopCount).c_str());
 }
 
+// Evaluates the function at the same zoom level over and over, like the tiles of a layer, or
+// the frames of a transition.
+static void Evaluate_CameraFunctionMemoized(benchmark::State& state) {
+    size_t stopCount = state.range(0);
+    auto doc = createFunctionJSON(stopCount);
+    conversion::Error error;
+    optional<PropertyValue<float>> function = conversion::convertJSON<PropertyValue<float>>(doc, error, false, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    const ZoomEvaluationStatistics before = ZoomEvaluationStatistics::current();
+    size_t i = 0;
+    while(state.KeepRunning()) {
+        float z = 24.0f * static_cast<float>(i++ / 64 % 100) / 100;
+        benchmark::DoNotOptimize(function->asExpression().evaluateMemoized(z));
+    }
+
+    const ZoomEvaluationStatistics saved = ZoomEvaluationStatistics::current() - before;
+    state.counters["hit rate"] = double(saved.hits) / (saved.hits + saved.misses);
+    state.SetLabel(std::to_string(stopCount).c_str());
+}
+
+// Computes the interpolation factor of the function between two tile zoom levels, like the
+// uniform values of data driven paint properties do for every tile that is drawn.
+static void Evaluate_InterpolationFactor(benchmark::State& state) {
+    size_t stopCount = state.range(0);
+    auto doc = createFunctionJSON(stopCount);
+    conversion::Error error;
+    optional<PropertyValue<float>> function = conversion::convertJSON<PropertyValue<float>>(doc, error, false, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    size_t i = 0;
+    while(state.KeepRunning()) {
+        float z = 24.0f * static_cast<float>(i++ / 64 % 100) / 100;
+        benchmark::DoNotOptimize(function->asExpression().interpolationFactor({ 0.0f, 24.0f }, z));
+    }
+
+    state.SetLabel(std::to_string(stopCount).c_str());
+}
+
+// The same with the zoom evaluation cache, which only pays off if computing the factor costs
+// more than the lookup.
+static void Evaluate_InterpolationFactorMemoized(benchmark::State& state) {
+    size_t stopCount = state.range(0);
+    auto doc = createFunctionJSON(stopCount);
+    conversion::Error error;
+    optional<PropertyValue<float>> function = conversion::convertJSON<PropertyValue<float>>(doc, error, false, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    size_t i = 0;
+    while(state.KeepRunning()) {
+        float z = 24.0f * static_cast<float>(i++ / 64 % 100) / 100;
+        benchmark::DoNotOptimize(function->asExpression().memoizedInterpolationFactor({ 0.0f, 24.0f }, z));
+    }
+
+    state.SetLabel(std::to_string(stopCount).c_str());
+}
+
 BENCHMARK(Parse_CameraFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
 BENCHMARK(Evaluate_CameraFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
+BENCHMARK(Evaluate_CameraFunctionMemoized)
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
+BENCHMARK(Evaluate_InterpolationFactor)
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
+
+BENCHMARK(Evaluate_InterpolationFactorMemoized)
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion/property_value.hpp>
+#include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+// A data-driven circle radius of the kind that styles commonly use. Its case expression and
+// interpolation between non-constant outputs are compiled to jumps, so batches evaluate it
+// one feature at a time.
+const std::string json = R"(
+    ["interpolate", ["linear"], ["get", "population"],
+        0, ["match", ["get", "class"], ["city", "town"], 4, 2],
+        1000000, ["*", 2, ["match", ["get", "class"], ["city", "town"], 4, 2]],
+        10000000, ["case", ["==", ["get", "capital"], true], 24, 16]
+    ]
+)";
+
+// A similar radius that only interpolates and matches constant outputs, which compiles to a
+// program without jumps that batches evaluate for many features at once.
+const std::string jumpFreeJson = R"(
+    ["*",
+        ["interpolate", ["linear"], ["get", "population"], 0, 2, 1000000, 8, 10000000, 16],
+        ["match", ["get", "class"], ["city", "town"], 1.5, 1]
+    ]
+)";
+
+std::vector<StubGeometryTileFeature> createFeatures() {
+    static const std::string classes[] = { "city", "town", "village" };
+    std::vector<StubGeometryTileFeature> features;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        features.emplace_back(PropertyMap {
+            { "population", i * 12345 },
+            { "class", classes[i % 3] },
+            { "capital", i % 7 == 0 },
+        });
+    }
+    return features;
+}
+
+void evaluateTree(benchmark::State& state, const std::string& source) {
+    conversion::Error error;
+    const auto value = conversion::convertJSON<PropertyValue<float>>(source, error, true, false);
+    const std::vector<StubGeometryTileFeature> features = createFeatures();
+
+    while (state.KeepRunning()) {
+        for (const auto& feature : features) {
+            const auto result = value->asExpression().getExpression().evaluate(expression::EvaluationContext(&feature));
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+void evaluateCompiled(benchmark::State& state, const std::string& source) {
+    conversion::Error error;
+    const auto value = conversion::convertJSON<PropertyValue<float>>(source, error, true, false);
+    const auto compiled = expression::CompiledExpression::compile(value->asExpression().getExpression());
+    const std::vector<StubGeometryTileFeature> features = createFeatures();
+
+    while (state.KeepRunning()) {
+        for (const auto& feature : features) {
+            float result = 0;
+            benchmark::DoNotOptimize(compiled->evaluate(expression::EvaluationContext(&feature), result));
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+void evaluateBatch(benchmark::State& state, const std::string& source) {
+    conversion::Error error;
+    const auto value = conversion::convertJSON<PropertyValue<float>>(source, error, true, false);
+    const auto compiled = expression::CompiledExpression::compile(value->asExpression().getExpression());
+    const std::vector<StubGeometryTileFeature> features = createFeatures();
+    std::vector<const GeometryTileFeature*> featurePtrs;
+    for (const auto& feature : features) {
+        featurePtrs.push_back(&feature);
+    }
+
+    std::vector<float> results;
+    while (state.KeepRunning()) {
+        compiled->evaluate(expression::EvaluationContext(), featurePtrs, results, 0.0f);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+} // namespace
+
+static void CompiledExpression_EvaluateTree(benchmark::State& state) {
+    evaluateTree(state, json);
+}
+
+static void CompiledExpression_EvaluateCompiled(benchmark::State& state) {
+    evaluateCompiled(state, json);
+}
+
+static void CompiledExpression_EvaluateBatch(benchmark::State& state) {
+    evaluateBatch(state, json);
+}
+
+static void CompiledExpression_EvaluateTreeJumpFree(benchmark::State& state) {
+    evaluateTree(state, jumpFreeJson);
+}
+
+static void CompiledExpression_EvaluateCompiledJumpFree(benchmark::State& state) {
+    evaluateCompiled(state, jumpFreeJson);
+}
+
+static void CompiledExpression_EvaluateBatchJumpFree(benchmark::State& state) {
+    evaluateBatch(state, jumpFreeJson);
+}
+
+BENCHMARK(CompiledExpression_EvaluateTree);
+BENCHMARK(CompiledExpression_EvaluateCompiled);
+BENCHMARK(CompiledExpression_EvaluateBatch);
+BENCHMARK(CompiledExpression_EvaluateTreeJumpFree);
+BENCHMARK(CompiledExpression_EvaluateCompiledJumpFree);
+BENCHMARK(CompiledExpression_EvaluateBatchJumpFree);
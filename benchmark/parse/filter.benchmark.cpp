@@ -5,7 +5,13 @@
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/style/conversion_impl.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
+#include <mbgl/benchmark/allocation_counter.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <utility>
+#include <vector>
 
 using namespace mbgl;
 
@@ -30,5 +36,85 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+// A subset of the source layers and filters used by the Mapbox Streets style.
+const std::vector<std::pair<const char*, const char*>>& streetsFilters() {
+    static const std::vector<std::pair<const char*, const char*>> filters = {
+        { "landcover", R"FILTER(["==", "class", "wood"])FILTER" },
+        { "landcover", R"FILTER(["==", "class", "scrub"])FILTER" },
+        { "landcover", R"FILTER(["==", "class", "grass"])FILTER" },
+        { "landcover", R"FILTER(["==", "class", "crop"])FILTER" },
+        { "landuse", R"FILTER(["==", "class", "park"])FILTER" },
+        { "landuse", R"FILTER(["in", "class", "school", "university", "college"])FILTER" },
+        { "landuse_overlay", R"FILTER(["==", "class", "wetland"])FILTER" },
+        { "waterway", R"FILTER(["all", ["==", "$type", "LineString"], ["in", "class", "canal", "river"]])FILTER" },
+        { "water", R"FILTER(["==", "$type", "Polygon"])FILTER" },
+        { "aeroway", R"FILTER(["all", ["==", "$type", "LineString"], ["==", "type", "runway"]])FILTER" },
+        { "road", R"FILTER(["all", ["==", "structure", "tunnel"], ["in", "class", "motorway", "trunk"]])FILTER" },
+        { "road", R"FILTER(["all", ["==", "$type", "LineString"], ["!in", "structure", "bridge", "tunnel"], ["in", "class", "motorway_link"]])FILTER" },
+        { "road", R"FILTER(["all", ["==", "$type", "LineString"], ["!in", "structure", "bridge", "tunnel"], ["in", "class", "motorway", "trunk", "primary"]])FILTER" },
+        { "road", R"FILTER(["all", ["==", "$type", "LineString"], ["!in", "structure", "bridge", "tunnel"], ["in", "class", "major_rail", "minor_rail"]])FILTER" },
+        { "road", R"FILTER(["all", ["==", "structure", "bridge"], ["==", "class", "motorway"]])FILTER" },
+        { "admin", R"FILTER(["all", [">=", "admin_level", 3], ["==", "maritime", 0]])FILTER" },
+        { "admin", R"FILTER(["all", ["==", "admin_level", 2], ["==", "disputed", 0], ["==", "maritime", 0]])FILTER" },
+        { "road_label", R"FILTER(["all", ["==", "$type", "Point"], ["==", "class", "motorway"], ["<=", "reflen", 6]])FILTER" },
+        { "place_label", R"FILTER(["all", ["==", "type", "city"], ["<=", "scalerank", 1]])FILTER" },
+        { "place_label", R"FILTER(["in", "type", "town", "village", "hamlet"])FILTER" },
+        { "poi_label", R"FILTER(["all", ["==", "$type", "Point"], ["has", "name"], ["<=", "scalerank", 2]])FILTER" },
+        { "water_label", R"FILTER(["==", "$type", "Point"])FILTER" },
+    };
+    return filters;
+}
+
+// Filters the features of the Streets fixture the way GeometryTileWorker does, either by
+// evaluating each filter's expression, or by evaluating the filters on the encoded features.
+static void filterStreetsTile(benchmark::State& state, bool compiled) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    std::vector<std::pair<std::string, style::Filter>> filters;
+    for (const auto& filter : streetsFilters()) {
+        filters.emplace_back(filter.first, parse(filter.second));
+    }
+
+    std::size_t features = 0;
+    const std::size_t allocations = allocationCount();
+    while (state.KeepRunning()) {
+        std::size_t matches = 0;
+        VectorTileData tile(data);
+        for (const auto& filter : filters) {
+            auto layer = tile.getLayer(filter.first);
+            if (!layer) {
+                continue;
+            }
+            features += layer->featureCount();
+            if (compiled) {
+                layer->forEachFeature(filter.second, 10.0f, [&](std::size_t, const GeometryTileFeature&) {
+                    ++matches;
+                    return true;
+                });
+            } else {
+                layer->forEachFeature([&](std::size_t, const GeometryTileFeature& feature) {
+                    if (filter.second(style::expression::EvaluationContext { 10.0f, &feature })) {
+                        ++matches;
+                    }
+                    return true;
+                });
+            }
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.counters["allocs/feature"] = double(allocationCount() - allocations) / features;
+    state.SetItemsProcessed(features);
+}
+
+static void Parse_EvaluateFilterStreets(benchmark::State& state) {
+    filterStreetsTile(state, false);
+}
+
+static void Parse_EvaluateFilterStreetsCompiled(benchmark::State& state) {
+    filterStreetsTile(state, true);
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateFilterStreets);
+BENCHMARK(Parse_EvaluateFilterStreetsCompiled);
@@ -1,13 +1,84 @@
 #include <benchmark/benchmark.h>
 
+#include <mbgl/benchmark/allocation_counter.hpp>
 #include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/util/io.hpp>
 
+#include <protozero/pbf_writer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
 using namespace mbgl;
 
+namespace {
+
+// Reports the allocations and the time spent per decoded feature.
+class FeatureCounters {
+public:
+    FeatureCounters() : allocations(allocationCount()), start(std::chrono::steady_clock::now()) {}
+
+    void report(benchmark::State& state, std::size_t features) const {
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+        state.counters["allocs/feature"] = double(allocationCount() - allocations) / features;
+        state.counters["ns/feature"] = elapsed.count() / features;
+        state.SetItemsProcessed(features);
+    }
+
+private:
+    const std::size_t allocations;
+    const std::chrono::steady_clock::time_point start;
+};
+
+// A tile with one point layer whose features are tagged with a few of its many keys, like POI
+// layers that have a name key for each of dozens of languages.
+std::string createManyKeysTile(uint32_t keyCount, uint32_t featureCount) {
+    std::string layerData;
+    {
+        protozero::pbf_writer layer(layerData);
+        layer.add_uint32(15, 2); // version
+        layer.add_string(1, "poi"); // name
+        for (uint32_t i = 0; i < featureCount; ++i) {
+            protozero::pbf_writer feature(layer, 2);
+            feature.add_uint64(1, i); // id
+            // class, and three names, each with a value of its own.
+            const uint32_t tags[] = { 0, 0, 1 + i % (keyCount - 1), 1 + i % 97,
+                                      1 + (i * 7) % (keyCount - 1), 1 + i % 89,
+                                      keyCount - 1, 1 + i % 83 };
+            feature.add_packed_uint32(2, std::begin(tags), std::end(tags));
+            feature.add_enum(3, 1); // point
+            const uint32_t geometry[] = { 9, 50, 34 };
+            feature.add_packed_uint32(4, std::begin(geometry), std::end(geometry));
+        }
+        layer.add_string(3, "class");
+        for (uint32_t i = 1; i < keyCount; ++i) {
+            layer.add_string(3, "name_" + std::to_string(i));
+        }
+        for (uint32_t i = 0; i < 100; ++i) {
+            std::string valueData;
+            protozero::pbf_writer value(valueData);
+            value.add_string(1, "value " + std::to_string(i));
+            layer.add_message(4, valueData);
+        }
+        layer.add_uint32(5, 4096); // extent
+    }
+
+    std::string tileData;
+    protozero::pbf_writer tile(tileData);
+    tile.add_message(3, layerData);
+    return tileData;
+}
+
+} // namespace
+
 static void Parse_VectorTile(benchmark::State& state) {
     auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
 
+    std::size_t features = 0;
+    const FeatureCounters counters;
     while (state.KeepRunning()) {
         std::size_t length = 0;
         VectorTileData tile(data);
@@ -18,11 +89,136 @@ static void Parse_VectorTile(benchmark::State& state) {
                     if (auto feature = layer->getFeature(i)) {
                         length += feature->getGeometries().size();
                         length += feature->getProperties().size();
+                        ++features;
                     }
                 }
             }
         }
     }
+    counters.report(state, features);
+}
+
+// Decodes geometries the way GeometryTileWorker does: features aren't allocated, and the
+// geometry collection is reused from one feature to the next.
+static void Parse_VectorTileGeometries(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    std::size_t features = 0;
+    const FeatureCounters counters;
+    while (state.KeepRunning()) {
+        std::size_t length = 0;
+        VectorTileData tile(data);
+        GeometryCollection geometries;
+        for (const auto& name : tile.layerNames()) {
+            if (auto layer = tile.getLayer(name)) {
+                layer->forEachFeature([&](std::size_t, const GeometryTileFeature& feature) {
+                    feature.decodeGeometries(geometries);
+                    length += geometries.size();
+                    ++features;
+                    return true;
+                });
+            }
+        }
+        benchmark::DoNotOptimize(length);
+    }
+    counters.report(state, features);
+}
+
+// Same as above, but with the previous approach of allocating every feature and geometry.
+static void Parse_VectorTileGeometriesAllocating(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    std::size_t features = 0;
+    const FeatureCounters counters;
+    while (state.KeepRunning()) {
+        std::size_t length = 0;
+        VectorTileData tile(data);
+        for (const auto& name : tile.layerNames()) {
+            if (auto layer = tile.getLayer(name)) {
+                const std::size_t count = layer->featureCount();
+                for (std::size_t i = 0; i < count; i++) {
+                    if (auto feature = layer->getFeature(i)) {
+                        length += feature->getGeometries().size();
+                        ++features;
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize(length);
+    }
+    counters.report(state, features);
+}
+
+// Reads properties of every feature the way filters and data-driven properties do, either
+// without copying them, or by copying each value.
+static void readVectorTileProperties(benchmark::State& state, bool copy) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    const std::vector<std::string> keys = { "class", "type", "name", "name_en", "scalerank" };
+
+    std::size_t features = 0;
+    const FeatureCounters counters;
+    while (state.KeepRunning()) {
+        std::size_t found = 0;
+        VectorTileData tile(data);
+        for (const auto& name : tile.layerNames()) {
+            if (auto layer = tile.getLayer(name)) {
+                layer->forEachFeature([&](std::size_t, const GeometryTileFeature& feature) {
+                    for (const auto& key : keys) {
+                        if (copy) {
+                            found += bool(feature.getValue(key));
+                        } else {
+                            optional<Value> storage;
+                            found += feature.findValue(key, storage) != nullptr;
+                        }
+                    }
+                    ++features;
+                    return true;
+                });
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    counters.report(state, features);
+}
+
+static void Parse_VectorTileProperties(benchmark::State& state) {
+    readVectorTileProperties(state, false);
+}
+
+static void Parse_VectorTilePropertiesCopying(benchmark::State& state) {
+    readVectorTileProperties(state, true);
+}
+
+// Looks up properties by name on a layer with many keys, so that the cost of finding a key
+// dominates over reading its value.
+static void Parse_VectorTilePropertiesManyKeys(benchmark::State& state) {
+    const auto keyCount = static_cast<uint32_t>(state.range(0));
+    auto data = std::make_shared<std::string>(createManyKeysTile(keyCount, 1000));
+    const std::vector<std::string> keys = { "class", "name_1", "name_" + std::to_string(keyCount - 1), "name_en" };
+
+    std::size_t features = 0;
+    const FeatureCounters counters;
+    while (state.KeepRunning()) {
+        std::size_t found = 0;
+        VectorTileData tile(data);
+        if (auto layer = tile.getLayer("poi")) {
+            layer->forEachFeature([&](std::size_t, const GeometryTileFeature& feature) {
+                for (const auto& key : keys) {
+                    optional<Value> storage;
+                    found += feature.findValue(key, storage) != nullptr;
+                }
+                ++features;
+                return true;
+            });
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    counters.report(state, features);
 }
 
 BENCHMARK(Parse_VectorTile);
+BENCHMARK(Parse_VectorTileGeometries);
+BENCHMARK(Parse_VectorTileGeometriesAllocating);
+BENCHMARK(Parse_VectorTileProperties);
+BENCHMARK(Parse_VectorTilePropertiesCopying);
+BENCHMARK(Parse_VectorTilePropertiesManyKeys)->Arg(8)->Arg(64)->Arg(256);
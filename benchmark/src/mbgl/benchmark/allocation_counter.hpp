@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mbgl {
+
+// Returns the number of calls to the global operator new made by this process so far.
+// Take the difference of two calls to measure the allocations made by a piece of code.
+std::size_t allocationCount();
+
+} // namespace mbgl
@@ -1,11 +1,19 @@
 #include <benchmark/benchmark.h>
 
 #include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/payload.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/sqlite3.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/util/string.hpp>
 
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+
+#include <unistd.h>
+
 class OfflineDatabase : public benchmark::Fixture {
 public:
     void SetUp(const ::benchmark::State&) override {
@@ -52,3 +60,133 @@ BENCHMARK_F(OfflineDatabase, InvalidateTileCache)(benchmark::State& state) {
         db.invalidateTileCache();
     }
 }
+
+namespace {
+
+using namespace mbgl;
+
+// Vector tiles are typically a few dozen kilobytes; random data doesn't compress, like
+// already compressed tile data.
+std::shared_ptr<std::string> tileData(std::size_t size, unsigned seed) {
+    auto data = std::make_shared<std::string>(size, 0);
+    std::mt19937 random(seed);
+    for (auto& c : *data) {
+        c = static_cast<char>(random());
+    }
+    return data;
+}
+
+// Creates a new temporary directory, so that running the benchmark doesn't write into the
+// source tree.
+std::string createTemporaryDirectory() {
+    const char* tmp = std::getenv("TMPDIR");
+    std::string directory = std::string(tmp && *tmp ? tmp : "/tmp") + "/mbgl-benchmark-XXXXXX";
+    if (!mkdtemp(&directory[0])) {
+        throw std::runtime_error("Can't create a temporary directory");
+    }
+    return directory;
+}
+
+Resource tile(unsigned i) {
+    return Resource::tile("mapbox://tile_mixed", 1.0, i % 1024, i / 1024, 10, Tileset::Scheme::XYZ);
+}
+
+// Each iteration stores one new tile and reads `state.range(1)` tiles that are already cached,
+// like a busy pan does. state.range(0) selects the journal mode.
+void MixedReadWrite(benchmark::State& state) {
+    using namespace std::chrono_literals;
+
+    const std::string directory = createTemporaryDirectory();
+    const std::string path = directory + "/offline.db";
+
+    const auto journalMode = state.range(0) ? mbgl::OfflineDatabase::JournalMode::WAL
+                                            : mbgl::OfflineDatabase::JournalMode::Delete;
+    const auto synchronous = state.range(0) ? mbgl::OfflineDatabase::Synchronous::Normal
+                                            : mbgl::OfflineDatabase::Synchronous::Full;
+    const unsigned reads = state.range(1);
+
+    {
+        mbgl::OfflineDatabase db(path, util::DEFAULT_MAX_CACHE_SIZE, journalMode, synchronous);
+
+        Response response;
+        response.expires = util::now() + 1h;
+
+        std::vector<std::shared_ptr<std::string>> payloads;
+        for (unsigned i = 0; i < 16; ++i) {
+            payloads.push_back(tileData(32 * 1024, i));
+        }
+
+        const unsigned cachedTiles = 256;
+        for (unsigned i = 0; i < cachedTiles; ++i) {
+            response.data = payloads[i % payloads.size()];
+            db.put(tile(i), response);
+        }
+        db.flush();
+
+        unsigned i = cachedTiles;
+        std::size_t bytes = 0;
+        for (auto _ : state) {
+            response.data = payloads[i % payloads.size()];
+            db.put(tile(i++), response);
+            for (unsigned j = 0; j < reads; ++j) {
+                if (auto cached = db.get(tile((i * 7 + j * 13) % cachedTiles))) {
+                    bytes += cached->data->size();
+                }
+            }
+        }
+        db.flush();
+
+        state.SetBytesProcessed(bytes);
+        state.SetItemsProcessed(state.iterations() * (reads + 1));
+    }
+
+    util::deleteFile(path);
+    util::deleteFile(path + "-wal");
+    util::deleteFile(path + "-shm");
+    rmdir(directory.c_str());
+}
+
+// Reads a cached, compressible tile. state.range(0) selects whether the database inflates it, or
+// leaves that to the tile worker like tiles do. Reports the bytes copied and inflated per tile.
+void GetCompressedTile(benchmark::State& state) {
+    using namespace std::chrono_literals;
+
+    mbgl::OfflineDatabase db(":memory:");
+
+    Resource resource = tile(0);
+    resource.acceptsCompressedData = state.range(0) != 0;
+
+    // Repetitive, like the keys and values of vector tile features.
+    std::string data;
+    while (data.size() < 64 * 1024) {
+        data += "{\"class\":\"street\",\"oneway\":" + util::toString(data.size() % 2) + "}";
+    }
+
+    Response response;
+    response.expires = util::now() + 1h;
+    response.data = std::make_shared<std::string>(std::move(data));
+    db.put(resource, response);
+
+    PayloadStatistics::reset();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.get(resource));
+    }
+
+    const auto statistics = PayloadStatistics::get();
+    state.counters["copied/tile"] = double(statistics.copiedBytes) / state.iterations();
+    state.counters["inflated/tile"] = double(statistics.inflatedBytes) / state.iterations();
+}
+
+} // namespace
+
+BENCHMARK(MixedReadWrite)
+    ->Args({ 0, 1 })
+    ->Args({ 0, 8 })
+    ->Args({ 1, 1 })
+    ->Args({ 1, 8 })
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(GetCompressedTile)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
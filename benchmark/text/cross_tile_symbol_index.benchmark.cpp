@@ -0,0 +1,136 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/cross_tile_symbol_index.hpp>
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr uint8_t minZoom = 12;
+constexpr uint8_t maxZoom = 15;
+// The view covers 4x4 tiles of the zoom level it shows, around the same center.
+constexpr int viewTiles = 4;
+const double centerX = 1205.5;
+const double centerY = 1539.5;
+
+// A place label, positioned in z12 tile units.
+struct Place {
+    double x;
+    double y;
+    std::u16string key;
+};
+
+SymbolInstance makeSymbolInstance(float x, float y, std::u16string key) {
+    GeometryCoordinates line;
+    GlyphPositions positions;
+    const ShapedTextOrientations shaping{};
+    style::SymbolLayoutProperties::Evaluated layout;
+    IndexedSubfeature subfeature(0, "", "", 0);
+    Anchor anchor(x, y, 0, 0);
+    return SymbolInstance(anchor, line, shaping, {}, layout, 0, 0, 0, style::SymbolPlacementType::Point, {{0, 0}}, 0, 0, {{0, 0}}, positions, subfeature, 0, 0, key, 0, 0, 0.0f);
+}
+
+std::vector<OverscaledTileID> viewTileIDs(uint8_t z) {
+    const double scale = std::pow(2, z - minZoom);
+    const int x0 = std::floor(centerX * scale) - viewTiles / 2;
+    const int y0 = std::floor(centerY * scale) - viewTiles / 2;
+    std::vector<OverscaledTileID> result;
+    for (int y = y0; y < y0 + viewTiles; ++y) {
+        for (int x = x0; x < x0 + viewTiles; ++x) {
+            result.emplace_back(z, x, y);
+        }
+    }
+    return result;
+}
+
+// Buckets for the tiles that a zoom animation from z12 to z15 shows. Most labels are unique
+// place names; a fifth of them are road names that repeat all over the view.
+class ZoomAnimation {
+public:
+    ZoomAnimation() {
+        std::mt19937 generator(1);
+        const double extent = double(viewTiles) / 2;
+        std::uniform_real_distribution<double> offset(-extent, extent);
+        std::vector<Place> places;
+        for (std::size_t i = 0; i < 20000; ++i) {
+            const std::string key = i % 5 == 0 ? "Road " + std::to_string(i % 50) : "Place " + std::to_string(i);
+            places.push_back({ centerX + offset(generator), centerY + offset(generator), std::u16string(key.begin(), key.end()) });
+        }
+
+        uint32_t bucketInstanceId = 0;
+        for (uint8_t z = minZoom; z <= maxZoom; ++z) {
+            const double scale = std::pow(2, z - minZoom);
+            for (const auto& tileID : viewTileIDs(z)) {
+                std::vector<SymbolInstance> instances;
+                for (const auto& place : places) {
+                    const double x = (place.x * scale - tileID.canonical.x) * util::EXTENT;
+                    const double y = (place.y * scale - tileID.canonical.y) * util::EXTENT;
+                    if (x >= 0 && x < util::EXTENT && y >= 0 && y < util::EXTENT) {
+                        instances.push_back(makeSymbolInstance(x, y, place.key));
+                    }
+                }
+
+                auto bucket = std::make_unique<SymbolBucket>(style::SymbolLayoutProperties::PossiblyEvaluated(),
+                    std::map<std::string, Immutable<style::LayerProperties>>(), 16.0f, 1.0f, 0, false, false, false,
+                    "layer", std::move(instances), 1.0f);
+                bucket->bucketInstanceId = ++bucketInstanceId;
+                buckets.emplace(tileID, std::move(bucket));
+            }
+        }
+
+        // Frames at every 0.05 zoom levels. For a few frames after the view switches to the next
+        // zoom level, the tiles of the previous one are still shown while the new ones fade in.
+        for (int frame = 0; frame <= 20 * (maxZoom - minZoom); ++frame) {
+            const auto z = uint8_t(minZoom + frame / 20);
+            frames.emplace_back(viewTileIDs(z));
+            if (frame % 20 < 5 && z > minZoom) {
+                for (const auto& tileID : viewTileIDs(z - 1)) {
+                    frames.back().push_back(tileID);
+                }
+            }
+        }
+    }
+
+    std::map<OverscaledTileID, std::unique_ptr<SymbolBucket>> buckets;
+    std::vector<std::vector<OverscaledTileID>> frames;
+};
+
+const ZoomAnimation& animation() {
+    static const auto instance = std::make_unique<ZoomAnimation>();
+    return *instance;
+}
+
+} // namespace
+
+// Adds the buckets of every frame of a zoom animation to a fresh index, and removes the buckets
+// of the tiles that went out of view, like CrossTileSymbolIndex::addLayer() does.
+static void CrossTileSymbolIndex_ZoomAnimation(benchmark::State& state) {
+    const auto& zoomAnimation = animation();
+
+    while (state.KeepRunning()) {
+        CrossTileSymbolLayerIndex index;
+        uint32_t maxCrossTileID = 0;
+        for (const auto& frame : zoomAnimation.frames) {
+            std::unordered_set<uint32_t> currentBucketIDs;
+            for (const auto& tileID : frame) {
+                SymbolBucket& bucket = *zoomAnimation.buckets.at(tileID);
+                index.addBucket(tileID, bucket, maxCrossTileID);
+                currentBucketIDs.insert(bucket.bucketInstanceId);
+            }
+            index.removeStaleBuckets(currentBucketIDs);
+        }
+        benchmark::DoNotOptimize(maxCrossTileID);
+    }
+    state.SetItemsProcessed(state.iterations() * zoomAnimation.frames.size());
+}
+
+BENCHMARK(CrossTileSymbolIndex_ZoomAnimation);
@@ -0,0 +1,184 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/glyph_sdf_cache.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/tiny_sdf.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+const FontStack fontStack{{ "Noto Sans Regular" }};
+const GlyphRange range{ 19968, 20223 };
+
+// A 30x30 raster like the ones that LocalGlyphRasterizer implementations produce for
+// ideographs: a few antialiased horizontal and vertical strokes.
+AlphaImage rasterizeIdeograph(GlyphID id) {
+    AlphaImage raster({ 30, 30 });
+    const uint32_t strokes = 2 + id % 4;
+    for (uint32_t i = 0; i < strokes; ++i) {
+        const uint32_t offset = 5 + (i * 7 + id) % 20;
+        for (uint32_t along = 4; along < 26; ++along) {
+            raster.data[offset * 30 + along] = 255;
+            raster.data[(offset + 1) * 30 + along] = 96;
+            raster.data[along * 30 + offset] = 255;
+            raster.data[along * 30 + offset + 1] = 96;
+        }
+    }
+    return raster;
+}
+
+// The distance transform that transformRasterToSDF() used before it was reworked for
+// the local glyph cache: double precision grids and fresh temporary arrays for every glyph.
+namespace reference {
+
+const double INF = 1e20;
+
+void edt1d(std::vector<double>& f, std::vector<double>& d, std::vector<int16_t>& v, std::vector<double>& z, uint32_t n) {
+    v[0] = 0;
+    z[0] = -INF;
+    z[1] = +INF;
+
+    for (uint32_t q = 1, k = 0; q < n; q++) {
+        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = +INF;
+    }
+
+    for (uint32_t q = 0, k = 0; q < n; q++) {
+        while (z[k + 1] < q) k++;
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+void edt(std::vector<double>& data, uint32_t width, uint32_t height,
+         std::vector<double>& f, std::vector<double>& d, std::vector<int16_t>& v, std::vector<double>& z) {
+    for (uint32_t x = 0; x < width; x++) {
+        for (uint32_t y = 0; y < height; y++) {
+            f[y] = data[y * width + x];
+        }
+        edt1d(f, d, v, z, height);
+        for (uint32_t y = 0; y < height; y++) {
+            data[y * width + x] = d[y];
+        }
+    }
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            f[x] = data[y * width + x];
+        }
+        edt1d(f, d, v, z, width);
+        for (uint32_t x = 0; x < width; x++) {
+            data[y * width + x] = std::sqrt(d[x]);
+        }
+    }
+}
+
+AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff) {
+    uint32_t size = rasterInput.size.width * rasterInput.size.height;
+    uint32_t maxDimension = std::max(rasterInput.size.width, rasterInput.size.height);
+
+    AlphaImage sdf(rasterInput.size);
+
+    std::vector<double> gridOuter(size);
+    std::vector<double> gridInner(size);
+    std::vector<double> f(maxDimension);
+    std::vector<double> d(maxDimension);
+    std::vector<double> z(maxDimension + 1);
+    std::vector<int16_t> v(maxDimension);
+
+    for (uint32_t i = 0; i < size; i++) {
+        double a = double(rasterInput.data[i]) / 255;
+        gridOuter[i] = a == 1.0 ? 0.0 : a == 0.0 ? INF : std::pow(std::max(0.0, 0.5 - a), 2.0);
+        gridInner[i] = a == 1.0 ? INF : a == 0.0 ? 0.0 : std::pow(std::max(0.0, a - 0.5), 2.0);
+    }
+
+    edt(gridOuter, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
+    edt(gridInner, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
+
+    for (uint32_t i = 0; i < size; i++) {
+        double distance = gridOuter[i] - gridInner[i];
+        sdf.data[i] = std::max(0l, std::min(255l, ::lround(255.0 - 255.0 * (distance / radius + cutoff))));
+    }
+
+    return sdf;
+}
+
+} // namespace reference
+
+std::vector<AlphaImage> rangeRasters() {
+    std::vector<AlphaImage> rasters;
+    for (uint32_t id = range.first; id <= range.second; ++id) {
+        rasters.push_back(rasterizeIdeograph(static_cast<GlyphID>(id)));
+    }
+    return rasters;
+}
+
+std::vector<Immutable<Glyph>> rangeGlyphs() {
+    std::vector<Immutable<Glyph>> glyphs;
+    for (uint32_t id = range.first; id <= range.second; ++id) {
+        Glyph glyph;
+        glyph.id = static_cast<GlyphID>(id);
+        glyph.metrics.width = 24;
+        glyph.metrics.height = 24;
+        glyph.metrics.top = -8;
+        glyph.metrics.advance = 24;
+        glyph.bitmap = util::transformRasterToSDF(rasterizeIdeograph(static_cast<GlyphID>(id)), 8, .25);
+        glyphs.push_back(Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph))));
+    }
+    return glyphs;
+}
+
+} // namespace
+
+// Turns rasterized ideographs into SDFs, like GlyphManager does for every glyph that isn't
+// in the local glyph cache.
+static void LocalGlyph_TransformRasterToSDF(benchmark::State& state) {
+    const std::vector<AlphaImage> rasters = rangeRasters();
+
+    while (state.KeepRunning()) {
+        for (const auto& raster : rasters) {
+            benchmark::DoNotOptimize(util::transformRasterToSDF(raster, 8, .25));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * rasters.size());
+}
+
+// The same with the previous distance transform, for comparison.
+static void LocalGlyph_TransformRasterToSDFReference(benchmark::State& state) {
+    const std::vector<AlphaImage> rasters = rangeRasters();
+
+    while (state.KeepRunning()) {
+        for (const auto& raster : rasters) {
+            benchmark::DoNotOptimize(reference::transformRasterToSDF(raster, 8, .25));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * rasters.size());
+}
+
+// Loads the SDFs of a glyph range from the local glyph cache instead.
+static void LocalGlyph_LoadFromCache(benchmark::State& state) {
+    const GlyphSDFCache cache("benchmark/fixtures", {}, 8, .25);
+    cache.store(fontStack, range, rangeGlyphs());
+
+    std::size_t glyphs = 0;
+    while (state.KeepRunning()) {
+        glyphs += cache.load(fontStack, range).size();
+    }
+    state.SetItemsProcessed(glyphs);
+
+    util::deleteFile(cache.path(fontStack, range));
+}
+
+BENCHMARK(LocalGlyph_TransformRasterToSDF);
+BENCHMARK(LocalGlyph_TransformRasterToSDFReference);
+BENCHMARK(LocalGlyph_LoadFromCache);
@@ -0,0 +1,204 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/collision_index.hpp>
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/layout/symbol_projection.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
+#include <mbgl/util/transform_points.hpp>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// A symbol heavy tile in a pitched 1024x1024 view: a dense field of point labels and a few
+// hundred labels along horizontal lines.
+class PlacementFixture {
+public:
+    PlacementFixture() {
+        transform.resize({ 1024, 1024 });
+        const LatLng center { 40.726989, -73.992857 };
+        transform.jumpTo(CameraOptions().withCenter(center).withZoom(16.0).withPitch(45.0));
+
+        const auto& state = transform.getState();
+        const auto tile = TileCoordinate::fromLatLng(16, center).p;
+        const UnwrappedTileID tileID(16, tile.x, tile.y);
+
+        mat4 projMatrix;
+        state.getProjMatrix(projMatrix);
+        state.matrixFor(posMatrix, tileID);
+        matrix::multiply(posMatrix, projMatrix, posMatrix);
+        labelPlaneMatrix = getLabelPlaneMatrix(posMatrix, false, true, state, tileID.pixelsToTileUnits(1, state.getZoom()));
+        pixelRatio = float(util::tileSize) / util::EXTENT;
+
+        // 20000 point labels of 60x16 px.
+        for (std::size_t i = 0; i < 20000; ++i) {
+            const float x = std::fmod(i * 409.7f, util::EXTENT);
+            const float y = std::fmod(i * 61.3f, util::EXTENT);
+            pointFeatures.emplace_back(GeometryCoordinates{}, Anchor(x, y, 0, 0), -8, 8, -30, 30, 16.0f, 0.0f,
+                                       style::SymbolPlacementType::Point,
+                                       IndexedSubfeature(i, "points", "points", i), 1.0f, 0.0f);
+        }
+
+        // 500 line labels, on lines with a vertex every 512 tile units.
+        for (std::size_t i = 0; i < 500; ++i) {
+            const int16_t y = int16_t(i * util::EXTENT / 500);
+            GeometryCoordinates line;
+            for (int16_t x = 0; x <= util::EXTENT; x += 512) {
+                line.emplace_back(x, y);
+            }
+
+            const float anchorX = 512.0f * (i % 14) + 768.0f;
+            const auto segment = uint16_t(anchorX / 512);
+            std::vector<float> tileDistances;
+            for (const auto& vertex : line) {
+                tileDistances.push_back(std::abs(vertex.x - anchorX));
+            }
+
+            lineFeatures.emplace_back(line, Anchor(anchorX, y, 0, 0, segment), -8, 8, -60, 60, 16.0f, 0.0f,
+                                      style::SymbolPlacementType::Line,
+                                      IndexedSubfeature(i, "lines", "lines", i), 1.0f, 0.0f);
+
+            lineSymbols.emplace_back(Point<float>(anchorX, y), segment, 16.0f, 16.0f, std::array<float, 2>{{ 0, 0 }},
+                                     WritingModeType::Horizontal, line, tileDistances);
+            for (int glyph = 0; glyph < 12; ++glyph) {
+                lineSymbols.back().glyphOffsets.push_back(10.0f * glyph - 55.0f);
+            }
+        }
+    }
+
+    CollisionIndex::Projection project(const CollisionIndex& collisionIndex, const CollisionFeature& feature,
+                                       const PlacedSymbol& symbol) const {
+        return collisionIndex.projectFeature(feature, posMatrix, labelPlaneMatrix, pixelRatio, symbol, 1.0f, 16.0f, false);
+    }
+
+    Transform transform;
+    mat4 posMatrix;
+    mat4 labelPlaneMatrix;
+    float pixelRatio;
+    std::vector<CollisionFeature> pointFeatures;
+    std::vector<CollisionFeature> lineFeatures;
+    std::vector<PlacedSymbol> lineSymbols;
+};
+
+const PlacementFixture& fixture() {
+    static const auto instance = std::make_unique<PlacementFixture>();
+    return *instance;
+}
+
+void registerSIMD(benchmark::internal::Benchmark* benchmark) {
+    benchmark->Arg(int(util::SIMD::None));
+    if (util::bestSIMD() != util::SIMD::None) {
+        benchmark->Arg(int(util::bestSIMD()));
+    }
+}
+
+} // namespace
+
+static void Placement_TransformPoints(benchmark::State& state) {
+    const auto simd = util::SIMD(state.range(0));
+    const auto& f = fixture();
+
+    std::vector<float> x, y;
+    for (const auto& feature : f.pointFeatures) {
+        x.push_back(feature.boxes.front().anchor.x);
+        y.push_back(feature.boxes.front().anchor.y);
+    }
+    std::vector<double> outX(x.size()), outY(x.size()), outW(x.size());
+
+    while (state.KeepRunning()) {
+        util::transformPoints(f.posMatrix, x.size(), x.data(), y.data(), outX.data(), outY.data(), outW.data(), simd);
+        benchmark::DoNotOptimize(outW.data());
+    }
+    state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+static void Placement_ProjectBoxFeatures(benchmark::State& state) {
+    const bool batched = state.range(0);
+    const auto& f = fixture();
+    const CollisionIndex collisionIndex(f.transform.getState());
+    const PlacedSymbol& symbol = f.lineSymbols.front();
+
+    std::vector<CollisionIndex::Projection> projections(f.pointFeatures.size());
+    std::vector<std::pair<const CollisionFeature*, CollisionIndex::Projection*>> features;
+    for (std::size_t i = 0; i < f.pointFeatures.size(); ++i) {
+        features.emplace_back(&f.pointFeatures[i], &projections[i]);
+    }
+
+    while (state.KeepRunning()) {
+        if (batched) {
+            collisionIndex.projectBoxFeatures(f.posMatrix, f.pixelRatio, features);
+        } else {
+            for (std::size_t i = 0; i < f.pointFeatures.size(); ++i) {
+                projections[i] = f.project(collisionIndex, f.pointFeatures[i], symbol);
+            }
+        }
+        benchmark::DoNotOptimize(projections.data());
+    }
+    state.SetItemsProcessed(state.iterations() * f.pointFeatures.size());
+}
+
+static void Placement_ProjectLineFeatures(benchmark::State& state) {
+    const auto& f = fixture();
+    const CollisionIndex collisionIndex(f.transform.getState());
+
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < f.lineFeatures.size(); ++i) {
+            auto projection = f.project(collisionIndex, f.lineFeatures[i], f.lineSymbols[i]);
+            benchmark::DoNotOptimize(projection.circles.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * f.lineFeatures.size());
+}
+
+static void Placement_ProjectAnchors(benchmark::State& state) {
+    const auto& f = fixture();
+
+    while (state.KeepRunning()) {
+        auto anchors = projectAnchors(f.lineSymbols, f.posMatrix);
+        benchmark::DoNotOptimize(anchors.w.data());
+    }
+    state.SetItemsProcessed(state.iterations() * f.lineSymbols.size());
+}
+
+// Projects, places and inserts every feature into a fresh index, like a placement of one layer.
+static void Placement_PlaceFeatures(benchmark::State& state) {
+    const auto& f = fixture();
+    auto pointFeatures = f.pointFeatures;
+    auto lineFeatures = f.lineFeatures;
+
+    while (state.KeepRunning()) {
+        CollisionIndex collisionIndex(f.transform.getState());
+        std::size_t placed = 0;
+
+        for (std::size_t i = 0; i < lineFeatures.size(); ++i) {
+            const auto projection = f.project(collisionIndex, lineFeatures[i], f.lineSymbols[i]);
+            if (collisionIndex.placeFeature(lineFeatures[i], projection, {}, false, false, nullopt, nullopt).first) {
+                collisionIndex.insertFeature(lineFeatures[i], false, 0, 0);
+                ++placed;
+            }
+        }
+
+        for (auto& feature : pointFeatures) {
+            const auto projection = f.project(collisionIndex, feature, f.lineSymbols.front());
+            if (collisionIndex.placeFeature(feature, projection, {}, false, false, nullopt, nullopt).first) {
+                collisionIndex.insertFeature(feature, false, 0, 0);
+                ++placed;
+            }
+        }
+
+        benchmark::DoNotOptimize(placed);
+    }
+    state.SetItemsProcessed(state.iterations() * (pointFeatures.size() + lineFeatures.size()));
+}
+
+BENCHMARK(Placement_TransformPoints)->Apply(registerSIMD);
+BENCHMARK(Placement_ProjectBoxFeatures)->Arg(false)->Arg(true);
+BENCHMARK(Placement_ProjectLineFeatures);
+BENCHMARK(Placement_ProjectAnchors);
+BENCHMARK(Placement_PlaceFeatures);
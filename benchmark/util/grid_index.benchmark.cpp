@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/grid_index.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+using Grid = GridIndex<IndexedSubfeature>;
+
+// 50000 label sized boxes in a 1224x1224 viewport with 25px cells, like a CollisionIndex.
+const std::vector<Grid::BBox>& boxes() {
+    static const std::vector<Grid::BBox> result = [] {
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<float> position(0, 1224);
+        std::uniform_real_distribution<float> size(5, 60);
+
+        std::vector<Grid::BBox> boxes_;
+        for (std::size_t i = 0; i < 50000; ++i) {
+            const float x = position(generator);
+            const float y = position(generator);
+            boxes_.push_back({{ x, y }, { x + size(generator), y + size(generator) / 3 }});
+        }
+        return boxes_;
+    }();
+    return result;
+}
+
+IndexedSubfeature feature(std::size_t i) {
+    return IndexedSubfeature(i, "", "", i);
+}
+
+} // namespace
+
+// Inserts the boxes that don't collide with any earlier box, like placement does.
+static void GridIndex_Place(benchmark::State& state) {
+    const auto& input = boxes();
+
+    while (state.KeepRunning()) {
+        Grid grid(1224, 1224, 25);
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            if (!grid.hitTest(input[i], [](const IndexedSubfeature& f) { return f.collisionGroupId == 0; })) {
+                grid.insert(feature(i), input[i]);
+            }
+        }
+        benchmark::DoNotOptimize(grid);
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+static void GridIndex_InsertAndHitTest(benchmark::State& state) {
+    const bool bulk = state.range(0);
+    const auto& input = boxes();
+
+    while (state.KeepRunning()) {
+        Grid grid(1224, 1224, 25);
+        if (bulk) {
+            std::vector<std::pair<IndexedSubfeature, Grid::BBox>> elements;
+            elements.reserve(input.size());
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                elements.emplace_back(feature(i), input[i]);
+            }
+            grid.insert(std::move(elements));
+        } else {
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                grid.insert(feature(i), input[i]);
+            }
+        }
+
+        std::size_t hits = 0;
+        for (const auto& box : input) {
+            hits += grid.hitTest(box);
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+static void GridIndex_Query(benchmark::State& state) {
+    const auto& input = boxes();
+    Grid grid(1224, 1224, 25);
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        grid.insert(feature(i), input[i]);
+    }
+
+    std::size_t i = 0;
+    while (state.KeepRunning()) {
+        const auto& box = input[i++ % input.size()];
+        auto result = grid.queryWithBoxes({{ box.min.x - 50, box.min.y - 50 }, { box.max.x + 50, box.max.y + 50 }});
+        benchmark::DoNotOptimize(result.data());
+    }
+}
+
+BENCHMARK(GridIndex_Place);
+BENCHMARK(GridIndex_InsertAndHitTest)->Arg(false)->Arg(true);
+BENCHMARK(GridIndex_Query);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/thread_pool.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Stands in for a GeometryTileWorker: decodes every feature of a tile per message.
+class ParseWorker {
+public:
+    ParseWorker(ActorRef<ParseWorker>, std::shared_ptr<const std::string> data_)
+        : data(std::move(data_)) {}
+
+    void parse(std::atomic<std::size_t>& remaining, std::promise<void>& done) {
+        std::size_t length = 0;
+        VectorTileData tile(data);
+        for (const auto& name : tile.layerNames()) {
+            if (auto layer = tile.getLayer(name)) {
+                const std::size_t count = layer->featureCount();
+                for (std::size_t i = 0; i < count; i++) {
+                    if (auto feature = layer->getFeature(i)) {
+                        length += feature->getGeometries().size();
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize(length);
+
+        if (--remaining == 0) {
+            done.set_value();
+        }
+    }
+
+private:
+    std::shared_ptr<const std::string> data;
+};
+
+template <class Pool>
+void parseTiles(benchmark::State& state) {
+    const auto threads = static_cast<std::size_t>(state.range(0));
+    const std::size_t actorCount = threads * 4;
+    const std::size_t tilesPerActor = 4;
+
+    auto data = std::make_shared<const std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    Pool pool(threads);
+    std::vector<std::unique_ptr<Actor<ParseWorker>>> actors;
+    for (std::size_t i = 0; i < actorCount; ++i) {
+        actors.push_back(std::make_unique<Actor<ParseWorker>>(pool, data));
+    }
+
+    while (state.KeepRunning()) {
+        std::atomic<std::size_t> remaining { actorCount * tilesPerActor };
+        std::promise<void> done;
+        auto future = done.get_future();
+
+        for (auto& actor : actors) {
+            for (std::size_t i = 0; i < tilesPerActor; ++i) {
+                actor->self().invoke(&ParseWorker::parse, std::ref(remaining), std::ref(done));
+            }
+        }
+
+        future.get();
+    }
+
+    state.SetItemsProcessed(state.iterations() * actorCount * tilesPerActor);
+}
+
+} // namespace
+
+static void ThreadPool_ParseTiles(benchmark::State& state) {
+    parseTiles<ThreadPool>(state);
+}
+
+static void WorkStealingThreadPool_ParseTiles(benchmark::State& state) {
+    parseTiles<WorkStealingThreadPool>(state);
+}
+
+BENCHMARK(ThreadPool_ParseTiles)->Arg(4)->Arg(16)->Arg(64)->UseRealTime();
+BENCHMARK(WorkStealingThreadPool_ParseTiles)->Arg(4)->Arg(16)->Arg(64)->UseRealTime();
@@ -6,6 +6,7 @@
 
 #include <mbgl/gfx/backend.hpp>
 #include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/recording/headless_backend.hpp>
 #include <mbgl/style/style.hpp>
 
 #include <args.hxx>
@@ -18,7 +19,7 @@ int main(int argc, char *argv[]) {
     args::ArgumentParser argumentParser("Mapbox GL render tool");
     args::HelpFlag helpFlag(argumentParser, "help", "Display this help menu", {"help"});
 
-    args::ValueFlag<std::string> backendValue(argumentParser, "Backend", "Rendering backend", {"backend"});
+    args::ValueFlag<std::string> backendValue(argumentParser, "Backend", "Rendering backend, \"recording\" to count draw calls without a GPU", {"backend"});
     args::ValueFlag<std::string> tokenValue(argumentParser, "key", "Mapbox access token", {'t', "token"});
     args::ValueFlag<std::string> styleValue(argumentParser, "URL", "Map stylesheet", {'s', "style"});
     args::ValueFlag<std::string> outputValue(argumentParser, "file", "Output file name", {'o', "output"});
@@ -73,11 +74,27 @@ int main(int argc, char *argv[]) {
 
     const bool debug = debugFlag ? args::get(debugFlag) : false;
 
+    const std::string backend = backendValue ? args::get(backendValue) : "";
+    if (!backend.empty() && backend != "recording") {
+        std::cerr << "Unknown backend: " << backend << std::endl;
+        exit(1);
+    }
+
     using namespace mbgl;
 
     util::RunLoop loop;
 
-    HeadlessFrontend frontend({ width, height }, pixelRatio);
+    std::unique_ptr<gfx::HeadlessBackend> headlessBackend;
+    recording::HeadlessBackend* recordingBackend = nullptr;
+    if (backend == "recording") {
+        auto recorder = std::make_unique<recording::HeadlessBackend>();
+        recordingBackend = recorder.get();
+        headlessBackend = std::move(recorder);
+    } else {
+        headlessBackend = gfx::HeadlessBackend::Create();
+    }
+
+    HeadlessFrontend frontend({ width, height }, pixelRatio, std::move(headlessBackend));
     Map map(frontend, MapObserver::nullObserver(),
             MapOptions().withMapMode(MapMode::Static).withSize(frontend.getSize()).withPixelRatio(pixelRatio),
             ResourceOptions().withCachePath(cache_file).withAssetPath(asset_root).withAccessToken(std::string(token)));
@@ -101,6 +118,19 @@ int main(int argc, char *argv[]) {
         std::ofstream out(output, std::ios::binary);
         out << encodePNG(frontend.render(map));
         out.close();
+
+        if (recordingBackend) {
+            const recording::Statistics& statistics = recordingBackend->getStatistics();
+            std::cout << "Render passes: " << statistics.renderPasses << std::endl
+                      << "Upload passes: " << statistics.uploadPasses << std::endl
+                      << "Draw calls: " << statistics.drawCalls << std::endl
+                      << "Indices: " << statistics.indices << std::endl
+                      << "State changes: " << statistics.stateChanges << std::endl
+                      << "Buffer uploads: " << statistics.bufferUploads << " ("
+                      << statistics.bufferUploadBytes << " bytes)" << std::endl
+                      << "Texture uploads: " << statistics.textureUploads << " ("
+                      << statistics.textureUploadBytes << " bytes)" << std::endl;
+        }
     } catch(std::exception& e) {
         std::cout << "Error: " << e.what() << std::endl;
         exit(1);
@@ -2,6 +2,18 @@
 load_sources_list(MBGL_CORE_FILES src/core-files.json)
 add_library(mbgl-core STATIC ${MBGL_CORE_FILES})
 
+# util::transformPoints() rounds like matrix::transformMat4() with every instruction set only if
+# neither of them is compiled to fused multiply-adds, which compilers otherwise emit for targets
+# that have them, like ARM64.
+if(CMAKE_CXX_COMPILER_ID MATCHES ".*Clang" OR CMAKE_COMPILER_IS_GNUCXX)
+    set_source_files_properties(
+        src/mbgl/util/mat4.cpp
+        src/mbgl/util/transform_points.cpp
+        PROPERTIES
+        COMPILE_FLAGS -ffp-contract=off
+    )
+endif()
+
 target_include_directories(mbgl-core
     PUBLIC include
     PRIVATE src
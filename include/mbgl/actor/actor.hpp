@@ -65,6 +65,11 @@ public:
         return parent.self();
     }
 
+    // Sets the priority of this actor's mailbox; see `Mailbox::Priority`.
+    void setPriority(Mailbox::Priority priority) {
+        parent.mailbox->setPriority(priority);
+    }
+
 private:
     std::shared_ptr<Scheduler> retainer;
     AspiringActor<Object> parent;
@@ -2,6 +2,8 @@
 
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -13,7 +15,10 @@ class Message;
 
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
 public:
-   
+    // Schedulers that support it process pending mailboxes with a higher priority
+    // first. Mailboxes start out with a priority of zero.
+    using Priority = std::int32_t;
+
     // Create a "holding" mailbox, messages to which will remain queued,
     // unconsumed, until the mailbox is associated with a Scheduler using
     // start(). This allows a Mailbox object to be created on one thread and
@@ -30,6 +35,9 @@ public:
 
     bool isOpen() const;
 
+    Priority getPriority() const;
+    void setPriority(Priority);
+
     void push(std::unique_ptr<Message>);
     void receive();
 
@@ -43,6 +51,8 @@ private:
 
     bool closed { false };
 
+    std::atomic<Priority> priority { 0 };
+
     std::mutex queueMutex;
     std::queue<std::unique_ptr<Message>> queue;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 
 namespace mbgl {
@@ -19,7 +20,14 @@ class Mailbox;
         concurrency within a mailbox
 
       Subject to these constraints, processing can happen on whatever thread in the
-      pool is available.
+      pool is available. Pending mailboxes with a higher `Mailbox::Priority` are
+      processed first; mailboxes of equal priority are processed in FIFO order.
+
+    * `WorkStealingThreadPool` preserves the same behaviors as `ThreadPool`, but
+      gives each worker thread its own queue and lets idle workers steal from busy
+      ones, which avoids contending on a single queue when many actors are woken at
+      once on machines with many cores. It does not take mailbox priorities into
+      account.
 
     * `Scheduler::GetCurrent()` is typically used to create a mailbox and `ActorRef`
       for an object that lives on the main thread and is not itself wrapped an
@@ -38,6 +46,10 @@ public:
     // time.
     virtual void schedule(std::weak_ptr<Mailbox>) = 0;
 
+    // Used by a Mailbox when its priority changed. Schedulers that order pending
+    // mailboxes by priority should reorder them before picking the next one.
+    virtual void reprioritize() {}
+
     // Set/Get the current Scheduler for this thread
     static Scheduler* GetCurrent();
     static void SetCurrent(Scheduler*);
@@ -46,6 +58,14 @@ public:
     // will lazily initialize a shared worker pool when ran
     // from the first time.
     static std::shared_ptr<Scheduler> GetBackground();
+
+    // Set the function that GetBackground() uses to create the shared worker pool,
+    // e.g. to use a `WorkStealingThreadPool` instead of the default four thread
+    // `ThreadPool`. It takes effect the next time the pool is created, i.e. once
+    // all references to the current one are released. An empty function restores
+    // the default.
+    using BackgroundFactory = std::function<std::shared_ptr<Scheduler>()>;
+    static void SetBackgroundFactory(BackgroundFactory);
 };
 
 } // namespace mbgl
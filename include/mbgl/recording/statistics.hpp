@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mbgl {
+namespace recording {
+
+// Counts the commands that a recording backend received instead of issuing them to a GPU. The
+// counts only depend on what the renderer does, so they are the same for every run of a frame.
+class Statistics {
+public:
+    std::size_t commandEncoders = 0;
+    std::size_t uploadPasses = 0;
+    std::size_t renderPasses = 0;
+    std::size_t debugGroups = 0;
+
+    std::size_t drawCalls = 0;
+    std::size_t indices = 0;
+
+    // Changes of the program, or of the depth, stencil, color or cull face mode, between
+    // consecutive draw calls. Each of them is a state change the GL backend would make.
+    std::size_t stateChanges = 0;
+
+    std::size_t bufferUploads = 0;
+    std::size_t bufferUploadBytes = 0;
+    std::size_t textureUploads = 0;
+    std::size_t textureUploadBytes = 0;
+
+    Statistics operator-(const Statistics& other) const {
+        return {
+            commandEncoders - other.commandEncoders,
+            uploadPasses - other.uploadPasses,
+            renderPasses - other.renderPasses,
+            debugGroups - other.debugGroups,
+            drawCalls - other.drawCalls,
+            indices - other.indices,
+            stateChanges - other.stateChanges,
+            bufferUploads - other.bufferUploads,
+            bufferUploadBytes - other.bufferUploadBytes,
+            textureUploads - other.textureUploads,
+            textureUploadBytes - other.textureUploadBytes,
+        };
+    }
+};
+
+} // namespace recording
+} // namespace mbgl
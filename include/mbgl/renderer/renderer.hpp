@@ -1,6 +1,8 @@
 #pragma once
 
 #include <mbgl/renderer/query.hpp>
+#include <mbgl/renderer/tile_cache_statistics.hpp>
+#include <mbgl/style/zoom_evaluation_cache.hpp>
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/geojson.hpp>
@@ -56,6 +58,18 @@ public:
     // Memory
     void reduceMemoryUse();
 
+    // Sets the approximate number of bytes that each source may use to keep tiles that left
+    // the viewport, in addition to limiting the number of those tiles.
+    void setTileCacheByteBudget(std::size_t bytes);
+    std::size_t getTileCacheByteBudget() const;
+
+    // Returns the counters of all sources' tile caches combined.
+    TileCacheStatistics getTileCacheStatistics() const;
+
+    // Returns how many evaluations of zoom dependent expressions the last rendered frame looked
+    // up in the expressions' caches, and how many of them were saved.
+    style::ZoomEvaluationStatistics getZoomEvaluationStatistics() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl;
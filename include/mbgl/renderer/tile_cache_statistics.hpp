@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mbgl {
+
+// Counters of the caches that keep tiles around after they left the viewport, e.g. to size the
+// tile cache budget for a deployment. Hits and misses count lookups for tiles that are needed
+// again; evictions count tiles that were dropped to stay within the budget.
+class TileCacheStatistics {
+public:
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+
+    // The number of tiles and the approximate number of bytes currently held by the caches.
+    std::size_t tiles = 0;
+    std::size_t bytes = 0;
+
+    TileCacheStatistics& operator+=(const TileCacheStatistics& other) {
+        hits += other.hits;
+        misses += other.misses;
+        evictions += other.evictions;
+        tiles += other.tiles;
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
+} // namespace mbgl
@@ -29,13 +29,19 @@ public:
      * There is no size limit for offline resources. If a user never creates any offline
      * regions, we want the database to remain fairly small (order tens or low hundreds
      * of megabytes).
+     *
+     * With cacheWriteAheadLogging, the database uses a write-ahead log, and writes into the
+     * ambient cache are committed in batches by a separate thread, so that they don't block
+     * reads. See ResourceOptions::withCacheWriteAheadLogging().
      */
     DefaultFileSource(const std::string& cachePath,
                       const std::string& assetPath,
-                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                      bool cacheWriteAheadLogging = false);
     DefaultFileSource(const std::string& cachePath,
                       std::unique_ptr<FileSource>&& assetFileSource,
-                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                      bool cacheWriteAheadLogging = false);
     ~DefaultFileSource() override;
 
     bool supportsCacheOnlyRequests() const override {
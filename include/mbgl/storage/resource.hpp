@@ -89,6 +89,11 @@ public:
     Priority priority{ Priority::Regular };
     std::string url;
 
+    // Set when the requestor inflates compressed data itself; see util::isCompressed(). File
+    // sources may then pass on data the way they stored it, instead of inflating it on their
+    // own thread.
+    bool acceptsCompressedData = false;
+
     // Includes auxiliary data if this is a tile request.
     optional<TileData> tileData;
 
@@ -96,6 +96,23 @@ public:
      */
     uint64_t maximumCacheSize() const;
 
+    /**
+     * @brief Sets whether the cache database uses a write-ahead log. Writes into the
+     * ambient cache are then committed in batches on a separate thread and connection,
+     * so that they don't block cache reads. Has no effect on in-memory caches.
+     *
+     * @param enabled Whether to use a write-ahead log. Disabled by default.
+     * @return reference to ResourceOptions for chaining options together.
+     */
+    ResourceOptions& withCacheWriteAheadLogging(bool enabled);
+
+    /**
+     * @brief Gets whether the cache database uses a write-ahead log.
+     *
+     * @return true if the cache database uses a write-ahead log.
+     */
+    bool cacheWriteAheadLogging() const;
+
     /**
      * @brief Sets the platform context. A platform context is usually an object
      * that assists the creation of a file source.
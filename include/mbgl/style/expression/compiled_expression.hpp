@@ -0,0 +1,76 @@
+#pragma once
+
+#include <mbgl/style/expression/expression.hpp>
+#include <mbgl/util/color.hpp>
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+/*
+    CompiledExpression is an alternative way of evaluating an expression that produces a
+    number, a boolean, or a color, for evaluating it for many features.
+
+    Compiling lowers the expression tree to a flat program of instructions that operate on
+    typed registers: numbers and booleans share a file of doubles, colors have a file of
+    their own. Subexpressions that don't depend on the feature, the zoom level, or the color
+    ramp parameter are folded into constants when compiling. Expressions that have no
+    instructions of their own, like coercions, `let`, or string operations, are evaluated
+    as trees by an instruction that evaluates the original subexpression.
+
+    Evaluation doesn't allocate, other than for reading the properties of features that
+    don't hold decoded values (see GeometryTileFeature::findValue()) and for subexpressions
+    that are evaluated as trees, and yields the same results as Expression::evaluate().
+    Errors aren't reported other than by failing evaluation.
+
+    Programs without jumps, which includes step and match expressions with constant outputs,
+    are evaluated for many features at once one instruction at a time, so that the loop over
+    the features of each instruction is tight.
+
+    A compiled expression refers to the subexpressions of the expression it was compiled
+    from, which must outlive it.
+*/
+class CompiledExpression {
+public:
+    // Returns null if the expression doesn't produce a number, a boolean, or a color, or
+    // needs more registers than evaluation provides.
+    static std::unique_ptr<CompiledExpression> compile(const Expression&);
+
+    ~CompiledExpression();
+
+    // Each returns false if evaluating the expression as a tree would have resulted in an
+    // error, and leaves the result untouched in that case. The result type must match the
+    // type of the compiled expression.
+    bool evaluate(const EvaluationContext&, float& result) const;
+    bool evaluate(const EvaluationContext&, bool& result) const;
+    bool evaluate(const EvaluationContext&, Color& result) const;
+
+    // Evaluate the expression for each of the features, with the zoom level and the color ramp
+    // parameter of the context. Results for which evaluation fails are set to the fallback.
+    void evaluate(const EvaluationContext&, const std::vector<const GeometryTileFeature*>&,
+                  std::vector<float>& results, float fallback) const;
+    void evaluate(const EvaluationContext&, const std::vector<const GeometryTileFeature*>&,
+                  std::vector<bool>& results, bool fallback) const;
+    void evaluate(const EvaluationContext&, const std::vector<const GeometryTileFeature*>&,
+                  std::vector<Color>& results, const Color& fallback) const;
+
+    class Program;
+
+private:
+    explicit CompiledExpression(std::unique_ptr<const Program>);
+
+    const std::unique_ptr<const Program> program;
+};
+
+// Whether PropertyExpression<T> evaluates compiled expressions.
+template <class T>
+struct IsCompilable : std::integral_constant<bool,
+    std::is_same<T, float>::value || std::is_same<T, bool>::value || std::is_same<T, Color>::value> {};
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
@@ -27,6 +27,10 @@ public:
 
     EvaluationResult evaluate(const EvaluationContext& params) const override;
 
+    const std::unique_ptr<Expression>& getInput() const { return input; }
+    const Branches& getBranches() const { return branches; }
+    const Expression& getOtherwise() const { return *otherwise; }
+
     void eachChild(const std::function<void(const Expression&)>& visit) const override;
 
     bool operator==(const Expression& e) const override;
@@ -1,12 +1,17 @@
 #pragma once
 
 #include <mbgl/style/expression/expression.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
 #include <mbgl/style/expression/is_constant.hpp>
 #include <mbgl/style/expression/interpolate.hpp>
 #include <mbgl/style/expression/step.hpp>
 #include <mbgl/style/expression/find_zoom_curve.hpp>
+#include <mbgl/style/zoom_evaluation_cache.hpp>
 #include <mbgl/util/range.hpp>
 
+#include <memory>
+#include <tuple>
+
 namespace mbgl {
 namespace style {
 
@@ -18,6 +23,8 @@ public:
     bool isFeatureConstant() const noexcept;
     bool canEvaluateWith(const expression::EvaluationContext&) const noexcept;
     float interpolationFactor(const Range<float>&, const float) const noexcept;
+    // Like interpolationFactor(), memoized in a cache that all copies of this expression share.
+    float memoizedInterpolationFactor(const Range<float>&, const float) const;
     Range<float> getCoveringStops(const float, const float) const noexcept;
     const expression::Expression& getExpression() const noexcept;
 
@@ -26,6 +33,13 @@ public:
 protected:
     std::shared_ptr<const expression::Expression> expression;
     variant<std::nullptr_t, const expression::Interpolate*, const expression::Step*> zoomCurve;
+    // Evaluates data-driven expressions without walking the tree. Null for feature constant
+    // expressions and for those that can't be compiled.
+    std::shared_ptr<const expression::CompiledExpression> compiled;
+    // Copies of an expression, like the ones of the paint property binders of all tiles of a
+    // layer, share the caches of zoom dependent results. Null if the result doesn't depend on
+    // the zoom level. Style changes create new expressions, which start with empty caches.
+    std::shared_ptr<ZoomEvaluationCache<std::tuple<float, float, float>, float>> interpolationFactors;
     bool isZoomConstant_;
     bool isFeatureConstant_;
 };
@@ -37,22 +51,29 @@ public:
     PropertyExpression(std::unique_ptr<expression::Expression> expression_, optional<T> defaultValue_ = nullopt)
         : PropertyExpressionBase(std::move(expression_)),
           defaultValue(std::move(defaultValue_)) {
+        if (!isZoomConstant_ && isFeatureConstant_) {
+            zoomValues = std::make_shared<ZoomEvaluationCache<float, T>>();
+        }
     }
 
     T evaluate(const expression::EvaluationContext& context, T finalDefaultValue = T()) const {
         assert(canEvaluateWith(context));
-        const expression::EvaluationResult result = expression->evaluate(context);
-        if (result) {
-            const optional<T> typed = expression::fromExpressionValue<T>(*result);
-            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
-        }
-        return defaultValue ? *defaultValue : finalDefaultValue;
+        return evaluate(context, std::move(finalDefaultValue), expression::IsCompilable<T>());
     }
 
     T evaluate(float zoom) const {
         return evaluate(expression::EvaluationContext(zoom));
     }
 
+    // Evaluates a feature constant expression, memoized in a cache that all copies of this
+    // expression share.
+    T evaluateMemoized(float zoom) const {
+        if (!zoomValues) {
+            return evaluate(zoom);
+        }
+        return zoomValues->get(zoom, [&] { return evaluate(zoom); });
+    }
+
     T evaluate(const GeometryTileFeature& feature, T finalDefaultValue) const {
         return evaluate(expression::EvaluationContext(&feature), finalDefaultValue);
     }
@@ -61,6 +82,17 @@ public:
         return evaluate(expression::EvaluationContext(zoom, &feature), finalDefaultValue);
     }
 
+    // Evaluates the expression for each of the features, in the context of the zoom level
+    // and the color ramp parameter of `context`. Compiled expressions evaluate all of the
+    // features in tight loops.
+    void evaluate(const expression::EvaluationContext& context,
+                  const std::vector<const GeometryTileFeature*>& features,
+                  std::vector<T>& results,
+                  T finalDefaultValue = T()) const {
+        assert(!isFeatureConstant());
+        evaluate(context, features, results, std::move(finalDefaultValue), expression::IsCompilable<T>());
+    }
+
     std::vector<optional<T>> possibleOutputs() const {
         return expression::fromExpressionValues<T>(expression->possibleOutputs());
     }
@@ -71,7 +103,53 @@ public:
     }
 
 private:
+    T evaluate(const expression::EvaluationContext& context, T finalDefaultValue, std::true_type) const {
+        if (!compiled) {
+            return evaluate(context, std::move(finalDefaultValue), std::false_type());
+        }
+        T result;
+        if (compiled->evaluate(context, result)) {
+            return result;
+        }
+        return defaultValue ? *defaultValue : finalDefaultValue;
+    }
+
+    T evaluate(const expression::EvaluationContext& context, T finalDefaultValue, std::false_type) const {
+        const expression::EvaluationResult result = expression->evaluate(context);
+        if (result) {
+            const optional<T> typed = expression::fromExpressionValue<T>(*result);
+            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
+        }
+        return defaultValue ? *defaultValue : finalDefaultValue;
+    }
+
+    void evaluate(const expression::EvaluationContext& context,
+                  const std::vector<const GeometryTileFeature*>& features,
+                  std::vector<T>& results,
+                  T finalDefaultValue,
+                  std::true_type) const {
+        if (!compiled) {
+            return evaluate(context, features, results, std::move(finalDefaultValue), std::false_type());
+        }
+        compiled->evaluate(context, features, results, defaultValue ? *defaultValue : finalDefaultValue);
+    }
+
+    void evaluate(const expression::EvaluationContext& context,
+                  const std::vector<const GeometryTileFeature*>& features,
+                  std::vector<T>& results,
+                  T finalDefaultValue,
+                  std::false_type) const {
+        results.clear();
+        results.reserve(features.size());
+        expression::EvaluationContext featureContext = context;
+        for (const GeometryTileFeature* feature : features) {
+            featureContext.feature = feature;
+            results.push_back(evaluate(featureContext, finalDefaultValue, std::false_type()));
+        }
+    }
+
     optional<T> defaultValue;
+    std::shared_ptr<ZoomEvaluationCache<float, T>> zoomValues;
 };
 
 } // namespace style
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <mbgl/util/optional.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+namespace mbgl {
+namespace style {
+
+// Counts lookups in the zoom evaluation caches of the calling thread. Hits are evaluations
+// that were saved; the renderer reports the counts of each frame it renders.
+class ZoomEvaluationStatistics {
+public:
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+
+    // The counters of the calling thread since it started.
+    static ZoomEvaluationStatistics& current();
+
+    ZoomEvaluationStatistics operator-(const ZoomEvaluationStatistics& other) const {
+        return { hits - other.hits, misses - other.misses };
+    }
+};
+
+// Memoizes a function of the zoom level for the few zoom levels that are in use at a time, e.g.
+// the current zoom level and its neighbors during a crossfade. Results are keyed on the exact
+// zoom level, so they're the same as the ones of the function itself.
+//
+// Layout properties are evaluated on the workers while the renderer evaluates paint
+// properties, but each expression is evaluated on one thread for the most part. The first
+// thread that uses the cache owns it and looks results up without locking; other threads
+// evaluate the function without the cache.
+template <class Key, class T>
+class ZoomEvaluationCache {
+public:
+    template <class Evaluate>
+    T get(const Key& key, Evaluate&& evaluate) {
+        if (!isOwnedByCurrentThread()) {
+            return evaluate();
+        }
+
+        ZoomEvaluationStatistics& statistics = ZoomEvaluationStatistics::current();
+        for (const auto& entry : entries) {
+            if (entry && entry->first == key) {
+                ++statistics.hits;
+                return entry->second;
+            }
+        }
+
+        ++statistics.misses;
+        T result = evaluate();
+        entries[next] = std::make_pair(key, result);
+        next = (next + 1) % entries.size();
+        return result;
+    }
+
+private:
+    bool isOwnedByCurrentThread() {
+        const std::thread::id current = std::this_thread::get_id();
+        // Only the owner reads and writes the entries, so the owner needs no stronger ordering.
+        std::thread::id expected = owner.load(std::memory_order_relaxed);
+        if (expected == current) {
+            return true;
+        }
+        return expected == std::thread::id() &&
+               owner.compare_exchange_strong(expected, current, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::thread::id> owner { std::thread::id() };
+    std::array<optional<std::pair<Key, T>>, 4> entries;
+    std::size_t next = 0;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -6,7 +6,12 @@ namespace mbgl {
 namespace util {
 
 std::string compress(const std::string& raw);
+
+// Inflates zlib and gzip streams.
 std::string decompress(const std::string& raw);
 
+// Returns true if the data starts with a zlib or gzip header. Tile formats never do.
+bool isCompressed(const std::string& data);
+
 } // namespace util
 } // namespace mbgl
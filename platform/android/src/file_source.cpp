@@ -15,7 +15,8 @@ namespace mbgl {
 
 std::shared_ptr<FileSource> FileSource::createPlatformFileSource(const ResourceOptions& options) {
     auto* assetFileSource = reinterpret_cast<AssetManagerFileSource*>(options.platformContext());
-    auto fileSource = std::make_shared<DefaultFileSource>(options.cachePath(), std::unique_ptr<AssetManagerFileSource>(assetFileSource));
+    auto fileSource = std::make_shared<DefaultFileSource>(options.cachePath(), std::unique_ptr<AssetManagerFileSource>(assetFileSource),
+                                                          options.maximumCacheSize(), options.cacheWriteAheadLogging());
     fileSource->setAccessToken(options.accessToken());
     return fileSource;
 }
@@ -25,6 +25,13 @@ public:
                      const optional<std::string> programCacheDir = {},
                      gfx::ContextMode mode = gfx::ContextMode::Unique,
                      const optional<std::string> localFontFamily = {});
+    // Renders with the given backend, e.g. a recording::HeadlessBackend. The frontend resizes it
+    // to its size times the pixel ratio.
+    HeadlessFrontend(Size,
+                     float pixelRatio_,
+                     std::unique_ptr<gfx::HeadlessBackend>,
+                     const optional<std::string> programCacheDir = {},
+                     const optional<std::string> localFontFamily = {});
     ~HeadlessFrontend() override;
 
     void reset() override;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <mbgl/gfx/headless_backend.hpp>
+#include <mbgl/gfx/renderer_backend.hpp>
+#include <mbgl/recording/statistics.hpp>
+
+#include <memory>
+
+namespace mbgl {
+namespace recording {
+
+// A headless backend that records what the renderer draws instead of drawing it, for measuring
+// the CPU side cost of rendering without a GPU. Still images it reads are transparent.
+class HeadlessBackend final : public gfx::RendererBackend, public gfx::HeadlessBackend {
+public:
+    HeadlessBackend(Size = { 256, 256 }, gfx::ContextMode = gfx::ContextMode::Unique);
+    ~HeadlessBackend() override;
+    gfx::Renderable& getDefaultRenderable() override;
+    PremultipliedImage readStillImage() override;
+    gfx::RendererBackend* getRendererBackend() override;
+
+    // The commands recorded since the backend was created.
+    const Statistics& getStatistics() const {
+        return statistics;
+    }
+
+private:
+    std::unique_ptr<gfx::Context> createContext() override;
+
+    void activate() override;
+    void deactivate() override;
+
+private:
+    Statistics statistics;
+};
+
+} // namespace recording
+} // namespace mbgl
@@ -30,6 +30,7 @@ class TileID;
 
 namespace util {
 struct IOException;
+template <typename T> class Thread;
 } // namespace util
 
 struct MapboxTileLimitExceededException :  util::Exception {
@@ -38,9 +39,29 @@ struct MapboxTileLimitExceededException :  util::Exception {
 
 class OfflineDatabase : private util::noncopyable {
 public:
+    enum class JournalMode : uint8_t {
+        // Every put is committed in its own transaction, on the calling thread.
+        Delete,
+        // The database uses a write-ahead log. Puts into the ambient cache are queued and
+        // committed in batches by a writer thread with its own connection, and get() reads
+        // from a separate read-only connection, so that cache writes don't block cache reads.
+        // In-memory databases always use the rollback journal.
+        WAL,
+    };
+
+    // See https://www.sqlite.org/pragma.html#pragma_synchronous
+    enum class Synchronous : uint8_t {
+        Off,
+        Normal,
+        Full,
+    };
+
     // Limits affect ambient caching (put) only; resources required by offline
     // regions are exempt.
-    OfflineDatabase(std::string path, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+    OfflineDatabase(std::string path,
+                    uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                    JournalMode = JournalMode::Delete,
+                    Synchronous = Synchronous::Full);
     ~OfflineDatabase();
 
     void changePath(const std::string&);
@@ -48,9 +69,13 @@ public:
 
     optional<Response> get(const Resource&);
 
-    // Return value is (inserted, stored size)
+    // Return value is (inserted, stored size). In write-ahead logging mode, the put is
+    // queued and the return value is (true, 0), unless the response is an error.
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
+    // Blocks until all queued puts are committed. Queued puts aren't visible to get() before.
+    void flush();
+
     // Force Mapbox GL Native to revalidate tiles stored in the ambient
     // cache with the tile server before using them, making sure they
     // are the latest version. This is more efficient than cleaning the
@@ -98,11 +123,13 @@ private:
     void migrateToVersion5();
     void migrateToVersion3();
     void migrateToVersion6();
+    void migrateToVersion7();
     void cleanup();
 
     mapbox::sqlite::Statement& getStatement(const char *);
+    mapbox::sqlite::Statement& getReadStatement(const char *);
 
-    optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
+    optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&, bool acceptsCompressedData);
     optional<int64_t> hasTile(const Resource::TileData&);
     bool putTile(const Resource::TileData&, const Response&,
                  const std::string&, bool compressed);
@@ -114,6 +141,8 @@ private:
 
     uint64_t putRegionResourceInternal(int64_t regionID, const Resource&, const Response&);
 
+    void updateAccessed(const Resource&);
+
     optional<std::pair<Response, uint64_t>> getInternal(const Resource&);
     optional<int64_t> hasInternal(const Resource&);
     std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict);
@@ -128,6 +157,28 @@ private:
     std::unique_ptr<mapbox::sqlite::Database> db;
     std::unordered_map<const char *, const std::unique_ptr<mapbox::sqlite::Statement>> statements;
 
+    const JournalMode journalMode;
+    const Synchronous synchronous;
+
+    // Only used in write-ahead logging mode.
+    class Writer;
+    struct WriteQueue;
+    void enqueue(const Resource&, optional<Response>);
+    void handleWriteError();
+    std::shared_ptr<WriteQueue> writeQueue;
+    std::unique_ptr<util::Thread<Writer>> writer;
+    std::unique_ptr<mapbox::sqlite::Database> readDB;
+    std::unordered_map<const char *, const std::unique_ptr<mapbox::sqlite::Statement>> readStatements;
+
+    // Opens the connection of a writer. It reports errors that require removing the database
+    // through the queue of the owning connection instead of removing the database itself.
+    OfflineDatabase(std::string path,
+                    uint64_t maximumCacheSize,
+                    JournalMode,
+                    Synchronous,
+                    std::shared_ptr<WriteQueue> ownerQueue);
+    const std::shared_ptr<WriteQueue> ownerQueue;
+
     template <class T>
     T getPragma(const char *);
 
@@ -136,7 +187,17 @@ private:
     uint64_t offlineMapboxTileCountLimit = util::mapbox::DEFAULT_OFFLINE_TILE_COUNT_LIMIT;
     optional<uint64_t> offlineMapboxTileCount;
 
+    // The total length of all resource and tile data.
+    uint64_t getStoredSize();
+    // The size of the database pages in use that isn't resource and tile data.
+    uint64_t getStorageOverhead();
+
     bool evict(uint64_t neededFreeSize);
+    bool evictChunk(uint64_t bytes);
+
+    // Shrinks the ambient cache below its low-water mark by one chunk, and returns the freed
+    // pages to the file system. Runs after puts, outside of their transactions.
+    void evictIncrementally();
 };
 
 } // namespace mbgl
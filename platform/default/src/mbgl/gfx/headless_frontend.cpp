@@ -22,10 +22,22 @@ HeadlessFrontend::HeadlessFrontend(Size size_,
                                    const optional<std::string> programCacheDir,
                                    const gfx::ContextMode contextMode,
                                    const optional<std::string> localFontFamily)
+    : HeadlessFrontend(size_,
+                       pixelRatio_,
+                       gfx::HeadlessBackend::Create({ static_cast<uint32_t>(size_.width * pixelRatio_),
+                                                     static_cast<uint32_t>(size_.height * pixelRatio_) }, contextMode),
+                       programCacheDir,
+                       localFontFamily) {
+}
+
+HeadlessFrontend::HeadlessFrontend(Size size_,
+                                   float pixelRatio_,
+                                   std::unique_ptr<gfx::HeadlessBackend> backend_,
+                                   const optional<std::string> programCacheDir,
+                                   const optional<std::string> localFontFamily)
     : size(size_),
       pixelRatio(pixelRatio_),
-      backend(gfx::HeadlessBackend::Create({ static_cast<uint32_t>(size.width * pixelRatio),
-                                             static_cast<uint32_t>(size.height * pixelRatio) }, contextMode)),
+      backend(std::move(backend_)),
     asyncInvalidate([this] {
         if (renderer && updateParameters) {
             gfx::BackendScope guard { *getBackend() };
@@ -39,6 +51,11 @@ HeadlessFrontend::HeadlessFrontend(Size size_,
         }
     }),
     renderer(std::make_unique<Renderer>(*getBackend(), pixelRatio, programCacheDir, localFontFamily)) {
+    const Size backendSize { static_cast<uint32_t>(size.width * pixelRatio),
+                             static_cast<uint32_t>(size.height * pixelRatio) };
+    if (backend->getSize() != backendSize) {
+        backend->setSize(backendSize);
+    }
 }
 
 HeadlessFrontend::~HeadlessFrontend() = default;
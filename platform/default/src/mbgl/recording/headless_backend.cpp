@@ -0,0 +1,41 @@
+#include <mbgl/recording/headless_backend.hpp>
+#include <mbgl/recording/context.hpp>
+
+namespace mbgl {
+namespace recording {
+
+HeadlessBackend::HeadlessBackend(const Size size_, const gfx::ContextMode contextMode_)
+    : gfx::RendererBackend(contextMode_), gfx::HeadlessBackend(size_) {
+}
+
+HeadlessBackend::~HeadlessBackend() {
+    // The context refers to the statistics, so destruct it first.
+    context.reset();
+}
+
+std::unique_ptr<gfx::Context> HeadlessBackend::createContext() {
+    return std::make_unique<recording::Context>(statistics);
+}
+
+void HeadlessBackend::activate() {
+    // no-op
+}
+
+void HeadlessBackend::deactivate() {
+    // no-op
+}
+
+gfx::Renderable& HeadlessBackend::getDefaultRenderable() {
+    return *this;
+}
+
+PremultipliedImage HeadlessBackend::readStillImage() {
+    return PremultipliedImage(size);
+}
+
+gfx::RendererBackend* HeadlessBackend::getRendererBackend() {
+    return this;
+}
+
+} // namespace recording
+} // namespace mbgl
@@ -2,6 +2,7 @@
 #include <mbgl/storage/asset_file_source.hpp>
 #include <mbgl/storage/file_source_request.hpp>
 #include <mbgl/storage/local_file_source.hpp>
+#include <mbgl/storage/mbtiles_file_source.hpp>
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
@@ -20,10 +21,16 @@ namespace mbgl {
 
 class DefaultFileSource::Impl {
 public:
-    Impl(std::shared_ptr<FileSource> assetFileSource_, std::string cachePath, uint64_t maximumCacheSize)
+    Impl(std::shared_ptr<FileSource> assetFileSource_, std::string cachePath, uint64_t maximumCacheSize, bool writeAheadLogging)
             : assetFileSource(std::move(assetFileSource_))
             , localFileSource(std::make_unique<LocalFileSource>())
-            , offlineDatabase(std::make_unique<OfflineDatabase>(cachePath, maximumCacheSize)) {
+            , mbtilesFileSource(std::make_unique<MBTilesFileSource>())
+            , offlineDatabase(writeAheadLogging
+                  // A write-ahead log stays consistent without syncing on every commit.
+                  ? std::make_unique<OfflineDatabase>(cachePath, maximumCacheSize,
+                                                      OfflineDatabase::JournalMode::WAL,
+                                                      OfflineDatabase::Synchronous::Normal)
+                  : std::make_unique<OfflineDatabase>(cachePath, maximumCacheSize)) {
     }
 
     void setAPIBaseURL(const std::string& url) {
@@ -110,6 +117,9 @@ public:
         } else if (LocalFileSource::acceptsURL(resource.url)) {
             //Local file request
             tasks[req] = localFileSource->request(resource, callback);
+        } else if (MBTilesFileSource::acceptsURL(resource.url)) {
+            //Tile archive request
+            tasks[req] = mbtilesFileSource->request(resource, callback);
         } else {
             // Try the offline database
             if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
@@ -202,6 +212,7 @@ private:
     // shared so that destruction is done on the creating thread
     const std::shared_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
+    const std::unique_ptr<FileSource> mbtilesFileSource;
     std::unique_ptr<OfflineDatabase> offlineDatabase;
     OnlineFileSource onlineFileSource;
     std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
@@ -210,15 +221,17 @@ private:
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
                                      const std::string& assetPath,
-                                     uint64_t maximumCacheSize)
-    : DefaultFileSource(cachePath, std::make_unique<AssetFileSource>(assetPath), maximumCacheSize) {
+                                     uint64_t maximumCacheSize,
+                                     bool cacheWriteAheadLogging)
+    : DefaultFileSource(cachePath, std::make_unique<AssetFileSource>(assetPath), maximumCacheSize, cacheWriteAheadLogging) {
 }
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
                                      std::unique_ptr<FileSource>&& assetFileSource_,
-                                     uint64_t maximumCacheSize)
+                                     uint64_t maximumCacheSize,
+                                     bool cacheWriteAheadLogging)
         : assetFileSource(std::move(assetFileSource_))
-        , impl(std::make_unique<util::Thread<Impl>>("DefaultFileSource", assetFileSource, cachePath, maximumCacheSize)) {
+        , impl(std::make_unique<util::Thread<Impl>>("DefaultFileSource", assetFileSource, cachePath, maximumCacheSize, cacheWriteAheadLogging)) {
 }
 
 DefaultFileSource::~DefaultFileSource() = default;
@@ -6,7 +6,9 @@
 namespace mbgl {
 
 std::shared_ptr<FileSource> FileSource::createPlatformFileSource(const ResourceOptions& options) {
-    auto fileSource = std::make_shared<DefaultFileSource>(options.cachePath(), options.assetPath());
+    auto fileSource = std::make_shared<DefaultFileSource>(options.cachePath(), options.assetPath(),
+                                                          options.maximumCacheSize(),
+                                                          options.cacheWriteAheadLogging());
     fileSource->setAccessToken(options.accessToken());
     fileSource->setAPIBaseURL(options.baseURL());
     return fileSource;
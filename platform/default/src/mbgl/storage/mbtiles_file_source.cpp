@@ -0,0 +1,469 @@
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/storage/file_source_request.hpp>
+#include <mbgl/storage/payload.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/sqlite3.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const std::string mbtilesProtocol = "mbtiles://";
+
+} // namespace
+
+namespace mbgl {
+
+namespace {
+
+using TileJSONWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
+// A read-only view of a whole file. Platforms without mmap read the file into memory instead.
+class MappedFile : private util::noncopyable {
+public:
+    MappedFile(const std::string& path) {
+#ifdef _WIN32
+        auto file = util::readFile(path);
+        if (!file) {
+            errno = ENOENT;
+            throw util::IOException(ENOENT, "Cannot read file " + path);
+        }
+        contents = std::move(*file);
+        data = contents.data();
+        size = contents.size();
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            throw util::IOException(errno, "Cannot open file " + path);
+        }
+
+        struct stat buf;
+        if (fstat(fd, &buf) == -1) {
+            const int err = errno;
+            ::close(fd);
+            throw util::IOException(err, "Cannot open file " + path);
+        }
+        if (S_ISDIR(buf.st_mode)) {
+            ::close(fd);
+            errno = EISDIR;
+            throw util::IOException(EISDIR, "Cannot open file " + path);
+        }
+
+        size = static_cast<std::size_t>(buf.st_size);
+        if (size > 0) {
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            const int err = errno;
+            ::close(fd);
+            if (mapping == MAP_FAILED) {
+                throw util::IOException(err, "Cannot map file " + path);
+            }
+            // Tiles are requested in no particular order, so read-ahead mostly wastes memory.
+            madvise(mapping, size, MADV_RANDOM);
+            data = static_cast<const char*>(mapping);
+        } else {
+            ::close(fd);
+        }
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (size > 0) {
+            munmap(const_cast<char*>(data), size);
+        }
+#endif
+    }
+
+    const char* data = nullptr;
+    std::size_t size = 0;
+
+#ifdef _WIN32
+private:
+    std::string contents;
+#endif
+};
+
+std::string tileURL(const std::string& url) {
+    return url + "?z={z}&x={x}&y={y}";
+}
+
+class Archive {
+public:
+    virtual ~Archive() = default;
+
+    // Returns the tile data as stored, which is usually gzip compressed, or nullptr if the
+    // archive doesn't contain the tile. y counts from the north.
+    virtual std::shared_ptr<const std::string> getTile(uint8_t z, uint32_t x, uint32_t y) = 0;
+
+    virtual std::string getTileJSON(const std::string& url) = 0;
+};
+
+// MBTiles files are SQLite databases; see https://github.com/mapbox/mbtiles-spec. SQLite reads
+// the database pages through a memory mapping of the file, and tiles are looked up in the
+// unique index on (zoom_level, tile_column, tile_row) that the specification requires.
+class MBTilesArchive : public Archive {
+public:
+    MBTilesArchive(const std::string& path, std::size_t size)
+        : db(open(path, size)),
+          tileStatement(db, "SELECT tile_data FROM tiles "
+                            "WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3") {
+    }
+
+    std::shared_ptr<const std::string> getTile(uint8_t z, uint32_t x, uint32_t y) override {
+        mapbox::sqlite::Query query{ tileStatement };
+        query.bind(1, int64_t(z));
+        query.bind(2, int64_t(x));
+        // MBTiles rows count from the south.
+        query.bind(3, (int64_t(1) << z) - 1 - int64_t(y));
+        if (!query.run()) {
+            return nullptr;
+        }
+        auto data = std::make_shared<const std::string>(query.get<std::string>(0));
+        PayloadStatistics::addCopiedBytes(data->size());
+        return data;
+    }
+
+    std::string getTileJSON(const std::string& url) override {
+        std::unordered_map<std::string, std::string> metadata;
+        {
+            mapbox::sqlite::Statement stmt{ db, "SELECT name, value FROM metadata" };
+            mapbox::sqlite::Query query{ stmt };
+            while (query.run()) {
+                metadata.emplace(query.get<std::string>(0), query.get<std::string>(1));
+            }
+        }
+
+        rapidjson::StringBuffer buffer;
+        TileJSONWriter writer(buffer);
+        writer.StartObject();
+        writer.Key("tilejson");
+        writer.String("2.2.0");
+        writer.Key("tiles");
+        writer.StartArray();
+        writer.String(tileURL(url));
+        writer.EndArray();
+        writer.Key("scheme");
+        writer.String("xyz");
+
+        for (const char* key : { "name", "attribution", "format" }) {
+            auto it = metadata.find(key);
+            if (it != metadata.end()) {
+                writer.Key(key);
+                writer.String(it->second);
+            }
+        }
+
+        mapbox::sqlite::Statement zoomStatement{ db, "SELECT MIN(zoom_level), MAX(zoom_level) FROM tiles" };
+        mapbox::sqlite::Query zoomQuery{ zoomStatement };
+        zoomQuery.run();
+        for (const auto& zoom : { std::make_pair("minzoom", 0), std::make_pair("maxzoom", 1) }) {
+            auto it = metadata.find(zoom.first);
+            if (it != metadata.end()) {
+                writer.Key(zoom.first);
+                writer.Int(std::atoi(it->second.c_str()));
+            } else if (auto value = zoomQuery.get<optional<int64_t>>(zoom.second)) {
+                writer.Key(zoom.first);
+                writer.Int64(*value);
+            }
+        }
+
+        // "west,south,east,north"
+        auto bounds = metadata.find("bounds");
+        if (bounds != metadata.end()) {
+            std::istringstream stream(bounds->second);
+            std::string coordinate;
+            writer.Key("bounds");
+            writer.StartArray();
+            while (std::getline(stream, coordinate, ',')) {
+                writer.Double(std::atof(coordinate.c_str()));
+            }
+            writer.EndArray();
+        }
+
+        writer.EndObject();
+        return buffer.GetString();
+    }
+
+private:
+    static mapbox::sqlite::Database open(const std::string& path, std::size_t size) {
+        auto database = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly);
+        database.exec("PRAGMA mmap_size = " + util::toString(uint64_t(size)));
+        return database;
+    }
+
+    mapbox::sqlite::Database db;
+    mapbox::sqlite::Statement tileStatement;
+};
+
+// A clustered tile archive is a single file that stores tiles back to back, laid out like
+// PMTiles version 2. All numbers are unsigned little-endian integers:
+//
+//     offset    size    field
+//          0       2    magic number 0x4D50 ("PM")
+//          2       2    version, 2
+//          4       4    length of the metadata, M
+//          8       2    number of entries in the root directory, N
+//         10       M    metadata: a JSON object with TileJSON properties, except "tiles"
+//     10 + M  17 * N    root directory
+//
+// A directory entry is a 1-byte zoom level, a 3-byte column, a 3-byte row counting from the
+// north, a 6-byte offset and a 4-byte length. Entries whose zoom level has the high bit set
+// refer to a leaf directory at the given offset instead of a tile; leaf directories consist of
+// entries too, but can't refer to further leaf directories. Tiles that are stored only once
+// for several entries, e.g. empty ocean tiles, have the same offset.
+//
+// The whole file is mapped into memory. Opening it reads all directories into a hash map so
+// that tile lookups take constant time.
+class ClusteredArchive : public Archive {
+public:
+    static constexpr uint16_t Magic = 0x4D50;
+    static constexpr uint16_t Version = 2;
+    static constexpr std::size_t HeaderSize = 10;
+    static constexpr std::size_t EntrySize = 17;
+
+    ClusteredArchive(std::unique_ptr<MappedFile> file_) : file(std::move(file_)) {
+        if (file->size < HeaderSize || read(0, 2) != Magic) {
+            throw std::runtime_error("File is not a tile archive");
+        }
+        if (read(2, 2) != Version) {
+            throw std::runtime_error("Unsupported tile archive version");
+        }
+
+        const uint64_t metadataLength = read(4, 4);
+        const uint64_t rootEntries = read(8, 2);
+        if (!contains(HeaderSize, metadataLength)) {
+            throw std::runtime_error("Tile archive is truncated");
+        }
+        metadata.assign(file->data + HeaderSize, metadataLength);
+
+        readDirectory(HeaderSize + metadataLength, rootEntries * EntrySize, true);
+    }
+
+    std::shared_ptr<const std::string> getTile(uint8_t z, uint32_t x, uint32_t y) override {
+        auto it = directory.find(key(z, x, y));
+        if (it == directory.end() || !contains(it->second.offset, it->second.length)) {
+            return nullptr;
+        }
+
+        // Entries that refer to the same data share the tile, as long as it's in use.
+        auto& shared = loadedTiles[it->second.offset];
+        if (auto data = shared.lock()) {
+            return data;
+        }
+
+        auto data = std::make_shared<const std::string>(file->data + it->second.offset, it->second.length);
+        PayloadStatistics::addCopiedBytes(data->size());
+        shared = data;
+        if (loadedTiles.size() >= sweepSize) {
+            sweep();
+        }
+        return data;
+    }
+
+    std::string getTileJSON(const std::string& url) override {
+        JSDocument document;
+        document.Parse<0>(metadata.c_str());
+        if (document.HasParseError() || !document.IsObject()) {
+            document.SetObject();
+        }
+
+        auto& allocator = document.GetAllocator();
+        document.RemoveMember("tiles");
+        document.RemoveMember("scheme");
+        if (!document.HasMember("tilejson")) {
+            document.AddMember("tilejson", "2.2.0", allocator);
+        }
+
+        JSValue tileURLs(rapidjson::kArrayType);
+        const std::string urlTemplate = tileURL(url);
+        tileURLs.PushBack(JSValue(urlTemplate.data(), rapidjson::SizeType(urlTemplate.size()), allocator), allocator);
+        document.AddMember("tiles", tileURLs, allocator);
+        document.AddMember("scheme", "xyz", allocator);
+
+        rapidjson::StringBuffer buffer;
+        TileJSONWriter writer(buffer);
+        document.Accept(writer);
+        return buffer.GetString();
+    }
+
+private:
+    struct Entry {
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    static uint64_t key(uint8_t z, uint32_t x, uint32_t y) {
+        return (uint64_t(z) << 48) | (uint64_t(x) << 24) | y;
+    }
+
+    uint64_t read(std::size_t offset, std::size_t bytes) const {
+        uint64_t value = 0;
+        for (std::size_t i = bytes; i-- > 0;) {
+            value = (value << 8) | static_cast<uint8_t>(file->data[offset + i]);
+        }
+        return value;
+    }
+
+    // Whether the given range lies within the file, without overflowing for offsets and lengths
+    // read from a damaged one.
+    bool contains(uint64_t offset, uint64_t length) const {
+        return offset <= file->size && length <= file->size - offset;
+    }
+
+    void readDirectory(uint64_t offset, uint64_t length, bool root) {
+        if (!contains(offset, length) || length % EntrySize != 0) {
+            throw std::runtime_error("Tile archive has an invalid directory");
+        }
+
+        directory.reserve(directory.size() + length / EntrySize);
+        for (uint64_t entry = offset; entry < offset + length; entry += EntrySize) {
+            const auto z = static_cast<uint8_t>(read(entry, 1));
+            const auto x = static_cast<uint32_t>(read(entry + 1, 3));
+            const auto y = static_cast<uint32_t>(read(entry + 4, 3));
+            const uint64_t dataOffset = read(entry + 7, 6);
+            const auto dataLength = static_cast<uint32_t>(read(entry + 13, 4));
+
+            if (z & 0x80) {
+                if (!root) {
+                    throw std::runtime_error("Tile archive has nested leaf directories");
+                }
+                readDirectory(dataOffset, dataLength, false);
+            } else if (!contains(dataOffset, dataLength)) {
+                throw std::runtime_error("Tile archive is truncated");
+            } else {
+                directory[key(z, x, y)] = { dataOffset, dataLength };
+            }
+        }
+    }
+
+    // Forgets tiles that are no longer in use.
+    void sweep() {
+        for (auto it = loadedTiles.begin(); it != loadedTiles.end();) {
+            it = it->second.expired() ? loadedTiles.erase(it) : std::next(it);
+        }
+        sweepSize = std::max<std::size_t>(minimumSweepSize, loadedTiles.size() * 2);
+    }
+
+    static constexpr std::size_t minimumSweepSize = 1024;
+
+    const std::unique_ptr<MappedFile> file;
+    std::string metadata;
+    std::unordered_map<uint64_t, Entry> directory;
+    std::unordered_map<uint64_t, std::weak_ptr<const std::string>> loadedTiles;
+    std::size_t sweepSize = minimumSweepSize;
+};
+
+constexpr std::size_t ClusteredArchive::minimumSweepSize;
+
+std::unique_ptr<Archive> openArchive(const std::string& path) {
+    static const char sqliteHeader[] = "SQLite format 3";
+
+    auto file = std::make_unique<MappedFile>(path);
+    if (file->size >= sizeof(sqliteHeader) &&
+        std::memcmp(file->data, sqliteHeader, sizeof(sqliteHeader)) == 0) {
+        const std::size_t size = file->size;
+        file.reset();
+        return std::make_unique<MBTilesArchive>(path, size);
+    }
+    return std::make_unique<ClusteredArchive>(std::move(file));
+}
+
+} // namespace
+
+class MBTilesFileSource::Impl {
+public:
+    Impl(ActorRef<Impl>) {}
+
+    void request(const Resource& resource, ActorRef<FileSourceRequest> req) {
+        Response response;
+
+        if (!acceptsURL(resource.url)) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other,
+                                                               "Invalid mbtiles URL");
+            req.invoke(&FileSourceRequest::setResponse, response);
+            return;
+        }
+
+        // Tile URLs append the tile coordinates as a query string.
+        const std::string url = resource.url.substr(0, resource.url.find('?'));
+        const auto path = util::percentDecode(url.substr(mbtilesProtocol.size()));
+
+        try {
+            Archive& archive = getArchive(path);
+            if (resource.tileData) {
+                const auto& tile = *resource.tileData;
+                response.data = archive.getTile(tile.z, tile.x, tile.y);
+                if (!response.data) {
+                    response.noContent = true;
+                } else if (!resource.acceptsCompressedData) {
+                    response.data = inflatePayload(std::move(response.data));
+                }
+            } else {
+                response.data = std::make_shared<const std::string>(archive.getTileJSON(url));
+            }
+        } catch (const util::IOException& ex) {
+            response.error = std::make_unique<Response::Error>(
+                ex.code == ENOENT || ex.code == EISDIR ? Response::Error::Reason::NotFound
+                                                       : Response::Error::Reason::Other,
+                ex.what());
+        } catch (...) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other,
+                                                               util::toString(std::current_exception()));
+        }
+
+        req.invoke(&FileSourceRequest::setResponse, response);
+    }
+
+private:
+    Archive& getArchive(const std::string& path) {
+        auto it = archives.find(path);
+        if (it == archives.end()) {
+            it = archives.emplace(path, openArchive(path)).first;
+        }
+        return *it->second;
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<Archive>> archives;
+};
+
+MBTilesFileSource::MBTilesFileSource()
+    : impl(std::make_unique<util::Thread<Impl>>("MBTilesFileSource")) {
+}
+
+MBTilesFileSource::~MBTilesFileSource() = default;
+
+std::unique_ptr<AsyncRequest> MBTilesFileSource::request(const Resource& resource, Callback callback) {
+    auto req = std::make_unique<FileSourceRequest>(std::move(callback));
+
+    impl->actor().invoke(&Impl::request, resource, req->actor());
+
+    return std::move(req);
+}
+
+bool MBTilesFileSource::acceptsURL(const std::string& url) {
+    return 0 == url.rfind(mbtilesProtocol, 0);
+}
+
+} // namespace mbgl
@@ -1,4 +1,5 @@
 #include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/payload.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/sqlite3.hpp>
 #include <mbgl/util/compression.hpp>
@@ -6,15 +7,141 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/thread.hpp>
 
 #include <mbgl/storage/offline_schema.hpp>
 #include <mbgl/storage/merge_sideloaded.hpp>
 
+#include <algorithm>
+#include <mutex>
 
 namespace mbgl {
 
-OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_)
+namespace {
+
+// Keeps the total length of all resource and tile data in the metadata table up to date, so
+// that eviction doesn't need to scan the tables. Part of schema version 7.
+// clang-format off
+constexpr const char* storedSizeSchema =
+    "CREATE TABLE metadata ("
+    "  key TEXT NOT NULL PRIMARY KEY,"
+    "  value INTEGER NOT NULL"
+    ");"
+    "CREATE TRIGGER resources_size_insert AFTER INSERT ON resources BEGIN"
+    "  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) WHERE key = 'stored_size';"
+    "END;"
+    "CREATE TRIGGER resources_size_update AFTER UPDATE OF data ON resources BEGIN"
+    "  UPDATE metadata SET value = value - ifnull(length(OLD.data), 0) + ifnull(length(NEW.data), 0) WHERE key = 'stored_size';"
+    "END;"
+    "CREATE TRIGGER resources_size_delete AFTER DELETE ON resources BEGIN"
+    "  UPDATE metadata SET value = value - ifnull(length(OLD.data), 0) WHERE key = 'stored_size';"
+    "END;"
+    "CREATE TRIGGER tiles_size_insert AFTER INSERT ON tiles BEGIN"
+    "  UPDATE metadata SET value = value + ifnull(length(NEW.data), 0) WHERE key = 'stored_size';"
+    "END;"
+    "CREATE TRIGGER tiles_size_update AFTER UPDATE OF data ON tiles BEGIN"
+    "  UPDATE metadata SET value = value - ifnull(length(OLD.data), 0) + ifnull(length(NEW.data), 0) WHERE key = 'stored_size';"
+    "END;"
+    "CREATE TRIGGER tiles_size_delete AFTER DELETE ON tiles BEGIN"
+    "  UPDATE metadata SET value = value - ifnull(length(OLD.data), 0) WHERE key = 'stored_size';"
+    "END;"
+    "INSERT INTO metadata (key, value) "
+    "SELECT 'stored_size', "
+    "       (SELECT ifnull(sum(length(data)), 0) FROM resources) + "
+    "       (SELECT ifnull(sum(length(data)), 0) FROM tiles);";
+// clang-format on
+
+// The maximum number of resources and tiles that are deleted at once.
+constexpr uint32_t evictionChunkSize = 64;
+
+// Between puts, the ambient cache is shrunk to this fraction of its maximum size, one chunk at
+// a time, so that puts rarely have to make space themselves.
+constexpr uint64_t evictionLowWaterMarkPercent = 90;
+
+// The maximum number of free pages that are returned to the file system at once.
+constexpr uint32_t incrementalVacuumPages = 256;
+
+} // namespace
+
+struct OfflineDatabase::WriteQueue {
+    struct Write {
+        Resource resource;
+        // Writes without a response only update the accessed timestamp.
+        optional<Response> response;
+    };
+
+    std::mutex mutex;
+    std::vector<Write> writes;
+    // An error of the writer that requires removing the database, which only the owning
+    // connection can do once it closed its connections.
+    optional<mapbox::sqlite::Exception> error;
+};
+
+// Commits queued writes in write-ahead logging mode, using its own connection. All writes that
+// were queued while the previous batch was being committed are grouped into one transaction.
+class OfflineDatabase::Writer {
+public:
+    Writer(std::string path, uint64_t maximumCacheSize, Synchronous synchronous, std::shared_ptr<WriteQueue> queue_)
+        // The journal mode is persistent, so the writer's connection doesn't need to set it.
+        : database(std::move(path), maximumCacheSize, JournalMode::Delete, synchronous, queue_),
+          queue(std::move(queue_)) {
+    }
+
+    void commit() {
+        std::vector<WriteQueue::Write> batch;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            batch.swap(queue->writes);
+        }
+        if (batch.empty()) {
+            return;
+        }
+
+        try {
+            if (!database.db) {
+                database.initialize();
+            }
+            mapbox::sqlite::Transaction transaction(*database.db, mapbox::sqlite::Transaction::Immediate);
+            for (const auto& write : batch) {
+                if (write.response) {
+                    database.putInternal(write.resource, *write.response, true);
+                } else {
+                    database.updateAccessed(write.resource);
+                }
+            }
+            transaction.commit();
+        } catch (const util::IOException& ex) {
+            database.handleError(ex, "write resources");
+            return;
+        } catch (const mapbox::sqlite::Exception& ex) {
+            database.handleError(ex, "write resources");
+            return;
+        }
+
+        database.evictIncrementally();
+    }
+
+private:
+    OfflineDatabase database;
+    const std::shared_ptr<WriteQueue> queue;
+};
+
+OfflineDatabase::OfflineDatabase(std::string path_,
+                                 uint64_t maximumCacheSize_,
+                                 JournalMode journalMode_,
+                                 Synchronous synchronous_)
+    : OfflineDatabase(std::move(path_), maximumCacheSize_, journalMode_, synchronous_, nullptr) {
+}
+
+OfflineDatabase::OfflineDatabase(std::string path_,
+                                 uint64_t maximumCacheSize_,
+                                 JournalMode journalMode_,
+                                 Synchronous synchronous_,
+                                 std::shared_ptr<WriteQueue> ownerQueue_)
     : path(std::move(path_)),
+      journalMode(path == ":memory:" ? JournalMode::Delete : journalMode_),
+      synchronous(synchronous_),
+      ownerQueue(std::move(ownerQueue_)),
       maximumCacheSize(maximumCacheSize_) {
     try {
         initialize();
@@ -38,6 +165,9 @@ void OfflineDatabase::initialize() {
         mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadWriteCreate));
     db->setBusyTimeout(Milliseconds::max());
     db->exec("PRAGMA foreign_keys = ON");
+    // Rows that are replaced by REPLACE statements fire the delete triggers that keep the stored
+    // size up to date.
+    db->exec("PRAGMA recursive_triggers = ON");
 
     const auto userVersion = getPragma<int64_t>("PRAGMA user_version");
     switch (userVersion) {
@@ -46,7 +176,7 @@ void OfflineDatabase::initialize() {
         // Newly created database, or old cache-only database; remove old table if it exists.
         removeOldCacheTable();
         createSchema();
-        return;
+        break;
     case 2:
         migrateToVersion3();
         // fall through
@@ -60,12 +190,37 @@ void OfflineDatabase::initialize() {
         migrateToVersion6();
         // fall through
     case 6:
+        migrateToVersion7();
+        // fall through
+    case 7:
         // Happy path; we're done
-        return;
+        break;
     default:
+        if (ownerQueue) {
+            throw mapbox::sqlite::Exception(mapbox::sqlite::ResultCode::NotADB, "Unsupported database version");
+        }
         // Downgrade: delete the database and try to reinitialize.
         removeExisting();
         initialize();
+        return;
+    }
+
+    switch (synchronous) {
+    case Synchronous::Off:
+        db->exec("PRAGMA synchronous = OFF");
+        break;
+    case Synchronous::Normal:
+        db->exec("PRAGMA synchronous = NORMAL");
+        break;
+    case Synchronous::Full:
+        db->exec("PRAGMA synchronous = FULL");
+        break;
+    }
+
+    if (journalMode == JournalMode::WAL) {
+        db->exec("PRAGMA journal_mode = WAL");
+        writeQueue = std::make_shared<WriteQueue>();
+        writer = std::make_unique<util::Thread<Writer>>("OfflineDatabase", path, maximumCacheSize, synchronous, writeQueue);
     }
 }
 
@@ -77,8 +232,14 @@ void OfflineDatabase::changePath(const std::string& path_) {
 }
 
 void OfflineDatabase::cleanup() {
+    // Commit queued writes before closing the connections.
+    flush();
+    writer.reset();
+
     // Deleting these SQLite objects may result in exceptions
     try {
+        readStatements.clear();
+        readDB.reset();
         statements.clear();
         db.reset();
     } catch (const util::IOException& ex) {
@@ -95,6 +256,12 @@ void OfflineDatabase::handleError(const mapbox::sqlite::Exception& ex, const cha
          ex.extendedCode == mapbox::sqlite::ExtendedResultCode::ReadOnlyDBMoved)) {
         // The database was corruped, moved away, or deleted. We're going to start fresh with a
         // clean slate for the next operation.
+        if (ownerQueue) {
+            std::lock_guard<std::mutex> lock(ownerQueue->mutex);
+            ownerQueue->error = nullopt;
+            ownerQueue->error.emplace(ex);
+            return;
+        }
         Log::Error(Event::Database, static_cast<int>(ex.code), "Can't %s: %s", action, ex.what());
         try {
             removeExisting();
@@ -115,10 +282,18 @@ void OfflineDatabase::handleError(const util::IOException& ex, const char* actio
 void OfflineDatabase::removeExisting() {
     Log::Warning(Event::Database, "Removing existing incompatible offline database");
 
+    // Queued writes are discarded along with the database.
+    writer.reset();
+    readStatements.clear();
+    readDB.reset();
     statements.clear();
     db.reset();
 
     util::deleteFile(path);
+    if (journalMode == JournalMode::WAL) {
+        util::deleteFile(path + "-wal");
+        util::deleteFile(path + "-shm");
+    }
 }
 
 void OfflineDatabase::removeOldCacheTable() {
@@ -134,7 +309,8 @@ void OfflineDatabase::createSchema() {
     db->exec("PRAGMA synchronous = FULL");
     mapbox::sqlite::Transaction transaction(*db);
     db->exec(offlineDatabaseSchema);
-    db->exec("PRAGMA user_version = 6");
+    db->exec(storedSizeSchema);
+    db->exec("PRAGMA user_version = 7");
     transaction.commit();
 }
 
@@ -167,6 +343,14 @@ void OfflineDatabase::migrateToVersion6() {
     transaction.commit();
 }
 
+void OfflineDatabase::migrateToVersion7() {
+    assert(db);
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec(storedSizeSchema);
+    db->exec("PRAGMA user_version = 7");
+    transaction.commit();
+}
+
 mapbox::sqlite::Statement& OfflineDatabase::getStatement(const char* sql) {
     if (!db) {
         initialize();
@@ -178,7 +362,65 @@ mapbox::sqlite::Statement& OfflineDatabase::getStatement(const char* sql) {
     return *it->second;
 }
 
+mapbox::sqlite::Statement& OfflineDatabase::getReadStatement(const char* sql) {
+    if (!db) {
+        initialize();
+    }
+    if (!writer) {
+        return getStatement(sql);
+    }
+    if (!readDB) {
+        readDB = std::make_unique<mapbox::sqlite::Database>(
+            mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly));
+        readDB->setBusyTimeout(Milliseconds::max());
+    }
+    auto it = readStatements.find(sql);
+    if (it == readStatements.end()) {
+        it = readStatements.emplace(sql, std::make_unique<mapbox::sqlite::Statement>(*readDB, sql)).first;
+    }
+    return *it->second;
+}
+
+void OfflineDatabase::enqueue(const Resource& resource, optional<Response> response) {
+    assert(writer);
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(writeQueue->mutex);
+        wasEmpty = writeQueue->writes.empty();
+        writeQueue->writes.push_back({ resource, std::move(response) });
+    }
+    // Otherwise, a commit is already scheduled and will pick up this write as well.
+    if (wasEmpty) {
+        writer->actor().invoke(&Writer::commit);
+    }
+}
+
+void OfflineDatabase::flush() {
+    if (writer) {
+        writer->actor().ask(&Writer::commit).wait();
+        handleWriteError();
+    }
+}
+
+void OfflineDatabase::handleWriteError() {
+    if (!writeQueue) {
+        return;
+    }
+    optional<mapbox::sqlite::Exception> error;
+    {
+        std::lock_guard<std::mutex> lock(writeQueue->mutex);
+        if (writeQueue->error) {
+            error.emplace(*writeQueue->error);
+            writeQueue->error = nullopt;
+        }
+    }
+    if (error) {
+        handleError(*error, "write resources");
+    }
+}
+
 optional<Response> OfflineDatabase::get(const Resource& resource) try {
+    handleWriteError();
     auto result = getInternal(resource);
     return result ? optional<Response>{ result->first } : nullopt;
 } catch (const util::IOException& ex) {
@@ -190,9 +432,16 @@ optional<Response> OfflineDatabase::get(const Resource& resource) try {
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resource& resource) {
+    // Update accessed timestamp used for LRU eviction.
+    if (writer) {
+        enqueue(resource, nullopt);
+    } else {
+        updateAccessed(resource);
+    }
+
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
-        return getTile(*resource.tileData);
+        return getTile(*resource.tileData, resource.acceptsCompressedData);
     } else {
         return getResource(resource);
     }
@@ -207,13 +456,60 @@ optional<int64_t> OfflineDatabase::hasInternal(const Resource& resource) {
     }
 }
 
+void OfflineDatabase::updateAccessed(const Resource& resource) try {
+    if (resource.kind == Resource::Kind::Tile) {
+        assert(resource.tileData);
+        const Resource::TileData& tile = *resource.tileData;
+
+        // clang-format off
+        mapbox::sqlite::Query accessedQuery{ getStatement(
+            "UPDATE tiles "
+            "SET accessed       = ?1 "
+            "WHERE url_template = ?2 "
+            "  AND pixel_ratio  = ?3 "
+            "  AND x            = ?4 "
+            "  AND y            = ?5 "
+            "  AND z            = ?6 ") };
+        // clang-format on
+
+        accessedQuery.bind(1, util::now());
+        accessedQuery.bind(2, tile.urlTemplate);
+        accessedQuery.bind(3, tile.pixelRatio);
+        accessedQuery.bind(4, tile.x);
+        accessedQuery.bind(5, tile.y);
+        accessedQuery.bind(6, tile.z);
+        accessedQuery.run();
+    } else {
+        mapbox::sqlite::Query accessedQuery{ getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2") };
+        accessedQuery.bind(1, util::now());
+        accessedQuery.bind(2, resource.url);
+        accessedQuery.run();
+    }
+} catch (const mapbox::sqlite::Exception& ex) {
+    if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
+        throw;
+    }
+
+    // If we don't have any indication that the database is corrupt, continue as usual.
+    Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
+}
+
 std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const Response& response) try {
+    handleWriteError();
     if (!db) {
         initialize();
     }
+    if (writer) {
+        if (response.error) {
+            return { false, 0 };
+        }
+        enqueue(resource, response);
+        return { true, 0 };
+    }
     mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
     auto result = putInternal(resource, response, true);
     transaction.commit();
+    evictIncrementally();
     return result;
 } catch (const mapbox::sqlite::Exception& ex) {
     handleError(ex, "write resource");
@@ -229,7 +525,11 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     bool compressed = false;
     uint64_t size = 0;
 
-    if (response.data) {
+    if (response.data && resource.acceptsCompressedData && util::isCompressed(*response.data)) {
+        // E.g. data that we previously handed out compressed, and that was revalidated since.
+        compressed = true;
+        size = response.data->size();
+    } else if (response.data) {
         compressedData = util::compress(*response.data);
         compressed = compressedData.size() < response.data->size();
         size = compressed ? compressedData.size() : response.data->size();
@@ -240,41 +540,24 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
         return { false, 0 };
     }
 
+    const std::string noData;
+    const std::string& data = compressed && !compressedData.empty() ? compressedData
+                            : response.data ? *response.data : noData;
     bool inserted;
 
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
-        inserted = putTile(*resource.tileData, response,
-                compressed ? compressedData : response.data ? *response.data : "",
-                compressed);
+        inserted = putTile(*resource.tileData, response, data, compressed);
     } else {
-        inserted = putResource(resource, response,
-                compressed ? compressedData : response.data ? *response.data : "",
-                compressed);
+        inserted = putResource(resource, response, data, compressed);
     }
 
     return { inserted, size };
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
-    // Update accessed timestamp used for LRU eviction.
-    try {
-        mapbox::sqlite::Query accessedQuery{ getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2") };
-        accessedQuery.bind(1, util::now());
-        accessedQuery.bind(2, resource.url);
-        accessedQuery.run();
-    } catch (const mapbox::sqlite::Exception& ex) {
-        if (ex.code == mapbox::sqlite::ResultCode::NotADB ||
-            ex.code == mapbox::sqlite::ResultCode::Corrupt) {
-            throw;
-        }
-
-        // If we don't have any indication that the database is corrupt, continue as usual.
-        Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
-    }
-
     // clang-format off
-    mapbox::sqlite::Query query{ getStatement(
+    mapbox::sqlite::Query query{ getReadStatement(
         //        0      1            2            3       4      5
         "SELECT etag, expires, must_revalidate, modified, data, compressed "
         "FROM resources "
@@ -298,12 +581,12 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     auto data = query.get<optional<std::string>>(4);
     if (!data) {
         response.noContent = true;
-    } else if (query.get<bool>(5)) {
+    } else if (query.get<bool>(5) && !resource.acceptsCompressedData) {
         response.data = std::make_shared<std::string>(util::decompress(*data));
         size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
     return std::make_pair(response, size);
@@ -404,38 +687,9 @@ bool OfflineDatabase::putResource(const Resource& resource,
     return true;
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
-    // Update accessed timestamp used for LRU eviction.
-    try {
-        // clang-format off
-        mapbox::sqlite::Query accessedQuery{ getStatement(
-            "UPDATE tiles "
-            "SET accessed       = ?1 "
-            "WHERE url_template = ?2 "
-            "  AND pixel_ratio  = ?3 "
-            "  AND x            = ?4 "
-            "  AND y            = ?5 "
-            "  AND z            = ?6 ") };
-        // clang-format on
-
-        accessedQuery.bind(1, util::now());
-        accessedQuery.bind(2, tile.urlTemplate);
-        accessedQuery.bind(3, tile.pixelRatio);
-        accessedQuery.bind(4, tile.x);
-        accessedQuery.bind(5, tile.y);
-        accessedQuery.bind(6, tile.z);
-        accessedQuery.run();
-    } catch (const mapbox::sqlite::Exception& ex) {
-        if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
-            throw;
-        }
-
-        // If we don't have any indication that the database is corrupt, continue as usual.
-        Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
-    }
-
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile, bool acceptsCompressedData) {
     // clang-format off
-    mapbox::sqlite::Query query{ getStatement(
+    mapbox::sqlite::Query query{ getReadStatement(
         //        0      1           2,            3,      4,      5
         "SELECT etag, expires, must_revalidate, modified, data, compressed "
         "FROM tiles "
@@ -467,12 +721,15 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     optional<std::string> data = query.get<optional<std::string>>(4);
     if (!data) {
         response.noContent = true;
-    } else if (query.get<bool>(5)) {
+    } else if (query.get<bool>(5) && !acceptsCompressedData) {
+        PayloadStatistics::addCopiedBytes(data->length());
         response.data = std::make_shared<std::string>(util::decompress(*data));
+        PayloadStatistics::addInflatedBytes(response.data->length());
         size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
+        PayloadStatistics::addCopiedBytes(data->length());
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
     return std::make_pair(response, size);
@@ -607,6 +864,9 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 }
 
 std::exception_ptr OfflineDatabase::invalidateTileCache() try {
+    // Queued tiles must be invalidated as well.
+    flush();
+
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
         "UPDATE tiles "
@@ -692,6 +952,9 @@ OfflineDatabase::createRegion(const OfflineRegionDefinition& definition,
 expected<OfflineRegions, std::exception_ptr>
 OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
     try {
+        // Merged tiles replace queued ambient tiles, not the other way around.
+        flush();
+
         // clang-format off
         mapbox::sqlite::Query query{ getStatement("ATTACH DATABASE ?1 AS side") };
         // clang-format on
@@ -703,12 +966,13 @@ OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
         return unexpected<std::exception_ptr>(std::current_exception());
     }
     try {
-        // Support sideloaded databases at user_version = 6. Future schema version
-        // changes will need to implement migration paths for sideloaded databases at
-        // version 6.
+        // Support sideloaded databases at user_version = 6 or 7. Version 7 only adds the
+        // stored size bookkeeping of the main database, which the merge doesn't read from
+        // the sideloaded one. Future schema version changes will need to implement
+        // migration paths for sideloaded databases at version 6.
         auto sideUserVersion = static_cast<int>(getPragma<int64_t>("PRAGMA side.user_version"));
         const auto mainUserVersion = getPragma<int64_t>("PRAGMA user_version");
-        if (sideUserVersion < 6 || sideUserVersion != mainUserVersion) {
+        if (sideUserVersion < 6 || sideUserVersion > mainUserVersion) {
             throw std::runtime_error("Merge database has incorrect user_version");
         }
 
@@ -1045,91 +1309,126 @@ T OfflineDatabase::getPragma(const char* sql) {
     return query.get<T>(0);
 }
 
-// Remove least-recently used resources and tiles until the used database size,
-// as calculated by multiplying the number of in-use pages by the page size, is
-// less than the maximum cache size. Returns false if this condition cannot be
-// satisfied.
+uint64_t OfflineDatabase::getStoredSize() {
+    mapbox::sqlite::Query query{ getStatement("SELECT value FROM metadata WHERE key = 'stored_size'") };
+    query.run();
+    return std::max<int64_t>(query.get<int64_t>(0), 0);
+}
+
+// The maximum cache size limits the pages that the database uses, like it did before the
+// stored size was kept. The stored size only counts the `data` columns, so this adds the
+// overhead of the other columns, the indexes and partially filled pages, measured from the
+// page counts. Eviction keeps it constant while deleting, which overestimates the size.
+uint64_t OfflineDatabase::getStorageOverhead() {
+    const uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
+    const uint64_t usedSize = pageSize * (getPragma<int64_t>("PRAGMA page_count") -
+                                          getPragma<int64_t>("PRAGMA freelist_count"));
+    return usedSize - std::min(usedSize, getStoredSize());
+}
+
+// Remove least-recently used resources and tiles until the used size plus the
+// needed free size is less than the maximum cache size. Returns false if this
+// condition cannot be satisfied.
 //
-// SQLite database never shrinks in size unless we call VACCUM. We here
-// are monitoring the soft limit (i.e. number of free pages in the file)
-// and as it approaches to the hard limit (i.e. the actual file size) we
-// delete an arbitrary number of old cache entries. The free pages approach saves
-// us from calling VACCUM or keeping a running total, which can be costly.
+// SQLite database never shrinks in size unless we call VACUUM. Pages that are
+// freed here are reused by the data that is being put; evictIncrementally()
+// returns the remaining free pages to the file system.
 bool OfflineDatabase::evict(uint64_t neededFreeSize) {
-    uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
-    uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
+    const uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
+    const uint64_t overhead = getStorageOverhead();
+
+    // The addition of pageSize is a fudge factor because the data that is put can get
+    // fragmented on the database.
+    uint64_t size;
+    while ((size = getStoredSize() + overhead + neededFreeSize + pageSize) > maximumCacheSize) {
+        if (!evictChunk(size - maximumCacheSize)) {
+            return false;
+        }
+    }
 
-    auto usedSize = [&] {
-        return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
-    };
+    return true;
+}
 
-    // The addition of pageSize is a fudge factor to account for non `data` column
-    // size, and because pages can get fragmented on the database.
-    while (usedSize() + neededFreeSize + pageSize > maximumCacheSize) {
+// Deletes least recently used ambient resources and tiles, oldest first, until at least the
+// given number of bytes was freed, or a chunk of entries was deleted. Returns false if there
+// was nothing to delete.
+bool OfflineDatabase::evictChunk(uint64_t bytes) {
+    std::vector<int64_t> resourceIDs;
+    std::vector<int64_t> tileIDs;
+
+    {
+        // Both halves are ordered by the `accessed` indexes, so that SQLite merges them instead of
+        // sorting all entries; the region tables are probed through their indexes as well.
         // clang-format off
-        mapbox::sqlite::Query accessedQuery{ getStatement(
-            "SELECT max(accessed) "
+        mapbox::sqlite::Query query{ getStatement(
+            "SELECT tile, id, size "
             "FROM ( "
-            "    SELECT accessed "
+            "    SELECT 0 AS tile, id, ifnull(length(data), 0) AS size, accessed "
             "    FROM resources "
-            "    LEFT JOIN region_resources "
-            "    ON resource_id = resources.id "
-            "    WHERE resource_id IS NULL "
+            "    WHERE NOT EXISTS (SELECT 1 FROM region_resources WHERE resource_id = resources.id) "
             "  UNION ALL "
-            "    SELECT accessed "
+            "    SELECT 1 AS tile, id, ifnull(length(data), 0) AS size, accessed "
             "    FROM tiles "
-            "    LEFT JOIN region_tiles "
-            "    ON tile_id = tiles.id "
-            "    WHERE tile_id IS NULL "
+            "    WHERE NOT EXISTS (SELECT 1 FROM region_tiles WHERE tile_id = tiles.id) "
             "  ORDER BY accessed ASC LIMIT ?1 "
-            ") "
-        ) };
-        accessedQuery.bind(1, 50);
+            ") ") };
         // clang-format on
-        if (!accessedQuery.run()) {
-            return false;
+        query.bind(1, evictionChunkSize);
+
+        uint64_t freed = 0;
+        while (freed < bytes && query.run()) {
+            (query.get<bool>(0) ? tileIDs : resourceIDs).push_back(query.get<int64_t>(1));
+            freed += query.get<int64_t>(2);
         }
-        Timestamp accessed = accessedQuery.get<Timestamp>(0);
+    }
 
-        // clang-format off
-        mapbox::sqlite::Query resourceQuery{ getStatement(
-            "DELETE FROM resources "
-            "WHERE id IN ( "
-            "  SELECT id FROM resources "
-            "  LEFT JOIN region_resources "
-            "  ON resource_id = resources.id "
-            "  WHERE resource_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ") };
-        // clang-format on
-        resourceQuery.bind(1, accessed);
+    if (resourceIDs.empty() && tileIDs.empty()) {
+        return false;
+    }
+
+    for (int64_t id : resourceIDs) {
+        mapbox::sqlite::Query resourceQuery{ getStatement("DELETE FROM resources WHERE id = ?1") };
+        resourceQuery.bind(1, id);
         resourceQuery.run();
-        const uint64_t resourceChanges = resourceQuery.changes();
+    }
 
-        // clang-format off
-        mapbox::sqlite::Query tileQuery{ getStatement(
-            "DELETE FROM tiles "
-            "WHERE id IN ( "
-            "  SELECT id FROM tiles "
-            "  LEFT JOIN region_tiles "
-            "  ON tile_id = tiles.id "
-            "  WHERE tile_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ") };
-        // clang-format on
-        tileQuery.bind(1, accessed);
+    for (int64_t id : tileIDs) {
+        mapbox::sqlite::Query tileQuery{ getStatement("DELETE FROM tiles WHERE id = ?1") };
+        tileQuery.bind(1, id);
         tileQuery.run();
-        const uint64_t tileChanges = tileQuery.changes();
+    }
 
-        // The cached value of offlineTileCount does not need to be updated
-        // here because only non-offline tiles can be removed by eviction.
+    // The cached value of offlineTileCount does not need to be updated
+    // here because only non-offline tiles can be removed by eviction.
 
-        if (resourceChanges == 0 && tileChanges == 0) {
-            return false;
-        }
+    return true;
+}
+
+void OfflineDatabase::evictIncrementally() try {
+    if (!db) {
+        return;
     }
 
-    return true;
+    const uint64_t lowWaterMark = maximumCacheSize / 100 * evictionLowWaterMarkPercent;
+    const uint64_t size = getStoredSize() + getStorageOverhead();
+    if (size <= lowWaterMark) {
+        return;
+    }
+
+    bool evicted;
+    {
+        mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+        evicted = evictChunk(size - lowWaterMark);
+        transaction.commit();
+    }
+
+    if (evicted) {
+        db->exec("PRAGMA incremental_vacuum(" + util::toString(incrementalVacuumPages) + ")");
+    }
+} catch (const util::IOException& ex) {
+    handleError(ex, "evict resources");
+} catch (const mapbox::sqlite::Exception& ex) {
+    handleError(ex, "evict resources");
 }
 
 void OfflineDatabase::setOfflineMapboxTileCountLimit(uint64_t limit) {
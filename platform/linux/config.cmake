@@ -70,6 +70,8 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/include/mbgl/gfx/headless_backend.hpp
         PRIVATE platform/default/src/mbgl/gl/headless_backend.cpp
         PRIVATE platform/default/include/mbgl/gl/headless_backend.hpp
+        PRIVATE platform/default/src/mbgl/recording/headless_backend.cpp
+        PRIVATE platform/default/include/mbgl/recording/headless_backend.hpp
 
         # Snapshotting
         PRIVATE platform/default/src/mbgl/map/map_snapshotter.cpp
@@ -17,6 +17,8 @@ set(MBGL_QT_CORE_FILES
     PRIVATE platform/default/include/mbgl/gfx/headless_backend.hpp
     PRIVATE platform/default/src/mbgl/gl/headless_backend.cpp
     PRIVATE platform/default/include/mbgl/gl/headless_backend.hpp
+    PRIVATE platform/default/src/mbgl/recording/headless_backend.cpp
+    PRIVATE platform/default/include/mbgl/recording/headless_backend.hpp
     PRIVATE platform/qt/src/headless_backend_qt.cpp
 
     # Thread
@@ -45,6 +45,22 @@ void Mailbox::close() {
 
 bool Mailbox::isOpen() const { return bool(scheduler); }
 
+Mailbox::Priority Mailbox::getPriority() const {
+    return priority.load(std::memory_order_relaxed);
+}
+
+void Mailbox::setPriority(Priority priority_) {
+    if (priority.exchange(priority_, std::memory_order_relaxed) == priority_) {
+        return;
+    }
+
+    // This mailbox may already be waiting in the scheduler's queue.
+    std::lock_guard<std::mutex> pushingLock(pushingMutex);
+    if (scheduler) {
+        (*scheduler)->reprioritize();
+    }
+}
+
 
 void Mailbox::push(std::unique_ptr<Message> message) {
     std::lock_guard<std::mutex> pushingLock(pushingMutex);
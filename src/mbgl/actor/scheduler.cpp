@@ -2,6 +2,8 @@
 #include <mbgl/util/thread_local.hpp>
 #include <mbgl/util/thread_pool.hpp>
 
+#include <mutex>
+
 namespace mbgl {
 
 util::ThreadLocal<Scheduler> g_currentScheduler;
@@ -19,16 +21,33 @@ Scheduler* Scheduler::GetCurrent() {
     return current().get();
 }
 
+static std::mutex& backgroundMutex() {
+    static std::mutex mtx;
+    return mtx;
+}
+
+static Scheduler::BackgroundFactory& backgroundFactory() {
+    static Scheduler::BackgroundFactory factory;
+    return factory;
+}
+
+// static
+void Scheduler::SetBackgroundFactory(BackgroundFactory factory) {
+    std::lock_guard<std::mutex> lock(backgroundMutex());
+    backgroundFactory() = std::move(factory);
+}
+
 // static
 std::shared_ptr<Scheduler> Scheduler::GetBackground() {
     static std::weak_ptr<Scheduler> weak;
-    static std::mutex mtx;
 
-    std::lock_guard<std::mutex> lock(mtx);
+    std::lock_guard<std::mutex> lock(backgroundMutex());
     std::shared_ptr<Scheduler> scheduler = weak.lock();
 
     if (!scheduler) {
-        weak = scheduler = std::make_shared<ThreadPool>(4);
+        const auto& factory = backgroundFactory();
+        scheduler = factory ? factory() : std::make_shared<ThreadPool>(4);
+        weak = scheduler;
     }
 
     return scheduler;
@@ -192,6 +192,10 @@ optional<GeometryCoordinates> FeatureIndex::translateQueryGeometry(
     return translated;
 }
 
+std::size_t FeatureIndex::getMemoryUse() const {
+    return grid.bytes();
+}
+
 void FeatureIndex::setBucketLayerIDs(const std::string& bucketLeaderID, const std::vector<std::string>& layerIDs) {
     bucketLayerIDs[bucketLeaderID] = layerIDs;
 }
@@ -77,6 +77,9 @@ public:
             const float bearing,
             const float pixelsToTileUnits);
 
+    // The approximate number of bytes used by the index, not counting the tile data.
+    std::size_t getMemoryUse() const;
+
     void setBucketLayerIDs(const std::string& bucketLeaderID, const std::vector<std::string>& layerIDs);
     
     std::unordered_map<std::string, std::vector<Feature>> lookupSymbolFeatures(
@@ -12,19 +12,29 @@ namespace mbgl {
 
 class ProgramParameters;
 
+namespace recording {
+
+// Defined in <mbgl/recording/program.hpp>, which callers of gfx::Context::createProgram() include.
+template <class Name>
+std::unique_ptr<gfx::Program<Name>> createProgram();
+
+} // namespace recording
+
 namespace gfx {
 
 class OffscreenTexture;
 
 class Context {
 protected:
-    Context(uint32_t maximumVertexBindingCount_)
-        : maximumVertexBindingCount(maximumVertexBindingCount_) {
+    Context(uint32_t maximumVertexBindingCount_, bool recordsDraws_ = false)
+        : maximumVertexBindingCount(maximumVertexBindingCount_), recordsDraws(recordsDraws_) {
     }
 
 public:
     static constexpr const uint32_t minimumRequiredVertexBindingCount = 8;
     const uint32_t maximumVertexBindingCount;
+    // Whether draw calls are recorded instead of issued to a GPU, see recording::Context.
+    const bool recordsDraws;
     bool supportsHalfFloatTextures = false;
 
 public:
@@ -81,6 +91,9 @@ protected:
 public:
     template <typename Name>
     std::unique_ptr<Program<Name>> createProgram(const ProgramParameters& programParameters) {
+        if (recordsDraws) {
+            return recording::createProgram<Name>();
+        }
         return Backend::Create<Program<Name>, const ProgramParameters&>(programParameters);
     }
 
@@ -42,6 +42,14 @@ public:
         updateVertexBufferResource(buffer.getResource(), v.data(), v.bytes());
     }
 
+    // Uploads `count` vertices of `v`, starting at `offset`, to the same place in `buffer`.
+    template <class Vertex>
+    void updateVertexBuffer(VertexBuffer<Vertex>& buffer, const VertexVector<Vertex>& v, std::size_t offset, std::size_t count) {
+        assert(v.elements() == buffer.elements);
+        assert(offset + count <= v.elements());
+        updateVertexBufferResourceSub(buffer.getResource(), offset * sizeof(Vertex), v.data() + offset, count * sizeof(Vertex));
+    }
+
     template <class DrawMode>
     IndexBuffer createIndexBuffer(IndexVector<DrawMode>&& v,
                                   const BufferUsageType usage = BufferUsageType::StaticDraw) {
@@ -59,6 +67,8 @@ protected:
     createVertexBufferResource(const void* data, std::size_t size, const BufferUsageType) = 0;
     virtual void
     updateVertexBufferResource(VertexBufferResource&, const void* data, std::size_t size) = 0;
+    virtual void
+    updateVertexBufferResourceSub(VertexBufferResource&, std::size_t offset, const void* data, std::size_t size) = 0;
 
     virtual std::unique_ptr<IndexBufferResource>
     createIndexBufferResource(const void* data, std::size_t size, const BufferUsageType) = 0;
@@ -34,6 +34,14 @@ void UploadPass::updateVertexBufferResource(gfx::VertexBufferResource& resource,
     MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
 }
 
+void UploadPass::updateVertexBufferResourceSub(gfx::VertexBufferResource& resource,
+                                               std::size_t offset,
+                                               const void* data,
+                                               std::size_t size) {
+    commandEncoder.context.vertexBuffer = static_cast<gl::VertexBufferResource&>(resource).buffer;
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
 std::unique_ptr<gfx::IndexBufferResource> UploadPass::createIndexBufferResource(
     const void* data, std::size_t size, const gfx::BufferUsageType usage) {
     BufferID id = 0;
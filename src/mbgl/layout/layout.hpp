@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/renderer/bucket_cache.hpp>
 #include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
@@ -38,6 +39,9 @@ public:
     const BucketParameters& bucketParameters;
     GlyphDependencies& glyphDependencies;
     ImageDependencies& imageDependencies;
+    // Identifies the tessellated geometry of the layout's bucket in the BucketCache, if its
+    // tile data can be identified.
+    optional<BucketCache::Key> bucketCacheKey;
 };
 
 } // namespace mbgl
@@ -32,11 +32,13 @@ public:
     PatternLayout(const BucketParameters& parameters,
                   const std::vector<Immutable<style::LayerProperties>>& group,
                   std::unique_ptr<GeometryTileLayer> sourceLayer_,
-                  ImageDependencies& patternDependencies)
+                  ImageDependencies& patternDependencies,
+                  optional<BucketCache::Key> cacheKey_ = {})
                   : sourceLayer(std::move(sourceLayer_)),
                     zoom(parameters.tileID.overscaledZ),
                     overscaling(parameters.tileID.overscaleFactor()),
-                    hasPattern(false) {
+                    hasPattern(false),
+                    cacheKey(std::move(cacheKey_)) {
         assert(!group.empty());
         auto leaderLayerProperties = staticImmutableCast<LayerPropertiesType>(group.front());
         layout = leaderLayerProperties->layerImpl().layout.evaluate(PropertyEvaluationParameters(zoom));
@@ -60,11 +62,8 @@ public:
             layerPropertiesMap.emplace(layerId, layerProperties);
         }
 
-        const size_t featureCount = sourceLayer->featureCount();
-        for (size_t i = 0; i < featureCount; ++i) {
-            auto feature = sourceLayer->getFeature(i);
-            if (!leaderLayerProperties->layerImpl().filter(style::expression::EvaluationContext { this->zoom, feature.get() }))
-                continue;
+        // Features that don't match the filter are skipped before they're decoded.
+        sourceLayer->forEachOwnedFeature(leaderLayerProperties->layerImpl().filter, this->zoom, [&](std::size_t i, std::unique_ptr<GeometryTileFeature> feature) {
 
             PatternLayerMap patternDependencyMap;
             if (hasPattern) {
@@ -91,7 +90,8 @@ public:
                 }
             }
             features.push_back({static_cast<uint32_t>(i), std::move(feature), patternDependencyMap});
-        }
+            return true;
+        });
     };
 
     ~PatternLayout() final = default;
@@ -102,15 +102,63 @@ public:
 
     void createBucket(const ImagePositions& patternPositions, std::unique_ptr<FeatureIndex>& featureIndex, std::unordered_map<std::string, LayerRenderData>& renderData, const bool, const bool) override {
         auto bucket = std::make_shared<BucketType>(layout, layerPropertiesMap, zoom, overscaling);
-        for (auto & patternFeature : features) {
-            const auto i = patternFeature.i;
-            std::unique_ptr<GeometryTileFeature> feature = std::move(patternFeature.feature);
-            const PatternLayerMap& patterns = patternFeature.patterns;
-            GeometryCollection geometries = feature->getGeometries();
-
-            bucket->addFeature(*feature, geometries, patternPositions, patterns);
-            featureIndex->insert(geometries, i, sourceLayerID, bucketLeaderID);
+
+        // Tessellating features is expensive. If an identical bucket was tessellated before,
+        // reuse its geometry, and only populate paint properties and the feature index. The
+        // cache key covers the tile data, the filter and the zoom level, so the same features
+        // are present in the same order.
+        std::shared_ptr<const BucketCache::Entry> cached = cacheKey ? BucketCache::get().find(*cacheKey) : nullptr;
+
+        const std::vector<std::size_t>* cachedVertexEnds = nullptr;
+        if (cached) {
+            // A colliding key would hand out vertices of other features, which paint properties
+            // would be populated for out of bounds. Tessellate if the geometry doesn't fit.
+            cachedVertexEnds = &bucket->restoreGeometry(*cached);
+            if (cachedVertexEnds->size() != features.size() ||
+                (cachedVertexEnds->empty() ? 0 : cachedVertexEnds->back()) != bucket->vertices.elements()) {
+                bucket = std::make_shared<BucketType>(layout, layerPropertiesMap, zoom, overscaling);
+                cachedVertexEnds = nullptr;
+            }
+        }
+
+        std::vector<const GeometryTileFeature*> bucketFeatures;
+        std::vector<const PatternLayerMap*> bucketPatterns;
+        bucketFeatures.reserve(features.size());
+        bucketPatterns.reserve(features.size());
+        for (const auto& patternFeature : features) {
+            bucketFeatures.push_back(patternFeature.feature.get());
+            bucketPatterns.push_back(&patternFeature.patterns);
         }
+
+        // Paint properties are populated for all features at once after tessellating them, so
+        // that data-driven properties are evaluated in tight loops.
+        if (cachedVertexEnds) {
+            GeometryCollection geometries;
+            for (const auto& patternFeature : features) {
+                patternFeature.feature->decodeGeometries(geometries);
+                featureIndex->insert(geometries, patternFeature.i, sourceLayerID, bucketLeaderID);
+            }
+
+            bucket->addPaintProperties(bucketFeatures, *cachedVertexEnds, patternPositions, bucketPatterns);
+        } else {
+            std::vector<std::size_t> featureVertexEnds;
+            featureVertexEnds.reserve(features.size());
+
+            for (const auto& patternFeature : features) {
+                GeometryCollection geometries = patternFeature.feature->getGeometries();
+                bucket->addFeatureGeometry(*patternFeature.feature, geometries);
+                featureIndex->insert(geometries, patternFeature.i, sourceLayerID, bucketLeaderID);
+                featureVertexEnds.push_back(bucket->vertices.elements());
+            }
+
+            bucket->addPaintProperties(bucketFeatures, featureVertexEnds, patternPositions, bucketPatterns);
+
+            if (cacheKey) {
+                BucketCache::get().insert(*cacheKey, bucket->saveGeometry(std::move(featureVertexEnds)));
+            }
+        }
+        features.clear();
+
         if (bucket->hasData()) {
             for (const auto& pair : layerPropertiesMap) {
                 renderData.emplace(pair.first, LayerRenderData {bucket, pair.second});
@@ -130,6 +178,7 @@ private:
     const uint32_t overscaling;
     std::string sourceLayerID;
     bool hasPattern;
+    const optional<BucketCache::Key> cacheKey;
 };
 
 } // namespace mbgl
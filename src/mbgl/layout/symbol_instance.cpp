@@ -1,5 +1,6 @@
 #include <mbgl/layout/symbol_instance.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
+#include <functional>
 #include <utility>
 
 namespace mbgl {
@@ -54,6 +55,7 @@ SymbolInstance::SymbolInstance(Anchor& anchor_,
     textOffset(textOffset_),
     iconOffset(iconOffset_),
     key(std::move(key_)),
+    keyHash(std::hash<std::u16string>()(key)),
     textBoxScale(textBoxScale_),
     radialTextOffset(radialTextOffset_),
     singleLine(shapedTextOrientations.singleLine) {
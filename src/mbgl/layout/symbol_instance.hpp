@@ -66,6 +66,8 @@ public:
     std::array<float, 2> textOffset;
     std::array<float, 2> iconOffset;
     std::u16string key;
+    // Hash of `key`, computed once, for matching the symbol across tiles.
+    std::size_t keyHash;
     bool isDuplicate;
     optional<size_t> placedRightTextIndex;
     optional<size_t> placedCenterTextIndex;
@@ -6,6 +6,7 @@
 #include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/text/get_anchors.hpp>
 #include <mbgl/text/shaping.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/utf.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
@@ -110,13 +111,9 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
         layerPaintProperties.emplace(layer->baseImpl->id, layer);
     }
 
-    // Determine glyph dependencies
-    const size_t featureCount = sourceLayer->featureCount();
-    for (size_t i = 0; i < featureCount; ++i) {
-        auto feature = sourceLayer->getFeature(i);
-        if (!leader.filter(expression::EvaluationContext { this->zoom, feature.get() }))
-            continue;
-
+    // Determine glyph dependencies. Features that don't match the filter are skipped before
+    // they're decoded.
+    sourceLayer->forEachOwnedFeature(leader.filter, this->zoom, [&](std::size_t i, std::unique_ptr<GeometryTileFeature> feature) {
         SymbolFeature ft(std::move(feature));
 
         ft.index = i;
@@ -174,7 +171,8 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
                 features.push_back(std::move(ft));
             }
         }
-    }
+        return true;
+    });
 
     if (layout.get<SymbolPlacement>() == SymbolPlacementType::Line) {
         util::mergeLines(features);
@@ -287,9 +285,15 @@ void SymbolLayout::prepareSymbols(const GlyphMap& glyphMap, const GlyphPositions
             const float spacing = util::i18n::allowsLetterSpacing(feature.formattedText->rawText()) ? layout.evaluate<TextLetterSpacing>(zoom, feature) * util::ONE_EM : 0.0f;
 
             auto applyShaping = [&] (const TaggedString& formattedText, WritingModeType writingMode, SymbolAnchorType textAnchor, TextJustifyType textJustify) {
-                const Shaping result = getShaping(
+                const float maxWidth = isPointPlacement ? layout.evaluate<TextMaxWidth>(zoom, feature) * util::ONE_EM : 0.0f;
+                ShapingCache::Key key(formattedText, maxWidth, lineHeight, textAnchor, textJustify, spacing, textOffset, writingMode, glyphMap);
+                if (auto cached = ShapingCache::get().find(key)) {
+                    return *cached;
+                }
+
+                auto result = std::make_shared<const Shaping>(getShaping(
                     /* string */ formattedText,
-                    /* maxWidth: ems */ isPointPlacement ? layout.evaluate<TextMaxWidth>(zoom, feature) * util::ONE_EM : 0.0f,
+                    /* maxWidth: ems */ maxWidth,
                     /* ems */ lineHeight,
                     textAnchor,
                     textJustify,
@@ -297,9 +301,10 @@ void SymbolLayout::prepareSymbols(const GlyphMap& glyphMap, const GlyphPositions
                     /* translate */ textOffset,
                     /* writingMode */ writingMode,
                     /* bidirectional algorithm object */ bidi,
-                    /* glyphs */ glyphMap);
+                    /* glyphs */ glyphMap));
+                ShapingCache::get().insert(std::move(key), result);
 
-                return result;
+                return *result;
             };
             const std::vector<style::TextVariableAnchorType> variableTextAnchor = layout.evaluate<TextVariableAnchor>(zoom, feature);
             const float radialOffset = layout.evaluate<TextRadialOffset>(zoom, feature);
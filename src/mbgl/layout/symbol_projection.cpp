@@ -360,7 +360,17 @@ namespace mbgl {
     }
 
 
+    util::TransformedPoints projectAnchors(const std::vector<PlacedSymbol>& placedSymbols, const mat4& posMatrix) {
+        std::vector<Point<float>> anchors;
+        anchors.reserve(placedSymbols.size());
+        for (const auto& placedSymbol : placedSymbols) {
+            anchors.push_back(placedSymbol.anchorPoint);
+        }
+        return util::TransformedPoints(posMatrix, anchors);
+    }
+
     void reprojectLineLabels(gfx::VertexVector<gfx::Vertex<SymbolDynamicLayoutAttributes>>& dynamicVertexArray, const std::vector<PlacedSymbol>& placedSymbols,
+            const util::TransformedPoints& projectedAnchors,
 			const mat4& posMatrix, bool pitchWithMap, bool rotateWithMap, bool keepUpright,
             const RenderTile& tile, const SymbolSizeBinder& sizeBinder, const TransformState& state) {
 
@@ -379,7 +389,11 @@ namespace mbgl {
         
         bool useVertical = false;
 
-        for (auto& placedSymbol : placedSymbols) {
+        assert(projectedAnchors.size() == placedSymbols.size());
+        assert(projectedAnchors.matrix == posMatrix);
+
+        for (size_t i = 0; i < placedSymbols.size(); ++i) {
+            const PlacedSymbol& placedSymbol = placedSymbols[i];
             // Don't do calculations for vertical glyphs unless the previous symbol was horizontal
             // and we determined that vertical glyphs were necessary.
             // Also don't do calculations for symbols that are collided and fully faded out
@@ -390,8 +404,8 @@ namespace mbgl {
             // Awkward... but we're counting on the paired "vertical" symbol coming immediately after its horizontal counterpart
             useVertical = false;
             
-			vec4 anchorPos = {{ placedSymbol.anchorPoint.x, placedSymbol.anchorPoint.y, 0, 1 }};
-            matrix::transformMat4(anchorPos, anchorPos, posMatrix);
+            // The z component isn't used.
+            const vec4 anchorPos = {{ projectedAnchors.x[i], projectedAnchors.y[i], 0, projectedAnchors.w[i] }};
 
             // Don't bother calculating the correct point for invisible labels.
             if (!isVisible(anchorPos, clippingBuffer)) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/util/mat4.hpp>
+#include <mbgl/util/transform_points.hpp>
 #include <mbgl/gfx/vertex_buffer.hpp>
 #include <mbgl/programs/symbol_program.hpp>
 
@@ -46,7 +47,12 @@ namespace mbgl {
     using PointAndCameraDistance = std::pair<Point<float>,float>;
     PointAndCameraDistance project(const Point<float>& point, const mat4& matrix);
 
+    // Transforms the anchors of the given symbols by `posMatrix` in one batch.
+    util::TransformedPoints projectAnchors(const std::vector<PlacedSymbol>&, const mat4& posMatrix);
+
+    // `projectedAnchors` are the anchors of the symbols, transformed by `posMatrix`; see projectAnchors().
     void reprojectLineLabels(gfx::VertexVector<gfx::Vertex<SymbolDynamicLayoutAttributes>>&, const std::vector<PlacedSymbol>&,
+            const util::TransformedPoints& projectedAnchors,
             const mat4& posMatrix, bool pitchWithMap, bool rotateWithMap, bool keepUpright,
             const RenderTile&, const SymbolSizeBinder& sizeBinder, const TransformState&);
     
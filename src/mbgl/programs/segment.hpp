@@ -45,4 +45,16 @@ public:
 template <class AttributeList>
 using SegmentVector = std::vector<Segment<AttributeList>>;
 
+// Returns a copy of the segments without their draw scopes, which belong to the original.
+template <class AttributeList>
+SegmentVector<AttributeList> copySegments(const SegmentVector<AttributeList>& segments) {
+    SegmentVector<AttributeList> result;
+    result.reserve(segments.size());
+    for (const auto& segment : segments) {
+        result.emplace_back(segment.vertexOffset, segment.indexOffset,
+                            segment.vertexLength, segment.indexLength, segment.sortKey);
+    }
+    return result;
+}
+
 } // namespace mbgl
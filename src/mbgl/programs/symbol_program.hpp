@@ -7,6 +7,7 @@
 #include <mbgl/programs/collision_box_program.hpp>
 #include <mbgl/programs/uniforms.hpp>
 #include <mbgl/programs/textures.hpp>
+#include <mbgl/recording/program.hpp>
 #include <mbgl/programs/segment.hpp>
 #include <mbgl/util/geometry.hpp>
 #include <mbgl/util/size.hpp>
@@ -123,7 +124,7 @@ public:
             const Range<float>& zoomLevels = std::get<0>(*coveringRanges);
             const Range<float>& sizeLevels = std::get<1>(*coveringRanges);
             float t = util::clamp(
-                expression->interpolationFactor(zoomLevels, currentZoom),
+                expression->memoizedInterpolationFactor(zoomLevels, currentZoom),
                 0.0f, 1.0f
             );
             size = sizeLevels.min + t * (sizeLevels.max - sizeLevels.min);
@@ -180,7 +181,7 @@ public:
 
     ZoomEvaluatedSize evaluateForZoom(float currentZoom) const override {
         float sizeInterpolationT = util::clamp(
-            expression.interpolationFactor(coveringZoomStops, currentZoom),
+            expression.memoizedInterpolationFactor(coveringZoomStops, currentZoom),
             0.0f, 1.0f
         );
 
@@ -0,0 +1,32 @@
+#include <mbgl/recording/command_encoder.hpp>
+#include <mbgl/recording/upload_pass.hpp>
+#include <mbgl/recording/render_pass.hpp>
+#include <mbgl/recording/context.hpp>
+
+namespace mbgl {
+namespace recording {
+
+std::unique_ptr<gfx::UploadPass>
+CommandEncoder::createUploadPass(const char* name) {
+    return std::make_unique<recording::UploadPass>(*this, name);
+}
+
+std::unique_ptr<gfx::RenderPass>
+CommandEncoder::createRenderPass(const char* name, const gfx::RenderPassDescriptor& descriptor) {
+    return std::make_unique<recording::RenderPass>(*this, name, descriptor);
+}
+
+void CommandEncoder::present(gfx::Renderable&) {
+    // no-op
+}
+
+void CommandEncoder::pushDebugGroup(const char*) {
+    ++context.statistics.debugGroups;
+}
+
+void CommandEncoder::popDebugGroup() {
+    // no-op
+}
+
+} // namespace recording
+} // namespace mbgl
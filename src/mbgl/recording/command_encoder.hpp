@@ -0,0 +1,31 @@
+#pragma once
+
+#include <mbgl/gfx/command_encoder.hpp>
+
+namespace mbgl {
+namespace recording {
+
+class Context;
+
+class CommandEncoder final : public gfx::CommandEncoder {
+public:
+    explicit CommandEncoder(recording::Context& context_) : context(context_) {
+    }
+
+    friend class UploadPass;
+    friend class RenderPass;
+
+    std::unique_ptr<gfx::UploadPass> createUploadPass(const char* name) override;
+    std::unique_ptr<gfx::RenderPass> createRenderPass(const char* name, const gfx::RenderPassDescriptor&) override;
+    void present(gfx::Renderable&) override;
+
+private:
+    void pushDebugGroup(const char* name) override;
+    void popDebugGroup() override;
+
+public:
+    recording::Context& context;
+};
+
+} // namespace recording
+} // namespace mbgl
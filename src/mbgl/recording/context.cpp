@@ -0,0 +1,165 @@
+#include <mbgl/recording/context.hpp>
+#include <mbgl/recording/command_encoder.hpp>
+#include <mbgl/recording/offscreen_texture.hpp>
+#include <mbgl/recording/resources.hpp>
+
+#include <cassert>
+#include <tuple>
+
+namespace mbgl {
+namespace recording {
+
+namespace {
+
+// The GL backend doesn't issue calls for modes that are equal to the current ones. These compare
+// the parts of the modes it sets.
+
+bool operator==(const gfx::DepthMode& a, const gfx::DepthMode& b) {
+    return a.func == b.func && a.mask == b.mask && a.range == b.range;
+}
+
+auto stencilTest(const gfx::StencilMode& stencil) {
+    return apply_visitor([&](const auto& test) {
+        return std::make_tuple(gfx::StencilFunctionType(test.func), stencil.ref, uint32_t(test.mask));
+    }, stencil.test);
+}
+
+bool operator==(const gfx::StencilMode& a, const gfx::StencilMode& b) {
+    const bool test = !a.test.is<gfx::StencilMode::Always>() || a.mask;
+    if (test != (!b.test.is<gfx::StencilMode::Always>() || b.mask)) {
+        return false;
+    }
+    return !test || (stencilTest(a) == stencilTest(b) && a.mask == b.mask && a.fail == b.fail &&
+                     a.depthFail == b.depthFail && a.pass == b.pass);
+}
+
+auto blendFunction(const gfx::ColorMode& color) {
+    return apply_visitor([](const auto& function) {
+        return std::make_tuple(gfx::ColorBlendEquationType(function.equation),
+                               gfx::ColorBlendFactorType(function.srcFactor),
+                               gfx::ColorBlendFactorType(function.dstFactor));
+    }, color.blendFunction);
+}
+
+bool operator==(const gfx::ColorMode& a, const gfx::ColorMode& b) {
+    const bool blend = !a.blendFunction.is<gfx::ColorMode::Replace>();
+    if (blend != !b.blendFunction.is<gfx::ColorMode::Replace>()) {
+        return false;
+    }
+    if (blend && (blendFunction(a) != blendFunction(b) || a.blendColor != b.blendColor)) {
+        return false;
+    }
+    return !(a.mask != b.mask);
+}
+
+bool operator==(const gfx::CullFaceMode& a, const gfx::CullFaceMode& b) {
+    return a.enabled == b.enabled && a.side == b.side && a.winding == b.winding;
+}
+
+// Replaces the current mode with the one of a draw call, and returns whether it changed.
+template <class Mode>
+bool change(optional<Mode>& current, const Mode& mode) {
+    if (current && *current == mode) {
+        return false;
+    }
+    current = mode;
+    return true;
+}
+
+} // namespace
+
+// Reports as many vertex attributes as GPUs commonly provide, so that the renderer skips the
+// layers it would skip with them.
+Context::Context(Statistics& statistics_)
+    : gfx::Context(16, true), statistics(statistics_) {
+    supportsHalfFloatTextures = true;
+}
+
+Context::~Context() = default;
+
+void Context::performCleanup() {
+    // no-op
+}
+
+std::unique_ptr<gfx::OffscreenTexture>
+Context::createOffscreenTexture(const Size size, const gfx::TextureChannelDataType type) {
+    return std::make_unique<recording::OffscreenTexture>(*this, size, type);
+}
+
+std::unique_ptr<gfx::OffscreenTexture>
+Context::createOffscreenTexture(const Size size,
+                                gfx::Renderbuffer<gfx::RenderbufferPixelType::Depth>&,
+                                const gfx::TextureChannelDataType type) {
+    return std::make_unique<recording::OffscreenTexture>(*this, size, type);
+}
+
+std::unique_ptr<gfx::TextureResource>
+Context::createTextureResource(const Size size, gfx::TexturePixelType, gfx::TextureChannelDataType) {
+    return std::make_unique<recording::TextureResource>(size);
+}
+
+std::unique_ptr<gfx::RenderbufferResource>
+Context::createRenderbufferResource(gfx::RenderbufferPixelType, Size) {
+    return std::make_unique<recording::RenderbufferResource>();
+}
+
+std::unique_ptr<gfx::DrawScopeResource> Context::createDrawScopeResource() {
+    return std::make_unique<recording::DrawScopeResource>();
+}
+
+std::unique_ptr<gfx::CommandEncoder> Context::createCommandEncoder() {
+    ++statistics.commandEncoders;
+    return std::make_unique<recording::CommandEncoder>(*this);
+}
+
+void Context::draw(const void* program_,
+                   const gfx::DrawMode&,
+                   const gfx::DepthMode& depthMode_,
+                   const gfx::StencilMode& stencilMode_,
+                   const gfx::ColorMode& colorMode_,
+                   const gfx::CullFaceMode& cullFaceMode_,
+                   std::size_t,
+                   std::size_t indexLength) {
+    ++statistics.drawCalls;
+    statistics.indices += indexLength;
+
+    if (program != program_) {
+        program = program_;
+        ++statistics.stateChanges;
+    }
+    statistics.stateChanges += change(depthMode, depthMode_);
+    statistics.stateChanges += change(stencilMode, stencilMode_);
+    statistics.stateChanges += change(colorMode, colorMode_);
+    statistics.stateChanges += change(cullFaceMode, cullFaceMode_);
+}
+
+#if not defined(NDEBUG)
+void Context::visualizeStencilBuffer() {
+    // no-op
+}
+
+void Context::visualizeDepthBuffer(float) {
+    // no-op
+}
+#endif
+
+void Context::clearStencilBuffer(int32_t) {
+    // no-op
+}
+
+void draw(gfx::Context& context,
+          const void* program,
+          const gfx::DrawMode& drawMode,
+          const gfx::DepthMode& depthMode,
+          const gfx::StencilMode& stencilMode,
+          const gfx::ColorMode& colorMode,
+          const gfx::CullFaceMode& cullFaceMode,
+          std::size_t indexOffset,
+          std::size_t indexLength) {
+    assert(context.recordsDraws);
+    static_cast<recording::Context&>(context).draw(program, drawMode, depthMode, stencilMode,
+                                                   colorMode, cullFaceMode, indexOffset, indexLength);
+}
+
+} // namespace recording
+} // namespace mbgl
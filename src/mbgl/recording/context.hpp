@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mbgl/gfx/context.hpp>
+#include <mbgl/gfx/color_mode.hpp>
+#include <mbgl/gfx/cull_face_mode.hpp>
+#include <mbgl/gfx/depth_mode.hpp>
+#include <mbgl/gfx/stencil_mode.hpp>
+#include <mbgl/recording/statistics.hpp>
+#include <mbgl/util/optional.hpp>
+
+namespace mbgl {
+namespace recording {
+
+// A context that doesn't need a GPU. It implements the gfx interface by counting the commands it
+// receives in the statistics of its backend, and so makes the CPU side cost of rendering a frame
+// measurable on its own.
+class Context final : public gfx::Context {
+public:
+    explicit Context(Statistics&);
+    ~Context() override;
+
+    void performCleanup() override;
+
+    std::unique_ptr<gfx::OffscreenTexture> createOffscreenTexture(
+        Size, gfx::TextureChannelDataType = gfx::TextureChannelDataType::UnsignedByte) override;
+    std::unique_ptr<gfx::OffscreenTexture> createOffscreenTexture(
+        Size,
+        gfx::Renderbuffer<gfx::RenderbufferPixelType::Depth>&,
+        gfx::TextureChannelDataType = gfx::TextureChannelDataType::UnsignedByte) override;
+
+    std::unique_ptr<gfx::CommandEncoder> createCommandEncoder() override;
+
+    void draw(const void* program,
+              const gfx::DrawMode&,
+              const gfx::DepthMode&,
+              const gfx::StencilMode&,
+              const gfx::ColorMode&,
+              const gfx::CullFaceMode&,
+              std::size_t indexOffset,
+              std::size_t indexLength);
+
+#if not defined(NDEBUG)
+    void visualizeStencilBuffer() override;
+    void visualizeDepthBuffer(float depthRangeSize) override;
+#endif
+
+    void clearStencilBuffer(int32_t) override;
+
+    Statistics& statistics;
+
+private:
+    std::unique_ptr<gfx::TextureResource>
+        createTextureResource(Size, gfx::TexturePixelType, gfx::TextureChannelDataType) override;
+    std::unique_ptr<gfx::RenderbufferResource>
+        createRenderbufferResource(gfx::RenderbufferPixelType, Size) override;
+    std::unique_ptr<gfx::DrawScopeResource> createDrawScopeResource() override;
+
+    // The state of the previous draw call.
+    const void* program = nullptr;
+    optional<gfx::DepthMode> depthMode;
+    optional<gfx::StencilMode> stencilMode;
+    optional<gfx::ColorMode> colorMode;
+    optional<gfx::CullFaceMode> cullFaceMode;
+};
+
+} // namespace recording
+} // namespace mbgl
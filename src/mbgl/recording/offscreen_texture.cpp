@@ -0,0 +1,27 @@
+#include <mbgl/recording/offscreen_texture.hpp>
+#include <mbgl/recording/context.hpp>
+
+namespace mbgl {
+namespace recording {
+
+OffscreenTexture::OffscreenTexture(recording::Context& context,
+                                   const Size size_,
+                                   const gfx::TextureChannelDataType type)
+    : gfx::OffscreenTexture(size_, nullptr),
+      texture(context.createTexture(size_, gfx::TexturePixelType::RGBA, type)) {
+}
+
+bool OffscreenTexture::isRenderable() {
+    return true;
+}
+
+PremultipliedImage OffscreenTexture::readStillImage() {
+    return PremultipliedImage(size);
+}
+
+gfx::Texture& OffscreenTexture::getTexture() {
+    return texture;
+}
+
+} // namespace recording
+} // namespace mbgl
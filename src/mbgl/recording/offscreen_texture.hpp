@@ -0,0 +1,28 @@
+#pragma once
+
+#include <mbgl/gfx/offscreen_texture.hpp>
+#include <mbgl/gfx/texture.hpp>
+
+namespace mbgl {
+namespace recording {
+
+class Context;
+
+class OffscreenTexture final : public gfx::OffscreenTexture {
+public:
+    OffscreenTexture(recording::Context&,
+                     Size size,
+                     gfx::TextureChannelDataType type = gfx::TextureChannelDataType::UnsignedByte);
+
+    bool isRenderable() override;
+
+    // Returns a transparent image, since nothing is drawn.
+    PremultipliedImage readStillImage() override;
+    gfx::Texture& getTexture() override;
+
+private:
+    gfx::Texture texture;
+};
+
+} // namespace recording
+} // namespace mbgl
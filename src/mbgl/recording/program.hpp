@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mbgl/gfx/program.hpp>
+
+#include <memory>
+
+namespace mbgl {
+namespace recording {
+
+// Records a draw call with the recording::Context that `context` is.
+void draw(gfx::Context& context,
+          const void* program,
+          const gfx::DrawMode&,
+          const gfx::DepthMode&,
+          const gfx::StencilMode&,
+          const gfx::ColorMode&,
+          const gfx::CullFaceMode&,
+          std::size_t indexOffset,
+          std::size_t indexLength);
+
+// Programs of the recording backend don't compile shaders, and don't look at the uniforms,
+// attributes and textures they are drawn with, so a single implementation serves all of them.
+template <class Name>
+class Program final : public gfx::Program<Name> {
+public:
+    using AttributeList = typename Name::AttributeList;
+    using UniformList = typename Name::UniformList;
+    using TextureList = typename Name::TextureList;
+
+    void draw(gfx::Context& context,
+              gfx::RenderPass&,
+              const gfx::DrawMode& drawMode,
+              const gfx::DepthMode& depthMode,
+              const gfx::StencilMode& stencilMode,
+              const gfx::ColorMode& colorMode,
+              const gfx::CullFaceMode& cullFaceMode,
+              const gfx::UniformValues<UniformList>&,
+              gfx::DrawScope&,
+              const gfx::AttributeBindings<AttributeList>&,
+              const gfx::TextureBindings<TextureList>&,
+              const gfx::IndexBuffer&,
+              std::size_t indexOffset,
+              std::size_t indexLength) override {
+        recording::draw(context, this, drawMode, depthMode, stencilMode, colorMode, cullFaceMode,
+                        indexOffset, indexLength);
+    }
+};
+
+template <class Name>
+std::unique_ptr<gfx::Program<Name>> createProgram() {
+    return std::make_unique<Program<Name>>();
+}
+
+} // namespace recording
+} // namespace mbgl
@@ -0,0 +1,24 @@
+#include <mbgl/recording/render_pass.hpp>
+#include <mbgl/recording/command_encoder.hpp>
+#include <mbgl/recording/context.hpp>
+
+namespace mbgl {
+namespace recording {
+
+RenderPass::RenderPass(recording::CommandEncoder& commandEncoder_,
+                       const char* name,
+                       const gfx::RenderPassDescriptor&)
+    : commandEncoder(commandEncoder_), debugGroup(commandEncoder.createDebugGroup(name)) {
+    ++commandEncoder.context.statistics.renderPasses;
+}
+
+void RenderPass::pushDebugGroup(const char* name) {
+    commandEncoder.pushDebugGroup(name);
+}
+
+void RenderPass::popDebugGroup() {
+    commandEncoder.popDebugGroup();
+}
+
+} // namespace recording
+} // namespace mbgl
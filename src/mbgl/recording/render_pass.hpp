@@ -0,0 +1,30 @@
+#pragma once
+
+#include <mbgl/gfx/render_pass.hpp>
+
+namespace mbgl {
+namespace gfx {
+
+class CommandEncoder;
+
+} // namespace gfx
+
+namespace recording {
+
+class CommandEncoder;
+
+class RenderPass final : public gfx::RenderPass {
+public:
+    RenderPass(recording::CommandEncoder&, const char* name, const gfx::RenderPassDescriptor&);
+
+private:
+    void pushDebugGroup(const char* name) override;
+    void popDebugGroup() override;
+
+private:
+    recording::CommandEncoder& commandEncoder;
+    const gfx::DebugGroup<gfx::CommandEncoder> debugGroup;
+};
+
+} // namespace recording
+} // namespace mbgl
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mbgl/gfx/draw_scope.hpp>
+#include <mbgl/gfx/index_buffer.hpp>
+#include <mbgl/gfx/renderbuffer.hpp>
+#include <mbgl/gfx/texture.hpp>
+#include <mbgl/gfx/vertex_buffer.hpp>
+#include <mbgl/util/size.hpp>
+
+#include <cstddef>
+
+namespace mbgl {
+namespace recording {
+
+// Resources of the recording backend only remember their sizes, for checking updates.
+
+class VertexBufferResource final : public gfx::VertexBufferResource {
+public:
+    explicit VertexBufferResource(std::size_t size_) : size(size_) {
+    }
+
+    const std::size_t size;
+};
+
+class IndexBufferResource final : public gfx::IndexBufferResource {
+public:
+    explicit IndexBufferResource(std::size_t size_) : size(size_) {
+    }
+
+    const std::size_t size;
+};
+
+class TextureResource final : public gfx::TextureResource {
+public:
+    explicit TextureResource(Size size_) : size(size_) {
+    }
+
+    Size size;
+};
+
+class RenderbufferResource final : public gfx::RenderbufferResource {
+};
+
+class DrawScopeResource final : public gfx::DrawScopeResource {
+};
+
+} // namespace recording
+} // namespace mbgl
@@ -0,0 +1,132 @@
+#include <mbgl/recording/upload_pass.hpp>
+#include <mbgl/recording/command_encoder.hpp>
+#include <mbgl/recording/context.hpp>
+#include <mbgl/recording/resources.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+namespace recording {
+
+namespace {
+
+std::size_t channelCount(const gfx::TexturePixelType format) {
+    switch (format) {
+    case gfx::TexturePixelType::RGBA:
+        return 4;
+    case gfx::TexturePixelType::Depth:
+        return 2;
+    case gfx::TexturePixelType::Alpha:
+    case gfx::TexturePixelType::Stencil:
+    case gfx::TexturePixelType::Luminance:
+        return 1;
+    }
+    return 1;
+}
+
+std::size_t channelSize(const gfx::TextureChannelDataType type) {
+    return type == gfx::TextureChannelDataType::HalfFloat ? 2 : 1;
+}
+
+} // namespace
+
+UploadPass::UploadPass(recording::CommandEncoder& commandEncoder_, const char* name)
+    : commandEncoder(commandEncoder_), debugGroup(commandEncoder.createDebugGroup(name)) {
+    ++commandEncoder.context.statistics.uploadPasses;
+}
+
+std::unique_ptr<gfx::VertexBufferResource> UploadPass::createVertexBufferResource(
+    const void*, const std::size_t size, const gfx::BufferUsageType) {
+    recordBuffer(size);
+    return std::make_unique<recording::VertexBufferResource>(size);
+}
+
+void UploadPass::updateVertexBufferResource(gfx::VertexBufferResource& resource,
+                                            const void*,
+                                            const std::size_t size) {
+    assert(size <= static_cast<recording::VertexBufferResource&>(resource).size);
+    (void)resource;
+    recordBuffer(size);
+}
+
+void UploadPass::updateVertexBufferResourceSub(gfx::VertexBufferResource& resource,
+                                               const std::size_t offset,
+                                               const void*,
+                                               const std::size_t size) {
+    assert(offset + size <= static_cast<recording::VertexBufferResource&>(resource).size);
+    (void)resource;
+    (void)offset;
+    recordBuffer(size);
+}
+
+std::unique_ptr<gfx::IndexBufferResource> UploadPass::createIndexBufferResource(
+    const void*, const std::size_t size, const gfx::BufferUsageType) {
+    recordBuffer(size);
+    return std::make_unique<recording::IndexBufferResource>(size);
+}
+
+void UploadPass::updateIndexBufferResource(gfx::IndexBufferResource& resource,
+                                           const void*,
+                                           const std::size_t size) {
+    assert(size <= static_cast<recording::IndexBufferResource&>(resource).size);
+    (void)resource;
+    recordBuffer(size);
+}
+
+std::unique_ptr<gfx::TextureResource>
+UploadPass::createTextureResource(const Size size,
+                                  const void*,
+                                  gfx::TexturePixelType format,
+                                  gfx::TextureChannelDataType type) {
+    recordTexture(size, format, type);
+    return std::make_unique<recording::TextureResource>(size);
+}
+
+void UploadPass::updateTextureResource(gfx::TextureResource& resource,
+                                       const Size size,
+                                       const void*,
+                                       gfx::TexturePixelType format,
+                                       gfx::TextureChannelDataType type) {
+    static_cast<recording::TextureResource&>(resource).size = size;
+    recordTexture(size, format, type);
+}
+
+void UploadPass::updateTextureResourceSub(gfx::TextureResource& resource,
+                                          const uint16_t xOffset,
+                                          const uint16_t yOffset,
+                                          const Size size,
+                                          const void*,
+                                          gfx::TexturePixelType format,
+                                          gfx::TextureChannelDataType type) {
+    assert(xOffset + size.width <= static_cast<recording::TextureResource&>(resource).size.width);
+    assert(yOffset + size.height <= static_cast<recording::TextureResource&>(resource).size.height);
+    (void)resource;
+    (void)xOffset;
+    (void)yOffset;
+    recordTexture(size, format, type);
+}
+
+void UploadPass::recordBuffer(const std::size_t size) {
+    Statistics& statistics = commandEncoder.context.statistics;
+    ++statistics.bufferUploads;
+    statistics.bufferUploadBytes += size;
+}
+
+void UploadPass::recordTexture(const Size size,
+                               const gfx::TexturePixelType format,
+                               const gfx::TextureChannelDataType type) {
+    Statistics& statistics = commandEncoder.context.statistics;
+    ++statistics.textureUploads;
+    statistics.textureUploadBytes += size.area() * channelCount(format) * channelSize(type);
+}
+
+void UploadPass::pushDebugGroup(const char* name) {
+    commandEncoder.pushDebugGroup(name);
+}
+
+void UploadPass::popDebugGroup() {
+    commandEncoder.popDebugGroup();
+}
+
+} // namespace recording
+} // namespace mbgl
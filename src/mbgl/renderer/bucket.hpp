@@ -1,6 +1,11 @@
 #pragma once
 
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/gfx/index_buffer.hpp>
+#include <mbgl/gfx/index_vector.hpp>
+#include <mbgl/gfx/texture.hpp>
+#include <mbgl/gfx/vertex_buffer.hpp>
+#include <mbgl/gfx/vertex_vector.hpp>
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/style/layer_impl.hpp>
@@ -50,6 +55,12 @@ public:
     bool needsUpload() const {
         return hasData() && !uploaded;
     }
+
+    // The approximate number of bytes used by the bucket's vertices, indices and images, in
+    // memory and in uploaded buffers and textures.
+    virtual std::size_t getMemoryUse() const {
+        return 0;
+    }
    
     // The following methods are implemented by buckets that require cross-tile indexing and placement.
 
@@ -61,10 +72,29 @@ public:
     }
     // Places this bucket to the given placement.
     virtual void place(Placement&, const BucketPlacementParameters&, std::set<uint32_t>&) {}
-    virtual void updateVertices(Placement&, bool /*updateOpacities*/, const TransformState&, const RenderTile&, std::set<uint32_t>&) {}
+    // Updates the opacities of the symbols from the given placement.
+    virtual void updateOpacities(Placement&, const TransformState&, std::set<uint32_t>&) {}
+    // Updates the vertices that depend on the camera. Different buckets may be updated concurrently.
+    virtual void updateDynamicVertices(Placement&, const TransformState&, const RenderTile&) {}
 
 protected:
     Bucket() = default;
+
+    template <class Vertex>
+    static std::size_t bytes(const gfx::VertexVector<Vertex>& vertices, const optional<gfx::VertexBuffer<Vertex>>& buffer) {
+        return vertices.bytes() + (buffer ? buffer->elements * sizeof(Vertex) : 0);
+    }
+
+    template <class DrawMode>
+    static std::size_t bytes(const gfx::IndexVector<DrawMode>& indices, const optional<gfx::IndexBuffer>& buffer) {
+        return indices.bytes() + (buffer ? buffer->elements * sizeof(uint16_t) : 0);
+    }
+
+    // Textures are assumed to be RGBA.
+    static std::size_t bytes(const optional<gfx::Texture>& texture) {
+        return texture ? texture->size.area() * 4 : 0;
+    }
+
     std::atomic<bool> uploaded { false };
 };
 
@@ -0,0 +1,103 @@
+#include <mbgl/renderer/bucket_cache.hpp>
+#include <mbgl/util/hash.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+constexpr std::size_t BucketCache::DefaultMaximumSize;
+
+bool BucketCache::Key::operator==(const Key& other) const {
+    return dataHash == other.dataHash &&
+           tileID == other.tileID &&
+           pixelRatio == other.pixelRatio &&
+           layoutKey == other.layoutKey;
+}
+
+std::size_t BucketCache::KeyHash::operator()(const Key& key) const {
+    return util::hash(key.dataHash, key.layoutKey, key.tileID, key.pixelRatio);
+}
+
+BucketCache& BucketCache::get() {
+    static BucketCache instance;
+    return instance;
+}
+
+std::shared_ptr<const BucketCache::Entry> BucketCache::find(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = index.find(key);
+    if (it == index.end()) {
+        statistics.misses++;
+        return nullptr;
+    }
+
+    statistics.hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+void BucketCache::insert(Key key, std::shared_ptr<const Entry> entry) {
+    const std::size_t bytes = entry->bytes();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Another worker tessellated the same geometry concurrently.
+        size -= it->second->second->bytes();
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    if (bytes > maximumSize) {
+        return;
+    }
+
+    entries.emplace_front(std::move(key), std::move(entry));
+    index.emplace(entries.front().first, entries.begin());
+    size += bytes;
+
+    evict();
+}
+
+void BucketCache::setMaximumSize(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumSize = bytes;
+    evict();
+}
+
+std::size_t BucketCache::getMaximumSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return maximumSize;
+}
+
+std::size_t BucketCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+BucketCache::Statistics BucketCache::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
+
+void BucketCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    size = 0;
+    statistics = {};
+}
+
+void BucketCache::evict() {
+    while (size > maximumSize) {
+        assert(!entries.empty());
+        size -= entries.back().second->bytes();
+        index.erase(entries.back().first);
+        entries.pop_back();
+        statistics.evictions++;
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace mbgl {
+
+// A process-wide cache of tessellated bucket geometry. Tiles that are parsed with identical
+// data and layout properties share the result of tessellating their features, whether they
+// belong to different Map instances using the same style, or to one Map that parses a tile
+// again after e.g. a paint property changed.
+//
+// Only geometry that doesn't depend on paint properties or on a graphics context is cached:
+// each bucket gets a copy of the cached vertices and indices, which it later moves into its
+// own buffers, and populates its own paint property binders.
+//
+// Caching costs a copy of the geometry of every bucket that isn't found, so the cache is
+// disabled until setMaximumSize() gives it a size, e.g. by applications that render the same
+// style in several maps.
+class BucketCache {
+public:
+    class Key {
+    public:
+        // Hash of the encoded tile data.
+        uint64_t dataHash;
+        // The layout key of the bucket's layer group; see layoutKey().
+        std::string layoutKey;
+        OverscaledTileID tileID;
+        float pixelRatio;
+
+        bool operator==(const Key&) const;
+    };
+
+    class Entry {
+    public:
+        virtual ~Entry() = default;
+
+        // The approximate number of bytes used by this entry.
+        virtual std::size_t bytes() const = 0;
+    };
+
+    class Statistics {
+    public:
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+    };
+
+    static constexpr std::size_t DefaultMaximumSize = 0;
+
+    static BucketCache& get();
+
+    // Returns the entry for the given key, or nullptr. Entries are reference counted, so an
+    // entry that is evicted while a bucket is restored from it stays valid.
+    std::shared_ptr<const Entry> find(const Key&);
+
+    // Adds an entry and evicts the least recently used entries until the cache fits into its
+    // maximum size again. Entries that are larger than the maximum size aren't added.
+    void insert(Key, std::shared_ptr<const Entry>);
+
+    // A maximum size of zero disables the cache.
+    void setMaximumSize(std::size_t bytes);
+    std::size_t getMaximumSize() const;
+
+    // The total number of bytes used by all entries.
+    std::size_t getSize() const;
+
+    Statistics getStatistics() const;
+
+    void clear();
+
+private:
+    BucketCache() = default;
+
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    using Entries = std::list<std::pair<Key, std::shared_ptr<const Entry>>>;
+
+    void evict();
+
+    mutable std::mutex mutex;
+
+    // Ordered from most recently to least recently used.
+    Entries entries;
+    std::unordered_map<Key, Entries::iterator, KeyHash> index;
+
+    std::size_t size = 0;
+    std::size_t maximumSize = DefaultMaximumSize;
+    Statistics statistics;
+};
+
+} // namespace mbgl
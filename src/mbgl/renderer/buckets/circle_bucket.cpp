@@ -35,6 +35,10 @@ void CircleBucket::upload(gfx::UploadPass& uploadPass) {
     uploaded = true;
 }
 
+std::size_t CircleBucket::getMemoryUse() const {
+    return bytes(vertices, vertexBuffer) + bytes(triangles, indexBuffer);
+}
+
 bool CircleBucket::hasData() const {
     return !segments.empty();
 }
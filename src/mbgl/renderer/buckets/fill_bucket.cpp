@@ -48,6 +48,12 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
                             const GeometryCollection& geometry,
                             const ImagePositions& patternPositions,
                             const PatternLayerMap& patternDependencies) {
+    addFeatureGeometry(feature, geometry);
+    addPaintProperties(feature, vertices.elements(), patternPositions, patternDependencies);
+}
+
+void FillBucket::addFeatureGeometry(const GeometryTileFeature&,
+                                    const GeometryCollection& geometry) {
     for (auto& polygon : classifyRings(geometry)) {
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
@@ -110,17 +116,73 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndicies;
     }
+}
 
+void FillBucket::addPaintProperties(const GeometryTileFeature& feature,
+                                    std::size_t vertexEnd,
+                                    const ImagePositions& patternPositions,
+                                    const PatternLayerMap& patternDependencies) {
     for (auto& pair : paintPropertyBinders) {
         const auto it = patternDependencies.find(pair.first);
         if (it != patternDependencies.end()){
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, it->second);
+            pair.second.populateVertexVectors(feature, vertexEnd, patternPositions, it->second);
         } else {
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, {});
+            pair.second.populateVertexVectors(feature, vertexEnd, patternPositions, {});
         }
     }
 }
 
+void FillBucket::addPaintProperties(const std::vector<const GeometryTileFeature*>& features,
+                                    const std::vector<std::size_t>& vertexEnds,
+                                    const ImagePositions& patternPositions,
+                                    const std::vector<const PatternLayerMap*>& patternDependencies) {
+    std::vector<const PatternDependency*> layerPatternDependencies(features.size());
+    for (auto& pair : paintPropertyBinders) {
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            const auto it = patternDependencies[i]->find(pair.first);
+            layerPatternDependencies[i] = it != patternDependencies[i]->end() ? &it->second : nullptr;
+        }
+        pair.second.populateVertexVectors(features, vertexEnds, patternPositions, layerPatternDependencies);
+    }
+}
+
+class FillBucket::Geometry final : public BucketCache::Entry {
+public:
+    gfx::VertexVector<FillLayoutVertex> vertices;
+    gfx::IndexVector<gfx::Lines> lines;
+    gfx::IndexVector<gfx::Triangles> triangles;
+    SegmentVector<FillAttributes> lineSegments;
+    SegmentVector<FillAttributes> triangleSegments;
+    std::vector<std::size_t> featureVertexEnds;
+
+    std::size_t bytes() const override {
+        return vertices.bytes() + lines.bytes() + triangles.bytes() +
+               (lineSegments.size() + triangleSegments.size()) * sizeof(Segment<FillAttributes>) +
+               featureVertexEnds.size() * sizeof(std::size_t);
+    }
+};
+
+std::shared_ptr<const BucketCache::Entry> FillBucket::saveGeometry(std::vector<std::size_t> featureVertexEnds) const {
+    auto geometry = std::make_shared<Geometry>();
+    geometry->vertices = vertices;
+    geometry->lines = lines;
+    geometry->triangles = triangles;
+    geometry->lineSegments = copySegments(lineSegments);
+    geometry->triangleSegments = copySegments(triangleSegments);
+    geometry->featureVertexEnds = std::move(featureVertexEnds);
+    return geometry;
+}
+
+const std::vector<std::size_t>& FillBucket::restoreGeometry(const BucketCache::Entry& entry) {
+    const auto& geometry = static_cast<const Geometry&>(entry);
+    vertices = geometry.vertices;
+    lines = geometry.lines;
+    triangles = geometry.triangles;
+    lineSegments = copySegments(geometry.lineSegments);
+    triangleSegments = copySegments(geometry.triangleSegments);
+    return geometry.featureVertexEnds;
+}
+
 void FillBucket::upload(gfx::UploadPass& uploadPass) {
     vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
     lineIndexBuffer = uploadPass.createIndexBuffer(std::move(lines));
@@ -133,6 +195,10 @@ void FillBucket::upload(gfx::UploadPass& uploadPass) {
     uploaded = true;
 }
 
+std::size_t FillBucket::getMemoryUse() const {
+    return bytes(vertices, vertexBuffer) + bytes(lines, lineIndexBuffer) + bytes(triangles, triangleIndexBuffer);
+}
+
 bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !lineSegments.empty();
 }
@@ -54,6 +54,12 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
                                      const GeometryCollection& geometry,
                                      const ImagePositions& patternPositions,
                                      const PatternLayerMap& patternDependencies) {
+    addFeatureGeometry(feature, geometry);
+    addPaintProperties(feature, vertices.elements(), patternPositions, patternDependencies);
+}
+
+void FillExtrusionBucket::addFeatureGeometry(const GeometryTileFeature&,
+                                             const GeometryCollection& geometry) {
     for (auto& polygon : classifyRings(geometry)) {
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
@@ -154,17 +160,67 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndices;
     }
+}
 
+void FillExtrusionBucket::addPaintProperties(const GeometryTileFeature& feature,
+                                             std::size_t vertexEnd,
+                                             const ImagePositions& patternPositions,
+                                             const PatternLayerMap& patternDependencies) {
     for (auto& pair : paintPropertyBinders) {
         const auto it = patternDependencies.find(pair.first);
         if (it != patternDependencies.end()){
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, it->second);
+            pair.second.populateVertexVectors(feature, vertexEnd, patternPositions, it->second);
         } else {
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, {});
+            pair.second.populateVertexVectors(feature, vertexEnd, patternPositions, {});
         }
     }
 }
 
+void FillExtrusionBucket::addPaintProperties(const std::vector<const GeometryTileFeature*>& features,
+                                             const std::vector<std::size_t>& vertexEnds,
+                                             const ImagePositions& patternPositions,
+                                             const std::vector<const PatternLayerMap*>& patternDependencies) {
+    std::vector<const PatternDependency*> layerPatternDependencies(features.size());
+    for (auto& pair : paintPropertyBinders) {
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            const auto it = patternDependencies[i]->find(pair.first);
+            layerPatternDependencies[i] = it != patternDependencies[i]->end() ? &it->second : nullptr;
+        }
+        pair.second.populateVertexVectors(features, vertexEnds, patternPositions, layerPatternDependencies);
+    }
+}
+
+class FillExtrusionBucket::Geometry final : public BucketCache::Entry {
+public:
+    gfx::VertexVector<FillExtrusionLayoutVertex> vertices;
+    gfx::IndexVector<gfx::Triangles> triangles;
+    SegmentVector<FillExtrusionAttributes> triangleSegments;
+    std::vector<std::size_t> featureVertexEnds;
+
+    std::size_t bytes() const override {
+        return vertices.bytes() + triangles.bytes() +
+               triangleSegments.size() * sizeof(Segment<FillExtrusionAttributes>) +
+               featureVertexEnds.size() * sizeof(std::size_t);
+    }
+};
+
+std::shared_ptr<const BucketCache::Entry> FillExtrusionBucket::saveGeometry(std::vector<std::size_t> featureVertexEnds) const {
+    auto geometry = std::make_shared<Geometry>();
+    geometry->vertices = vertices;
+    geometry->triangles = triangles;
+    geometry->triangleSegments = copySegments(triangleSegments);
+    geometry->featureVertexEnds = std::move(featureVertexEnds);
+    return geometry;
+}
+
+const std::vector<std::size_t>& FillExtrusionBucket::restoreGeometry(const BucketCache::Entry& entry) {
+    const auto& geometry = static_cast<const Geometry&>(entry);
+    vertices = geometry.vertices;
+    triangles = geometry.triangles;
+    triangleSegments = copySegments(geometry.triangleSegments);
+    return geometry.featureVertexEnds;
+}
+
 void FillExtrusionBucket::upload(gfx::UploadPass& uploadPass) {
     vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
     indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
@@ -176,6 +232,10 @@ void FillExtrusionBucket::upload(gfx::UploadPass& uploadPass) {
     uploaded = true;
 }
 
+std::size_t FillExtrusionBucket::getMemoryUse() const {
+    return bytes(vertices, vertexBuffer) + bytes(triangles, indexBuffer);
+}
+
 bool FillExtrusionBucket::hasData() const {
     return !triangleSegments.empty();
 }
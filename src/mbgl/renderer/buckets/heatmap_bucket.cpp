@@ -35,6 +35,10 @@ void HeatmapBucket::upload(gfx::UploadPass& uploadPass) {
     uploaded = true;
 }
 
+std::size_t HeatmapBucket::getMemoryUse() const {
+    return bytes(vertices, vertexBuffer) + bytes(triangles, indexBuffer);
+}
+
 bool HeatmapBucket::hasData() const {
     return !segments.empty();
 }
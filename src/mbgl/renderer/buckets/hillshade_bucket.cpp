@@ -110,6 +110,11 @@ void HillshadeBucket::setMask(TileMask&& mask_) {
     }
 }
 
+std::size_t HillshadeBucket::getMemoryUse() const {
+    return demdata.getImage()->bytes() + bytes(dem) + bytes(texture) +
+           bytes(vertices, vertexBuffer) + bytes(indices, indexBuffer);
+}
+
 bool HillshadeBucket::hasData() const {
     return demdata.getImage()->valid();
 }
@@ -34,20 +34,44 @@ void LineBucket::addFeature(const GeometryTileFeature& feature,
                             const GeometryCollection& geometryCollection,
                             const ImagePositions& patternPositions,
                             const PatternLayerMap& patternDependencies) {
+    addFeatureGeometry(feature, geometryCollection);
+    addPaintProperties(feature, vertices.elements(), patternPositions, patternDependencies);
+}
+
+void LineBucket::addFeatureGeometry(const GeometryTileFeature& feature,
+                                    const GeometryCollection& geometryCollection) {
     for (auto& line : geometryCollection) {
         addGeometry(line, feature);
     }
+}
 
+void LineBucket::addPaintProperties(const GeometryTileFeature& feature,
+                                    std::size_t vertexEnd,
+                                    const ImagePositions& patternPositions,
+                                    const PatternLayerMap& patternDependencies) {
     for (auto& pair : paintPropertyBinders) {
         const auto it = patternDependencies.find(pair.first);
         if (it != patternDependencies.end()){
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, it->second);
+            pair.second.populateVertexVectors(feature, vertexEnd, patternPositions, it->second);
         } else {
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, {});
+            pair.second.populateVertexVectors(feature, vertexEnd, patternPositions, {});
         }
     }
 }
 
+void LineBucket::addPaintProperties(const std::vector<const GeometryTileFeature*>& features,
+                                    const std::vector<std::size_t>& vertexEnds,
+                                    const ImagePositions& patternPositions,
+                                    const std::vector<const PatternLayerMap*>& patternDependencies) {
+    std::vector<const PatternDependency*> layerPatternDependencies(features.size());
+    for (auto& pair : paintPropertyBinders) {
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            const auto it = patternDependencies[i]->find(pair.first);
+            layerPatternDependencies[i] = it != patternDependencies[i]->end() ? &it->second : nullptr;
+        }
+        pair.second.populateVertexVectors(features, vertexEnds, patternPositions, layerPatternDependencies);
+    }
+}
 
 /*
  * Sharp corners cause dashed lines to tilt because the distance along the line
@@ -508,6 +532,37 @@ void LineBucket::addPieSliceVertex(const GeometryCoordinate& currentVertex,
     }
 }
 
+class LineBucket::Geometry final : public BucketCache::Entry {
+public:
+    gfx::VertexVector<LineLayoutVertex> vertices;
+    gfx::IndexVector<gfx::Triangles> triangles;
+    SegmentVector<LineAttributes> segments;
+    std::vector<std::size_t> featureVertexEnds;
+
+    std::size_t bytes() const override {
+        return vertices.bytes() + triangles.bytes() +
+               segments.size() * sizeof(Segment<LineAttributes>) +
+               featureVertexEnds.size() * sizeof(std::size_t);
+    }
+};
+
+std::shared_ptr<const BucketCache::Entry> LineBucket::saveGeometry(std::vector<std::size_t> featureVertexEnds) const {
+    auto geometry = std::make_shared<Geometry>();
+    geometry->vertices = vertices;
+    geometry->triangles = triangles;
+    geometry->segments = copySegments(segments);
+    geometry->featureVertexEnds = std::move(featureVertexEnds);
+    return geometry;
+}
+
+const std::vector<std::size_t>& LineBucket::restoreGeometry(const BucketCache::Entry& entry) {
+    const auto& geometry = static_cast<const Geometry&>(entry);
+    vertices = geometry.vertices;
+    triangles = geometry.triangles;
+    segments = copySegments(geometry.segments);
+    return geometry.featureVertexEnds;
+}
+
 void LineBucket::upload(gfx::UploadPass& uploadPass) {
     vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
     indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
@@ -519,6 +574,10 @@ void LineBucket::upload(gfx::UploadPass& uploadPass) {
     uploaded = true;
 }
 
+std::size_t LineBucket::getMemoryUse() const {
+    return bytes(vertices, vertexBuffer) + bytes(triangles, indexBuffer);
+}
+
 bool LineBucket::hasData() const {
     return !segments.empty();
 }
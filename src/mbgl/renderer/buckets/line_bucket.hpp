@@ -1,5 +1,6 @@
 #pragma once
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/bucket_cache.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/gfx/vertex_buffer.hpp>
 #include <mbgl/gfx/index_buffer.hpp>
@@ -31,12 +32,34 @@ public:
                     const mbgl::ImagePositions& patternPositions,
                     const PatternLayerMap&) override;
 
+    // Tessellates the geometry of a feature without populating its paint properties.
+    void addFeatureGeometry(const GeometryTileFeature&, const GeometryCollection&);
+
+    void addPaintProperties(const GeometryTileFeature&,
+                            std::size_t vertexEnd,
+                            const mbgl::ImagePositions&,
+                            const PatternLayerMap&);
+
+    // Populates the paint properties of many features at once; vertexEnds[i] is the number of
+    // vertices up to and including those of features[i].
+    void addPaintProperties(const std::vector<const GeometryTileFeature*>&,
+                            const std::vector<std::size_t>& vertexEnds,
+                            const mbgl::ImagePositions&,
+                            const std::vector<const PatternLayerMap*>&);
+
+    // Tessellated geometry that can be shared through the BucketCache; see PatternLayout.
+    class Geometry;
+    std::shared_ptr<const BucketCache::Entry> saveGeometry(std::vector<std::size_t> featureVertexEnds) const;
+    const std::vector<std::size_t>& restoreGeometry(const BucketCache::Entry&);
+
     bool hasData() const override;
 
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
 
+    std::size_t getMemoryUse() const override;
+
     PossiblyEvaluatedLayoutProperties layout;
 
     gfx::VertexVector<LineLayoutVertex> vertices;
@@ -108,6 +108,11 @@ void RasterBucket::setMask(TileMask&& mask_) {
     }
 }
 
+std::size_t RasterBucket::getMemoryUse() const {
+    return (image ? image->bytes() : 0) + bytes(texture) +
+           bytes(vertices, vertexBuffer) + bytes(indices, indexBuffer);
+}
+
 bool RasterBucket::hasData() const {
     return !!image;
 }
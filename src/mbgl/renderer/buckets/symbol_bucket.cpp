@@ -6,6 +6,8 @@
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/placement.hpp>
 
+#include <cstring>
+
 namespace mbgl {
 
 using namespace style;
@@ -49,6 +51,63 @@ SymbolBucket::SymbolBucket(style::SymbolLayoutProperties::PossiblyEvaluated layo
 
 SymbolBucket::~SymbolBucket() = default;
 
+void SymbolBucket::Buffer::updateDynamicDirtyRanges() {
+    // Runs that are this close are uploaded together, to save calls.
+    const std::size_t maxGap = 64;
+
+    const auto& current = dynamicVertices.vector();
+    const auto& previous = uploadedDynamicVertices.vector();
+    dynamicVerticesChanged = true;
+    dynamicDirtyRanges.clear();
+
+    if (current.size() == previous.size()) {
+        // Every placed symbol has four vertices per glyph, in order.
+        std::size_t begin = 0;
+        for (const auto& placedSymbol : placedSymbols) {
+            const std::size_t end = begin + placedSymbol.glyphOffsets.size() * 4;
+            if (end > current.size()) {
+                break;
+            }
+            if (std::memcmp(current.data() + begin, previous.data() + begin, (end - begin) * sizeof(current.front())) != 0) {
+                if (!dynamicDirtyRanges.empty() && begin - dynamicDirtyRanges.back().second <= maxGap) {
+                    dynamicDirtyRanges.back().second = end;
+                } else {
+                    dynamicDirtyRanges.emplace_back(begin, end);
+                }
+            }
+            begin = end;
+        }
+        if (begin == current.size()) {
+            return;
+        }
+    }
+
+    dynamicDirtyRanges.clear();
+    dynamicDirtyRanges.emplace_back(0, current.size());
+}
+
+namespace {
+
+void uploadDynamicVertices(gfx::UploadPass& uploadPass, SymbolBucket::Buffer& buffer) {
+    if (!buffer.dynamicVertexBuffer) {
+        buffer.dynamicVertexBuffer = uploadPass.createVertexBuffer(std::move(buffer.dynamicVertices), gfx::BufferUsageType::StreamDraw);
+    } else if (buffer.dynamicVerticesChanged) {
+        for (const auto& range : buffer.dynamicDirtyRanges) {
+            uploadPass.updateVertexBuffer(*buffer.dynamicVertexBuffer, buffer.dynamicVertices, range.first, range.second - range.first);
+        }
+    } else {
+        return;
+    }
+
+    // Keep the uploaded vertices to compare the next ones with. The other array is overwritten by
+    // the next update.
+    std::swap(buffer.dynamicVertices, buffer.uploadedDynamicVertices);
+    buffer.dynamicDirtyRanges.clear();
+    buffer.dynamicVerticesChanged = false;
+}
+
+} // namespace
+
 void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
     if (hasTextData()) {
         if (!staticUploaded) {
@@ -62,11 +121,7 @@ void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
         }
 
         if (!dynamicUploaded) {
-            if (!text.dynamicVertexBuffer) {
-                text.dynamicVertexBuffer = uploadPass.createVertexBuffer(std::move(text.dynamicVertices), gfx::BufferUsageType::StreamDraw);
-            } else {
-                uploadPass.updateVertexBuffer(*text.dynamicVertexBuffer, std::move(text.dynamicVertices));
-            }
+            uploadDynamicVertices(uploadPass, text);
         }
         if (!placementChangesUploaded) {
             if (!text.opacityVertexBuffer) {
@@ -88,11 +143,7 @@ void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
             uploadPass.updateIndexBuffer(*icon.indexBuffer, std::move(icon.triangles));
         }
         if (!dynamicUploaded) {
-            if (!icon.dynamicVertexBuffer) {
-                icon.dynamicVertexBuffer = uploadPass.createVertexBuffer(std::move(icon.dynamicVertices), gfx::BufferUsageType::StreamDraw);
-            } else {
-                uploadPass.updateVertexBuffer(*icon.dynamicVertexBuffer, std::move(icon.dynamicVertices));
-            }
+            uploadDynamicVertices(uploadPass, icon);
         }
         if (!placementChangesUploaded) {
             if (!icon.opacityVertexBuffer) {
@@ -138,6 +189,24 @@ void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
     sortUploaded = true;
 }
 
+std::size_t SymbolBucket::getMemoryUse() const {
+    const auto bufferBytes = [](const Buffer& buffer) {
+        return bytes(buffer.vertices, buffer.vertexBuffer) +
+               bytes(buffer.dynamicVertices, buffer.dynamicVertexBuffer) +
+               buffer.uploadedDynamicVertices.bytes() +
+               bytes(buffer.opacityVertices, buffer.opacityVertexBuffer) +
+               bytes(buffer.triangles, buffer.indexBuffer);
+    };
+    const auto collisionBytes = [](const CollisionBuffer& buffer) {
+        return bytes(buffer.vertices, buffer.vertexBuffer) +
+               bytes(buffer.dynamicVertices, buffer.dynamicVertexBuffer);
+    };
+
+    return bufferBytes(text) + bufferBytes(icon) + icon.atlasImage.bytes() +
+           collisionBytes(collisionBox) + bytes(collisionBox.lines, collisionBox.indexBuffer) +
+           collisionBytes(collisionCircle) + bytes(collisionCircle.triangles, collisionCircle.indexBuffer);
+}
+
 bool SymbolBucket::hasData() const {
     return hasTextData() || hasIconData() || hasCollisionBoxData();
 }
@@ -253,13 +322,13 @@ void SymbolBucket::place(Placement& placement, const BucketPlacementParameters&
     placement.placeBucket(*this, params, seenIds);
 }
 
-void SymbolBucket::updateVertices(Placement& placement, bool updateOpacities, const TransformState& state, const RenderTile& tile, std::set<uint32_t>& seenIds) {
-    if (updateOpacities) {
-        placement.updateBucketOpacities(*this, state, seenIds);
-        placementChangesUploaded = false;
-        uploaded = false;
-    }
+void SymbolBucket::updateOpacities(Placement& placement, const TransformState& state, std::set<uint32_t>& seenIds) {
+    placement.updateBucketOpacities(*this, state, seenIds);
+    placementChangesUploaded = false;
+    uploaded = false;
+}
 
+void SymbolBucket::updateDynamicVertices(Placement& placement, const TransformState& state, const RenderTile& tile) {
     if (placement.updateBucketDynamicVertices(*this, state, tile)) {
         dynamicUploaded = false;
         uploaded = false;
@@ -58,9 +58,11 @@ public:
 
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
+    std::size_t getMemoryUse() const override;
     std::pair<uint32_t, bool> registerAtCrossTileIndex(CrossTileSymbolLayerIndex&, const OverscaledTileID&, uint32_t& maxCrossTileID) override;
     void place(Placement&, const BucketPlacementParameters&, std::set<uint32_t>&) override;
-    void updateVertices(Placement&, bool updateOpacities, const TransformState&, const RenderTile&, std::set<uint32_t>&) override;
+    void updateOpacities(Placement&, const TransformState&, std::set<uint32_t>&) override;
+    void updateDynamicVertices(Placement&, const TransformState&, const RenderTile&) override;
     bool hasTextData() const;
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
@@ -108,6 +110,17 @@ public:
         optional<gfx::VertexBuffer<gfx::Vertex<SymbolDynamicLayoutAttributes>>> dynamicVertexBuffer;
         optional<gfx::VertexBuffer<gfx::Vertex<SymbolOpacityAttributes>>> opacityVertexBuffer;
         optional<gfx::IndexBuffer> indexBuffer;
+
+        // The dynamic vertices as they were last uploaded. `dynamicVertices` is rewritten in the
+        // meantime, and only the ranges of it that differ are uploaded.
+        gfx::VertexVector<gfx::Vertex<SymbolDynamicLayoutAttributes>> uploadedDynamicVertices;
+        // [begin, end) ranges of `dynamicVertices` that differ from `uploadedDynamicVertices`.
+        std::vector<std::pair<std::size_t, std::size_t>> dynamicDirtyRanges;
+        bool dynamicVerticesChanged = false;
+
+        // To be called after `dynamicVertices` was rewritten. Compares it with the uploaded vertices,
+        // one placed symbol at a time.
+        void updateDynamicDirtyRanges();
     } text;
 
     std::unique_ptr<SymbolSizeBinder> iconSizeBinder;
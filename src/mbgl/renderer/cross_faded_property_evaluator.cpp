@@ -17,9 +17,9 @@ Faded<T> CrossFadedPropertyEvaluator<T>::operator()(const T& constant) const {
 
 template <typename T>
 Faded<T> CrossFadedPropertyEvaluator<T>::operator()(const style::PropertyExpression<T>& expression) const {
-    return calculate(expression.evaluate(parameters.z - 1.0f),
-                     expression.evaluate(parameters.z),
-                     expression.evaluate(parameters.z + 1.0f));
+    return calculate(expression.evaluateMemoized(parameters.z - 1.0f),
+                     expression.evaluateMemoized(parameters.z),
+                     expression.evaluateMemoized(parameters.z + 1.0f));
 }
 
 template <typename T>
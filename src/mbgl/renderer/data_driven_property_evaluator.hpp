@@ -31,12 +31,12 @@ public:
                 returnExpression.useIntegerZoom = true;
                 return ResultType(returnExpression);
             } 
-            return ResultType(expression.evaluate(floor(parameters.z)));
+            return ResultType(expression.evaluateMemoized(floor(parameters.z)));
         } else {
             if (!expression.isFeatureConstant()) {
                 return ResultType(expression);
             }
-            return ResultType(expression.evaluate(parameters.z));
+            return ResultType(expression.evaluateMemoized(parameters.z));
         }
     }
 
@@ -66,7 +66,7 @@ public:
         if (!expression.isFeatureConstant()) {
             return ResultType(expression);
         } else {
-            const T evaluated = expression.evaluate(floor(parameters.z));
+            const T evaluated = expression.evaluateMemoized(floor(parameters.z));
             return ResultType(calculate(evaluated, evaluated, evaluated));
         }
     }
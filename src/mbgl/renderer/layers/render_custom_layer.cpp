@@ -54,6 +54,11 @@ void RenderCustomLayer::prepare(const LayerPrepareParameters&) {
 }
 
 void RenderCustomLayer::render(PaintParameters& paintParameters) {
+    // Custom layers draw with GL themselves, which a recording context doesn't provide.
+    if (paintParameters.context.recordsDraws) {
+        return;
+    }
+
     if (host != impl(baseImpl).host) {
         //If the context changed, deinitialize the previous one before initializing the new one.
         if (host && !contextDestroyed) {
@@ -33,7 +33,8 @@ PaintParameters::PaintParameters(gfx::Context& context_,
                     const TransformParameters& transformParams_,
                     RenderStaticData& staticData_,
                     LineAtlas& lineAtlas_,
-                    PatternAtlas& patternAtlas_)
+                    PatternAtlas& patternAtlas_,
+                    const optional<gfx::Texture>& glyphAtlasTexture_)
     : context(context_),
     backend(backend_),
     encoder(context.createCommandEncoder()),
@@ -43,6 +44,7 @@ PaintParameters::PaintParameters(gfx::Context& context_,
     staticData(staticData_),
     lineAtlas(lineAtlas_),
     patternAtlas(patternAtlas_),
+    glyphAtlasTexture(glyphAtlasTexture_),
     mapMode(updateParameters.mode),
     debugOptions(updateParameters.debugOptions),
     timePoint(updateParameters.timePoint),
@@ -7,6 +7,7 @@
 #include <mbgl/gfx/stencil_mode.hpp>
 #include <mbgl/gfx/color_mode.hpp>
 #include <mbgl/util/mat4.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <array>
 #include <map>
@@ -30,6 +31,7 @@ class Context;
 class RendererBackend;
 class CommandEncoder;
 class RenderPass;
+class Texture;
 } // namespace gfx
 
 
@@ -52,7 +54,8 @@ public:
                     const TransformParameters&,
                     RenderStaticData&,
                     LineAtlas&,
-                    PatternAtlas&);
+                    PatternAtlas&,
+                    const optional<gfx::Texture>& glyphAtlasTexture);
     ~PaintParameters();
 
     gfx::Context& context;
@@ -67,6 +70,8 @@ public:
     RenderStaticData& staticData;
     LineAtlas& lineAtlas;
     PatternAtlas& patternAtlas;
+    // Created by the upload pass.
+    const optional<gfx::Texture>& glyphAtlasTexture;
 
     RenderPass pass = RenderPass::Opaque;
     MapMode mapMode;
@@ -100,6 +100,21 @@ public:
                                       std::size_t length, const ImagePositions&,
                                       const optional<PatternDependency>&,
                                       const style::expression::Value&) = 0;
+
+    // Populates the vertex vectors for many features at once. vertexEnds[i] is the number of
+    // vertices up to and including those of features[i], and patternDependencies[i] its pattern
+    // dependency, if any.
+    virtual void populateVertexVectors(const std::vector<const GeometryTileFeature*>& features,
+                                       const std::vector<std::size_t>& vertexEnds,
+                                       const ImagePositions& patternPositions,
+                                       const std::vector<const PatternDependency*>& patternDependencies) {
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            const optional<PatternDependency> patternDependency =
+                patternDependencies[i] ? *patternDependencies[i] : optional<PatternDependency>();
+            populateVertexVector(*features[i], vertexEnds[i], patternPositions, patternDependency, {});
+        }
+    }
+
     virtual void upload(gfx::UploadPass&) = 0;
     virtual void setPatternParameters(const optional<ImagePosition>&, const optional<ImagePosition>&, const CrossfadeParameters&) = 0;
     virtual std::tuple<ExpandToType<As, optional<gfx::AttributeBinding>>...> attributeBinding(const PossiblyEvaluatedType& currentValue) const = 0;
@@ -197,6 +212,21 @@ public:
         }
     }
 
+    void populateVertexVectors(const std::vector<const GeometryTileFeature*>& features,
+                               const std::vector<std::size_t>& vertexEnds,
+                               const ImagePositions&,
+                               const std::vector<const PatternDependency*>&) override {
+        std::vector<T> evaluated;
+        expression.evaluate(style::expression::EvaluationContext(), features, evaluated, defaultValue);
+        for (std::size_t f = 0; f < features.size(); ++f) {
+            this->statistics.add(evaluated[f]);
+            auto value = attributeValue(evaluated[f]);
+            for (std::size_t i = vertexVector.elements(); i < vertexEnds[f]; ++i) {
+                vertexVector.emplace_back(BaseVertex { value });
+            }
+        }
+    }
+
     void upload(gfx::UploadPass& uploadPass) override {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertexVector));
     }
@@ -261,6 +291,27 @@ public:
         }
     }
 
+    void populateVertexVectors(const std::vector<const GeometryTileFeature*>& features,
+                               const std::vector<std::size_t>& vertexEnds,
+                               const ImagePositions&,
+                               const std::vector<const PatternDependency*>&) override {
+        using style::expression::EvaluationContext;
+        std::vector<T> min;
+        std::vector<T> max;
+        expression.evaluate(EvaluationContext(zoomRange.min), features, min, defaultValue);
+        expression.evaluate(EvaluationContext(zoomRange.max), features, max, defaultValue);
+        for (std::size_t f = 0; f < features.size(); ++f) {
+            this->statistics.add(min[f]);
+            this->statistics.add(max[f]);
+            AttributeValue value = zoomInterpolatedAttributeValue(
+                attributeValue(min[f]),
+                attributeValue(max[f]));
+            for (std::size_t i = vertexVector.elements(); i < vertexEnds[f]; ++i) {
+                vertexVector.emplace_back(Vertex { value });
+            }
+        }
+    }
+
     void upload(gfx::UploadPass& uploadPass) override {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertexVector));
     }
@@ -277,9 +328,9 @@ public:
 
     std::tuple<float> interpolationFactor(float currentZoom) const override {
         if (expression.useIntegerZoom) {
-            return std::tuple<float> { expression.interpolationFactor(zoomRange, std::floor(currentZoom)) };
+            return std::tuple<float> { expression.memoizedInterpolationFactor(zoomRange, std::floor(currentZoom)) };
         } else {
-            return std::tuple<float> { expression.interpolationFactor(zoomRange, currentZoom) };
+            return std::tuple<float> { expression.memoizedInterpolationFactor(zoomRange, currentZoom) };
         }
     }
 
@@ -497,6 +548,15 @@ public:
         });
     }
 
+    void populateVertexVectors(const std::vector<const GeometryTileFeature*>& features,
+                               const std::vector<std::size_t>& vertexEnds,
+                               const ImagePositions& patternPositions,
+                               const std::vector<const PatternDependency*>& patternDependencies) {
+        util::ignore({
+            (binders.template get<Ps>()->populateVertexVectors(features, vertexEnds, patternPositions, patternDependencies), 0)...
+        });
+    }
+
     void setPatternParameters(const optional<ImagePosition>& posA, const optional<ImagePosition>& posB, const CrossfadeParameters& crossfade) const {
         util::ignore({
             (binders.template get<Ps>()->setPatternParameters(posA, posB, crossfade), 0)...
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/map/mode.hpp>
+#include <mbgl/renderer/tile_cache_statistics.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/util/mat4.hpp>
@@ -96,6 +97,10 @@ public:
 
     virtual void reduceMemoryUse() = 0;
 
+    // Sources that cache tiles which left the viewport bound the cache by the given number of bytes.
+    virtual void setTileCacheByteBudget(std::size_t) {}
+    virtual TileCacheStatistics getTileCacheStatistics() const { return {}; }
+
     virtual void dumpDebugLogs() const = 0;
 
     void setObserver(RenderSourceObserver*);
@@ -77,12 +77,6 @@ optional<ImagePosition> RenderTile::getPattern(const std::string& pattern) const
     return static_cast<const GeometryTile&>(tile).getPattern(pattern);
 }
 
-const gfx::Texture& RenderTile::getGlyphAtlasTexture() const {
-    assert(tile.kind == Tile::Kind::Geometry);
-    assert(static_cast<const GeometryTile&>(tile).glyphAtlasTexture);
-    return *(static_cast<const GeometryTile&>(tile).glyphAtlasTexture);
-}
-
 const gfx::Texture& RenderTile::getIconAtlasTexture() const {
     assert(tile.kind == Tile::Kind::Geometry);
     assert(static_cast<const GeometryTile&>(tile).iconAtlasTexture);
@@ -56,7 +56,6 @@ public:
     Bucket* getBucket(const style::Layer::Impl&) const;
     const LayerRenderData* getLayerRenderData(const style::Layer::Impl&) const;
     optional<ImagePosition> getPattern(const std::string& pattern) const;
-    const gfx::Texture& getGlyphAtlasTexture() const;
     const gfx::Texture& getIconAtlasTexture() const;
     std::shared_ptr<FeatureIndex> getFeatureIndex() const;
 
@@ -116,4 +116,20 @@ void Renderer::reduceMemoryUse() {
     impl->reduceMemoryUse();
 }
 
+void Renderer::setTileCacheByteBudget(std::size_t bytes) {
+    impl->setTileCacheByteBudget(bytes);
+}
+
+std::size_t Renderer::getTileCacheByteBudget() const {
+    return impl->tileCacheByteBudget;
+}
+
+TileCacheStatistics Renderer::getTileCacheStatistics() const {
+    return impl->getTileCacheStatistics();
+}
+
+style::ZoomEvaluationStatistics Renderer::getZoomEvaluationStatistics() const {
+    return impl->zoomEvaluationStatistics;
+}
+
 } // namespace mbgl
@@ -26,6 +26,7 @@
 #include <mbgl/geometry/line_atlas.hpp>
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/transition_options.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/util/math.hpp>
@@ -60,6 +61,9 @@ Renderer::Impl::Impl(gfx::RendererBackend& backend_,
     , renderLight(makeMutable<Light::Impl>())
     , placement(std::make_unique<Placement>(TransformState{}, MapMode::Static, TransitionOptions{}, true)) {
     glyphManager->setObserver(this);
+    if (programCacheDir) {
+        glyphManager->setLocalGlyphCache(*programCacheDir, localFontFamily);
+    }
     imageManager->setObserver(this);
 }
 
@@ -83,6 +87,10 @@ void Renderer::Impl::setObserver(RendererObserver* observer_) {
 }
 
 void Renderer::Impl::render(const UpdateParameters& updateParameters) {
+    // Paint properties are evaluated and drawn on this thread, so the differences of its counters
+    // are the evaluations of zoom dependent expressions that this frame needed.
+    const style::ZoomEvaluationStatistics zoomEvaluationsBefore = style::ZoomEvaluationStatistics::current();
+
     const bool isMapModeContinuous = updateParameters.mode == MapMode::Continuous;
     if (!isMapModeContinuous) {
         // Reset zoom history state.
@@ -210,6 +218,7 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
     for (const auto& entry : sourceDiff.added) {
         std::unique_ptr<RenderSource> renderSource = RenderSource::create(entry.second);
         renderSource->setObserver(this);
+        renderSource->setTileCacheByteBudget(tileCacheByteBudget);
         renderSources.emplace(entry.first, std::move(renderSource));
     }
     transformState = updateParameters.transformState;
@@ -288,6 +297,7 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
 
     const bool loaded = updateParameters.styleLoaded && isLoaded();
     if (!isMapModeContinuous && !loaded) {
+        zoomEvaluationStatistics = style::ZoomEvaluationStatistics::current() - zoomEvaluationsBefore;
         return;
     }
 
@@ -328,6 +338,7 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
                 updateParameters.transformState, updateParameters.mode,
                 updateParameters.transitionOptions, updateParameters.crossSourceCollisions,
                 std::move(placement));
+            placement->projectLayers(layersNeedPlacement, transformParams.projMatrix);
         }
 
         for (auto it = layersNeedPlacement.rbegin(); it != layersNeedPlacement.rend(); ++it) {
@@ -350,9 +361,7 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
             placement->setStale();
         }
 
-        for (auto it = layersNeedPlacement.rbegin(); it != layersNeedPlacement.rend(); ++it) {
-            placement->updateLayerBuckets(*it, updateParameters.transformState, placementChanged || symbolBucketsChanged);
-        }
+        placement->updateLayerBuckets(layersNeedPlacement, updateParameters.transformState, placementChanged || symbolBucketsChanged);
     }
 
     auto& context = backend.getContext();
@@ -369,7 +378,8 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         transformParams,
         *staticData,
         *lineAtlas,
-        *patternAtlas
+        *patternAtlas,
+        glyphAtlasTexture
     };
 
     parameters.symbolFadeChange = placement->symbolFadeChange(updateParameters.timePoint);
@@ -401,6 +411,7 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         staticData->upload(*uploadPass);
         lineAtlas->upload(*uploadPass);
         patternAtlas->upload(*uploadPass);
+        glyphManager->getAtlas()->upload(*uploadPass, glyphAtlasTexture);
     }
 
     // - 3D PASS -------------------------------------------------------------------------------------
@@ -517,6 +528,8 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
     // CommandEncoder destructor submits render commands.
     parameters.encoder.reset();
 
+    zoomEvaluationStatistics = style::ZoomEvaluationStatistics::current() - zoomEvaluationsBefore;
+
 
     const bool needsRepaint = isMapModeContinuous && hasTransitions(parameters.timePoint);
     observer->onDidFinishRenderingFrame(
@@ -671,6 +684,21 @@ void Renderer::Impl::reduceMemoryUse() {
     observer->onInvalidate();
 }
 
+void Renderer::Impl::setTileCacheByteBudget(std::size_t bytes) {
+    tileCacheByteBudget = bytes;
+    for (const auto& entry : renderSources) {
+        entry.second->setTileCacheByteBudget(bytes);
+    }
+}
+
+TileCacheStatistics Renderer::Impl::getTileCacheStatistics() const {
+    TileCacheStatistics result;
+    for (const auto& entry : renderSources) {
+        result += entry.second->getTileCacheStatistics();
+    }
+    return result;
+}
+
 void Renderer::Impl::dumpDebugLogs() {
     for (const auto& entry : renderSources) {
         entry.second->dumpDebugLogs();
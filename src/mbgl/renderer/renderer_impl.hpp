@@ -3,15 +3,18 @@
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/renderer/render_source_observer.hpp>
 #include <mbgl/renderer/render_light.hpp>
+#include <mbgl/gfx/texture.hpp>
 #include <mbgl/style/image.hpp>
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/layer.hpp>
+#include <mbgl/style/zoom_evaluation_cache.hpp>
 #include <mbgl/map/transform_state.hpp>
 #include <mbgl/map/zoom_history.hpp>
 #include <mbgl/text/cross_tile_symbol_index.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/renderer/image_manager_observer.hpp>
 #include <mbgl/text/placement.hpp>
+#include <mbgl/tile/tile_cache.hpp>
 
 #include <memory>
 #include <string>
@@ -65,6 +68,8 @@ public:
                                                  const optional<std::map<std::string, Value>>& args) const;
 
     void reduceMemoryUse();
+    void setTileCacheByteBudget(std::size_t);
+    TileCacheStatistics getTileCacheStatistics() const;
     void dumpDebugLogs();
 
 private:
@@ -118,6 +123,7 @@ private:
     std::unique_ptr<ImageManager> imageManager;
     std::unique_ptr<LineAtlas> lineAtlas;
     std::unique_ptr<PatternAtlas> patternAtlas;
+    optional<gfx::Texture> glyphAtlasTexture;
     std::unique_ptr<RenderStaticData> staticData;
 
     Immutable<std::vector<Immutable<style::Image::Impl>>> imageImpls;
@@ -125,8 +131,11 @@ private:
     Immutable<std::vector<Immutable<style::Layer::Impl>>> layerImpls;
 
     std::unordered_map<std::string, std::unique_ptr<RenderSource>> renderSources;
+    std::size_t tileCacheByteBudget = TileCache::DefaultByteBudget;
     std::unordered_map<std::string, std::unique_ptr<RenderLayer>> renderLayers;
     RenderLight renderLight;
+    // The lookups in zoom evaluation caches while rendering the last frame.
+    style::ZoomEvaluationStatistics zoomEvaluationStatistics;
 
     CrossTileSymbolIndex crossTileSymbolIndex;
     std::unique_ptr<Placement> placement;
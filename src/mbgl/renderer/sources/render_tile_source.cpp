@@ -70,6 +70,14 @@ void RenderTileSource::reduceMemoryUse() {
     tilePyramid.reduceMemoryUse();
 }
 
+void RenderTileSource::setTileCacheByteBudget(std::size_t bytes) {
+    tilePyramid.setCacheByteBudget(bytes);
+}
+
+TileCacheStatistics RenderTileSource::getTileCacheStatistics() const {
+    return tilePyramid.getCacheStatistics();
+}
+
 void RenderTileSource::dumpDebugLogs() const {
     tilePyramid.dumpDebugLogs();
 }
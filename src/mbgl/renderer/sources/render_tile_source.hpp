@@ -35,6 +35,8 @@ public:
     querySourceFeatures(const SourceQueryOptions&) const override;
 
     void reduceMemoryUse() override;
+    void setTileCacheByteBudget(std::size_t) override;
+    TileCacheStatistics getTileCacheStatistics() const override;
     void dumpDebugLogs() const override;
 
 protected:
@@ -5,6 +5,7 @@
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/math/clamp.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tile_range.hpp>
 #include <mbgl/util/enum.hpp>
@@ -23,6 +24,33 @@ using namespace style;
 
 static TileObserver nullObserver;
 
+// Workers parse the tiles at the ideal zoom level that are required to render the viewport
+// first, nearest to the center of the screen first. Other required tiles, e.g. prefetched
+// lower zoom level tiles, come next, followed by optional tiles.
+static Mailbox::Priority tilePriority(const OverscaledTileID& tileID,
+                                      const TileNecessity necessity,
+                                      const int32_t idealZoom,
+                                      const LatLng& center) {
+    constexpr Mailbox::Priority range = 1 << 16;
+
+    const uint8_t z = tileID.canonical.z;
+    const TileCoordinatePoint centerPoint = TileCoordinate::fromLatLng(z, center).p;
+    const double dx = tileID.canonical.x + tileID.wrap * std::pow(2.0, z) + 0.5 - centerPoint.x;
+    const double dy = tileID.canonical.y + 0.5 - centerPoint.y;
+
+    // Distance to the center of the screen, in tiles at the ideal zoom level.
+    const double distance = std::sqrt(dx * dx + dy * dy) * std::pow(2.0, idealZoom - z);
+    const auto proximity = range - 1 - static_cast<Mailbox::Priority>(std::min<double>(distance * 64, range - 1));
+
+    if (necessity == TileNecessity::Optional) {
+        return proximity - range;
+    } else if (tileID.overscaledZ == idealZoom) {
+        return 2 * range + proximity;
+    } else {
+        return range + proximity;
+    }
+}
+
 TilePyramid::TilePyramid()
     : observer(&nullObserver) {
 }
@@ -112,10 +140,10 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
     // kinds of tiles we need: the ideal tiles determined by the tile cover. They may not yet be in
     // use because they're still loading. In addition to that, we also need to retain all tiles that
     // we're actively using, e.g. as a replacement for tile that aren't loaded yet.
-    std::set<OverscaledTileID> retain;
+    std::map<OverscaledTileID, TileNecessity> retain;
 
     auto retainTileFn = [&](Tile& tile, TileNecessity necessity) -> void {
-        if (retain.emplace(tile.id).second) {
+        if (retain.emplace(tile.id, necessity).second) {
             tile.setNecessity(necessity);
         }
 
@@ -191,20 +219,24 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
         cache.setSize(conservativeCacheSize);
     }
 
-    // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
-    // and removes items from tiles that don't have the corresponding key in the retain set.
+    // Remove stale tiles. This goes through the (sorted!) tiles map and retain map in lockstep
+    // and removes items from tiles that don't have the corresponding key in the retain map.
+    // Retained tiles are prioritized according to their necessity and their position.
     {
+        const LatLng center = parameters.transformState.getLatLng();
         auto tilesIt = tiles.begin();
         auto retainIt = retain.begin();
         while (tilesIt != tiles.end()) {
-            if (retainIt == retain.end() || tilesIt->first < *retainIt) {
+            if (retainIt == retain.end() || tilesIt->first < retainIt->first) {
                 if (!needsRelayout) {
                     tilesIt->second->setNecessity(TileNecessity::Optional);
+                    tilesIt->second->setPriority(tilePriority(tilesIt->first, TileNecessity::Optional, tileZoom, center));
                     cache.add(tilesIt->first, std::move(tilesIt->second));
                 }
                 tiles.erase(tilesIt++);
             } else {
-                if (!(*retainIt < tilesIt->first)) {
+                if (!(retainIt->first < tilesIt->first)) {
+                    tilesIt->second->setPriority(tilePriority(tilesIt->first, retainIt->second, tileZoom, center));
                     ++tilesIt;
                 }
                 ++retainIt;
@@ -358,6 +390,14 @@ void TilePyramid::setCacheSize(size_t size) {
     cache.setSize(size);
 }
 
+void TilePyramid::setCacheByteBudget(size_t bytes) {
+    cache.setByteBudget(bytes);
+}
+
+TileCacheStatistics TilePyramid::getCacheStatistics() const {
+    return cache.getStatistics();
+}
+
 void TilePyramid::reduceMemoryUse() {
     cache.clear();
 }
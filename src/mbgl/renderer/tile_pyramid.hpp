@@ -58,6 +58,8 @@ public:
     std::vector<Feature> querySourceFeatures(const SourceQueryOptions&) const;
 
     void setCacheSize(size_t);
+    void setCacheByteBudget(size_t);
+    TileCacheStatistics getCacheStatistics() const;
     void reduceMemoryUse();
 
     void setObserver(TileObserver*);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+// Serves tiles straight from read-only tile archives on the local file system, without
+// importing them into the offline database first. Supported archives are MBTiles files, which
+// SQLite reads through a memory mapping, and single-file clustered tile archives, which are
+// memory mapped as a whole and looked up in a tile directory that is built when the archive is
+// opened; see mbtiles_file_source.cpp for their layout.
+//
+// A source URL is "mbtiles://" followed by the path of an archive. Requesting it yields a
+// TileJSON document whose tile URLs refer back to the archive. Archives are opened on first use
+// and stay open until the file source is destroyed, so they must not be modified in the meantime.
+class MBTilesFileSource : public FileSource {
+public:
+    MBTilesFileSource();
+    ~MBTilesFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    static bool acceptsURL(const std::string& url);
+
+private:
+    class Impl;
+
+    std::unique_ptr<util::Thread<Impl>> impl;
+};
+
+} // namespace mbgl
@@ -0,0 +1,45 @@
+#include <mbgl/storage/payload.hpp>
+#include <mbgl/util/compression.hpp>
+
+namespace mbgl {
+
+std::atomic<uint64_t> PayloadStatistics::tiles(0);
+std::atomic<uint64_t> PayloadStatistics::copiedBytes(0);
+std::atomic<uint64_t> PayloadStatistics::inflatedBytes(0);
+
+void PayloadStatistics::addTile() {
+    tiles.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PayloadStatistics::addCopiedBytes(std::size_t bytes) {
+    copiedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void PayloadStatistics::addInflatedBytes(std::size_t bytes) {
+    inflatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+PayloadStatistics::Counters PayloadStatistics::get() {
+    Counters counters;
+    counters.tiles = tiles.load(std::memory_order_relaxed);
+    counters.copiedBytes = copiedBytes.load(std::memory_order_relaxed);
+    counters.inflatedBytes = inflatedBytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void PayloadStatistics::reset() {
+    tiles = 0;
+    copiedBytes = 0;
+    inflatedBytes = 0;
+}
+
+std::shared_ptr<const std::string> inflatePayload(std::shared_ptr<const std::string> data) {
+    if (!data || !util::isCompressed(*data)) {
+        return data;
+    }
+    auto inflated = std::make_shared<const std::string>(util::decompress(*data));
+    PayloadStatistics::addInflatedBytes(inflated->size());
+    return inflated;
+}
+
+} // namespace mbgl
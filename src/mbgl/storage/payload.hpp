@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+// Process-wide counters of the work that is done to get tile data from where it is stored into
+// the buffer that a tile parser reads.
+class PayloadStatistics {
+public:
+    class Counters {
+    public:
+        // The number of tile payloads that were handed to tiles.
+        uint64_t tiles = 0;
+        // Bytes copied out of storage, e.g. out of an SQLite blob or a memory mapped file.
+        uint64_t copiedBytes = 0;
+        // Bytes produced by inflating compressed payloads.
+        uint64_t inflatedBytes = 0;
+    };
+
+    static void addTile();
+    static void addCopiedBytes(std::size_t);
+    static void addInflatedBytes(std::size_t);
+
+    static Counters get();
+    static void reset();
+
+private:
+    static std::atomic<uint64_t> tiles;
+    static std::atomic<uint64_t> copiedBytes;
+    static std::atomic<uint64_t> inflatedBytes;
+};
+
+// Returns the data, or an inflated copy if it is compressed. Tiles request their data with
+// Resource::acceptsCompressedData, and call this on their worker threads.
+std::shared_ptr<const std::string> inflatePayload(std::shared_ptr<const std::string>);
+
+} // namespace mbgl
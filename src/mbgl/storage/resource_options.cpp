@@ -10,6 +10,7 @@ public:
     std::string cachePath = ":memory:";
     std::string assetPath = ".";
     uint64_t maximumSize = mbgl::util::DEFAULT_MAX_CACHE_SIZE;
+    bool writeAheadLogging = false;
     void* platformContext = nullptr;
 };
 
@@ -68,6 +69,15 @@ uint64_t ResourceOptions::maximumCacheSize() const {
     return impl_->maximumSize;
 }
 
+ResourceOptions& ResourceOptions::withCacheWriteAheadLogging(bool enabled) {
+    impl_->writeAheadLogging = enabled;
+    return *this;
+}
+
+bool ResourceOptions::cacheWriteAheadLogging() const {
+    return impl_->writeAheadLogging;
+}
+
 ResourceOptions& ResourceOptions::withPlatformContext(void* context) {
     impl_->platformContext = context;
     return *this;
@@ -0,0 +1,1379 @@
+#include <mbgl/style/expression/compiled_expression.hpp>
+#include <mbgl/style/expression/assertion.hpp>
+#include <mbgl/style/expression/boolean_operator.hpp>
+#include <mbgl/style/expression/case.hpp>
+#include <mbgl/style/expression/comparison.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/style/expression/interpolate.hpp>
+#include <mbgl/style/expression/is_constant.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/style/expression/match.hpp>
+#include <mbgl/style/expression/step.hpp>
+#include <mbgl/style/expression/util.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/math/log2.hpp>
+#include <mbgl/util/interpolate.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+namespace {
+
+// The number of registers that evaluation provides. Booleans are stored as 0 or 1 in number
+// registers.
+constexpr std::size_t numberRegisters = 32;
+constexpr std::size_t colorRegisters = 8;
+
+// The number of features that batch evaluation evaluates each instruction for at once.
+constexpr std::size_t batchSize = 64;
+
+// In the comments below, n[] and c[] are the number and color registers.
+enum class Opcode : uint8_t {
+    LoadNumber,             // n[dst] = numbers[operand]
+    LoadColor,              // c[dst] = colors[operand]
+    LoadZoom,               // n[dst] = zoom
+    LoadColorRampParameter, // n[dst] = heatmap-density or line-progress
+    LoadNumberProperty,     // n[dst] = ["number", ["get", keys[operand]]]
+    LoadBooleanProperty,    // n[dst] = ["boolean", ["get", keys[operand]]]
+    HasProperty,            // n[dst] = ["has", keys[operand]]
+    PropertyEquals,         // n[dst] = ["==", ["get", keys[operand]], values[a]]
+
+    // n[dst] = n[a] op n[b]
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    Power,
+    Min,
+    Max,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+
+    // n[dst] = op(n[a])
+    Negate,
+    Not,
+    Sqrt,
+    Log10,
+    Ln,
+    Log2,
+    Sin,
+    Cos,
+    Tan,
+    Asin,
+    Acos,
+    Atan,
+    Round,
+    Floor,
+    Ceil,
+    Abs,
+
+    Rgba,                   // c[dst] = ["rgba", n[a], n[a + 1], n[a + 2], n[a + 3]]
+
+    InterpolateNumber,      // n[dst] = curves[operand] at n[a], which has constant outputs
+    InterpolateColor,       // c[dst] = curves[operand] at n[a], which has constant outputs
+    LerpNumber,             // n[dst] = interpolate(n[dst], n[a], n[b])
+    LerpColor,              // c[dst] = interpolate(c[dst], c[a], n[b])
+
+    // n[dst] = the index of the output that a step or match expression selects
+    StepIndex,              // of curves[operand] at n[a]
+    MatchIndex,             // of matches[operand] for n[a]
+    MatchNumberPropertyIndex, // of matches[operand] for its property
+    MatchStringPropertyIndex, // of matches[operand] for its property
+
+    SelectNumber,           // n[dst] = numbers[operand + n[a]]
+    SelectColor,            // c[dst] = colors[operand + n[a]]
+
+    // n[dst] or c[dst] = subexpressions[operand]->evaluate()
+    EvaluateNumber,
+    EvaluateBoolean,
+    EvaluateColor,
+
+    // Jumps to the instruction at operand, or to the one that a table selects. Programs without
+    // jumps can be evaluated for a batch of features one instruction at a time.
+    Jump,
+    JumpIfTrue,             // if n[a]
+    JumpIfFalse,            // if !n[a]
+    JumpTable,              // to jumpTables[operand][n[a]]
+    InterpolateJump,        // to the output(s) of curves[operand] at n[a], with n[b] = factor
+};
+
+struct Instruction {
+    Opcode op;
+    uint8_t dst;
+    uint8_t a;
+    uint8_t b;
+    uint32_t operand;
+};
+
+// The stops of a step or interpolate expression.
+struct Curve {
+    // Provides the interpolation factor.
+    const Interpolate* interpolate = nullptr;
+    std::vector<double> inputs;
+    // The index of the first output in the constant numbers or colors, if all outputs are
+    // constant.
+    uint32_t outputs = 0;
+    // The code that computes the output of each stop.
+    std::vector<uint32_t> targets;
+    // The code that computes the outputs of stop i and i + 1 and interpolates between them.
+    std::vector<uint32_t> pairTargets;
+};
+
+// Maps the labels of a match expression to the index of their output.
+struct MatchTable {
+    uint32_t key = 0;
+    std::unordered_map<int64_t, uint32_t> integers;
+    std::unordered_map<std::string, uint32_t> strings;
+    uint32_t otherwise = 0;
+};
+
+struct Registers {
+    double n[numberRegisters];
+    Color c[colorRegisters];
+};
+
+// The registers of a single feature that is being evaluated.
+class SingleLane {
+public:
+    SingleLane(const GeometryTileFeature* feature_) : feature(feature_) {}
+
+    // Executes the function with the registers and the feature, unless evaluation has failed
+    // already. The function returns false if evaluation fails.
+    template <class Fn>
+    void each(Fn fn) {
+        if (!failed && !fn(registers, feature)) {
+            failed = true;
+        }
+    }
+
+    Registers registers;
+    const GeometryTileFeature* const feature;
+    bool failed = false;
+};
+
+// The registers of a batch of features that are being evaluated together.
+class BatchLanes {
+public:
+    template <class Fn>
+    void each(Fn fn) {
+        for (std::size_t l = 0; l < count; ++l) {
+            if (!failed[l] && !fn(registers[l], features[l])) {
+                failed[l] = true;
+            }
+        }
+    }
+
+    std::array<Registers, batchSize> registers;
+    std::array<const GeometryTileFeature*, batchSize> features;
+    std::array<bool, batchSize> failed;
+    std::size_t count = 0;
+};
+
+optional<double> numericValue(const mbgl::Value& value) {
+    if (value.is<double>()) {
+        return value.get<double>();
+    } else if (value.is<uint64_t>()) {
+        return static_cast<double>(value.get<uint64_t>());
+    } else if (value.is<int64_t>()) {
+        return static_cast<double>(value.get<int64_t>());
+    }
+    return {};
+}
+
+// Whether a feature property equals a literal, like the Values that ["get", key] and
+// the literal evaluate to would be.
+bool propertyEquals(const mbgl::Value* property, const Value& literal) {
+    if (!property) {
+        return false;
+    }
+    return literal.match(
+        [&](const std::string& string) {
+            return property->is<std::string>() && property->get<std::string>() == string;
+        },
+        [&](double number) {
+            const optional<double> value = numericValue(*property);
+            return value && *value == number;
+        },
+        [&](bool boolean) {
+            return property->is<bool>() && property->get<bool>() == boolean;
+        },
+        [&](const auto&) {
+            assert(false);
+            return false;
+        }
+    );
+}
+
+// Mirrors std::map::upper_bound() on the stops of step and interpolate expressions.
+std::size_t upperBound(const std::vector<double>& inputs, const float x) {
+    return std::upper_bound(inputs.begin(), inputs.end(), x) - inputs.begin();
+}
+
+
+// Finds the stop of a step or interpolate expression that the input selects, like Step and
+// Interpolate do. If the input falls between two stops of an interpolate expression, `stop`
+// is the lower one and `t` is the interpolation factor, otherwise `t` is 0. Returns false if
+// evaluating the expression would have resulted in an error.
+bool findStop(const Curve& curve, const double input, std::size_t& stop, float& t) {
+    const float x = static_cast<float>(input);
+    if (std::isnan(x) || curve.inputs.empty()) {
+        return false;
+    }
+
+    t = 0.0f;
+    const std::size_t upper = upperBound(curve.inputs, x);
+    if (upper == curve.inputs.size()) {
+        stop = upper - 1;
+    } else if (upper == 0) {
+        stop = 0;
+    } else if (curve.interpolate) {
+        t = curve.interpolate->interpolationFactor({ curve.inputs[upper - 1], curve.inputs[upper] }, x);
+        stop = t == 1.0f ? upper : upper - 1;
+        t = t == 1.0f ? 0.0f : t;
+    } else {
+        stop = upper - 1;
+    }
+    return true;
+}
+
+uint32_t matchInteger(const MatchTable& table, const double numeric) {
+    const int64_t rounded = std::floor(numeric);
+    if (numeric == rounded) {
+        auto it = table.integers.find(rounded);
+        if (it != table.integers.end()) {
+            return it->second;
+        }
+    }
+    return table.otherwise;
+}
+
+void addLabel(MatchTable& table, int64_t label, uint32_t target) {
+    table.integers.emplace(label, target);
+}
+
+void addLabel(MatchTable& table, const std::string& label, uint32_t target) {
+    table.strings.emplace(label, target);
+}
+
+// Adds the labels of a match expression to the table, and its outputs, of which labels that
+// share an output share a single one, followed by the otherwise output.
+template <class T>
+std::vector<const Expression*> matchOutputs(const Match<T>& match, MatchTable& table) {
+    std::vector<const Expression*> outputs;
+    std::unordered_map<const Expression*, uint32_t> indexes;
+    for (const auto& branch : match.getBranches()) {
+        auto it = indexes.find(branch.second.get());
+        if (it == indexes.end()) {
+            it = indexes.emplace(branch.second.get(), static_cast<uint32_t>(outputs.size())).first;
+            outputs.push_back(branch.second.get());
+        }
+        addLabel(table, branch.first, it->second);
+    }
+
+    table.otherwise = static_cast<uint32_t>(outputs.size());
+    outputs.push_back(&match.getOtherwise());
+    return outputs;
+}
+
+// The key of a ["get", key] expression that reads a feature property.
+optional<std::string> propertyKey(const Expression& expression) {
+    if (expression.getKind() != Kind::CompoundExpression || expression.getOperator() != "get") {
+        return {};
+    }
+
+    std::vector<const Expression*> args;
+    expression.eachChild([&](const Expression& arg) {
+        args.push_back(&arg);
+    });
+    if (args.size() != 1 || args[0]->getKind() != Kind::Literal) {
+        return {};
+    }
+
+    const Value key = static_cast<const Literal*>(args[0])->getValue();
+    return key.is<std::string>() ? key.get<std::string>() : optional<std::string>();
+}
+
+// Whether the expression refers to a `let` binding. Variables don't report the expression they're
+// bound to as a child, so is_constant.hpp can't see whether that one depends on the feature.
+bool usesVariables(const Expression& expression) {
+    if (expression.getKind() == Kind::Var) {
+        return true;
+    }
+    bool result = false;
+    expression.eachChild([&](const Expression& child) {
+        result = result || usesVariables(child);
+    });
+    return result;
+}
+
+std::vector<const Expression*> children(const Expression& expression) {
+    std::vector<const Expression*> result;
+    expression.eachChild([&](const Expression& child) {
+        result.push_back(&child);
+    });
+    return result;
+}
+
+} // namespace
+
+class CompiledExpression::Program {
+public:
+    // Evaluates the program for a single feature.
+    bool run(const EvaluationContext&, SingleLane&) const;
+    // Evaluates a program without jumps for a batch of features.
+    void run(const EvaluationContext&, BatchLanes&) const;
+
+    std::vector<Instruction> instructions;
+    bool color = false;
+    bool hasJumps = false;
+
+    std::vector<double> numbers;
+    std::vector<Color> colors;
+    std::vector<std::string> keys;
+    std::vector<Value> values;
+    std::vector<Curve> curves;
+    std::vector<MatchTable> matches;
+    std::vector<std::vector<uint32_t>> jumpTables;
+    std::vector<const Expression*> subexpressions;
+
+private:
+    // Executes an instruction other than a jump for each of the lanes.
+    template <class Lanes>
+    void execute(const Instruction&, const EvaluationContext&, Lanes&) const;
+};
+
+namespace {
+
+class Compiler {
+public:
+    using Program = CompiledExpression::Program;
+
+    Compiler(Program& program_) : program(program_) {}
+
+    // Compiles the expression so that it leaves its result in register `dst` of the file
+    // for its type.
+    void compile(const Expression&, uint8_t dst);
+
+    uint8_t allocate(bool color) {
+        uint8_t& top = color ? colorTop : numberTop;
+        if (top == (color ? colorRegisters : numberRegisters)) {
+            overflow = true;
+            return 0;
+        }
+        return top++;
+    }
+
+    bool overflow = false;
+
+private:
+    // Releases the registers that were allocated during its lifetime.
+    class Scratch {
+    public:
+        Scratch(Compiler& compiler_)
+            : compiler(compiler_), numberTop(compiler.numberTop), colorTop(compiler.colorTop) {}
+        ~Scratch() {
+            compiler.numberTop = numberTop;
+            compiler.colorTop = colorTop;
+        }
+
+    private:
+        Compiler& compiler;
+        const uint8_t numberTop;
+        const uint8_t colorTop;
+    };
+
+    static bool isColor(const Expression& expression) {
+        return expression.getType() == type::Color;
+    }
+
+    std::size_t emit(Opcode op, uint8_t dst = 0, uint8_t a = 0, uint8_t b = 0, uint32_t operand = 0) {
+        program.instructions.push_back({ op, dst, a, b, operand });
+        return program.instructions.size() - 1;
+    }
+
+    uint32_t here() const {
+        return static_cast<uint32_t>(program.instructions.size());
+    }
+
+    void patch(std::size_t instruction, uint32_t target) {
+        program.instructions[instruction].operand = target;
+    }
+
+    template <class T>
+    static uint32_t add(std::vector<T>& pool, T value) {
+        pool.push_back(std::move(value));
+        return static_cast<uint32_t>(pool.size() - 1);
+    }
+
+    optional<Value> constantValue(const Expression&) const;
+    optional<uint32_t> addConstants(const std::vector<const Expression*>&, bool color);
+    void emitConstant(const Value&, uint8_t dst);
+    void emitEvaluate(const Expression&, uint8_t dst);
+
+    void compileCompound(const Expression&, uint8_t dst);
+    void compileVarargs(const std::vector<const Expression*>&, Opcode, double identity, uint8_t dst);
+    void compileAssertion(const Expression&, uint8_t dst);
+    void compileComparison(const Expression&, uint8_t dst);
+    void compileBoolean(const Expression&, bool any, uint8_t dst);
+    void compileCase(const Expression&, uint8_t dst);
+    void compileStep(const Step&, uint8_t dst);
+    void compileInterpolate(const Interpolate&, uint8_t dst);
+    void compileMatch(const Match<int64_t>&, uint8_t dst);
+    void compileMatch(const Match<std::string>&, uint8_t dst);
+    void compileSelection(const std::vector<const Expression*>& outputs, bool color, uint8_t index, uint8_t dst);
+
+    Program& program;
+    uint8_t numberTop = 0;
+    uint8_t colorTop = 0;
+};
+
+// Returns the value of expressions that evaluate to the same value in every context.
+optional<Value> Compiler::constantValue(const Expression& expression) const {
+    if (expression.getKind() == Kind::Literal) {
+        return static_cast<const Literal&>(expression).getValue();
+    }
+
+    static const std::array<std::string, 3> contextProperties {{ "zoom", "heatmap-density", "line-progress" }};
+    if (!isFeatureConstant(expression) || !isGlobalPropertyConstant(expression, contextProperties) ||
+        usesVariables(expression)) {
+        return {};
+    }
+
+    const EvaluationResult result = expression.evaluate(EvaluationContext());
+    if (!result) {
+        return {};
+    }
+    return *result;
+}
+
+void Compiler::emitConstant(const Value& value, uint8_t dst) {
+    value.match(
+        [&](double number) { emit(Opcode::LoadNumber, dst, 0, 0, add(program.numbers, number)); },
+        [&](bool boolean) { emit(Opcode::LoadNumber, dst, 0, 0, add(program.numbers, boolean ? 1.0 : 0.0)); },
+        [&](const Color& color) { emit(Opcode::LoadColor, dst, 0, 0, add(program.colors, color)); },
+        [&](const auto&) { assert(false); }
+    );
+}
+
+void Compiler::emitEvaluate(const Expression& expression, uint8_t dst) {
+    const Opcode op = isColor(expression) ? Opcode::EvaluateColor
+        : expression.getType() == type::Boolean ? Opcode::EvaluateBoolean
+        : Opcode::EvaluateNumber;
+    emit(op, dst, 0, 0, add(program.subexpressions, &expression));
+}
+
+void Compiler::compile(const Expression& expression, uint8_t dst) {
+    assert(expression.getType() == type::Number ||
+           expression.getType() == type::Boolean ||
+           expression.getType() == type::Color);
+
+    if (optional<Value> constant = constantValue(expression)) {
+        emitConstant(*constant, dst);
+        return;
+    }
+
+    switch (expression.getKind()) {
+    case Kind::CompoundExpression:
+        compileCompound(expression, dst);
+        return;
+    case Kind::Assertion:
+        compileAssertion(expression, dst);
+        return;
+    case Kind::Comparison:
+        compileComparison(expression, dst);
+        return;
+    case Kind::Any:
+        compileBoolean(expression, true, dst);
+        return;
+    case Kind::All:
+        compileBoolean(expression, false, dst);
+        return;
+    case Kind::Case:
+        compileCase(expression, dst);
+        return;
+    case Kind::Step:
+        compileStep(static_cast<const Step&>(expression), dst);
+        return;
+    case Kind::Interpolate:
+        compileInterpolate(static_cast<const Interpolate&>(expression), dst);
+        return;
+    case Kind::Match:
+        if (auto numeric = dynamic_cast<const Match<int64_t>*>(&expression)) {
+            compileMatch(*numeric, dst);
+        } else {
+            compileMatch(static_cast<const Match<std::string>&>(expression), dst);
+        }
+        return;
+    default:
+        emitEvaluate(expression, dst);
+        return;
+    }
+}
+
+void Compiler::compileCompound(const Expression& expression, uint8_t dst) {
+    static const std::unordered_map<std::string, Opcode> binary {
+        { "/", Opcode::Divide },
+        { "%", Opcode::Modulo },
+        { "^", Opcode::Power },
+    };
+    static const std::unordered_map<std::string, Opcode> unary {
+        { "!", Opcode::Not },
+        { "sqrt", Opcode::Sqrt },
+        { "log10", Opcode::Log10 },
+        { "ln", Opcode::Ln },
+        { "log2", Opcode::Log2 },
+        { "sin", Opcode::Sin },
+        { "cos", Opcode::Cos },
+        { "tan", Opcode::Tan },
+        { "asin", Opcode::Asin },
+        { "acos", Opcode::Acos },
+        { "atan", Opcode::Atan },
+        { "round", Opcode::Round },
+        { "floor", Opcode::Floor },
+        { "ceil", Opcode::Ceil },
+        { "abs", Opcode::Abs },
+    };
+
+    const std::string name = expression.getOperator();
+    const std::vector<const Expression*> args = children(expression);
+
+    if (name == "zoom") {
+        emit(Opcode::LoadZoom, dst);
+    } else if (name == "heatmap-density" || name == "line-progress") {
+        emit(Opcode::LoadColorRampParameter, dst);
+    } else if (name == "has" && args.size() == 1 && args[0]->getKind() == Kind::Literal &&
+               static_cast<const Literal*>(args[0])->getValue().is<std::string>()) {
+        const std::string key = static_cast<const Literal*>(args[0])->getValue().get<std::string>();
+        emit(Opcode::HasProperty, dst, 0, 0, add(program.keys, key));
+    } else if (name == "+") {
+        compileVarargs(args, Opcode::Add, 0.0, dst);
+    } else if (name == "*") {
+        compileVarargs(args, Opcode::Multiply, 1.0, dst);
+    } else if (name == "min") {
+        compileVarargs(args, Opcode::Min, std::numeric_limits<double>::infinity(), dst);
+    } else if (name == "max") {
+        compileVarargs(args, Opcode::Max, -std::numeric_limits<double>::infinity(), dst);
+    } else if (name == "-" && args.size() == 1) {
+        compile(*args[0], dst);
+        emit(Opcode::Negate, dst, dst);
+    } else if ((name == "-" || binary.count(name)) && args.size() == 2) {
+        Scratch scratch(*this);
+        const uint8_t rhs = allocate(false);
+        compile(*args[0], dst);
+        compile(*args[1], rhs);
+        emit(name == "-" ? Opcode::Subtract : binary.at(name), dst, dst, rhs);
+    } else if (unary.count(name) && args.size() == 1) {
+        compile(*args[0], dst);
+        emit(unary.at(name), dst, dst);
+    } else if ((name == "rgba" && args.size() == 4) || (name == "rgb" && args.size() == 3)) {
+        Scratch scratch(*this);
+        const uint8_t channels = allocate(false);
+        for (std::size_t i = 1; i < 4; ++i) {
+            allocate(false);
+        }
+        for (std::size_t i = 0; i < args.size(); ++i) {
+            compile(*args[i], static_cast<uint8_t>(channels + i));
+        }
+        if (args.size() == 3) {
+            emit(Opcode::LoadNumber, static_cast<uint8_t>(channels + 3), 0, 0, add(program.numbers, 1.0));
+        }
+        emit(Opcode::Rgba, dst, channels);
+    } else {
+        emitEvaluate(expression, dst);
+    }
+}
+
+// Folds the arguments into the identity element in order, like the varargs functions do.
+void Compiler::compileVarargs(const std::vector<const Expression*>& args, Opcode op, double identity, uint8_t dst) {
+    emit(Opcode::LoadNumber, dst, 0, 0, add(program.numbers, identity));
+    Scratch scratch(*this);
+    const uint8_t arg = allocate(false);
+    for (const Expression* expression : args) {
+        compile(*expression, arg);
+        emit(op, dst, arg, dst);
+    }
+}
+
+void Compiler::compileAssertion(const Expression& expression, uint8_t dst) {
+    const std::vector<const Expression*> inputs = children(expression);
+    if (inputs.size() == 1) {
+        const type::Type& type = expression.getType();
+        if (inputs[0]->getType() == type) {
+            compile(*inputs[0], dst);
+            return;
+        }
+        if (optional<std::string> key = propertyKey(*inputs[0])) {
+            if (type == type::Number) {
+                emit(Opcode::LoadNumberProperty, dst, 0, 0, add(program.keys, *key));
+                return;
+            } else if (type == type::Boolean) {
+                emit(Opcode::LoadBooleanProperty, dst, 0, 0, add(program.keys, *key));
+                return;
+            }
+        }
+    }
+    emitEvaluate(expression, dst);
+}
+
+void Compiler::compileComparison(const Expression& expression, uint8_t dst) {
+    static const std::unordered_map<std::string, Opcode> ops {
+        { "==", Opcode::Equal },
+        { "!=", Opcode::NotEqual },
+        { "<", Opcode::Less },
+        { "<=", Opcode::LessEqual },
+        { ">", Opcode::Greater },
+        { ">=", Opcode::GreaterEqual },
+    };
+
+    const std::string op = expression.getOperator();
+    if (!dynamic_cast<const BasicComparison*>(&expression) || !ops.count(op)) {
+        emitEvaluate(expression, dst);
+        return;
+    }
+
+    const std::vector<const Expression*> args = children(expression);
+    assert(args.size() == 2);
+    const type::Type& lhsType = args[0]->getType();
+    const type::Type& rhsType = args[1]->getType();
+
+    if (lhsType == rhsType && (lhsType == type::Number || lhsType == type::Boolean)) {
+        Scratch scratch(*this);
+        const uint8_t rhs = allocate(false);
+        compile(*args[0], dst);
+        compile(*args[1], rhs);
+        emit(ops.at(op), dst, dst, rhs);
+        return;
+    }
+
+    // ["==", ["get", key], literal] and the like compare the property without converting it.
+    if (op == "==" || op == "!=") {
+        for (std::size_t i = 0; i < 2; ++i) {
+            const optional<std::string> key = propertyKey(*args[i]);
+            const Expression& other = *args[1 - i];
+            if (!key || other.getKind() != Kind::Literal) {
+                continue;
+            }
+            const Value literal = static_cast<const Literal&>(other).getValue();
+            if (!literal.is<std::string>() && !literal.is<double>() && !literal.is<bool>()) {
+                continue;
+            }
+            if (program.values.size() > std::numeric_limits<uint8_t>::max()) {
+                break;
+            }
+            const uint8_t value = static_cast<uint8_t>(add(program.values, literal));
+            emit(Opcode::PropertyEquals, dst, value, 0, add(program.keys, *key));
+            if (op == "!=") {
+                emit(Opcode::Not, dst, dst);
+            }
+            return;
+        }
+    }
+
+    emitEvaluate(expression, dst);
+}
+
+// Short-circuits like Any and All do.
+void Compiler::compileBoolean(const Expression& expression, bool any, uint8_t dst) {
+    const std::vector<const Expression*> inputs = children(expression);
+    if (inputs.empty()) {
+        emit(Opcode::LoadNumber, dst, 0, 0, add(program.numbers, any ? 0.0 : 1.0));
+        return;
+    }
+
+    std::vector<std::size_t> exits;
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        compile(*inputs[i], dst);
+        if (i + 1 < inputs.size()) {
+            exits.push_back(emit(any ? Opcode::JumpIfTrue : Opcode::JumpIfFalse, 0, dst));
+        }
+    }
+    for (std::size_t exit : exits) {
+        patch(exit, here());
+    }
+}
+
+void Compiler::compileCase(const Expression& expression, uint8_t dst) {
+    // Tests and outputs alternate, followed by the otherwise output.
+    const std::vector<const Expression*> args = children(expression);
+    assert(args.size() % 2 == 1);
+
+    std::vector<std::size_t> exits;
+    for (std::size_t i = 0; i + 1 < args.size(); i += 2) {
+        std::size_t next;
+        {
+            Scratch scratch(*this);
+            const uint8_t test = allocate(false);
+            compile(*args[i], test);
+            next = emit(Opcode::JumpIfFalse, 0, test);
+        }
+        compile(*args[i + 1], dst);
+        exits.push_back(emit(Opcode::Jump));
+        patch(next, here());
+    }
+    compile(*args.back(), dst);
+
+    for (std::size_t exit : exits) {
+        patch(exit, here());
+    }
+}
+
+
+// Adds the values of the outputs to the constant numbers or colors, if they're all constant,
+// and returns the index of the first one.
+optional<uint32_t> Compiler::addConstants(const std::vector<const Expression*>& outputs, bool color) {
+    std::vector<Value> constants;
+    for (const Expression* output : outputs) {
+        optional<Value> constant = constantValue(*output);
+        if (!constant) {
+            return {};
+        }
+        constants.push_back(std::move(*constant));
+    }
+
+    const uint32_t first = static_cast<uint32_t>(color ? program.colors.size() : program.numbers.size());
+    for (const Value& constant : constants) {
+        if (color) {
+            program.colors.push_back(constant.get<Color>());
+        } else if (constant.is<bool>()) {
+            program.numbers.push_back(constant.get<bool>() ? 1.0 : 0.0);
+        } else {
+            program.numbers.push_back(constant.get<double>());
+        }
+    }
+    return first;
+}
+
+// Compiles the outputs of a step or match expression, of which register `index` holds the
+// index of the selected one. Outputs that are all constant are selected without jumping.
+void Compiler::compileSelection(const std::vector<const Expression*>& outputs, bool color, uint8_t index, uint8_t dst) {
+    if (optional<uint32_t> constants = addConstants(outputs, color)) {
+        emit(color ? Opcode::SelectColor : Opcode::SelectNumber, dst, index, 0, *constants);
+        return;
+    }
+
+    const uint32_t table = add(program.jumpTables, std::vector<uint32_t>());
+    emit(Opcode::JumpTable, 0, index, 0, table);
+
+    std::vector<uint32_t> targets;
+    std::vector<std::size_t> exits;
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+        targets.push_back(here());
+        compile(*outputs[i], dst);
+        if (i + 1 < outputs.size()) {
+            exits.push_back(emit(Opcode::Jump));
+        }
+    }
+    for (std::size_t exit : exits) {
+        patch(exit, here());
+    }
+
+    program.jumpTables[table] = std::move(targets);
+}
+
+void Compiler::compileStep(const Step& step, uint8_t dst) {
+    Curve curve;
+    std::vector<const Expression*> outputs;
+    step.eachStop([&](double input, const Expression& output) {
+        curve.inputs.push_back(input);
+        outputs.push_back(&output);
+    });
+
+    Scratch scratch(*this);
+    const uint8_t input = allocate(false);
+    const uint8_t index = allocate(false);
+    compile(*step.getInput(), input);
+    emit(Opcode::StepIndex, index, input, 0, add(program.curves, std::move(curve)));
+    compileSelection(outputs, isColor(step), index, dst);
+}
+
+void Compiler::compileInterpolate(const Interpolate& interpolate, uint8_t dst) {
+    const bool color = isColor(interpolate);
+    if (!color && interpolate.getType() != type::Number) {
+        emitEvaluate(interpolate, dst);
+        return;
+    }
+
+    Curve curve;
+    curve.interpolate = &interpolate;
+    std::vector<const Expression*> outputs;
+    interpolate.eachStop([&](double input, const Expression& output) {
+        curve.inputs.push_back(input);
+        outputs.push_back(&output);
+    });
+
+    Scratch scratch(*this);
+    const uint8_t input = allocate(false);
+    compile(*interpolate.getInput(), input);
+
+    // Stops with constant outputs, like most of them have, are interpolated by a single instruction.
+    if (optional<uint32_t> constants = addConstants(outputs, color)) {
+        curve.outputs = *constants;
+        emit(color ? Opcode::InterpolateColor : Opcode::InterpolateNumber, dst, input, 0,
+             add(program.curves, std::move(curve)));
+        return;
+    }
+
+    const uint8_t factor = allocate(false);
+    const uint32_t index = add(program.curves, Curve());
+    emit(Opcode::InterpolateJump, 0, input, factor, index);
+
+    std::vector<std::size_t> exits;
+    for (const Expression* output : outputs) {
+        curve.targets.push_back(here());
+        compile(*output, dst);
+        exits.push_back(emit(Opcode::Jump));
+    }
+    for (std::size_t i = 0; i + 1 < outputs.size(); ++i) {
+        curve.pairTargets.push_back(here());
+        Scratch pairScratch(*this);
+        const uint8_t upper = allocate(color);
+        compile(*outputs[i], dst);
+        compile(*outputs[i + 1], upper);
+        emit(color ? Opcode::LerpColor : Opcode::LerpNumber, dst, upper, factor);
+        exits.push_back(emit(Opcode::Jump));
+    }
+    for (std::size_t exit : exits) {
+        patch(exit, here());
+    }
+
+    program.curves[index] = std::move(curve);
+}
+
+void Compiler::compileMatch(const Match<int64_t>& match, uint8_t dst) {
+    MatchTable table;
+    const std::vector<const Expression*> outputs = matchOutputs(match, table);
+    const Expression& input = *match.getInput();
+
+    Scratch scratch(*this);
+    const uint8_t index = allocate(false);
+    if (input.getType() == type::Number) {
+        const uint8_t value = allocate(false);
+        compile(input, value);
+        emit(Opcode::MatchIndex, index, value, 0, add(program.matches, std::move(table)));
+    } else if (optional<std::string> key = propertyKey(input)) {
+        table.key = add(program.keys, *key);
+        emit(Opcode::MatchNumberPropertyIndex, index, 0, 0, add(program.matches, std::move(table)));
+    } else {
+        emitEvaluate(match, dst);
+        return;
+    }
+    compileSelection(outputs, isColor(match), index, dst);
+}
+
+void Compiler::compileMatch(const Match<std::string>& match, uint8_t dst) {
+    const optional<std::string> key = propertyKey(*match.getInput());
+    if (!key) {
+        emitEvaluate(match, dst);
+        return;
+    }
+
+    MatchTable table;
+    const std::vector<const Expression*> outputs = matchOutputs(match, table);
+    table.key = add(program.keys, *key);
+
+    Scratch scratch(*this);
+    const uint8_t index = allocate(false);
+    emit(Opcode::MatchStringPropertyIndex, index, 0, 0, add(program.matches, std::move(table)));
+    compileSelection(outputs, isColor(match), index, dst);
+}
+
+} // namespace
+
+namespace {
+
+template <class Lanes, class Fn>
+void unary(Lanes& lanes, const Instruction& i, Fn fn) {
+    lanes.each([&](Registers& r, const GeometryTileFeature*) {
+        r.n[i.dst] = fn(r.n[i.a]);
+        return true;
+    });
+}
+
+template <class Lanes, class Fn>
+void binary(Lanes& lanes, const Instruction& i, Fn fn) {
+    lanes.each([&](Registers& r, const GeometryTileFeature*) {
+        r.n[i.dst] = fn(r.n[i.a], r.n[i.b]);
+        return true;
+    });
+}
+
+} // namespace
+
+template <class Lanes>
+void CompiledExpression::Program::execute(const Instruction& i, const EvaluationContext& context, Lanes& lanes) const {
+    switch (i.op) {
+    case Opcode::LoadNumber:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            r.n[i.dst] = numbers[i.operand];
+            return true;
+        });
+        break;
+    case Opcode::LoadColor:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            r.c[i.dst] = colors[i.operand];
+            return true;
+        });
+        break;
+    case Opcode::LoadZoom:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            r.n[i.dst] = context.zoom ? *context.zoom : 0.0;
+            return bool(context.zoom);
+        });
+        break;
+    case Opcode::LoadColorRampParameter:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            r.n[i.dst] = context.colorRampParameter ? *context.colorRampParameter : 0.0;
+            return bool(context.colorRampParameter);
+        });
+        break;
+    case Opcode::LoadNumberProperty:
+        lanes.each([&](Registers& r, const GeometryTileFeature* feature) {
+            if (!feature) return false;
+            optional<mbgl::Value> storage;
+            const mbgl::Value* property = feature->findValue(keys[i.operand], storage);
+            const optional<double> value = property ? numericValue(*property) : optional<double>();
+            if (!value) return false;
+            r.n[i.dst] = *value;
+            return true;
+        });
+        break;
+    case Opcode::LoadBooleanProperty:
+        lanes.each([&](Registers& r, const GeometryTileFeature* feature) {
+            if (!feature) return false;
+            optional<mbgl::Value> storage;
+            const mbgl::Value* property = feature->findValue(keys[i.operand], storage);
+            if (!property || !property->is<bool>()) return false;
+            r.n[i.dst] = property->get<bool>();
+            return true;
+        });
+        break;
+    case Opcode::HasProperty:
+        lanes.each([&](Registers& r, const GeometryTileFeature* feature) {
+            if (!feature) return false;
+            optional<mbgl::Value> storage;
+            r.n[i.dst] = bool(feature->findValue(keys[i.operand], storage));
+            return true;
+        });
+        break;
+    case Opcode::PropertyEquals:
+        lanes.each([&](Registers& r, const GeometryTileFeature* feature) {
+            if (!feature) return false;
+            optional<mbgl::Value> storage;
+            r.n[i.dst] = propertyEquals(feature->findValue(keys[i.operand], storage), values[i.a]);
+            return true;
+        });
+        break;
+
+    case Opcode::Add:
+        binary(lanes, i, [](double a, double b) { return a + b; });
+        break;
+    case Opcode::Subtract:
+        binary(lanes, i, [](double a, double b) { return a - b; });
+        break;
+    case Opcode::Multiply:
+        binary(lanes, i, [](double a, double b) { return a * b; });
+        break;
+    case Opcode::Divide:
+        binary(lanes, i, [](double a, double b) { return a / b; });
+        break;
+    case Opcode::Modulo:
+        binary(lanes, i, [](double a, double b) { return std::fmod(a, b); });
+        break;
+    case Opcode::Power:
+        binary(lanes, i, [](double a, double b) { return std::pow(a, b); });
+        break;
+    case Opcode::Min:
+        binary(lanes, i, [](double a, double b) { return std::fmin(a, b); });
+        break;
+    case Opcode::Max:
+        binary(lanes, i, [](double a, double b) { return std::fmax(a, b); });
+        break;
+    case Opcode::Equal:
+        binary(lanes, i, [](double a, double b) -> double { return a == b; });
+        break;
+    case Opcode::NotEqual:
+        binary(lanes, i, [](double a, double b) -> double { return a != b; });
+        break;
+    case Opcode::Less:
+        binary(lanes, i, [](double a, double b) -> double { return a < b; });
+        break;
+    case Opcode::LessEqual:
+        binary(lanes, i, [](double a, double b) -> double { return a <= b; });
+        break;
+    case Opcode::Greater:
+        binary(lanes, i, [](double a, double b) -> double { return a > b; });
+        break;
+    case Opcode::GreaterEqual:
+        binary(lanes, i, [](double a, double b) -> double { return a >= b; });
+        break;
+
+    case Opcode::Negate:
+        unary(lanes, i, [](double a) { return -a; });
+        break;
+    case Opcode::Not:
+        unary(lanes, i, [](double a) -> double { return !a; });
+        break;
+    case Opcode::Sqrt:
+        unary(lanes, i, [](double a) { return std::sqrt(a); });
+        break;
+    case Opcode::Log10:
+        unary(lanes, i, [](double a) { return std::log10(a); });
+        break;
+    case Opcode::Ln:
+        unary(lanes, i, [](double a) { return std::log(a); });
+        break;
+    case Opcode::Log2:
+        unary(lanes, i, [](double a) { return util::log2(a); });
+        break;
+    case Opcode::Sin:
+        unary(lanes, i, [](double a) { return std::sin(a); });
+        break;
+    case Opcode::Cos:
+        unary(lanes, i, [](double a) { return std::cos(a); });
+        break;
+    case Opcode::Tan:
+        unary(lanes, i, [](double a) { return std::tan(a); });
+        break;
+    case Opcode::Asin:
+        unary(lanes, i, [](double a) { return std::asin(a); });
+        break;
+    case Opcode::Acos:
+        unary(lanes, i, [](double a) { return std::acos(a); });
+        break;
+    case Opcode::Atan:
+        unary(lanes, i, [](double a) { return std::atan(a); });
+        break;
+    case Opcode::Round:
+        unary(lanes, i, [](double a) { return ::round(a); });
+        break;
+    case Opcode::Floor:
+        unary(lanes, i, [](double a) { return std::floor(a); });
+        break;
+    case Opcode::Ceil:
+        unary(lanes, i, [](double a) { return std::ceil(a); });
+        break;
+    case Opcode::Abs:
+        unary(lanes, i, [](double a) { return std::abs(a); });
+        break;
+
+    case Opcode::Rgba:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            const Result<Color> color = rgba(r.n[i.a], r.n[i.a + 1], r.n[i.a + 2], r.n[i.a + 3]);
+            if (!color) return false;
+            r.c[i.dst] = *color;
+            return true;
+        });
+        break;
+
+    case Opcode::InterpolateNumber:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            const Curve& curve = curves[i.operand];
+            std::size_t stop;
+            float t;
+            if (!findStop(curve, r.n[i.a], stop, t)) return false;
+            const double* outputs = numbers.data() + curve.outputs;
+            r.n[i.dst] = t != 0.0f ? util::interpolate(outputs[stop], outputs[stop + 1], t) : outputs[stop];
+            return true;
+        });
+        break;
+    case Opcode::InterpolateColor:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            const Curve& curve = curves[i.operand];
+            std::size_t stop;
+            float t;
+            if (!findStop(curve, r.n[i.a], stop, t)) return false;
+            const Color* outputs = colors.data() + curve.outputs;
+            r.c[i.dst] = t != 0.0f ? util::interpolate(outputs[stop], outputs[stop + 1], t) : outputs[stop];
+            return true;
+        });
+        break;
+    case Opcode::LerpNumber:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            r.n[i.dst] = util::interpolate(r.n[i.dst], r.n[i.a], static_cast<float>(r.n[i.b]));
+            return true;
+        });
+        break;
+    case Opcode::LerpColor:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            r.c[i.dst] = util::interpolate(r.c[i.dst], r.c[i.a], static_cast<float>(r.n[i.b]));
+            return true;
+        });
+        break;
+
+    case Opcode::StepIndex:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            std::size_t stop;
+            float t;
+            if (!findStop(curves[i.operand], r.n[i.a], stop, t)) return false;
+            r.n[i.dst] = stop;
+            return true;
+        });
+        break;
+    case Opcode::MatchIndex:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            r.n[i.dst] = matchInteger(matches[i.operand], r.n[i.a]);
+            return true;
+        });
+        break;
+    case Opcode::MatchNumberPropertyIndex:
+        lanes.each([&](Registers& r, const GeometryTileFeature* feature) {
+            if (!feature) return false;
+            const MatchTable& table = matches[i.operand];
+            optional<mbgl::Value> storage;
+            const mbgl::Value* property = feature->findValue(keys[table.key], storage);
+            const optional<double> value = property ? numericValue(*property) : optional<double>();
+            r.n[i.dst] = value ? matchInteger(table, *value) : table.otherwise;
+            return true;
+        });
+        break;
+    case Opcode::MatchStringPropertyIndex:
+        lanes.each([&](Registers& r, const GeometryTileFeature* feature) {
+            if (!feature) return false;
+            const MatchTable& table = matches[i.operand];
+            optional<mbgl::Value> storage;
+            const mbgl::Value* property = feature->findValue(keys[table.key], storage);
+            r.n[i.dst] = table.otherwise;
+            if (property && property->is<std::string>()) {
+                auto it = table.strings.find(property->get<std::string>());
+                if (it != table.strings.end()) {
+                    r.n[i.dst] = it->second;
+                }
+            }
+            return true;
+        });
+        break;
+    case Opcode::SelectNumber:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            r.n[i.dst] = numbers[i.operand + static_cast<std::size_t>(r.n[i.a])];
+            return true;
+        });
+        break;
+    case Opcode::SelectColor:
+        lanes.each([&](Registers& r, const GeometryTileFeature*) {
+            r.c[i.dst] = colors[i.operand + static_cast<std::size_t>(r.n[i.a])];
+            return true;
+        });
+        break;
+
+    case Opcode::EvaluateNumber:
+    case Opcode::EvaluateBoolean:
+    case Opcode::EvaluateColor:
+        lanes.each([&](Registers& r, const GeometryTileFeature* feature) {
+            EvaluationContext featureContext = context;
+            featureContext.feature = feature;
+            const EvaluationResult result = subexpressions[i.operand]->evaluate(featureContext);
+            if (!result) {
+                return false;
+            } else if (i.op == Opcode::EvaluateNumber && result->is<double>()) {
+                r.n[i.dst] = result->get<double>();
+            } else if (i.op == Opcode::EvaluateBoolean && result->is<bool>()) {
+                r.n[i.dst] = result->get<bool>();
+            } else if (i.op == Opcode::EvaluateColor && result->is<Color>()) {
+                r.c[i.dst] = result->get<Color>();
+            } else {
+                return false;
+            }
+            return true;
+        });
+        break;
+
+    case Opcode::Jump:
+    case Opcode::JumpIfTrue:
+    case Opcode::JumpIfFalse:
+    case Opcode::JumpTable:
+    case Opcode::InterpolateJump:
+        assert(false);
+        break;
+    }
+}
+
+bool CompiledExpression::Program::run(const EvaluationContext& context, SingleLane& lane) const {
+    const double* const n = lane.registers.n;
+
+    const std::size_t size = instructions.size();
+    for (std::size_t pc = 0; pc < size;) {
+        const Instruction& i = instructions[pc++];
+        switch (i.op) {
+        case Opcode::Jump:
+            pc = i.operand;
+            break;
+        case Opcode::JumpIfTrue:
+            if (n[i.a]) pc = i.operand;
+            break;
+        case Opcode::JumpIfFalse:
+            if (!n[i.a]) pc = i.operand;
+            break;
+        case Opcode::JumpTable:
+            pc = jumpTables[i.operand][static_cast<std::size_t>(n[i.a])];
+            break;
+        case Opcode::InterpolateJump: {
+            const Curve& curve = curves[i.operand];
+            std::size_t stop;
+            float t;
+            if (!findStop(curve, n[i.a], stop, t)) return false;
+            lane.registers.n[i.b] = t;
+            pc = t != 0.0f ? curve.pairTargets[stop] : curve.targets[stop];
+            break;
+        }
+        default:
+            execute(i, context, lane);
+            if (lane.failed) return false;
+            break;
+        }
+    }
+
+    return true;
+}
+
+void CompiledExpression::Program::run(const EvaluationContext& context, BatchLanes& lanes) const {
+    assert(!hasJumps);
+    for (const Instruction& instruction : instructions) {
+        execute(instruction, context, lanes);
+    }
+}
+
+namespace {
+
+// Evaluates the program for each of the features, and stores the results of those for which
+// evaluation succeeds.
+template <class T, class Result>
+void evaluateFeatures(const CompiledExpression::Program& program,
+                      const EvaluationContext& context,
+                      const std::vector<const GeometryTileFeature*>& features,
+                      std::vector<T>& results,
+                      const T& fallback,
+                      Result result) {
+    results.assign(features.size(), fallback);
+
+    if (program.hasJumps) {
+        for (std::size_t f = 0; f < features.size(); ++f) {
+            SingleLane lane(features[f]);
+            if (program.run(context, lane)) {
+                results[f] = result(lane.registers);
+            }
+        }
+        return;
+    }
+
+    auto lanes = std::make_unique<BatchLanes>();
+    for (std::size_t begin = 0; begin < features.size(); begin += batchSize) {
+        lanes->count = std::min(batchSize, features.size() - begin);
+        for (std::size_t l = 0; l < lanes->count; ++l) {
+            lanes->features[l] = features[begin + l];
+            lanes->failed[l] = false;
+        }
+        program.run(context, *lanes);
+        for (std::size_t l = 0; l < lanes->count; ++l) {
+            if (!lanes->failed[l]) {
+                results[begin + l] = result(lanes->registers[l]);
+            }
+        }
+    }
+}
+
+} // namespace
+
+CompiledExpression::CompiledExpression(std::unique_ptr<const Program> program_)
+    : program(std::move(program_)) {
+}
+
+CompiledExpression::~CompiledExpression() = default;
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(const Expression& expression) {
+    const type::Type type = expression.getType();
+    if (type != type::Number && type != type::Boolean && type != type::Color) {
+        return nullptr;
+    }
+
+    auto program = std::make_unique<Program>();
+    program->color = type == type::Color;
+
+    Compiler compiler(*program);
+    const uint8_t result = compiler.allocate(program->color);
+    compiler.compile(expression, result);
+    if (compiler.overflow) {
+        return nullptr;
+    }
+
+    program->hasJumps = std::any_of(program->instructions.begin(), program->instructions.end(), [](const Instruction& i) {
+        return i.op >= Opcode::Jump;
+    });
+
+    return std::unique_ptr<CompiledExpression>(new CompiledExpression(std::move(program)));
+}
+
+bool CompiledExpression::evaluate(const EvaluationContext& context, float& result) const {
+    assert(!program->color);
+    SingleLane lane(context.feature);
+    if (!program->run(context, lane)) {
+        return false;
+    }
+    result = static_cast<float>(lane.registers.n[0]);
+    return true;
+}
+
+bool CompiledExpression::evaluate(const EvaluationContext& context, bool& result) const {
+    assert(!program->color);
+    SingleLane lane(context.feature);
+    if (!program->run(context, lane)) {
+        return false;
+    }
+    result = lane.registers.n[0] != 0;
+    return true;
+}
+
+bool CompiledExpression::evaluate(const EvaluationContext& context, Color& result) const {
+    assert(program->color);
+    SingleLane lane(context.feature);
+    if (!program->run(context, lane)) {
+        return false;
+    }
+    result = lane.registers.c[0];
+    return true;
+}
+
+void CompiledExpression::evaluate(const EvaluationContext& context,
+                                  const std::vector<const GeometryTileFeature*>& features,
+                                  std::vector<float>& results,
+                                  const float fallback) const {
+    assert(!program->color);
+    evaluateFeatures(*program, context, features, results, fallback, [](const Registers& r) {
+        return static_cast<float>(r.n[0]);
+    });
+}
+
+void CompiledExpression::evaluate(const EvaluationContext& context,
+                                  const std::vector<const GeometryTileFeature*>& features,
+                                  std::vector<bool>& results,
+                                  const bool fallback) const {
+    assert(!program->color);
+    evaluateFeatures(*program, context, features, results, fallback, [](const Registers& r) {
+        return r.n[0] != 0;
+    });
+}
+
+void CompiledExpression::evaluate(const EvaluationContext& context,
+                                  const std::vector<const GeometryTileFeature*>& features,
+                                  std::vector<Color>& results,
+                                  const Color& fallback) const {
+    assert(program->color);
+    evaluateFeatures(*program, context, features, results, fallback, [](const Registers& r) {
+        return r.c[0];
+    });
+}
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
@@ -234,10 +234,26 @@ Value featureIdAsExpressionValue(EvaluationContext params) {
 
 optional<Value> featurePropertyAsExpressionValue(EvaluationContext params, const std::string& key) {
     assert(params.feature);
-    auto property = params.feature->getValue(key);
+    optional<mbgl::Value> storage;
+    const mbgl::Value* property = params.feature->findValue(key, storage);
     return property ? toExpressionValue(*property) : optional<Value>();
 };
 
+// Compares without converting the property to an expression value, so that comparing string
+// properties doesn't copy them.
+bool featurePropertyEquals(EvaluationContext params, const std::string& key, const Value& value) {
+    assert(params.feature);
+    optional<mbgl::Value> storage;
+    const mbgl::Value* property = params.feature->findValue(key, storage);
+    if (!property) {
+        return false;
+    }
+    if (property->is<std::string>()) {
+        return value.is<std::string>() && value.get<std::string>() == property->get<std::string>();
+    }
+    return value == toExpressionValue(*property);
+};
+
 optional<std::string> featureTypeAsString(FeatureType type) {
     switch(type) {
     case FeatureType::Point:
@@ -255,23 +271,25 @@ optional<std::string> featureTypeAsString(FeatureType type) {
 
 optional<double> featurePropertyAsDouble(EvaluationContext params, const std::string& key) {
     assert(params.feature);
-    auto property = params.feature->getValue(key);
+    optional<mbgl::Value> storage;
+    const mbgl::Value* property = params.feature->findValue(key, storage);
     if (!property) return {};
     return property->match(
         [](double value) { return value; },
         [](uint64_t value) { return optional<double>(static_cast<double>(value)); },
         [](int64_t value) { return optional<double>(static_cast<double>(value)); },
-        [](auto) { return optional<double>(); }
+        [](const auto&) { return optional<double>(); }
     );
 };
 
 optional<std::string> featurePropertyAsString(EvaluationContext params, const std::string& key) {
     assert(params.feature);
-    auto property = params.feature->getValue(key);
+    optional<mbgl::Value> storage;
+    const mbgl::Value* property = params.feature->findValue(key, storage);
     if (!property) return {};
     return property->match(
-        [](std::string value) { return value; },
-        [](auto) { return optional<std::string>(); }
+        [](const std::string& value) { return optional<std::string>(value); },
+        [](const auto&) { return optional<std::string>(); }
     );
 };
 
@@ -376,7 +394,8 @@ const auto& hasContextCompoundExpression() {
             };
         }
 
-        return params.feature->getValue(key) ? true : false;
+        optional<mbgl::Value> storage;
+        return params.feature->findValue(key, storage) ? true : false;
     });
     return signature;
 }
@@ -396,7 +415,8 @@ const auto& getContextCompoundExpression() {
             };
         }
 
-        auto propertyValue = params.feature->getValue(key);
+        optional<mbgl::Value> storage;
+        const mbgl::Value* propertyValue = params.feature->findValue(key, storage);
         if (!propertyValue) {
             return Null;
         }
@@ -665,8 +685,7 @@ const auto& errorCompoundExpression() {
 // Legacy Filters
 const auto& filterEqualsCompoundExpression() {
     static auto signature = detail::makeSignature("filter-==", [](const EvaluationContext& params, const std::string& key, const Value &lhs) -> Result<bool> {
-        const auto rhs = featurePropertyAsExpressionValue(params, key);
-        return rhs ? lhs == *rhs : false;
+        return featurePropertyEquals(params, key, lhs);
     });
     return signature;
 }
@@ -817,7 +836,8 @@ const auto& filterIdGreaterOrEqualThanStringCompoundExpression() {
 const auto& filterHasCompoundExpression() {
     static auto signature = detail::makeSignature("filter-has", [](const EvaluationContext& params, const std::string& key) -> Result<bool> {
         assert(params.feature);
-        return bool(params.feature->getValue(key));
+        optional<mbgl::Value> storage;
+        return bool(params.feature->findValue(key, storage));
     });
     return signature;
 }
@@ -25,6 +25,10 @@ public:
         }
         return optional<mbgl::Value>();
     }
+    const mbgl::Value* findValue(const std::string& key, optional<mbgl::Value>&) const override {
+        auto it = feature.properties.find(key);
+        return it != feature.properties.end() ? &it->second : nullptr;
+    }
 };
 
 
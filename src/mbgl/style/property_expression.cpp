@@ -8,6 +8,12 @@ PropertyExpressionBase::PropertyExpressionBase(std::unique_ptr<expression::Expre
       zoomCurve(expression::findZoomCurveChecked(expression.get())) {
     isZoomConstant_ = expression::isZoomConstant(*expression);
     isFeatureConstant_ = expression::isFeatureConstant(*expression);
+    if (!isFeatureConstant_) {
+        compiled = expression::CompiledExpression::compile(*expression);
+    }
+    if (zoomCurve.is<const expression::Interpolate*>()) {
+        interpolationFactors = std::make_shared<ZoomEvaluationCache<std::tuple<float, float, float>, float>>();
+    }
 }
 
 bool PropertyExpressionBase::isZoomConstant() const noexcept {
@@ -48,6 +54,15 @@ float PropertyExpressionBase::interpolationFactor(const Range<float>& inputLevel
     );
 }
 
+float PropertyExpressionBase::memoizedInterpolationFactor(const Range<float>& inputLevels, const float inputValue) const {
+    if (!interpolationFactors) {
+        return interpolationFactor(inputLevels, inputValue);
+    }
+    return interpolationFactors->get(std::make_tuple(inputLevels.min, inputLevels.max, inputValue), [&] {
+        return interpolationFactor(inputLevels, inputValue);
+    });
+}
+
 Range<float> PropertyExpressionBase::getCoveringStops(const float lower, const float upper) const noexcept {
     return zoomCurve.match(
         [](std::nullptr_t) {
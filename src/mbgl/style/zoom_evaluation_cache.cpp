@@ -0,0 +1,14 @@
+#include <mbgl/style/zoom_evaluation_cache.hpp>
+
+namespace mbgl {
+namespace style {
+
+ZoomEvaluationStatistics& ZoomEvaluationStatistics::current() {
+    // Trivially destructible, so unlike util::ThreadLocal this needs no cleanup when the
+    // thread exits.
+    static thread_local ZoomEvaluationStatistics statistics;
+    return statistics;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -5,8 +5,10 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/math/minmax.hpp>
+#include <mbgl/math/clamp.hpp>
 #include <mbgl/util/intersection_tests.hpp>
 #include <mbgl/layout/symbol_projection.hpp>
+#include <mbgl/util/transform_points.hpp>
 
 #include <mapbox/geometry/envelope.hpp>
 
@@ -24,10 +26,13 @@ namespace mbgl {
 // stability, but it's expensive.
 static const float viewportPadding = 100;
 
+// The size of the cells of the collision grid.
+static const int cellSize = 25;
+
 CollisionIndex::CollisionIndex(const TransformState& transformState_)
     : transformState(transformState_)
-    , collisionGrid(transformState.getSize().width + 2 * viewportPadding, transformState.getSize().height + 2 * viewportPadding, 25)
-    , ignoredGrid(transformState.getSize().width + 2 * viewportPadding, transformState.getSize().height + 2 * viewportPadding, 25)
+    , collisionGrid(transformState.getSize().width + 2 * viewportPadding, transformState.getSize().height + 2 * viewportPadding, cellSize)
+    , ignoredGrid(transformState.getSize().width + 2 * viewportPadding, transformState.getSize().height + 2 * viewportPadding, cellSize)
     , screenRightBoundary(transformState.getSize().width + viewportPadding)
     , screenBottomBoundary(transformState.getSize().height + viewportPadding)
     , gridRightBoundary(transformState.getSize().width + 2 * viewportPadding)
@@ -35,7 +40,7 @@ CollisionIndex::CollisionIndex(const TransformState& transformState_)
     , pitchFactor(std::cos(transformState.getPitch()) * transformState.getCameraToCenterDistance())
 {}
 
-float CollisionIndex::approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap) {
+float CollisionIndex::approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap) const {
     // This is a quick and dirty solution for chosing which collision circles to use (since collision circles are
     // laid out in tile units). Ideally, I think we should generate collision circles on the fly in viewport coordinates
     // at the time we do collision detection.
@@ -79,53 +84,24 @@ bool CollisionIndex::isInsideTile(const CollisionBox& box, const CollisionTileBo
 }
 
 
-std::pair<bool,bool> CollisionIndex::placeFeature(CollisionFeature& feature,
-                                      Point<float> shift,
-                                      const mat4& posMatrix,
-                                      const mat4& labelPlaneMatrix,
-                                      const float textPixelRatio,
-                                      PlacedSymbol& symbol,
-                                      const float scale,
-                                      const float fontSize,
-                                      const bool allowOverlap,
-                                      const bool pitchWithMap,
-                                      const bool collisionDebug,
-                                      const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate) {
-    if (!feature.alongLine) {
-        CollisionBox& box = feature.boxes.front();
-        const auto projectedPoint = projectAndGetPerspectiveRatio(posMatrix, box.anchor);
-        const float tileToViewport = textPixelRatio * projectedPoint.second;
-        box.px1 = (box.x1 + shift.x) * tileToViewport + projectedPoint.first.x;
-        box.py1 = (box.y1 + shift.y) * tileToViewport + projectedPoint.first.y;
-        box.px2 = (box.x2 + shift.x) * tileToViewport + projectedPoint.first.x;
-        box.py2 = (box.y2 + shift.y) * tileToViewport + projectedPoint.first.y;
-    
+CollisionIndex::Projection CollisionIndex::projectFeature(const CollisionFeature& feature,
+                                                         const mat4& posMatrix,
+                                                         const mat4& labelPlaneMatrix,
+                                                         const float textPixelRatio,
+                                                         const PlacedSymbol& symbol,
+                                                         const float scale,
+                                                         const float fontSize,
+                                                         const bool pitchWithMap) const {
+    Projection projection;
 
-        if ((avoidEdges && !isInsideTile(box, *avoidEdges)) ||
-            !isInsideGrid(box) ||
-            (!allowOverlap && collisionGrid.hitTest({{ box.px1, box.py1 }, { box.px2, box.py2 }}, collisionGroupPredicate))) {
-            return { false, false };
+    if (!feature.alongLine) {
+        if (!feature.boxes.empty()) {
+            const auto projectedPoint = projectAndGetPerspectiveRatio(posMatrix, feature.boxes.front().anchor);
+            projection.anchor = projectedPoint.first;
+            projection.tileToViewport = textPixelRatio * projectedPoint.second;
         }
-
-        return {true, isOffscreen(box)};
-    } else {
-        return placeLineFeature(feature, posMatrix, labelPlaneMatrix, textPixelRatio, symbol, scale, fontSize, allowOverlap, pitchWithMap, collisionDebug, avoidEdges, collisionGroupPredicate);
+        return projection;
     }
-}
-
-std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
-                                      const mat4& posMatrix,
-                                      const mat4& labelPlaneMatrix,
-                                      const float textPixelRatio,
-                                      PlacedSymbol& symbol,
-                                      const float scale,
-                                      const float fontSize,
-                                      const bool allowOverlap,
-                                      const bool pitchWithMap,
-                                      const bool collisionDebug,
-                                      const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate) {
 
     const auto tileUnitAnchorPoint = symbol.anchorPoint;
     const auto projectedAnchor = projectAnchor(posMatrix, tileUnitAnchorPoint);
@@ -147,27 +123,126 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
         labelPlaneMatrix,
         /*return tile distance*/ true);
 
-    bool collisionDetected = false;
-    bool inGrid = false;
-    bool entirelyOffscreen = true;
+    projection.tileToViewport = projectedAnchor.first * textPixelRatio;
+    if (!firstAndLastGlyph) {
+        return projection;
+    }
 
-    const auto tileToViewport = projectedAnchor.first * textPixelRatio;
     // pixelsToTileUnits is used for translating line geometry to tile units
     // ... so we care about 'scale' but not 'perspectiveRatio'
     // equivalent to pixel_to_tile_units
     const auto pixelsToTileUnits = 1 / (textPixelRatio * scale);
 
-    float firstTileDistance = 0, lastTileDistance = 0;
-    if (firstAndLastGlyph) {
-        firstTileDistance = approximateTileDistance(*(firstAndLastGlyph->first.tileDistance), firstAndLastGlyph->first.angle, pixelsToTileUnits, projectedAnchor.second, pitchWithMap);
-        lastTileDistance = approximateTileDistance(*(firstAndLastGlyph->second.tileDistance), firstAndLastGlyph->second.angle, pixelsToTileUnits, projectedAnchor.second, pitchWithMap);
+    projection.fitsOnLine = true;
+    projection.firstTileDistance = approximateTileDistance(*(firstAndLastGlyph->first.tileDistance), firstAndLastGlyph->first.angle, pixelsToTileUnits, projectedAnchor.second, pitchWithMap);
+    projection.lastTileDistance = approximateTileDistance(*(firstAndLastGlyph->second.tileDistance), firstAndLastGlyph->second.angle, pixelsToTileUnits, projectedAnchor.second, pitchWithMap);
+
+    // Project the circles in one batch. Only the ones that the label extends over are used.
+    const size_t count = feature.boxes.size();
+    std::vector<float> anchors(2 * count);
+    std::vector<double> clip(3 * count);
+    for (size_t i = 0; i < count; i++) {
+        anchors[i] = feature.boxes[i].anchor.x;
+        anchors[count + i] = feature.boxes[i].anchor.y;
+    }
+    util::transformPoints(posMatrix, count, anchors.data(), anchors.data() + count,
+                          clip.data(), clip.data() + count, clip.data() + 2 * count);
+
+    projection.circles.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const CollisionBox& circle = feature.boxes[i];
+        if (!(circle.signedDistanceFromAnchor < -projection.firstTileDistance ||
+              circle.signedDistanceFromAnchor > projection.lastTileDistance)) {
+            projection.circles[i] = clipToViewport(clip[i], clip[count + i], clip[2 * count + i]);
+        }
+    }
+
+    return projection;
+}
+
+void CollisionIndex::projectBoxFeatures(const mat4& posMatrix,
+                                        const float textPixelRatio,
+                                        const std::vector<std::pair<const CollisionFeature*, Projection*>>& features) const {
+    const size_t count = features.size();
+    std::vector<float> anchors(2 * count);
+    std::vector<double> clip(3 * count);
+    for (size_t i = 0; i < count; i++) {
+        assert(!features[i].first->alongLine && !features[i].first->boxes.empty());
+        anchors[i] = features[i].first->boxes.front().anchor.x;
+        anchors[count + i] = features[i].first->boxes.front().anchor.y;
+    }
+    util::transformPoints(posMatrix, count, anchors.data(), anchors.data() + count,
+                          clip.data(), clip.data() + count, clip.data() + 2 * count);
+
+    for (size_t i = 0; i < count; i++) {
+        const double w = clip[2 * count + i];
+        Projection& projection = *features[i].second;
+        projection.anchor = clipToViewport(clip[i], clip[count + i], w);
+        projection.tileToViewport = textPixelRatio * perspectiveRatio(w);
     }
+}
+
+namespace {
+
+using CollisionGroupPredicate = optional<std::function<bool(const IndexedSubfeature&)>>;
+
+bool hitTest(const CollisionIndex::CollisionGrid& grid, const CollisionIndex::CollisionGrid::BBox& box, const CollisionGroupPredicate& predicate) {
+    return predicate ? grid.hitTest(box, *predicate) : grid.hitTest(box);
+}
+
+bool hitTest(const CollisionIndex::CollisionGrid& grid, const CollisionIndex::CollisionGrid::BCircle& circle, const CollisionGroupPredicate& predicate) {
+    return predicate ? grid.hitTest(circle, *predicate) : grid.hitTest(circle);
+}
+
+} // namespace
+
+std::pair<bool,bool> CollisionIndex::placeFeature(CollisionFeature& feature,
+                                      const Projection& projection,
+                                      Point<float> shift,
+                                      const bool allowOverlap,
+                                      const bool collisionDebug,
+                                      const optional<CollisionTileBoundaries>& avoidEdges,
+                                      const optional<std::function<bool(const IndexedSubfeature&)>>& collisionGroupPredicate) {
+    if (!feature.alongLine) {
+        CollisionBox& box = feature.boxes.front();
+        const float tileToViewport = projection.tileToViewport;
+        box.px1 = (box.x1 + shift.x) * tileToViewport + projection.anchor.x;
+        box.py1 = (box.y1 + shift.y) * tileToViewport + projection.anchor.y;
+        box.px2 = (box.x2 + shift.x) * tileToViewport + projection.anchor.x;
+        box.py2 = (box.y2 + shift.y) * tileToViewport + projection.anchor.y;
+    
+
+        if ((avoidEdges && !isInsideTile(box, *avoidEdges)) ||
+            !isInsideGrid(box) ||
+            (!allowOverlap && hitTest(collisionGrid, {{ box.px1, box.py1 }, { box.px2, box.py2 }}, collisionGroupPredicate))) {
+            return { false, false };
+        }
+
+        return {true, isOffscreen(box)};
+    } else {
+        return placeLineFeature(feature, projection, allowOverlap, collisionDebug, avoidEdges, collisionGroupPredicate);
+    }
+}
+
+std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
+                                      const Projection& projection,
+                                      const bool allowOverlap,
+                                      const bool collisionDebug,
+                                      const optional<CollisionTileBoundaries>& avoidEdges,
+                                      const optional<std::function<bool(const IndexedSubfeature&)>>& collisionGroupPredicate) {
+    bool collisionDetected = false;
+    bool inGrid = false;
+    bool entirelyOffscreen = true;
+
+    const float tileToViewport = projection.tileToViewport;
+    const float firstTileDistance = projection.firstTileDistance;
+    const float lastTileDistance = projection.lastTileDistance;
 
     bool atLeastOneCirclePlaced = false;
     for (size_t i = 0; i < feature.boxes.size(); i++) {
         CollisionBox& circle = feature.boxes[i];
         const float boxSignedDistanceFromAnchor = circle.signedDistanceFromAnchor;
-        if (!firstAndLastGlyph ||
+        if (!projection.fitsOnLine ||
             (boxSignedDistanceFromAnchor < -firstTileDistance) ||
             (boxSignedDistanceFromAnchor > lastTileDistance)) {
             // The label either doesn't fit on its line or we
@@ -177,7 +252,7 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
             continue;
         }
 
-        const auto projectedPoint = projectPoint(posMatrix, circle.anchor);
+        const auto& projectedPoint = projection.circles[i];
         const float tileUnitRadius = (circle.x2 - circle.x1) / 2;
         const float radius = tileUnitRadius * tileToViewport;
 
@@ -225,7 +300,7 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
         inGrid |= isInsideGrid(circle);
 
         if ((avoidEdges && !isInsideTile(circle, *avoidEdges)) ||
-            (!allowOverlap && collisionGrid.hitTest({{circle.px, circle.py}, circle.radius}, collisionGroupPredicate))) {
+            (!allowOverlap && hitTest(collisionGrid, {{circle.px, circle.py}, circle.radius}, collisionGroupPredicate))) {
             if (!collisionDebug) {
                 return {false, false};
             } else {
@@ -236,7 +311,7 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
         }
     }
 
-    return {!collisionDetected && firstAndLastGlyph && inGrid, entirelyOffscreen};
+    return {!collisionDetected && projection.fitsOnLine && inGrid, entirelyOffscreen};
 }
 
 
@@ -276,6 +351,56 @@ void CollisionIndex::insertFeature(CollisionFeature& feature, bool ignorePlaceme
     }
 }
 
+template <class Fn>
+void CollisionIndex::forEachCell(float x1, float y1, float x2, float y2, Fn fn) const {
+    const int xCellCount = std::ceil(gridRightBoundary / cellSize);
+    const int yCellCount = std::ceil(gridBottomBoundary / cellSize);
+    auto toCell = [](float coordinate, int cellCount) {
+        return static_cast<int>(util::clamp(std::floor(coordinate / cellSize), 0.0f, float(cellCount - 1)));
+    };
+    const int cx1 = toCell(x1, xCellCount);
+    const int cy1 = toCell(y1, yCellCount);
+    const int cx2 = toCell(x2, xCellCount);
+    const int cy2 = toCell(y2, yCellCount);
+    for (int y = cy1; y <= cy2; ++y) {
+        for (int x = cx1; x <= cx2; ++x) {
+            if (fn(std::size_t(y) * xCellCount + x)) {
+                return;
+            }
+        }
+    }
+}
+
+void CollisionIndex::markChanged(const CollisionFeature& feature) {
+    if (changedCells.empty()) {
+        changedCells.resize(std::size_t(std::ceil(gridRightBoundary / cellSize)) * std::ceil(gridBottomBoundary / cellSize));
+    }
+
+    auto mark = [&](std::size_t cell) {
+        changedCells[cell] = true;
+        return false;
+    };
+
+    for (const auto& box : feature.boxes) {
+        if (!feature.alongLine || box.used) {
+            forEachCell(box.px1, box.py1, box.px2, box.py2, mark);
+        }
+    }
+}
+
+bool CollisionIndex::isChanged(const CollisionBox& box, float distance) const {
+    if (changedCells.empty()) {
+        return false;
+    }
+
+    bool changed = false;
+    forEachCell(box.px1 - distance, box.py1 - distance, box.px2 + distance, box.py2 + distance, [&](std::size_t cell) {
+        changed = changedCells[cell];
+        return changed;
+    });
+    return changed;
+}
+
 bool polygonIntersectsBox(const LineString<float>& polygon, const GridIndex<IndexedSubfeature>::BBox& bbox) {
     // This is just a wrapper that allows us to use the integer-based util::polygonIntersectsPolygon
     // Conversion limits our query accuracy to single-pixel resolution
@@ -337,39 +462,39 @@ std::unordered_map<uint32_t, std::vector<IndexedSubfeature>> CollisionIndex::que
 }
 
 std::pair<float,float> CollisionIndex::projectAnchor(const mat4& posMatrix, const Point<float>& point) const {
-    vec4 p = {{ point.x, point.y, 0, 1 }};
-    matrix::transformMat4(p, p, posMatrix);
+    double x, y, w;
+    util::transformPoints(posMatrix, 1, &point.x, &point.y, &x, &y, &w);
     return std::make_pair(
-        0.5 + 0.5 * (transformState.getCameraToCenterDistance() / p[3]),
-        p[3]
+        0.5 + 0.5 * (transformState.getCameraToCenterDistance() / w),
+        w
     );
 }
 
 std::pair<Point<float>,float> CollisionIndex::projectAndGetPerspectiveRatio(const mat4& posMatrix, const Point<float>& point) const {
-    vec4 p = {{ point.x, point.y, 0, 1 }};
-    matrix::transformMat4(p, p, posMatrix);
-    auto offset = transformState.getCenterOffset();
-    auto size = transformState.getSize();
-    return std::make_pair(
-        Point<float>(
-            (((p[0] / p[3] + 1) / 2) * size.width) + viewportPadding + offset.x,
-            (((-p[1] / p[3] + 1) / 2) * size.height) + viewportPadding + offset.y
-        ),
-        // See perspective ratio comment in symbol_sdf.vertex
-        // We're doing collision detection in viewport space so we need
-        // to scale down boxes in the distance
-        0.5 + 0.5 * transformState.getCameraToCenterDistance() / p[3]
-    );
+    double x, y, w;
+    util::transformPoints(posMatrix, 1, &point.x, &point.y, &x, &y, &w);
+    return std::make_pair(clipToViewport(x, y, w), perspectiveRatio(w));
 }
 
 Point<float> CollisionIndex::projectPoint(const mat4& posMatrix, const Point<float>& point) const {
-    vec4 p = {{ point.x, point.y, 0, 1 }};
-    matrix::transformMat4(p, p, posMatrix);
+    double x, y, w;
+    util::transformPoints(posMatrix, 1, &point.x, &point.y, &x, &y, &w);
+    return clipToViewport(x, y, w);
+}
+
+Point<float> CollisionIndex::clipToViewport(double x, double y, double w) const {
     auto offset = transformState.getCenterOffset();
     auto size = transformState.getSize();
     return Point<float> {
-        static_cast<float>((((p[0] / p[3] + 1) / 2) * size.width) + viewportPadding + offset.x),
-        static_cast<float>((((-p[1] / p[3] + 1) / 2) * size.height) + viewportPadding + offset.y) };
+        static_cast<float>((((x / w + 1) / 2) * size.width) + viewportPadding + offset.x),
+        static_cast<float>((((-y / w + 1) / 2) * size.height) + viewportPadding + offset.y) };
+}
+
+float CollisionIndex::perspectiveRatio(double w) const {
+    // See perspective ratio comment in symbol_sdf.vertex
+    // We're doing collision detection in viewport space so we need
+    // to scale down boxes in the distance
+    return 0.5 + 0.5 * transformState.getCameraToCenterDistance() / w;
 }
 
 } // namespace mbgl
@@ -7,6 +7,7 @@
 #include <mbgl/map/transform_state.hpp>
 
 #include <array>
+#include <vector>
 
 namespace mbgl {
 
@@ -22,22 +23,57 @@ public:
 
     explicit CollisionIndex(const TransformState&);
 
+    // The part of placing a feature that only depends on the camera and on the feature itself,
+    // and not on the features that are already in the index.
+    class Projection {
+    public:
+        // Box features: the projected anchor of the box.
+        Point<float> anchor;
+        // Scales tile units at the anchor to viewport pixels.
+        float tileToViewport = 0;
+
+        // Line features: whether the label fits on its line, and how far it extends from its
+        // anchor in tile units.
+        bool fitsOnLine = false;
+        float firstTileDistance = 0;
+        float lastTileDistance = 0;
+        // Projected centers of the circles that the label extends over. Entries of other
+        // circles are left unset.
+        std::vector<Point<float>> circles;
+    };
+
+    // Doesn't modify the index or the feature, so features may be projected concurrently.
+    Projection projectFeature(const CollisionFeature& feature,
+                              const mat4& posMatrix,
+                              const mat4& labelPlaneMatrix,
+                              const float textPixelRatio,
+                              const PlacedSymbol& symbol,
+                              const float scale,
+                              const float fontSize,
+                              const bool pitchWithMap) const;
+
+    // Projects many box features at once, with the same results as projectFeature(). Their anchors
+    // are transformed in one batch.
+    void projectBoxFeatures(const mat4& posMatrix,
+                            const float textPixelRatio,
+                            const std::vector<std::pair<const CollisionFeature*, Projection*>>& features) const;
+
     std::pair<bool,bool> placeFeature(CollisionFeature& feature,
+                                      const Projection& projection,
                                       Point<float> shift,
-                                      const mat4& posMatrix,
-                                      const mat4& labelPlaneMatrix,
-                                      const float textPixelRatio,
-                                      PlacedSymbol& symbol,
-                                      const float scale,
-                                      const float fontSize,
                                       const bool allowOverlap,
-                                      const bool pitchWithMap,
                                       const bool collisionDebug,
                                       const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate);
+                                      const optional<std::function<bool(const IndexedSubfeature&)>>& collisionGroupPredicate);
 
     void insertFeature(CollisionFeature& feature, bool ignorePlacement, uint32_t bucketInstanceId, uint16_t collisionGroupId);
 
+    // Used by incremental placement: marks the grid cells under the placed boxes or circles of a
+    // feature as changed, because the feature wasn't placed there in the previous placement.
+    void markChanged(const CollisionFeature& feature);
+    // Whether any cell within `distance` pixels of the placed box was marked as changed.
+    bool isChanged(const CollisionBox& box, float distance) const;
+
     std::unordered_map<uint32_t, std::vector<IndexedSubfeature>> queryRenderedSymbols(const ScreenLineString&) const;
     
     CollisionTileBoundaries projectTileBoundaries(const mat4& posMatrix) const;
@@ -50,28 +86,30 @@ private:
     bool isInsideTile(const CollisionBox&, const CollisionTileBoundaries& tileBoundaries) const;
 
     std::pair<bool,bool> placeLineFeature(CollisionFeature& feature,
-                                  const mat4& posMatrix,
-                                  const mat4& labelPlaneMatrix,
-                                  const float textPixelRatio,
-                                  PlacedSymbol& symbol,
-                                  const float scale,
-                                  const float fontSize,
+                                  const Projection& projection,
                                   const bool allowOverlap,
-                                  const bool pitchWithMap,
                                   const bool collisionDebug,
                                   const optional<CollisionTileBoundaries>& avoidEdges,
-                                  const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate);
+                                  const optional<std::function<bool(const IndexedSubfeature&)>>& collisionGroupPredicate);
     
-    float approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap);
+    float approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap) const;
     
     std::pair<float,float> projectAnchor(const mat4& posMatrix, const Point<float>& point) const;
     std::pair<Point<float>,float> projectAndGetPerspectiveRatio(const mat4& posMatrix, const Point<float>& point) const;
     Point<float> projectPoint(const mat4& posMatrix, const Point<float>& point) const;
+    Point<float> clipToViewport(double x, double y, double w) const;
+    float perspectiveRatio(double w) const;
+
+    template <class Fn>
+    void forEachCell(float x1, float y1, float x2, float y2, Fn) const;
 
     const TransformState transformState;
 
     CollisionGrid collisionGrid;
     CollisionGrid ignoredGrid;
+
+    // Cells of the collision grid, row by row. Allocated when the first feature is marked.
+    std::vector<bool> changedCells;
     
     const float screenRightBoundary;
     const float screenBottomBoundary;
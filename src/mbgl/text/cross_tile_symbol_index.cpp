@@ -4,14 +4,23 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/tile/tile.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
 namespace mbgl {
 
 
 TileLayerIndex::TileLayerIndex(OverscaledTileID coord_, std::vector<SymbolInstance>& symbolInstances, uint32_t bucketInstanceId_)
     : coord(coord_), bucketInstanceId(bucketInstanceId_) {
+        indexedSymbolInstances.reserve(symbolInstances.size());
         for (SymbolInstance& symbolInstance : symbolInstances) {
-            indexedSymbolInstances[symbolInstance.key].emplace_back(symbolInstance.crossTileID, getScaledCoordinates(symbolInstance, coord));
+            indexedSymbolInstances.emplace_back(symbolInstance.crossTileID, getScaledCoordinates(symbolInstance, coord),
+                                                symbolInstance.keyHash, indexedSymbolInstances.size());
         }
+        std::sort(indexedSymbolInstances.begin(), indexedSymbolInstances.end(), [](const IndexedSymbolInstance& a, const IndexedSymbolInstance& b) {
+            return std::tie(a.keyHash, a.coord.x, a.order) < std::tie(b.keyHash, b.coord.x, b.order);
+        });
     }
 
 Point<int64_t> TileLayerIndex::getScaledCoordinates(SymbolInstance& symbolInstance, const OverscaledTileID& childTileCoord) {
@@ -24,8 +33,10 @@ Point<int64_t> TileLayerIndex::getScaledCoordinates(SymbolInstance& symbolInstan
     };
 }
 
-void TileLayerIndex::findMatches(std::vector<SymbolInstance>& symbolInstances, const OverscaledTileID& newCoord, std::set<uint32_t>& zoomCrossTileIDs) {
+void TileLayerIndex::findMatches(std::vector<SymbolInstance>& symbolInstances, const OverscaledTileID& newCoord, std::unordered_set<uint32_t>& zoomCrossTileIDs) {
     float tolerance = coord.canonical.z < newCoord.canonical.z ? 1 : std::pow(2, coord.canonical.z - newCoord.canonical.z);
+    // The coordinates are integers, and the tolerance is a whole number of grid units.
+    const auto range = static_cast<int64_t>(tolerance);
 
     for (auto& symbolInstance : symbolInstances) {
         if (symbolInstance.crossTileID) {
@@ -33,28 +44,34 @@ void TileLayerIndex::findMatches(std::vector<SymbolInstance>& symbolInstances, c
             continue;
         }
 
-        auto it = indexedSymbolInstances.find(symbolInstance.key);
-        if (it == indexedSymbolInstances.end()) {
-            // No symbol with this key in this bucket
-            continue;
-        }
-
         auto scaledSymbolCoord = getScaledCoordinates(symbolInstance, newCoord);
 
-        for (IndexedSymbolInstance& thisTileSymbol: it->second) {
-            // Return any symbol with the same keys whose coordinates are within 1
-            // grid unit. (with a 4px grid, this covers a 12px by 12px area)
-            if (std::abs(thisTileSymbol.coord.x - scaledSymbolCoord.x) <= tolerance &&
-                std::abs(thisTileSymbol.coord.y - scaledSymbolCoord.y) <= tolerance &&
-                zoomCrossTileIDs.find(thisTileSymbol.crossTileID) == zoomCrossTileIDs.end()) {
-                // Once we've marked ourselves duplicate against this parent symbol,
-                // don't let any other symbols at the same zoom level duplicate against
-                // the same parent (see issue #10844)
-                zoomCrossTileIDs.insert(thisTileSymbol.crossTileID);
-                symbolInstance.crossTileID = thisTileSymbol.crossTileID;
-                break;
+        // Return the first symbol with the same keys whose coordinates are within 1
+        // grid unit. (with a 4px grid, this covers a 12px by 12px area)
+        auto it = std::lower_bound(indexedSymbolInstances.begin(), indexedSymbolInstances.end(),
+                                   std::make_pair(symbolInstance.keyHash, scaledSymbolCoord.x - range),
+                                   [](const IndexedSymbolInstance& a, const std::pair<std::size_t, int64_t>& b) {
+            return std::tie(a.keyHash, a.coord.x) < std::tie(b.first, b.second);
+        });
+
+        const IndexedSymbolInstance* match = nullptr;
+        for (; it != indexedSymbolInstances.end() &&
+               it->keyHash == symbolInstance.keyHash &&
+               it->coord.x <= scaledSymbolCoord.x + range; ++it) {
+            if (std::abs(it->coord.y - scaledSymbolCoord.y) <= range &&
+                (!match || it->order < match->order) &&
+                zoomCrossTileIDs.find(it->crossTileID) == zoomCrossTileIDs.end()) {
+                match = &*it;
             }
         }
+
+        if (match) {
+            // Once we've marked ourselves duplicate against this parent symbol,
+            // don't let any other symbols at the same zoom level duplicate against
+            // the same parent (see issue #10844)
+            zoomCrossTileIDs.insert(match->crossTileID);
+            symbolInstance.crossTileID = match->crossTileID;
+        }
     }
 }
 
@@ -107,7 +124,7 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID, Symbol
 
     for (auto& it : indexes) {
         auto zoom = it.first;
-        auto zoomIndexes = it.second;
+        auto& zoomIndexes = it.second;
         if (zoom > tileID.overscaledZ) {
             for (auto& childIndex : zoomIndexes) {
                 if (childIndex.second.coord.isChildOf(tileID)) {
@@ -138,10 +155,9 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID, Symbol
 }
 
 void CrossTileSymbolLayerIndex::removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket) {
-    for (auto key : removedBucket.indexedSymbolInstances) {
-        for (auto indexedSymbolInstance : key.second) {
-            usedCrossTileIDs[zoom].erase(indexedSymbolInstance.crossTileID);
-        }
+    auto& zoomCrossTileIDs = usedCrossTileIDs[zoom];
+    for (const auto& indexedSymbolInstance : removedBucket.indexedSymbolInstances) {
+        zoomCrossTileIDs.erase(indexedSymbolInstance.crossTileID);
     }
 }
 
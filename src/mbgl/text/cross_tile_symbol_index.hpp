@@ -20,12 +20,15 @@ class SymbolBucket;
 
 class IndexedSymbolInstance {
 public:
-    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_)
-        : crossTileID(crossTileID_), coord(coord_)
+    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_, std::size_t keyHash_, uint32_t order_)
+        : crossTileID(crossTileID_), coord(coord_), keyHash(keyHash_), order(order_)
     {}
 
     uint32_t crossTileID;
     Point<int64_t> coord;
+    std::size_t keyHash;
+    // Index of the symbol in its bucket. Of several matching symbols, the first one wins.
+    uint32_t order;
 };
 
 class TileLayerIndex {
@@ -33,11 +36,13 @@ public:
     TileLayerIndex(OverscaledTileID coord, std::vector<SymbolInstance>&, uint32_t bucketInstanceId);
 
     Point<int64_t> getScaledCoordinates(SymbolInstance&, const OverscaledTileID&);
-    void findMatches(std::vector<SymbolInstance>&, const OverscaledTileID&, std::set<uint32_t>&);
+    void findMatches(std::vector<SymbolInstance>&, const OverscaledTileID&, std::unordered_set<uint32_t>&);
     
     OverscaledTileID coord;
     uint32_t bucketInstanceId;
-    std::map<std::u16string,std::vector<IndexedSymbolInstance>> indexedSymbolInstances;
+    // Sorted by key hash and then by x coordinate, so that the symbols with the same key near a
+    // point are found with a binary search.
+    std::vector<IndexedSymbolInstance> indexedSymbolInstances;
 };
 
 class CrossTileSymbolLayerIndex {
@@ -50,7 +55,7 @@ private:
     void removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket);
 
     std::map<uint8_t, std::map<OverscaledTileID,TileLayerIndex>> indexes;
-    std::map<uint8_t, std::set<uint32_t>> usedCrossTileIDs;
+    std::map<uint8_t, std::unordered_set<uint32_t>> usedCrossTileIDs;
     float lng = 0;
 };
 
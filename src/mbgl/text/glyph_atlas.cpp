@@ -1,65 +1,193 @@
 #include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/gfx/upload_pass.hpp>
+#include <mbgl/util/hash.hpp>
 
-#include <mapbox/shelf-pack.hpp>
+#include <algorithm>
+#include <cassert>
 
 namespace mbgl {
 
-static constexpr uint32_t padding = 1;
+namespace {
 
-GlyphAtlas makeGlyphAtlas(const GlyphMap& glyphs) {
-    GlyphAtlas result;
+const uint16_t padding = 1;
 
+mapbox::ShelfPack::ShelfPackOptions shelfPackOptions() {
     mapbox::ShelfPack::ShelfPackOptions options;
     options.autoResize = true;
-    mapbox::ShelfPack pack(0, 0, options);
+    return options;
+}
+
+Size packSize(const mapbox::ShelfPack& pack) {
+    return {
+        static_cast<uint32_t>(pack.width()),
+        static_cast<uint32_t>(pack.height())
+    };
+}
+
+} // namespace
+
+GlyphAtlas::Glyphs::Glyphs(std::shared_ptr<GlyphAtlas> atlas_, std::vector<mapbox::Bin*> bins_)
+    : atlas(std::move(atlas_)),
+      bins(std::move(bins_)) {
+}
+
+GlyphAtlas::Glyphs::~Glyphs() {
+    atlas->removeGlyphs(bins);
+}
+
+std::size_t GlyphAtlas::KeyHash::operator()(const Key& key) const {
+    return util::hash(key.first, key.second);
+}
+
+GlyphAtlas::GlyphAtlas()
+    : shelfPack(128, 128, shelfPackOptions()),
+      image(packSize(shelfPack)) {
+}
+
+GlyphAtlas::~GlyphAtlas() = default;
+
+std::unique_ptr<GlyphAtlas::Glyphs> GlyphAtlas::addGlyphs(const GlyphMap& glyphs, GlyphPositions& positions) {
+    std::vector<mapbox::Bin*> bins;
+
+    std::lock_guard<std::mutex> lock(mutex);
 
     for (const auto& glyphMapEntry : glyphs) {
         FontStackHash fontStack = glyphMapEntry.first;
-        GlyphPositionMap& positions = result.positions[fontStack];
+        GlyphPositionMap& fontStackPositions = positions[fontStack];
 
         for (const auto& entry : glyphMapEntry.second) {
-            if (entry.second && (*entry.second)->bitmap.valid()) {
-                const Glyph& glyph = **entry.second;
+            if (!entry.second || !(*entry.second)->bitmap.valid()) {
+                continue;
+            }
 
-                const mapbox::Bin& bin = *pack.packOne(-1,
-                    glyph.bitmap.size.width + 2 * padding,
-                    glyph.bitmap.size.height + 2 * padding);
+            const Immutable<Glyph>& glyph = *entry.second;
+            const Key key { fontStack, glyph->id };
 
-                result.image.resize({
-                    static_cast<uint32_t>(pack.width()),
-                    static_cast<uint32_t>(pack.height())
-                });
+            mapbox::Bin* bin = nullptr;
+            auto it = entries.find(key);
+            if (it != entries.end() && (it->second.glyph == glyph || it->second.glyph->bitmap == glyph->bitmap)) {
+                bin = it->second.bin;
+                shelfPack.ref(*bin);
+            } else {
+                bin = shelfPack.packOne(-1,
+                    glyph->bitmap.size.width + 2 * padding,
+                    glyph->bitmap.size.height + 2 * padding);
+                if (!bin) {
+                    continue;
+                }
 
-                AlphaImage::copy(glyph.bitmap,
-                                 result.image,
+                image.resize(packSize(shelfPack));
+                AlphaImage::copy(glyph->bitmap,
+                                 image,
                                  { 0, 0 },
                                  {
-                                    bin.x + padding,
-                                    bin.y + padding
+                                    static_cast<uint32_t>(bin->x + padding),
+                                    static_cast<uint32_t>(bin->y + padding)
                                  },
-                                 glyph.bitmap.size);
-
-                positions.emplace(glyph.id,
-                                  GlyphPosition {
-                                     Rect<uint16_t> {
-                                         static_cast<uint16_t>(bin.x),
-                                         static_cast<uint16_t>(bin.y),
-                                         static_cast<uint16_t>(bin.w),
-                                         static_cast<uint16_t>(bin.h)
-                                     },
-                                     glyph.metrics
-                                  });
+                                 glyph->bitmap.size);
+                markDirty(*bin);
+
+                // Tiles that still use the previous bitmap keep their bin until they release it.
+                entries[key] = Entry { bin, glyph };
+                binKeys.emplace(bin->id, key);
             }
+
+            bins.push_back(bin);
+            fontStackPositions.emplace(glyph->id,
+                                       GlyphPosition {
+                                          Rect<uint16_t> {
+                                              static_cast<uint16_t>(bin->x),
+                                              static_cast<uint16_t>(bin->y),
+                                              static_cast<uint16_t>(bin->w),
+                                              static_cast<uint16_t>(bin->h)
+                                          },
+                                          glyph->metrics
+                                       });
         }
     }
 
-    pack.shrink();
-    result.image.resize({
-        static_cast<uint32_t>(pack.width()),
-        static_cast<uint32_t>(pack.height())
-    });
+    return std::make_unique<Glyphs>(shared_from_this(), std::move(bins));
+}
+
+void GlyphAtlas::removeGlyphs(const std::vector<mapbox::Bin*>& bins) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (mapbox::Bin* bin : bins) {
+        const int32_t id = bin->id;
+        const uint32_t x = bin->x;
+        const uint32_t y = bin->y;
+        const uint32_t w = bin->w;
+        const uint32_t h = bin->h;
+
+        if (shelfPack.unref(*bin) > 0) {
+            continue;
+        }
+
+        // Clear the glyph so that the padding of the next glyph in this bin is empty.
+        AlphaImage::clear(image, { x, y }, { w, h });
+
+        auto binKey = binKeys.find(id);
+        assert(binKey != binKeys.end());
+        auto it = entries.find(binKey->second);
+        if (it != entries.end() && it->second.bin == bin) {
+            entries.erase(it);
+        }
+        binKeys.erase(binKey);
+    }
+}
+
+void GlyphAtlas::markDirty(const mapbox::Bin& bin) {
+    const Rect<uint32_t> rect {
+        static_cast<uint32_t>(bin.x),
+        static_cast<uint32_t>(bin.y),
+        static_cast<uint32_t>(bin.w),
+        static_cast<uint32_t>(bin.h)
+    };
+
+    if (!dirtyRect) {
+        dirtyRect = rect;
+        return;
+    }
+
+    const uint32_t x1 = std::min(dirtyRect->x, rect.x);
+    const uint32_t y1 = std::min(dirtyRect->y, rect.y);
+    const uint32_t x2 = std::max(dirtyRect->x + dirtyRect->w, rect.x + rect.w);
+    const uint32_t y2 = std::max(dirtyRect->y + dirtyRect->h, rect.y + rect.h);
+    dirtyRect = Rect<uint32_t> { x1, y1, x2 - x1, y2 - y1 };
+}
+
+void GlyphAtlas::upload(gfx::UploadPass& uploadPass, optional<gfx::Texture>& texture) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!texture) {
+        texture = uploadPass.createTexture(image);
+    } else if (texture->size != image.size) {
+        // The atlas grew. Bins never move, so the positions of all glyphs stay valid.
+        uploadPass.updateTexture(*texture, image);
+    } else if (dirtyRect) {
+        AlphaImage changed({ dirtyRect->w, dirtyRect->h });
+        AlphaImage::copy(image, changed, { dirtyRect->x, dirtyRect->y }, { 0, 0 }, changed.size);
+        uploadPass.updateTextureSub(*texture, changed,
+                                    static_cast<uint16_t>(dirtyRect->x),
+                                    static_cast<uint16_t>(dirtyRect->y));
+    }
+
+    dirtyRect = nullopt;
+}
+
+Size GlyphAtlas::getPixelSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return packSize(shelfPack);
+}
+
+std::size_t GlyphAtlas::getGlyphCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return binKeys.size();
+}
 
-    return result;
+AlphaImage GlyphAtlas::getAtlasImageForTests() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return image.clone();
 }
 
 } // namespace mbgl
@@ -1,11 +1,22 @@
 #pragma once
 
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <mapbox/shelf-pack.hpp>
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace mbgl {
 
+namespace gfx {
+class Texture;
+class UploadPass;
+} // namespace gfx
+
 struct GlyphPosition {
     Rect<uint16_t> rect;
     GlyphMetrics metrics;
@@ -14,12 +25,72 @@ struct GlyphPosition {
 using GlyphPositionMap = std::map<GlyphID, GlyphPosition>;
 using GlyphPositions = std::map<FontStackHash, GlyphPositionMap>;
 
-class GlyphAtlas {
+// A glyph atlas that is shared by all tiles of a renderer. Tile workers add the glyphs they
+// lay out and keep them in the atlas for as long as the tile is alive; glyphs that no tile
+// references anymore free their space for other glyphs. Only the parts of the atlas that
+// changed since the last frame are uploaded.
+class GlyphAtlas : public std::enable_shared_from_this<GlyphAtlas> {
 public:
+    // Holds a reference to the glyphs that were added for a tile, and releases them when
+    // it is destroyed.
+    class Glyphs {
+    public:
+        Glyphs(std::shared_ptr<GlyphAtlas>, std::vector<mapbox::Bin*>);
+        Glyphs(const Glyphs&) = delete;
+        Glyphs& operator=(const Glyphs&) = delete;
+        ~Glyphs();
+
+    private:
+        std::shared_ptr<GlyphAtlas> atlas;
+        std::vector<mapbox::Bin*> bins;
+    };
+
+    GlyphAtlas();
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+    ~GlyphAtlas();
+
+    // Adds the glyphs with bitmaps to the atlas and fills in their positions. Glyphs that are
+    // already in the atlas are shared. May be called from any thread.
+    std::unique_ptr<Glyphs> addGlyphs(const GlyphMap&, GlyphPositions&);
+
+    // Creates the texture, or updates the parts of it that changed since the last upload.
+    void upload(gfx::UploadPass&, optional<gfx::Texture>&);
+
+    Size getPixelSize() const;
+
+    // The number of distinct glyphs in the atlas.
+    std::size_t getGlyphCount() const;
+
+    AlphaImage getAtlasImageForTests() const;
+
+private:
+    struct Entry {
+        mapbox::Bin* bin;
+        // The glyph that was copied into the bin. Font stacks that are loaded again may
+        // bring other bitmaps for the same glyph IDs.
+        Immutable<Glyph> glyph;
+    };
+
+    using Key = std::pair<FontStackHash, GlyphID>;
+
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    void removeGlyphs(const std::vector<mapbox::Bin*>&);
+    void markDirty(const mapbox::Bin&);
+
+    mutable std::mutex mutex;
+
+    mapbox::ShelfPack shelfPack;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    // The keys of the glyphs in each bin, by bin ID.
+    std::unordered_map<int32_t, Key> binKeys;
     AlphaImage image;
-    GlyphPositions positions;
-};
 
-GlyphAtlas makeGlyphAtlas(const GlyphMap&);
+    // The area that changed since the last upload.
+    optional<Rect<uint32_t>> dirtyRect;
+};
 
 } // namespace mbgl
@@ -1,22 +1,67 @@
 #include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
-#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/text/glyph_manager_worker.hpp>
+#include <mbgl/text/glyph_sdf_cache.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/hash.hpp>
 #include <mbgl/util/tiny_sdf.hpp>
 #include <mbgl/util/std.hpp>
+#include <mbgl/util/timer.hpp>
 
 namespace mbgl {
 
 static GlyphManagerObserver nullObserver;
 
+// The SDF parameters of locally rasterized glyphs.
+static const double sdfRadius = 8;
+static const double sdfCutoff = .25;
+
+// Ranges of all font stacks are spread over this many workers. Each range always goes to the
+// same worker, so that its responses are parsed in the order they arrived in.
+static const std::size_t parserWorkers = 4;
+
+// Ranges that glyphs are rasterized for are stored in the local glyph cache at most this often,
+// so that a range that fills up over time isn't written again for every glyph.
+static const Duration localGlyphCacheDelay = Seconds(1);
+
+struct GlyphManager::Parser {
+    Parser(GlyphManager& glyphManager)
+        : mailbox(std::make_shared<Mailbox>(*Scheduler::GetCurrent())) {
+        for (std::size_t i = 0; i < parserWorkers; ++i) {
+            workers.push_back(std::make_unique<Actor<GlyphManagerWorker>>(
+                Scheduler::GetBackground(), ActorRef<GlyphManager>(glyphManager, mailbox)));
+        }
+    }
+
+    Actor<GlyphManagerWorker>& worker(const FontStack& fontStack, const GlyphRange& range) {
+        return *workers[util::hash(FontStackHasher()(fontStack), range.first) % workers.size()];
+    }
+
+    std::shared_ptr<Mailbox> mailbox;
+    std::vector<std::unique_ptr<Actor<GlyphManagerWorker>>> workers;
+};
+
 GlyphManager::GlyphManager(std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_)
     : observer(&nullObserver),
-      localGlyphRasterizer(std::move(localGlyphRasterizer_)) {
+      localGlyphRasterizer(std::move(localGlyphRasterizer_)),
+      atlas(std::make_shared<GlyphAtlas>()) {
 }
 
-GlyphManager::~GlyphManager() = default;
+GlyphManager::~GlyphManager() {
+    if (localGlyphCacheWriter) {
+        storeLocalGlyphs();
+        // The writer stores ranges in the order they were sent, so all are stored once the
+        // last one is.
+        if (lastLocalGlyphStore.valid()) {
+            lastLocalGlyphStore.wait();
+        }
+    }
+}
 
 void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphDependencies, FileSource& fileSource) {
     auto dependencies = std::make_shared<GlyphDependencies>(std::move(glyphDependencies));
@@ -27,28 +72,65 @@ void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphD
     // for that requestor have been fetched, and can notify it of completion.
     for (const auto& dependency : *dependencies) {
         const FontStack& fontStack = dependency.first;
+        const bool newFontStack = entries.find(fontStack) == entries.end();
         Entry& entry = entries[fontStack];
 
         const GlyphIDs& glyphIDs = dependency.second;
         std::unordered_set<GlyphRange> ranges;
+        std::set<GlyphRange> generatedRanges;
         for (const auto& glyphID : glyphIDs) {
             if (localGlyphRasterizer->canRasterizeGlyph(fontStack, glyphID)) {
+                if (entry.glyphs.find(glyphID) == entry.glyphs.end()) {
+                    loadLocalGlyphs(fontStack, entry, getGlyphRange(glyphID));
+                }
                 if (entry.glyphs.find(glyphID) == entry.glyphs.end()) {
                     entry.glyphs.emplace(glyphID, makeMutable<Glyph>(generateLocalSDF(fontStack, glyphID)));
+                    generatedRanges.insert(getGlyphRange(glyphID));
                 }
             } else {
                 ranges.insert(getGlyphRange(glyphID));
             }
         }
 
+        if (localGlyphCache && !generatedRanges.empty()) {
+            entry.unstoredLocalRanges.insert(generatedRanges.begin(), generatedRanges.end());
+            if (!localGlyphStoreScheduled) {
+                localGlyphStoreScheduled = true;
+                localGlyphCacheTimer->start(localGlyphCacheDelay, Duration::zero(), [this] {
+                    localGlyphStoreScheduled = false;
+                    storeLocalGlyphs();
+                });
+            }
+        }
+
         for (const auto& range : ranges) {
             auto it = entry.ranges.find(range);
             if (it == entry.ranges.end() || !it->second.parsed) {
                 GlyphRequest& request = entry.ranges[range];
+                request.prefetched = false;
+                if (request.failed) {
+                    request.failed = false;
+                    request.req.reset();
+                }
                 request.requestors[&requestor] = dependencies;
                 requestRange(request, fontStack, range, fileSource);
             }
         }
+
+        // Other font stacks will likely need ranges that this one needs for the first time,
+        // and a font stack that is new will likely need the ranges that others needed.
+        for (const auto& range : ranges) {
+            if (seenRanges.insert(range).second) {
+                for (auto& other : entries) {
+                    prefetchRange(other.first, other.second, range, fileSource);
+                }
+            }
+        }
+        if (newFontStack) {
+            for (const auto& range : seenRanges) {
+                prefetchRange(fontStack, entry, range, fileSource);
+            }
+        }
     }
 
     // If the shared dependencies pointer is already unique, then all dependent glyph ranges
@@ -60,10 +142,52 @@ void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphD
 
 Glyph GlyphManager::generateLocalSDF(const FontStack& fontStack, GlyphID glyphID) {
     Glyph local = localGlyphRasterizer->rasterizeGlyph(fontStack, glyphID);
-    local.bitmap = util::transformRasterToSDF(local.bitmap, 8, .25);
+    local.bitmap = util::transformRasterToSDF(local.bitmap, sdfRadius, sdfCutoff);
     return local;
 }
 
+void GlyphManager::setLocalGlyphCache(const std::string& directory, const optional<std::string>& localFontFamily) {
+    localGlyphCache = std::make_unique<GlyphSDFCache>(directory, localFontFamily, sdfRadius, sdfCutoff);
+    localGlyphCacheWriter = std::make_unique<Actor<GlyphSDFCache>>(
+        Scheduler::GetBackground(), directory, localFontFamily, sdfRadius, sdfCutoff);
+    localGlyphCacheTimer = std::make_unique<util::Timer>();
+}
+
+void GlyphManager::loadLocalGlyphs(const FontStack& fontStack, Entry& entry, const GlyphRange& range) {
+    if (!localGlyphCache || !entry.localRanges.insert(range).second) {
+        return;
+    }
+
+    for (auto& glyph : localGlyphCache->load(fontStack, range)) {
+        if (localGlyphRasterizer->canRasterizeGlyph(fontStack, glyph.id)) {
+            const GlyphID glyphID = glyph.id;
+            entry.glyphs.emplace(glyphID, makeMutable<Glyph>(std::move(glyph)));
+        }
+    }
+}
+
+void GlyphManager::storeLocalGlyphs(const FontStack& fontStack, Entry& entry) {
+    for (const auto& range : entry.unstoredLocalRanges) {
+        // Ranges may hold glyphs that were downloaded as well.
+        std::vector<Immutable<Glyph>> glyphs;
+        for (auto it = entry.glyphs.lower_bound(range.first);
+             it != entry.glyphs.end() && it->first <= range.second; ++it) {
+            if (localGlyphRasterizer->canRasterizeGlyph(fontStack, it->first)) {
+                glyphs.push_back(it->second);
+            }
+        }
+
+        lastLocalGlyphStore = localGlyphCacheWriter->self().ask(&GlyphSDFCache::store, fontStack, range, std::move(glyphs));
+    }
+    entry.unstoredLocalRanges.clear();
+}
+
+void GlyphManager::storeLocalGlyphs() {
+    for (auto& entry : entries) {
+        storeLocalGlyphs(entry.first, entry.second);
+    }
+}
+
 void GlyphManager::requestRange(GlyphRequest& request, const FontStack& fontStack, const GlyphRange& range, FileSource& fileSource) {
     if (request.req) {
         return;
@@ -74,9 +198,21 @@ void GlyphManager::requestRange(GlyphRequest& request, const FontStack& fontStac
     });
 }
 
+void GlyphManager::prefetchRange(const FontStack& fontStack, Entry& entry, const GlyphRange& range, FileSource& fileSource) {
+    if (entry.ranges.find(range) != entry.ranges.end()) {
+        return;
+    }
+
+    GlyphRequest& request = entry.ranges[range];
+    request.prefetched = true;
+    requestRange(request, fontStack, range, fileSource);
+}
+
 void GlyphManager::processResponse(const Response& res, const FontStack& fontStack, const GlyphRange& range) {
     if (res.error) {
-        observer->onGlyphsError(fontStack, range, std::make_exception_ptr(std::runtime_error(res.error->message)));
+        if (!deferError(fontStack, range)) {
+            observer->onGlyphsError(fontStack, range, std::make_exception_ptr(std::runtime_error(res.error->message)));
+        }
         return;
     }
 
@@ -84,25 +220,60 @@ void GlyphManager::processResponse(const Response& res, const FontStack& fontSta
         return;
     }
 
-    Entry& entry = entries[fontStack];
-    GlyphRequest& request = entry.ranges[range];
+    if (res.noContent) {
+        auto entry = entries.find(fontStack);
+        if (entry != entries.end()) {
+            finishRequest(fontStack, entry->second, range);
+        }
+        return;
+    }
 
-    if (!res.noContent) {
-        std::vector<Glyph> glyphs;
+    if (!parser) {
+        parser = std::make_unique<Parser>(*this);
+    }
 
-        try {
-            glyphs = parseGlyphPBF(range, *res.data);
-        } catch (...) {
-            observer->onGlyphsError(fontStack, range, std::current_exception());
-            return;
-        }
+    parser->worker(fontStack, range).self().invoke(&GlyphManagerWorker::parse, fontStack, range, res.data);
+}
 
-        for (auto& glyph : glyphs) {
-            entry.glyphs.erase(glyph.id);
-            entry.glyphs.emplace(glyph.id, makeMutable<Glyph>(std::move(glyph)));
-        }
+void GlyphManager::onParsed(FontStack fontStack, GlyphRange range, std::vector<Glyph>&& glyphs) {
+    // The font stack may have been evicted while the response was parsed.
+    auto it = entries.find(fontStack);
+    if (it == entries.end()) {
+        return;
+    }
+
+    Entry& entry = it->second;
+    for (auto& glyph : glyphs) {
+        entry.glyphs.erase(glyph.id);
+        entry.glyphs.emplace(glyph.id, makeMutable<Glyph>(std::move(glyph)));
+    }
+
+    finishRequest(fontStack, entry, range);
+}
+
+void GlyphManager::onParseError(FontStack fontStack, GlyphRange range, std::exception_ptr error) {
+    if (entries.find(fontStack) != entries.end() && !deferError(fontStack, range)) {
+        observer->onGlyphsError(fontStack, range, error);
     }
+}
 
+// Marks a failed request that was prefetched, whose error is only reported once a requestor
+// needs the range. Returns whether the request was prefetched.
+bool GlyphManager::deferError(const FontStack& fontStack, const GlyphRange& range) {
+    auto entry = entries.find(fontStack);
+    if (entry == entries.end()) {
+        return false;
+    }
+    auto request = entry->second.ranges.find(range);
+    if (request == entry->second.ranges.end() || !request->second.prefetched) {
+        return false;
+    }
+    request->second.failed = true;
+    return true;
+}
+
+void GlyphManager::finishRequest(const FontStack& fontStack, Entry& entry, const GlyphRange& range) {
+    GlyphRequest& request = entry.ranges[range];
     request.parsed = true;
 
     for (auto& pair : request.requestors) {
@@ -154,9 +325,16 @@ void GlyphManager::removeRequestor(GlyphRequestor& requestor) {
 }
 
 void GlyphManager::evict(const std::set<FontStack>& keep) {
-    util::erase_if(entries, [&] (const auto& entry) {
-        return keep.count(entry.first) == 0;
+    util::erase_if(entries, [&] (auto& entry) {
+        if (keep.count(entry.first) != 0) {
+            return false;
+        }
+        if (localGlyphCacheWriter) {
+            storeLocalGlyphs(entry.first, entry.second);
+        }
+        return true;
     });
+    seenRanges.clear();
 }
 
 } // namespace mbgl
@@ -7,13 +7,25 @@
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/immutable.hpp>
 
+#include <exception>
+#include <future>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
+namespace util {
+class Timer;
+} // namespace util
+
 class FileSource;
 class AsyncRequest;
+template <class> class Actor;
+class GlyphAtlas;
+class GlyphManagerWorker;
+class GlyphSDFCache;
 class Response;
 
 class GlyphRequestor {
@@ -35,7 +47,11 @@ public:
     // their `GlyphDependencies`. If all glyphs are already locally available, GlyphManager
     // will provide them to the requestor immediately. Otherwise, it makes a request on the
     // FileSource is made for each range needed, and notifies the observer when all are
-    // complete.
+    // complete. Responses are parsed on background workers.
+    //
+    // Ranges that any requestor needs are also prefetched for every other font stack that
+    // is in use, since the labels of a tile set tend to use the same scripts in all of their
+    // font stacks.
     void getGlyphs(GlyphRequestor&, GlyphDependencies, FileSource&);
     void removeRequestor(GlyphRequestor&);
 
@@ -45,15 +61,33 @@ public:
 
     void setObserver(GlyphManagerObserver*);
 
-    // Remove glyphs for all but the supplied font stacks.
+    // Keeps the SDFs of locally rasterized glyphs in the given directory, so that later
+    // processes load them instead of rasterizing them again. `localFontFamily` must be the
+    // font family that the LocalGlyphRasterizer uses. Rasterized glyphs are written in
+    // batches on a background thread, and when the GlyphManager is destroyed.
+    void setLocalGlyphCache(const std::string& directory, const optional<std::string>& localFontFamily);
+
+    // Remove glyphs for all but the supplied font stacks. This also forgets the ranges that
+    // were prefetched for.
     void evict(const std::set<FontStack>&);
 
+    // The atlas that the tiles of this renderer add their glyphs to.
+    const std::shared_ptr<GlyphAtlas>& getAtlas() const {
+        return atlas;
+    }
+
 private:
     Glyph generateLocalSDF(const FontStack& fontStack, GlyphID glyphID);
     std::string glyphURL;
 
     struct GlyphRequest {
         bool parsed = false;
+        // Whether the range was requested before any requestor needed it. Errors of such
+        // requests aren't reported.
+        bool prefetched = false;
+        // Whether the prefetched range failed to load. It's requested again once a requestor
+        // needs it, so that the requestor is notified, or the error is reported.
+        bool failed = false;
         std::unique_ptr<AsyncRequest> req;
         std::unordered_map<GlyphRequestor*, std::shared_ptr<GlyphDependencies>> requestors;
     };
@@ -61,17 +95,45 @@ private:
     struct Entry {
         std::map<GlyphRange, GlyphRequest> ranges;
         std::map<GlyphID, Immutable<Glyph>> glyphs;
+        // Ranges whose locally rasterized glyphs were looked up in the local glyph cache.
+        std::set<GlyphRange> localRanges;
+        // Ranges with rasterized glyphs that weren't stored in the local glyph cache yet.
+        std::set<GlyphRange> unstoredLocalRanges;
     };
 
     std::unordered_map<FontStack, Entry, FontStackHasher> entries;
 
+    // Downloaded ranges that requestors needed for any font stack.
+    std::set<GlyphRange> seenRanges;
+
     void requestRange(GlyphRequest&, const FontStack&, const GlyphRange&, FileSource& fileSource);
+    void prefetchRange(const FontStack&, Entry&, const GlyphRange&, FileSource&);
     void processResponse(const Response&, const FontStack&, const GlyphRange&);
+
+    // Invoked by GlyphManagerWorker
+    friend class GlyphManagerWorker;
+    void onParsed(FontStack, GlyphRange, std::vector<Glyph>&&);
+    void onParseError(FontStack, GlyphRange, std::exception_ptr);
+    void finishRequest(const FontStack&, Entry&, const GlyphRange&);
+    bool deferError(const FontStack&, const GlyphRange&);
     void notify(GlyphRequestor&, const GlyphDependencies&);
+    void loadLocalGlyphs(const FontStack&, Entry&, const GlyphRange&);
+    void storeLocalGlyphs(const FontStack&, Entry&);
+    void storeLocalGlyphs();
     
     GlyphManagerObserver* observer = nullptr;
     
     std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+    std::unique_ptr<GlyphSDFCache> localGlyphCache;
+    std::unique_ptr<Actor<GlyphSDFCache>> localGlyphCacheWriter;
+    std::unique_ptr<util::Timer> localGlyphCacheTimer;
+    bool localGlyphStoreScheduled = false;
+    std::future<void> lastLocalGlyphStore;
+
+    std::shared_ptr<GlyphAtlas> atlas;
+
+    struct Parser;
+    std::unique_ptr<Parser> parser;
 };
 
 } // namespace mbgl
@@ -0,0 +1,24 @@
+#include <mbgl/text/glyph_manager_worker.hpp>
+#include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/text/glyph_pbf.hpp>
+
+namespace mbgl {
+
+GlyphManagerWorker::GlyphManagerWorker(ActorRef<GlyphManagerWorker>, ActorRef<GlyphManager> parent_)
+    : parent(std::move(parent_)) {
+}
+
+void GlyphManagerWorker::parse(FontStack fontStack, GlyphRange range, std::shared_ptr<const std::string> data) {
+    std::vector<Glyph> glyphs;
+
+    try {
+        glyphs = parseGlyphPBF(range, *data);
+    } catch (...) {
+        parent.invoke(&GlyphManager::onParseError, std::move(fontStack), std::move(range), std::current_exception());
+        return;
+    }
+
+    parent.invoke(&GlyphManager::onParsed, std::move(fontStack), std::move(range), std::move(glyphs));
+}
+
+} // namespace mbgl
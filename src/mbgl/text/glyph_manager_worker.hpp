@@ -0,0 +1,24 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/text/glyph_range.hpp>
+#include <mbgl/util/font_stack.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class GlyphManager;
+
+class GlyphManagerWorker {
+public:
+    GlyphManagerWorker(ActorRef<GlyphManagerWorker>, ActorRef<GlyphManager>);
+
+    void parse(FontStack, GlyphRange, std::shared_ptr<const std::string> data);
+
+private:
+    ActorRef<GlyphManager> parent;
+};
+
+} // namespace mbgl
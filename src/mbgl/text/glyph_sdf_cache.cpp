@@ -0,0 +1,196 @@
+#include <mbgl/text/glyph_sdf_cache.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+
+namespace mbgl {
+
+constexpr uint32_t GlyphSDFCache::Version;
+
+namespace {
+
+// Also tells files that were written on machines with another byte order apart.
+constexpr uint32_t magic = 0x46445347; // "GSDF"
+
+void write(std::string& data, uint32_t value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write(std::string& data, int32_t value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+class Reader {
+public:
+    Reader(const std::string& data_) : data(data_) {}
+
+    template <class T>
+    bool read(T& value) {
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool read(std::size_t length, std::string& value) {
+        if (data.size() - offset < length) {
+            return false;
+        }
+        value.assign(data, offset, length);
+        offset += length;
+        return true;
+    }
+
+    bool read(AlphaImage& image) {
+        if (image.bytes() > data.size() - offset) {
+            return false;
+        }
+        std::memcpy(image.data.get(), data.data() + offset, image.bytes());
+        offset += image.bytes();
+        return true;
+    }
+
+    bool atEnd() const {
+        return offset == data.size();
+    }
+
+private:
+    const std::string& data;
+    std::size_t offset = 0;
+};
+
+} // namespace
+
+GlyphSDFCache::GlyphSDFCache(std::string directory_,
+                             optional<std::string> fontFamily_,
+                             const double radius_,
+                             const double cutoff_)
+    : directory(std::move(directory_)),
+      fontFamily(std::move(fontFamily_)),
+      radius(radius_),
+      cutoff(cutoff_) {
+}
+
+std::string GlyphSDFCache::key(const FontStack& fontStack, const GlyphRange& range) const {
+    std::string result;
+    result += fontFamily ? *fontFamily : "";
+    result += '|';
+    result += fontStackToString(fontStack);
+    result += '|';
+    result += util::toString(static_cast<uint32_t>(range.first));
+    result += '-';
+    result += util::toString(static_cast<uint32_t>(range.second));
+    result += '|';
+    result += util::toString(radius, true);
+    result += '|';
+    result += util::toString(cutoff, true);
+    return result;
+}
+
+std::string GlyphSDFCache::path(const FontStack& fontStack, const GlyphRange& range) const {
+    return pathForKey(key(fontStack, range));
+}
+
+std::string GlyphSDFCache::pathForKey(const std::string& key_) const {
+    std::string result;
+    result.reserve(directory.length() + 64);
+    result += directory;
+    result += "/com.mapbox.gl.glyphs.";
+    result += util::toHex(static_cast<uint64_t>(std::hash<std::string>()(key_)));
+    result += ".sdf";
+    return result;
+}
+
+std::vector<Glyph> GlyphSDFCache::load(const FontStack& fontStack, const GlyphRange& range) const {
+    const std::string expectedKey = key(fontStack, range);
+    const optional<std::string> data = util::readFile(pathForKey(expectedKey));
+    if (!data) {
+        return {};
+    }
+
+    Reader reader(*data);
+    uint32_t fileMagic = 0;
+    uint32_t version = 0;
+    uint32_t keyLength = 0;
+    std::string fileKey;
+    uint32_t count = 0;
+    if (!reader.read(fileMagic) || fileMagic != magic ||
+        !reader.read(version) || version != Version ||
+        !reader.read(keyLength) || !reader.read(keyLength, fileKey) || fileKey != expectedKey ||
+        !reader.read(count)) {
+        return {};
+    }
+
+    std::vector<Glyph> result;
+    for (uint32_t i = 0; i < count; ++i) {
+        Glyph glyph;
+        uint32_t id = 0;
+        Size size;
+        if (!reader.read(id) || id < range.first || id > range.second ||
+            !reader.read(size.width) || !reader.read(size.height) ||
+            !reader.read(glyph.metrics.width) || !reader.read(glyph.metrics.height) ||
+            !reader.read(glyph.metrics.left) || !reader.read(glyph.metrics.top) ||
+            !reader.read(glyph.metrics.advance)) {
+            return {};
+        }
+        glyph.id = static_cast<GlyphID>(id);
+        if (!size.isEmpty()) {
+            glyph.bitmap = AlphaImage(size);
+            if (!reader.read(glyph.bitmap)) {
+                return {};
+            }
+        }
+        result.push_back(std::move(glyph));
+    }
+
+    if (!reader.atEnd()) {
+        return {};
+    }
+
+    return result;
+}
+
+void GlyphSDFCache::store(const FontStack& fontStack, const GlyphRange& range, const std::vector<Immutable<Glyph>>& glyphs) const {
+    const std::string fileKey = key(fontStack, range);
+
+    std::string data;
+    write(data, magic);
+    write(data, Version);
+    write(data, static_cast<uint32_t>(fileKey.size()));
+    data += fileKey;
+    write(data, static_cast<uint32_t>(glyphs.size()));
+    for (const auto& glyph : glyphs) {
+        write(data, static_cast<uint32_t>(glyph->id));
+        write(data, glyph->bitmap.size.width);
+        write(data, glyph->bitmap.size.height);
+        write(data, glyph->metrics.width);
+        write(data, glyph->metrics.height);
+        write(data, glyph->metrics.left);
+        write(data, glyph->metrics.top);
+        write(data, glyph->metrics.advance);
+        if (glyph->bitmap.valid()) {
+            data.append(reinterpret_cast<const char*>(glyph->bitmap.data.get()), glyph->bitmap.bytes());
+        }
+    }
+
+    // Write to a temporary file first, so that other processes never read a partial file.
+    const std::string filePath = pathForKey(fileKey);
+    const std::string temporaryPath = filePath + ".tmp";
+    try {
+        util::write_file(temporaryPath, data);
+        if (std::rename(temporaryPath.c_str(), filePath.c_str()) != 0) {
+            util::deleteFile(temporaryPath);
+            Log::Warning(Event::Glyph, "Failed to store glyphs in %s", filePath.c_str());
+        }
+    } catch (const std::exception& error) {
+        Log::Warning(Event::Glyph, "Failed to store glyphs: %s", error.what());
+    }
+}
+
+} // namespace mbgl
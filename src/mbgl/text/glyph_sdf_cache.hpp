@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_range.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    Stores the SDFs of locally rasterized glyphs on disk, so that a process only rasterizes
+    an ideograph the first time any process uses it. Each file holds the glyphs of one
+    glyph range of a font stack.
+
+    Files are keyed by the local font family, the font stack, the glyph range, and the SDF
+    parameters. Files that were written with other keys or by another version of the
+    format are ignored and overwritten.
+*/
+class GlyphSDFCache {
+public:
+    // Bump when the format of the files or the SDFs that TinySDF generates change.
+    static constexpr uint32_t Version = 1;
+
+    GlyphSDFCache(std::string directory,
+                  optional<std::string> fontFamily,
+                  double radius,
+                  double cutoff);
+
+    // Returns the glyphs that were stored for the given range, or none if there's no
+    // valid file for it.
+    std::vector<Glyph> load(const FontStack&, const GlyphRange&) const;
+
+    // Replaces the glyphs stored for the given range.
+    void store(const FontStack&, const GlyphRange&, const std::vector<Immutable<Glyph>>&) const;
+
+    // The file that holds the glyphs of the given range.
+    std::string path(const FontStack&, const GlyphRange&) const;
+
+private:
+    std::string key(const FontStack&, const GlyphRange&) const;
+    std::string pathForKey(const std::string& key) const;
+
+    const std::string directory;
+    const optional<std::string> fontFamily;
+    const double radius;
+    const double cutoff;
+};
+
+} // namespace mbgl
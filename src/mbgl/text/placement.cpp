@@ -7,6 +7,11 @@
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/util/parallel_for.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
 #include <utility>
 
 namespace mbgl {
@@ -67,7 +72,182 @@ Placement::Placement(const TransformState& state_, MapMode mapMode_, style::Tran
 {
     if (prevPlacement) {
         prevPlacement->prevPlacement.reset(); // Only hold on to one placement back
+
+        const TransformState& prevState = prevPlacement->collisionIndex.getTransformState();
+        incremental = mapMode == MapMode::Continuous && prevPlacement->mapMode == MapMode::Continuous &&
+                      state_.getSize() == prevState.getSize() &&
+                      state_.getZoom() == prevState.getZoom() &&
+                      state_.getBearing() == prevState.getBearing() &&
+                      state_.getPitch() == prevState.getPitch() &&
+                      state_.getFieldOfView() == prevState.getFieldOfView();
+        if (incremental) {
+            // Without pitch, everything moves as much as the center of the previous camera does.
+            // With pitch, features far from it move a bit more or less, and those that moved more
+            // than the tolerance are tested again.
+            const LatLng prevCenter = prevState.getLatLng();
+            const ScreenCoordinate movement = state_.latLngToScreenCoordinate(prevCenter) - prevState.latLngToScreenCoordinate(prevCenter);
+            origin = prevPlacement->origin + Point<float>(movement.x, movement.y);
+        }
+    }
+}
+
+namespace {
+
+// The parts of placing a bucket that are shared by all of its symbols, and needed to project them.
+class BucketProjectionParameters {
+public:
+    BucketProjectionParameters(const SymbolBucket& bucket, const RenderTile& renderTile, const mat4& projMatrix, const TransformState& state) {
+        const auto& layout = bucket.layout;
+        const float pixelsToTileUnits = renderTile.id.pixelsToTileUnits(1, state.getZoom());
+        const OverscaledTileID& overscaledID = renderTile.getOverscaledTileID();
+        scale = std::pow(2, state.getZoom() - overscaledID.overscaledZ);
+        pixelRatio = (util::tileSize * overscaledID.overscaleFactor()) / util::EXTENT;
+
+        state.matrixFor(posMatrix, renderTile.id);
+        matrix::multiply(posMatrix, projMatrix, posMatrix);
+
+        textLabelPlaneMatrix = getLabelPlaneMatrix(posMatrix,
+                layout.get<style::TextPitchAlignment>() == style::AlignmentType::Map,
+                layout.get<style::TextRotationAlignment>() == style::AlignmentType::Map,
+                state,
+                pixelsToTileUnits);
+
+        iconLabelPlaneMatrix = getLabelPlaneMatrix(posMatrix,
+                layout.get<style::IconPitchAlignment>() == style::AlignmentType::Map,
+                layout.get<style::IconRotationAlignment>() == style::AlignmentType::Map,
+                state,
+                pixelsToTileUnits);
+
+        partiallyEvaluatedTextSize = bucket.textSizeBinder->evaluateForZoom(state.getZoom());
+        partiallyEvaluatedIconSize = bucket.iconSizeBinder->evaluateForZoom(state.getZoom());
+        pitchWithMap = layout.get<style::TextPitchAlignment>() == style::AlignmentType::Map;
+    }
+
+    // Projects the symbols in [begin, end) of `bucket.symbolInstances` to `projections`, which is
+    // indexed like `bucket.symbolInstances`. Box features are projected in one batch.
+    void project(const CollisionIndex& collisionIndex, const SymbolBucket& bucket,
+                 std::size_t begin, std::size_t end, std::vector<SymbolProjection>& projections) const {
+        std::vector<std::pair<const CollisionFeature*, CollisionIndex::Projection*>> boxFeatures;
+        boxFeatures.reserve(2 * (end - begin));
+
+        auto projectFeature = [&](const CollisionFeature& feature, CollisionIndex::Projection& projection,
+                                  const mat4& labelPlaneMatrix, const PlacedSymbol& placedSymbol, const float fontSize) {
+            if (!feature.alongLine) {
+                if (!feature.boxes.empty()) {
+                    boxFeatures.emplace_back(&feature, &projection);
+                }
+            } else {
+                projection = collisionIndex.projectFeature(feature,
+                        posMatrix, labelPlaneMatrix, pixelRatio,
+                        placedSymbol, scale, fontSize, pitchWithMap);
+            }
+        };
+
+        for (std::size_t i = begin; i < end; ++i) {
+            const SymbolInstance& symbolInstance = bucket.symbolInstances[i];
+            SymbolProjection& projection = projections[i];
+
+            optional<size_t> horizontalTextIndex = symbolInstance.getDefaultHorizontalPlacedTextIndex();
+            if (horizontalTextIndex) {
+                const PlacedSymbol& placedSymbol = bucket.text.placedSymbols.at(*horizontalTextIndex);
+                projectFeature(symbolInstance.textCollisionFeature, projection.text, textLabelPlaneMatrix,
+                               placedSymbol, evaluateSizeForFeature(partiallyEvaluatedTextSize, placedSymbol));
+            }
+
+            if (symbolInstance.placedIconIndex) {
+                const PlacedSymbol& placedSymbol = bucket.icon.placedSymbols.at(*symbolInstance.placedIconIndex);
+                projectFeature(symbolInstance.iconCollisionFeature, projection.icon, iconLabelPlaneMatrix,
+                               placedSymbol, evaluateSizeForFeature(partiallyEvaluatedIconSize, placedSymbol));
+            }
+        }
+
+        collisionIndex.projectBoxFeatures(posMatrix, pixelRatio, boxFeatures);
     }
+
+    mat4 posMatrix;
+    mat4 textLabelPlaneMatrix;
+    mat4 iconLabelPlaneMatrix;
+    float scale;
+    float pixelRatio;
+    ZoomEvaluatedSize partiallyEvaluatedTextSize;
+    ZoomEvaluatedSize partiallyEvaluatedIconSize;
+    bool pitchWithMap;
+};
+
+// Line labels that rotate with the map are reprojected in every frame; see updateBucketDynamicVertices().
+bool reprojectsLineIcons(const SymbolBucket& bucket) {
+    return bucket.layout.get<style::SymbolPlacement>() != style::SymbolPlacementType::Point &&
+           bucket.hasIconData() && bucket.layout.get<style::IconRotationAlignment>() == style::AlignmentType::Map;
+}
+
+bool reprojectsLineText(const SymbolBucket& bucket) {
+    return bucket.layout.get<style::SymbolPlacement>() != style::SymbolPlacementType::Point &&
+           bucket.hasTextData() && bucket.layout.get<style::TextRotationAlignment>() == style::AlignmentType::Map;
+}
+
+} // namespace
+
+void Placement::projectLayers(const std::vector<std::reference_wrapper<RenderLayer>>& layers, const mat4& projMatrix) {
+    // Symbols are projected in chunks, so that the work of large buckets is spread over threads too.
+    constexpr std::size_t chunkSize = 128;
+
+    struct Chunk {
+        const SymbolBucket* bucket;
+        const BucketProjectionParameters* parameters;
+        std::vector<SymbolProjection>* projections;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // Anchors of line labels that are reprojected after this placement, in the same frame.
+    struct Anchors {
+        const std::vector<PlacedSymbol>* placedSymbols;
+        const mat4* posMatrix;
+        util::TransformedPoints* result;
+    };
+
+    const auto& state = collisionIndex.getTransformState();
+    std::vector<std::unique_ptr<BucketProjectionParameters>> parameters;
+    std::vector<Chunk> chunks;
+    std::vector<Anchors> anchors;
+
+    for (const RenderLayer& layer : layers) {
+        for (const auto& item : layer.getPlacementData()) {
+            // Only symbol layers need placement, and their placement data refers to symbol buckets.
+            const auto& bucket = static_cast<const SymbolBucket&>(item.bucket.get());
+            auto inserted = projections.emplace(&bucket, std::vector<SymbolProjection>());
+            if (!inserted.second || bucket.symbolInstances.empty()) {
+                continue;
+            }
+
+            inserted.first->second.resize(bucket.symbolInstances.size());
+            parameters.push_back(std::make_unique<BucketProjectionParameters>(bucket, item.tile, projMatrix, state));
+            for (std::size_t begin = 0; begin < bucket.symbolInstances.size(); begin += chunkSize) {
+                chunks.push_back({ &bucket, parameters.back().get(), &inserted.first->second,
+                                   begin, std::min(begin + chunkSize, bucket.symbolInstances.size()) });
+            }
+
+            // Line labels are reprojected with the tile matrix, which is usually the same as the
+            // matrix that collision features are projected with.
+            const auto& posMatrix = parameters.back()->posMatrix;
+            if (reprojectsLineIcons(bucket)) {
+                anchors.push_back({ &bucket.icon.placedSymbols, &posMatrix, &projectedAnchors[&bucket.icon.placedSymbols] });
+            }
+            if (reprojectsLineText(bucket)) {
+                anchors.push_back({ &bucket.text.placedSymbols, &posMatrix, &projectedAnchors[&bucket.text.placedSymbols] });
+            }
+        }
+    }
+
+    util::parallelFor(chunks.size() + anchors.size(), [&](std::size_t index) {
+        if (index < chunks.size()) {
+            const Chunk& chunk = chunks[index];
+            chunk.parameters->project(collisionIndex, *chunk.bucket, chunk.begin, chunk.end, *chunk.projections);
+        } else {
+            const Anchors& job = anchors[index - chunks.size()];
+            *job.result = projectAnchors(*job.placedSymbols, *job.posMatrix);
+        }
+    });
 }
 
 void Placement::placeLayer(const RenderLayer& layer, const mat4& projMatrix, bool showCollisionBoxes) {
@@ -84,6 +264,42 @@ void Placement::placeLayer(const RenderLayer& layer, const mat4& projMatrix, boo
 }
 
 namespace {
+
+// How far a feature may move relative to the map, in pixels, and keep its previous placement.
+constexpr float incrementalPlacementTolerance = 0.5f;
+
+// The bounds of the boxes or circles of a feature that were placed into the collision index last.
+optional<PlacedCollisionBounds> getPlacedBounds(const CollisionFeature& feature, Point<float> origin) {
+    optional<PlacedCollisionBounds> bounds;
+    for (const CollisionBox& box : feature.boxes) {
+        if (feature.alongLine && !box.used) {
+            continue;
+        }
+        if (!bounds) {
+            bounds = PlacedCollisionBounds{ box.px1, box.py1, box.px2, box.py2 };
+        } else {
+            bounds->x1 = std::min(bounds->x1, box.px1);
+            bounds->y1 = std::min(bounds->y1, box.py1);
+            bounds->x2 = std::max(bounds->x2, box.px2);
+            bounds->y2 = std::max(bounds->y2, box.py2);
+        }
+    }
+    if (bounds) {
+        bounds->x1 -= origin.x;
+        bounds->y1 -= origin.y;
+        bounds->x2 -= origin.x;
+        bounds->y2 -= origin.y;
+    }
+    return bounds;
+}
+
+bool samePlace(const PlacedCollisionBounds& a, const PlacedCollisionBounds& b) {
+    return std::abs(a.x1 - b.x1) <= incrementalPlacementTolerance &&
+           std::abs(a.y1 - b.y1) <= incrementalPlacementTolerance &&
+           std::abs(a.x2 - b.x2) <= incrementalPlacementTolerance &&
+           std::abs(a.y2 - b.y2) <= incrementalPlacementTolerance;
+}
+
 Point<float> calculateVariableLayoutOffset(style::SymbolAnchorType anchor, float width, float height, float radialOffset, float textBoxScale) {
     AnchorAlignment alignment = AnchorAlignment::getAnchorAlignment(anchor);
     float shiftX = -(alignment.horizontalAlign - 0.5f) * width;
@@ -103,30 +319,19 @@ void Placement::placeBucket(
     const auto& layout = bucket.layout;
     const auto& renderTile = params.tile;
     const auto& state = collisionIndex.getTransformState();
-    const float pixelsToTileUnits = renderTile.id.pixelsToTileUnits(1, state.getZoom());
     const OverscaledTileID& overscaledID = renderTile.getOverscaledTileID();
-    const float scale = std::pow(2, state.getZoom() - overscaledID.overscaledZ);
-    const float pixelRatio = (util::tileSize * overscaledID.overscaleFactor()) / util::EXTENT;
-
-    mat4 posMatrix;
-    state.matrixFor(posMatrix, renderTile.id);
-    matrix::multiply(posMatrix, params.projMatrix, posMatrix);
-
-    mat4 textLabelPlaneMatrix = getLabelPlaneMatrix(posMatrix,
-            layout.get<style::TextPitchAlignment>() == style::AlignmentType::Map,
-            layout.get<style::TextRotationAlignment>() == style::AlignmentType::Map,
-            state,
-            pixelsToTileUnits);
-
-    mat4 iconLabelPlaneMatrix = getLabelPlaneMatrix(posMatrix,
-            layout.get<style::IconPitchAlignment>() == style::AlignmentType::Map,
-            layout.get<style::IconRotationAlignment>() == style::AlignmentType::Map,
-            state,
-            pixelsToTileUnits);
+    const BucketProjectionParameters projectionParameters(bucket, renderTile, params.projMatrix, state);
+    const mat4& posMatrix = projectionParameters.posMatrix;
+
+    auto projected = projections.find(&bucket);
+    if (projected == projections.end()) {
+        std::vector<SymbolProjection> bucketProjections(bucket.symbolInstances.size());
+        projectionParameters.project(collisionIndex, bucket, 0, bucket.symbolInstances.size(), bucketProjections);
+        projected = projections.emplace(&bucket, std::move(bucketProjections)).first;
+    }
+    const std::vector<SymbolProjection>& symbolProjections = projected->second;
 
     const auto& collisionGroup = collisionGroups.get(params.sourceId);
-    auto partiallyEvaluatedTextSize = bucket.textSizeBinder->evaluateForZoom(state.getZoom());
-    auto partiallyEvaluatedIconSize = bucket.iconSizeBinder->evaluateForZoom(state.getZoom());
 
     optional<CollisionTileBoundaries> avoidEdges;
     if (mapMode == MapMode::Tile &&
@@ -159,6 +364,45 @@ void Placement::placeBucket(
 
     const bool zOrderByViewportY = layout.get<style::SymbolZOrder>() == style::SymbolZOrderType::ViewportY;
 
+    // Places a feature without a variable anchor. With incremental placement, a box feature that
+    // was placed at the same spot in the previous placement is kept, and isn't tested against the
+    // index again, unless a feature that wasn't placed there before was placed near it.
+    auto placeFeature = [&] (CollisionFeature& feature, const CollisionIndex::Projection& projection, bool allowOverlap,
+                             const optional<PlacedCollisionBounds>& prevBounds, bool& kept) {
+        if (prevBounds && !feature.alongLine) {
+            // Only computes the projected box, and checks that it's still in the grid.
+            auto placed = collisionIndex.placeFeature(feature, projection, {}, true,
+                    params.showCollisionBoxes, avoidEdges, collisionGroup.second);
+            const auto bounds = getPlacedBounds(feature, origin);
+            if (placed.first && samePlace(*bounds, *prevBounds) &&
+                !collisionIndex.isChanged(feature.boxes.front(), incrementalPlacementTolerance)) {
+                kept = true;
+                return placed;
+            }
+        }
+        kept = false;
+        return collisionIndex.placeFeature(feature, projection, {}, allowOverlap,
+                params.showCollisionBoxes, avoidEdges, collisionGroup.second);
+    };
+
+    // Inserts a placed feature into the index, and records where it was placed. Kept features
+    // keep the bounds they were tested at, so that they can't drift away from them bit by bit.
+    auto insertFeature = [&] (CollisionFeature& feature, bool ignorePlacement, const optional<PlacedCollisionBounds>& prevBounds,
+                              bool kept, optional<PlacedCollisionBounds>& bounds) {
+        collisionIndex.insertFeature(feature, ignorePlacement, bucket.bucketInstanceId, collisionGroup.first);
+        if (mapMode != MapMode::Continuous) {
+            return;
+        }
+        if (kept) {
+            bounds = prevBounds;
+            return;
+        }
+        bounds = getPlacedBounds(feature, origin);
+        if (!ignorePlacement && bounds && !(prevBounds && samePlace(*bounds, *prevBounds))) {
+            collisionIndex.markChanged(feature);
+        }
+    };
+
     auto placeSymbol = [&] (SymbolInstance& symbolInstance) {
         if (seenCrossTileIDs.count(symbolInstance.crossTileID) != 0u) return;
 
@@ -169,21 +413,26 @@ void Placement::placeBucket(
             return;
         }
 
+        const SymbolProjection& projection = symbolProjections[&symbolInstance - bucket.symbolInstances.data()];
+        PlacedSymbolBounds prevBounds;
+        if (incremental) {
+            auto found = prevPlacement->placedBounds.find(symbolInstance.crossTileID);
+            if (found != prevPlacement->placedBounds.end() && found->second.bucketInstanceId == bucket.bucketInstanceId) {
+                prevBounds = found->second;
+            }
+        }
+
         bool placeText = false;
         bool placeIcon = false;
+        bool keptText = false;
+        bool keptIcon = false;
         bool offscreen = true;
         optional<size_t> horizontalTextIndex = symbolInstance.getDefaultHorizontalPlacedTextIndex();
         if (horizontalTextIndex) {
             CollisionFeature& textCollisionFeature = symbolInstance.textCollisionFeature;
-            PlacedSymbol& placedSymbol = bucket.text.placedSymbols.at(*horizontalTextIndex);
-            const float fontSize = evaluateSizeForFeature(partiallyEvaluatedTextSize, placedSymbol);
             if (variableTextAnchors.empty()) {
-                auto placed = collisionIndex.placeFeature(textCollisionFeature, {},
-                        posMatrix, textLabelPlaneMatrix, pixelRatio,
-                        placedSymbol, scale, fontSize,
-                        layout.get<style::TextAllowOverlap>(),
-                        pitchWithMap,
-                        params.showCollisionBoxes, avoidEdges, collisionGroup.second);
+                auto placed = placeFeature(textCollisionFeature, projection.text,
+                        layout.get<style::TextAllowOverlap>(), prevBounds.text, keptText);
                 placeText = placed.first;
                 offscreen &= placed.second;
             } else if (!textCollisionFeature.alongLine && !textCollisionFeature.boxes.empty()) {
@@ -217,11 +466,8 @@ void Placement::placeBucket(
                         shift = util::rotate(shift, angle);
                     }
 
-                    auto placed = collisionIndex.placeFeature(textCollisionFeature, shift,
-                                                                posMatrix, mat4(), pixelRatio,
-                                                                placedSymbol, scale, fontSize,
+                    auto placed = collisionIndex.placeFeature(textCollisionFeature, projection.text, shift,
                                                                 layout.get<style::TextAllowOverlap>(),
-                                                                pitchWithMap,
                                                                 params.showCollisionBoxes, avoidEdges, collisionGroup.second);
 
                     if (placed.first) {
@@ -269,15 +515,8 @@ void Placement::placeBucket(
         }
 
         if (symbolInstance.placedIconIndex) {
-            PlacedSymbol& placedSymbol = bucket.icon.placedSymbols.at(*symbolInstance.placedIconIndex);
-            const float fontSize = evaluateSizeForFeature(partiallyEvaluatedIconSize, placedSymbol);
-
-            auto placed = collisionIndex.placeFeature(symbolInstance.iconCollisionFeature, {},
-                    posMatrix, iconLabelPlaneMatrix, pixelRatio,
-                    placedSymbol, scale, fontSize,
-                    layout.get<style::IconAllowOverlap>(),
-                    pitchWithMap,
-                    params.showCollisionBoxes, avoidEdges, collisionGroup.second);
+            auto placed = placeFeature(symbolInstance.iconCollisionFeature, projection.icon,
+                    layout.get<style::IconAllowOverlap>(), prevBounds.icon, keptIcon);
             placeIcon = placed.first;
             offscreen &= placed.second;
         }
@@ -294,12 +533,21 @@ void Placement::placeBucket(
             placeIcon = placeText && placeIcon;
         }
 
+        PlacedSymbolBounds bounds;
+        bounds.bucketInstanceId = bucket.bucketInstanceId;
+
         if (placeText) {
-            collisionIndex.insertFeature(symbolInstance.textCollisionFeature, layout.get<style::TextIgnorePlacement>(), bucket.bucketInstanceId, collisionGroup.first);
+            insertFeature(symbolInstance.textCollisionFeature, layout.get<style::TextIgnorePlacement>(), prevBounds.text, keptText, bounds.text);
         }
 
         if (placeIcon) {
-            collisionIndex.insertFeature(symbolInstance.iconCollisionFeature, layout.get<style::IconIgnorePlacement>(), bucket.bucketInstanceId, collisionGroup.first);
+            insertFeature(symbolInstance.iconCollisionFeature, layout.get<style::IconIgnorePlacement>(), prevBounds.icon, keptIcon, bounds.icon);
+        }
+
+        if (bounds.text || bounds.icon) {
+            placedBounds[symbolInstance.crossTileID] = bounds;
+        } else {
+            placedBounds.erase(symbolInstance.crossTileID);
         }
 
         assert(symbolInstance.crossTileID != 0);
@@ -327,6 +575,7 @@ void Placement::placeBucket(
     }
 
     bucket.justReloaded = false;
+    projections.erase(projected);
 
     // As long as this placement lives, we have to hold onto this bucket's
     // matching FeatureIndex/data for querying purposes
@@ -384,11 +633,24 @@ void Placement::commit(TimePoint now) {
     fadeStartTime = placementChanged ? commitTime : prevPlacement->fadeStartTime;
 }
 
-void Placement::updateLayerBuckets(const RenderLayer& layer, const TransformState& state, bool updateOpacities) {
-    std::set<uint32_t> seenCrossTileIDs;
-    for (const auto& item : layer.getPlacementData()) {
-        item.bucket.get().updateVertices(*this, updateOpacities, state, item.tile, seenCrossTileIDs);
+void Placement::updateLayerBuckets(const std::vector<std::reference_wrapper<RenderLayer>>& layers, const TransformState& state, bool updateOpacities) {
+    std::vector<const LayerPlacementData*> items;
+    for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+        std::set<uint32_t> seenCrossTileIDs;
+        for (const auto& item : it->get().getPlacementData()) {
+            if (updateOpacities) {
+                item.bucket.get().updateOpacities(*this, state, seenCrossTileIDs);
+            }
+            items.push_back(&item);
+        }
     }
+
+    // Each bucket only writes its own vertices, and only reads the placement.
+    util::parallelFor(items.size(), [&](std::size_t i) {
+        items[i]->bucket.get().updateDynamicVertices(*this, state, items[i]->tile);
+    });
+
+    projectedAnchors.clear();
 }
 
 namespace {
@@ -402,6 +664,15 @@ Point<float> calculateVariableRenderShift(style::SymbolAnchorType anchor, float
 }
 } // namespace
 
+util::TransformedPoints Placement::takeProjectedAnchors(const std::vector<PlacedSymbol>& placedSymbols, const mat4& posMatrix) {
+    // Doesn't insert or erase entries, so that buckets may take their anchors concurrently.
+    auto found = projectedAnchors.find(&placedSymbols);
+    if (found != projectedAnchors.end() && found->second.matrix == posMatrix && found->second.size() == placedSymbols.size()) {
+        return std::move(found->second);
+    }
+    return projectAnchors(placedSymbols, posMatrix);
+}
+
 bool Placement::updateBucketDynamicVertices(SymbolBucket& bucket, const TransformState& state, const RenderTile& tile) {
     using namespace style;
     const auto& layout = bucket.layout;
@@ -409,21 +680,25 @@ bool Placement::updateBucketDynamicVertices(SymbolBucket& bucket, const Transfor
     bool result = false;
 
     if (alongLine) {
-        if (bucket.hasIconData() && layout.get<IconRotationAlignment>() == AlignmentType::Map) {
+        if (reprojectsLineIcons(bucket)) {
             const bool pitchWithMap = layout.get<style::IconPitchAlignment>() == style::AlignmentType::Map;
             const bool keepUpright = layout.get<style::IconKeepUpright>();
             reprojectLineLabels(bucket.icon.dynamicVertices, bucket.icon.placedSymbols,
+                takeProjectedAnchors(bucket.icon.placedSymbols, tile.matrix),
                 tile.matrix, pitchWithMap, true /*rotateWithMap*/, keepUpright,
                 tile, *bucket.iconSizeBinder, state);
+            bucket.icon.updateDynamicDirtyRanges();
             result = true;
         }
 
-        if (bucket.hasTextData() && layout.get<TextRotationAlignment>() == AlignmentType::Map) {
+        if (reprojectsLineText(bucket)) {
             const bool pitchWithMap = layout.get<style::TextPitchAlignment>() == style::AlignmentType::Map;
             const bool keepUpright = layout.get<style::TextKeepUpright>();
             reprojectLineLabels(bucket.text.dynamicVertices, bucket.text.placedSymbols,
+                takeProjectedAnchors(bucket.text.placedSymbols, tile.matrix),
                 tile.matrix, pitchWithMap, true /*rotateWithMap*/, keepUpright,
                 tile, *bucket.textSizeBinder, state);
+            bucket.text.updateDynamicDirtyRanges();
             result = true;
         }
     } else if (!layout.get<TextVariableAnchor>().empty() && bucket.hasTextData()) {
@@ -493,6 +768,7 @@ bool Placement::updateBucketDynamicVertices(SymbolBucket& bucket, const Transfor
             }
         }
 
+        bucket.text.updateDynamicDirtyRanges();
         result = true;
     }
 
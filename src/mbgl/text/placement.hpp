@@ -7,6 +7,8 @@
 #include <mbgl/layout/symbol_projection.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <unordered_set>
+#include <functional>
+#include <vector>
 
 namespace mbgl {
 
@@ -88,6 +90,31 @@ private:
     bool crossSourceCollisions;
 };
 
+// The bounds of the placed boxes or circles of a collision feature, in viewport pixels relative to
+// the origin of the placement that tested it for collisions.
+class PlacedCollisionBounds {
+public:
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+};
+
+// Where the collision features of a symbol were placed, for incremental placement.
+class PlacedSymbolBounds {
+public:
+    uint32_t bucketInstanceId = 0;
+    optional<PlacedCollisionBounds> text;
+    optional<PlacedCollisionBounds> icon;
+};
+
+// The projected collision features of a symbol instance.
+class SymbolProjection {
+public:
+    CollisionIndex::Projection text;
+    CollisionIndex::Projection icon;
+};
+
 class BucketPlacementParameters {
 public:
     const RenderTile& tile;
@@ -99,9 +126,17 @@ public:
 class Placement {
 public:
     Placement(const TransformState&, MapMode, style::TransitionOptions, const bool crossSourceCollisions, std::unique_ptr<Placement> prevPlacementOrNull = nullptr);
+    // Projects the collision features of all symbols in the given layers, spreading the work
+    // across threads. Projecting only reads the buckets, and doesn't depend on the collision
+    // index. placeLayer() then uses these projections, and resolves collisions in layer order
+    // exactly as it would without them. Layers that weren't projected are projected while
+    // they're placed.
+    void projectLayers(const std::vector<std::reference_wrapper<RenderLayer>>&, const mat4& projMatrix);
     void placeLayer(const RenderLayer&, const mat4&, bool showCollisionBoxes);
     void commit(TimePoint);
-    void updateLayerBuckets(const RenderLayer&, const TransformState&,  bool updateOpacities);
+    // Updates the opacities and the camera dependent vertices of the buckets of the given layers.
+    // The vertices of different buckets are updated in parallel.
+    void updateLayerBuckets(const std::vector<std::reference_wrapper<RenderLayer>>&, const TransformState&, bool updateOpacities);
     float symbolFadeChange(TimePoint now) const;
     bool hasTransitions(TimePoint now) const;
 
@@ -125,6 +160,14 @@ private:
 
     CollisionIndex collisionIndex;
 
+    // Indexed like `SymbolBucket::symbolInstances`. Entries are dropped once their bucket is placed.
+    std::unordered_map<const SymbolBucket*, std::vector<SymbolProjection>> projections;
+
+    // Anchors of line labels, projected along with the collision features, for reprojecting the
+    // labels in the same frame. Entries are dropped after the buckets are updated.
+    std::unordered_map<const std::vector<PlacedSymbol>*, util::TransformedPoints> projectedAnchors;
+    util::TransformedPoints takeProjectedAnchors(const std::vector<PlacedSymbol>&, const mat4& posMatrix);
+
     MapMode mapMode;
     style::TransitionOptions transitionOptions;
 
@@ -135,6 +178,17 @@ private:
     std::unordered_map<uint32_t, JointOpacityState> opacities;
     std::unordered_map<uint32_t, VariableOffset> variableOffsets;
 
+    // Incremental placement: if the camera only moved across the screen since the previous
+    // placement, a box feature that was placed then, and that moved along with the camera, keeps
+    // its placement without being tested against the collision index, unless a feature that wasn't
+    // placed at the same spot before was placed near it. Features that weren't placed are always
+    // tested, because whatever hid them may be gone.
+    bool incremental = false;
+    // How far the map moved across the screen, in pixels, since the last placement that wasn't
+    // incremental.
+    Point<float> origin;
+    std::unordered_map<uint32_t, PlacedSymbolBounds> placedBounds;
+
     bool stale = false;
     
     std::unordered_map<uint32_t, RetainedQueryData> retainedQueryData;
@@ -0,0 +1,162 @@
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/util/hash.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+constexpr std::size_t ShapingCache::DefaultMaximumSize;
+
+ShapingCache::Key::Key(const TaggedString& string,
+                       const float maxWidth_,
+                       const float lineHeight_,
+                       const style::SymbolAnchorType textAnchor_,
+                       const style::TextJustifyType textJustify_,
+                       const float spacing_,
+                       const Point<float>& translate_,
+                       const WritingModeType writingMode_,
+                       const GlyphMap& glyphMap)
+    : styledText(string.getStyledText()),
+      maxWidth(maxWidth_),
+      lineHeight(lineHeight_),
+      textAnchor(textAnchor_),
+      textJustify(textJustify_),
+      spacing(spacing_),
+      translate(translate_),
+      writingMode(writingMode_),
+      glyphsHash(0) {
+    sections.reserve(string.sectionCount());
+    for (const auto& section : string.getSections()) {
+        sections.emplace_back(section.scale, section.fontStackHash);
+    }
+
+    for (std::size_t i = 0; i < string.length(); ++i) {
+        uint32_t advance = 0;
+        bool found = false;
+        auto glyphs = glyphMap.find(string.getSection(i).fontStackHash);
+        if (glyphs != glyphMap.end()) {
+            auto it = glyphs->second.find(string.getCharCodeAt(i));
+            if (it != glyphs->second.end() && it->second) {
+                advance = (*it->second)->metrics.advance;
+                found = true;
+            }
+        }
+        util::hash_combine(glyphsHash, found);
+        util::hash_combine(glyphsHash, advance);
+    }
+
+    hash = util::hash(styledText.first, maxWidth, lineHeight, textAnchor, textJustify, spacing,
+                      translate.x, translate.y, writingMode, glyphsHash);
+    for (uint8_t sectionIndex : styledText.second) {
+        util::hash_combine(hash, sectionIndex);
+    }
+    for (const auto& section : sections) {
+        util::hash_combine(hash, section.first);
+        util::hash_combine(hash, section.second);
+    }
+}
+
+bool ShapingCache::Key::operator==(const Key& other) const {
+    return hash == other.hash &&
+           glyphsHash == other.glyphsHash &&
+           maxWidth == other.maxWidth &&
+           lineHeight == other.lineHeight &&
+           textAnchor == other.textAnchor &&
+           textJustify == other.textJustify &&
+           spacing == other.spacing &&
+           translate == other.translate &&
+           writingMode == other.writingMode &&
+           styledText == other.styledText &&
+           sections == other.sections;
+}
+
+ShapingCache& ShapingCache::get() {
+    static ShapingCache instance;
+    return instance;
+}
+
+std::shared_ptr<const Shaping> ShapingCache::find(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = index.find(key);
+    if (it == index.end()) {
+        statistics.misses++;
+        return nullptr;
+    }
+
+    statistics.hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+void ShapingCache::insert(Key key, std::shared_ptr<const Shaping> shaping) {
+    const std::size_t entryBytes = bytes(key, *shaping);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Another worker shaped the same text concurrently.
+        size -= bytes(it->second->first, *it->second->second);
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    if (entryBytes > maximumSize) {
+        return;
+    }
+
+    entries.emplace_front(std::move(key), std::move(shaping));
+    index.emplace(entries.front().first, entries.begin());
+    size += entryBytes;
+
+    evict();
+}
+
+void ShapingCache::setMaximumSize(std::size_t bytes_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumSize = bytes_;
+    evict();
+}
+
+std::size_t ShapingCache::getMaximumSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return maximumSize;
+}
+
+std::size_t ShapingCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+ShapingCache::Statistics ShapingCache::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
+
+void ShapingCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    size = 0;
+    statistics = {};
+}
+
+std::size_t ShapingCache::bytes(const Key& key, const Shaping& shaping) {
+    // The key is stored twice: in the list of entries and in the index.
+    return 2 * (sizeof(Key) + key.styledText.first.size() * sizeof(char16_t) + key.styledText.second.size() +
+                key.sections.size() * sizeof(key.sections.front())) +
+           sizeof(Shaping) + shaping.positionedGlyphs.size() * sizeof(PositionedGlyph);
+}
+
+void ShapingCache::evict() {
+    while (size > maximumSize) {
+        assert(!entries.empty());
+        size -= bytes(entries.back().first, *entries.back().second);
+        index.erase(entries.back().first);
+        entries.pop_back();
+        statistics.evictions++;
+    }
+}
+
+} // namespace mbgl
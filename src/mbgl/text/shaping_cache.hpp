@@ -0,0 +1,109 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/text/tagged_string.hpp>
+#include <mbgl/style/types.hpp>
+#include <mbgl/util/geometry.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+// A process-wide cache of text shapings. Street names and POI labels repeat across the features
+// of a tile and across neighboring tiles, and the tile workers of all maps share the result of
+// shaping them.
+class ShapingCache {
+public:
+    // Everything that getShaping() depends on.
+    class Key {
+    public:
+        Key(const TaggedString&,
+            float maxWidth,
+            float lineHeight,
+            style::SymbolAnchorType,
+            style::TextJustifyType,
+            float spacing,
+            const Point<float>& translate,
+            WritingModeType,
+            const GlyphMap&);
+
+        bool operator==(const Key&) const;
+
+        StyledText styledText;
+        // The scale and font stack of each section. Text colors don't affect shaping.
+        std::vector<std::pair<double, FontStackHash>> sections;
+        float maxWidth;
+        float lineHeight;
+        style::SymbolAnchorType textAnchor;
+        style::TextJustifyType textJustify;
+        float spacing;
+        Point<float> translate;
+        WritingModeType writingMode;
+        // Shaping only uses the advances of the glyphs of the text, and skips missing glyphs. A
+        // hash of those keeps fonts with the same name but different glyphs apart.
+        std::size_t glyphsHash;
+        std::size_t hash;
+    };
+
+    class Statistics {
+    public:
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+    };
+
+    static constexpr std::size_t DefaultMaximumSize = 4 * 1024 * 1024;
+
+    static ShapingCache& get();
+
+    // Returns the shaping for the given key, or nullptr.
+    std::shared_ptr<const Shaping> find(const Key&);
+
+    // Adds a shaping and evicts the least recently used ones until the cache fits into its
+    // maximum size again. Shapings that are larger than the maximum size aren't added, so a
+    // maximum size of 0 disables the cache.
+    void insert(Key, std::shared_ptr<const Shaping>);
+
+    void setMaximumSize(std::size_t bytes);
+    std::size_t getMaximumSize() const;
+
+    // The approximate number of bytes used by all entries.
+    std::size_t getSize() const;
+
+    Statistics getStatistics() const;
+
+    void clear();
+
+private:
+    ShapingCache() = default;
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            return key.hash;
+        }
+    };
+
+    using Entries = std::list<std::pair<Key, std::shared_ptr<const Shaping>>>;
+
+    static std::size_t bytes(const Key&, const Shaping&);
+    void evict();
+
+    mutable std::mutex mutex;
+
+    // Ordered from most recently to least recently used.
+    Entries entries;
+    std::unordered_map<Key, Entries::iterator, KeyHash> index;
+
+    std::size_t size = 0;
+    std::size_t maximumSize = DefaultMaximumSize;
+    Statistics statistics;
+};
+
+} // namespace mbgl
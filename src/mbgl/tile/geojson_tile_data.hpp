@@ -43,6 +43,11 @@ public:
         }
         return optional<Value>();
     }
+
+    const Value* findValue(const std::string& key, optional<Value>&) const override {
+        auto it = feature.properties.find(key);
+        return it != feature.properties.end() ? &it->second : nullptr;
+    }
 };
 
 class GeoJSONTileLayer : public GeometryTileLayer {
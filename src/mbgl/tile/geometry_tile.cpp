@@ -19,6 +19,8 @@
 #include <mbgl/util/logging.hpp>
 #include <mbgl/actor/scheduler.hpp>
 
+#include <unordered_set>
+
 namespace mbgl {
 
 using namespace style;
@@ -53,7 +55,8 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
              obsolete,
              parameters.mode,
              parameters.pixelRatio,
-             parameters.debugOptions & MapDebugOptions::Collision),
+             parameters.debugOptions & MapDebugOptions::Collision,
+             parameters.glyphManager.getAtlas()),
       fileSource(parameters.fileSource),
       glyphManager(parameters.glyphManager),
       imageManager(parameters.imageManager),
@@ -123,6 +126,10 @@ void GeometryTile::setShowCollisionBoxes(const bool showCollisionBoxes_) {
     }
 }
 
+void GeometryTile::setPriority(Mailbox::Priority priority) {
+    worker.setPriority(priority);
+}
+
 void GeometryTile::onLayout(LayoutResult result, const uint64_t resultCorrelationID) {
     loaded = true;
     renderable = true;
@@ -134,8 +141,8 @@ void GeometryTile::onLayout(LayoutResult result, const uint64_t resultCorrelatio
     
     latestFeatureIndex = std::move(result.featureIndex);
 
-    if (result.glyphAtlasImage) {
-        glyphAtlasImage = std::move(*result.glyphAtlasImage);
+    if (result.glyphs) {
+        glyphs = std::move(result.glyphs);
     }
     if (result.iconAtlas.image.valid()) {
         iconAtlas = std::move(result.iconAtlas);
@@ -187,11 +194,6 @@ void GeometryTile::upload(gfx::UploadPass& uploadPass) {
         uploadFn(*entry.second.bucket);
     }
 
-    if (glyphAtlasImage) {
-        glyphAtlasTexture = uploadPass.createTexture(*glyphAtlasImage);
-        glyphAtlasImage = {};
-    }
-
     if (iconAtlas.image.valid()) {
         iconAtlasTexture = uploadPass.createTexture(iconAtlas.image);
         iconAtlas.image = {};
@@ -207,6 +209,27 @@ Bucket* GeometryTile::getBucket(const Layer::Impl& layer) const {
     return data ? data->bucket.get() : nullptr; 
 }
 
+std::size_t GeometryTile::getMemoryUse() const {
+    std::size_t result = latestFeatureIndex ? latestFeatureIndex->getMemoryUse() : 0;
+
+    // Layers that share their layout properties also share a bucket.
+    std::unordered_set<const Bucket*> buckets;
+    for (const auto& entry : layerIdToLayerRenderData) {
+        const Bucket* bucket = entry.second.bucket.get();
+        if (bucket && buckets.insert(bucket).second) {
+            result += bucket->getMemoryUse();
+        }
+    }
+
+    // Glyphs live in the renderer's shared atlas. The icon atlas has four 8 bit channels.
+    result += iconAtlas.image.bytes();
+    if (iconAtlasTexture) {
+        result += iconAtlasTexture->size.area() * 4;
+    }
+
+    return result;
+}
+
 const LayerRenderData* GeometryTile::getLayerRenderData(const style::Layer::Impl& layerImpl) const {
     auto* that = const_cast<GeometryTile*>(this);
     return that->getMutableLayerRenderData(layerImpl);
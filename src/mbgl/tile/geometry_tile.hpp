@@ -4,6 +4,7 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/gfx/texture.hpp>
 #include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/tile/geometry_tile_worker.hpp>
@@ -21,7 +22,6 @@ class GeometryTileData;
 class RenderLayer;
 class SourceQueryOptions;
 class TileParameters;
-class GlyphAtlas;
 class ImageAtlas;
 
 class GeometryTile : public Tile, public GlyphRequestor, public ImageRequestor {
@@ -37,6 +37,7 @@ public:
 
     void setLayers(const std::vector<Immutable<style::LayerProperties>>&) override;
     void setShowCollisionBoxes(const bool showCollisionBoxes) override;
+    void setPriority(Mailbox::Priority) override;
 
     void onGlyphsAvailable(GlyphMap) override;
     void onImagesAvailable(ImageMap, ImageMap, ImageVersionMap versionMap, uint64_t imageCorrelationID) override;
@@ -69,16 +70,16 @@ public:
     public:
         std::unordered_map<std::string, LayerRenderData> renderData;
         std::unique_ptr<FeatureIndex> featureIndex;
-        optional<AlphaImage> glyphAtlasImage;
+        std::unique_ptr<GlyphAtlas::Glyphs> glyphs;
         ImageAtlas iconAtlas;
 
         LayoutResult(std::unordered_map<std::string, LayerRenderData> renderData_,
                      std::unique_ptr<FeatureIndex> featureIndex_,
-                     optional<AlphaImage> glyphAtlasImage_,
+                     std::unique_ptr<GlyphAtlas::Glyphs> glyphs_,
                      ImageAtlas iconAtlas_)
             : renderData(std::move(renderData_)),
               featureIndex(std::move(featureIndex_)),
-              glyphAtlasImage(std::move(glyphAtlasImage_)),
+              glyphs(std::move(glyphs_)),
               iconAtlas(std::move(iconAtlas_)) {}
     };
     void onLayout(LayoutResult, uint64_t correlationID);
@@ -91,6 +92,8 @@ public:
     void performedFadePlacement() override;
     const optional<ImagePosition> getPattern(const std::string& pattern) const;
     const std::shared_ptr<FeatureIndex> getFeatureIndex() const { return latestFeatureIndex; }
+
+    std::size_t getMemoryUse() const override;
     
     const std::string sourceID;
     
@@ -120,7 +123,8 @@ private:
     
     std::shared_ptr<FeatureIndex> latestFeatureIndex;
 
-    optional<AlphaImage> glyphAtlasImage;
+    // Keeps the glyphs of the latest layout in the renderer's glyph atlas.
+    std::unique_ptr<GlyphAtlas::Glyphs> glyphs;
     ImageAtlas iconAtlas;
 
     const MapMode mode;
@@ -136,7 +140,6 @@ private:
 
     FadeState fadeState = FadeState::Loaded;
 public:
-    optional<gfx::Texture> glyphAtlasTexture;
     optional<gfx::Texture> iconAtlasTexture;
 };
 
@@ -1,10 +1,44 @@
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/style/filter.hpp>
 
 #include <mapbox/geometry/wagyu/wagyu.hpp>
 
 namespace mbgl {
 
+void GeometryTileLayer::forEachFeature(const FeatureVisitor& visitor) const {
+    const std::size_t count = featureCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (auto feature = getFeature(i)) {
+            if (!visitor(i, *feature)) {
+                return;
+            }
+        }
+    }
+}
+
+void GeometryTileLayer::forEachFeature(const style::Filter& filter, float zoom, const FeatureVisitor& visitor) const {
+    forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+        if (!filter(style::expression::EvaluationContext { zoom, &feature })) {
+            return true;
+        }
+        return visitor(i, feature);
+    });
+}
+
+void GeometryTileLayer::forEachOwnedFeature(const style::Filter& filter, float zoom, const OwnedFeatureVisitor& visitor) const {
+    const std::size_t count = featureCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        auto feature = getFeature(i);
+        if (!feature || !filter(style::expression::EvaluationContext { zoom, feature.get() })) {
+            continue;
+        }
+        if (!visitor(i, std::move(feature))) {
+            return;
+        }
+    }
+}
+
 static double signedArea(const GeometryCoordinates& ring) {
     double sum = 0;
 
@@ -5,6 +5,7 @@
 #include <mbgl/util/optional.hpp>
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -13,6 +14,10 @@ namespace mbgl {
 
 class CanonicalTileID;
 
+namespace style {
+class Filter;
+} // namespace style
+
 // Normalized vector tile coordinates.
 // Each geometry coordinate represents a point in a bidimensional space,
 // varying from -V...0...+V, where V is the maximum extent applicable.
@@ -42,9 +47,24 @@ public:
     virtual ~GeometryTileFeature() = default;
     virtual FeatureType getType() const = 0;
     virtual optional<Value> getValue(const std::string& key) const = 0;
+
+    // Returns the value of the property with the given key like getValue(), or null if the
+    // feature doesn't have it, without copying the value where possible: features that hold
+    // their values return a pointer to them, which is valid as long as the feature. Others copy
+    // the value into `storage` and return a pointer to that.
+    virtual const Value* findValue(const std::string& key, optional<Value>& storage) const {
+        storage = getValue(key);
+        return storage ? &*storage : nullptr;
+    }
+
     virtual PropertyMap getProperties() const { return PropertyMap(); }
     virtual FeatureIdentifier getID() const { return NullValue {}; }
     virtual GeometryCollection getGeometries() const = 0;
+
+    // Replaces the contents of the given collection with the geometries of this feature,
+    // reusing the memory the collection already holds. Use this instead of getGeometries()
+    // when decoding many features in a row.
+    virtual void decodeGeometries(GeometryCollection& geometries) const { geometries = getGeometries(); }
 };
 
 class GeometryTileLayer {
@@ -56,6 +76,22 @@ public:
     // object may *not* outlive the layer object.
     virtual std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const = 0;
 
+    // Calls the visitor with the index and the feature object of every feature in the layer,
+    // in order, until the visitor returns false. The feature object is only valid for the
+    // duration of the call, which allows implementations to avoid allocating it.
+    using FeatureVisitor = std::function<bool (std::size_t, const GeometryTileFeature&)>;
+    virtual void forEachFeature(const FeatureVisitor&) const;
+
+    // Same as above, but only visits features that match the filter at the given zoom level.
+    // Implementations may evaluate the filter without creating feature objects, and skip
+    // features that don't match before decoding any of their properties or geometries.
+    virtual void forEachFeature(const style::Filter&, float zoom, const FeatureVisitor&) const;
+
+    // Same as above, but passes ownership of the feature objects to the visitor, for visitors
+    // that keep them. Like the ones returned by getFeature(), they may *not* outlive the layer.
+    using OwnedFeatureVisitor = std::function<bool (std::size_t, std::unique_ptr<GeometryTileFeature>)>;
+    virtual void forEachOwnedFeature(const style::Filter&, float zoom, const OwnedFeatureVisitor&) const;
+
     virtual std::string getName() const = 0;
 };
 
@@ -67,6 +103,10 @@ public:
     // Returns the layer with the given name. The returned layer object *may* outlive the data
     // object.
     virtual std::unique_ptr<GeometryTileLayer> getLayer(const std::string&) const = 0;
+
+    // Returns a hash of the encoded data, if the data has an encoded form. Tiles with equal
+    // hashes are assumed to have identical data.
+    virtual optional<uint64_t> getDataHash() const { return {}; }
 };
 
 // classifies an array of rings into polygons with outer rings and holes
@@ -5,6 +5,7 @@
 #include <mbgl/layout/layout.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
 #include <mbgl/layout/pattern_layout.hpp>
+#include <mbgl/renderer/bucket_cache.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/renderer/group_by_layout.hpp>
 #include <mbgl/style/filter.hpp>
@@ -14,6 +15,7 @@
 #include <mbgl/renderer/layers/render_line_layer.hpp>
 #include <mbgl/renderer/layers/render_symbol_layer.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
@@ -34,7 +36,8 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        const std::atomic<bool>& obsolete_,
                                        const MapMode mode_,
                                        const float pixelRatio_,
-                                       const bool showCollisionBoxes_)
+                                       const bool showCollisionBoxes_,
+                                       std::shared_ptr<GlyphAtlas> glyphAtlas_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
       id(std::move(id_)),
@@ -42,6 +45,7 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
       obsolete(obsolete_),
       mode(mode_),
       pixelRatio(pixelRatio_),
+      glyphAtlas(std::move(glyphAtlas_)),
       showCollisionBoxes(showCollisionBoxes_) {
 }
 
@@ -365,7 +369,13 @@ void GeometryTileWorker::parse() {
         // and either immediately create a bucket if no images/glyphs are used, or the Layout is stored until
         // the images/glyphs are available to add the features to the buckets.
         if (leaderImpl.getTypeInfo()->layout == LayerTypeInfo::Layout::Required) {
-            std::unique_ptr<Layout> layout = LayerManager::get()->createLayout({parameters, glyphDependencies, imageDependencies}, std::move(geometryLayer), group);
+            optional<BucketCache::Key> bucketCacheKey;
+            optional<uint64_t> dataHash;
+            if (BucketCache::get().getMaximumSize() != 0 && (dataHash = (*data)->getDataHash())) {
+                bucketCacheKey = BucketCache::Key { *dataHash, pair.first, id, pixelRatio };
+            }
+
+            std::unique_ptr<Layout> layout = LayerManager::get()->createLayout({parameters, glyphDependencies, imageDependencies, std::move(bucketCacheKey)}, std::move(geometryLayer), group);
             if (layout->hasDependencies()) {
                 layouts.push_back(std::move(layout));
             } else {
@@ -376,16 +386,20 @@ void GeometryTileWorker::parse() {
             const std::string& sourceLayerID = leaderImpl.sourceLayer;
             std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(parameters, group);
 
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+            // Reused for all features of the layer so that decoding doesn't allocate for every feature.
+            GeometryCollection geometries;
 
-                if (!filter(expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), feature.get() }))
-                    continue;
+            // Features that don't match the filter are skipped before they're decoded.
+            geometryLayer->forEachFeature(filter, static_cast<float>(this->id.overscaledZ), [&](std::size_t i, const GeometryTileFeature& feature) {
+                if (obsolete) {
+                    return false;
+                }
 
-                GeometryCollection geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries, {}, PatternLayerMap ());
+                feature.decodeGeometries(geometries);
+                bucket->addFeature(feature, geometries, {}, PatternLayerMap ());
                 featureIndex->insert(geometries, i, sourceLayerID, leaderImpl.id);
-            }
+                return true;
+            });
 
             if (!bucket->hasData()) {
                 continue;
@@ -427,18 +441,18 @@ void GeometryTileWorker::finalizeLayout() {
     }
     
     MBGL_TIMING_START(watch)
-    optional<AlphaImage> glyphAtlasImage;
+    std::unique_ptr<GlyphAtlas::Glyphs> glyphs;
     ImageAtlas iconAtlas = makeImageAtlas(imageMap, patternMap, versionMap);
     if (!layouts.empty()) {
-        GlyphAtlas glyphAtlas = makeGlyphAtlas(glyphMap);
-        glyphAtlasImage = std::move(glyphAtlas.image);
+        GlyphPositions glyphPositions;
+        glyphs = glyphAtlas->addGlyphs(glyphMap, glyphPositions);
 
         for (auto& layout : layouts) {
             if (obsolete) {
                 return;
             }
 
-            layout->prepareSymbols(glyphMap, glyphAtlas.positions,
+            layout->prepareSymbols(glyphMap, glyphPositions,
                                   imageMap, iconAtlas.iconPositions);
 
             if (!layout->hasSymbolInstances()) {
@@ -463,7 +477,7 @@ void GeometryTileWorker::finalizeLayout() {
     parent.invoke(&GeometryTile::onLayout, GeometryTile::LayoutResult {
         std::move(renderData),
         std::move(featureIndex),
-        std::move(glyphAtlasImage),
+        std::move(glyphs),
         std::move(iconAtlas)
     }, correlationID);
 }
@@ -20,6 +20,7 @@ namespace mbgl {
 
 class GeometryTile;
 class GeometryTileData;
+class GlyphAtlas;
 class Layout;
 
 namespace style {
@@ -35,7 +36,8 @@ public:
                        const std::atomic<bool>&,
                        const MapMode,
                        const float pixelRatio,
-                       const bool showCollisionBoxes_);
+                       const bool showCollisionBoxes_,
+                       std::shared_ptr<GlyphAtlas>);
     ~GeometryTileWorker();
 
     void setLayers(std::vector<Immutable<style::LayerProperties>>, uint64_t correlationID);
@@ -69,6 +71,7 @@ private:
     const std::atomic<bool>& obsolete;
     const MapMode mode;
     const float pixelRatio;
+    const std::shared_ptr<GlyphAtlas> glyphAtlas;
     
     std::unique_ptr<FeatureIndex> featureIndex;
     std::unordered_map<std::string, LayerRenderData> renderData;
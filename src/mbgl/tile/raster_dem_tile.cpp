@@ -80,6 +80,10 @@ Bucket* RasterDEMTile::getBucket(const style::Layer::Impl&) const {
     return bucket.get();
 }
 
+std::size_t RasterDEMTile::getMemoryUse() const {
+    return bucket ? bucket->getMemoryUse() : 0;
+}
+
 HillshadeBucket* RasterDEMTile::getBucket() const {
     return bucket.get();
 }
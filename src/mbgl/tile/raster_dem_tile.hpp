@@ -74,6 +74,7 @@ public:
 
     void upload(gfx::UploadPass&) override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
+    std::size_t getMemoryUse() const override;
 
     HillshadeBucket* getBucket() const;
     void backfillBorder(const RasterDEMTile& borderTile, const DEMTileNeighbors mask);
@@ -68,6 +68,10 @@ Bucket* RasterTile::getBucket(const style::Layer::Impl&) const {
     return bucket.get();
 }
 
+std::size_t RasterTile::getMemoryUse() const {
+    return bucket ? bucket->getMemoryUse() : 0;
+}
+
 void RasterTile::setMask(TileMask&& mask) {
     if (bucket) {
         bucket->setMask(std::move(mask));
@@ -30,6 +30,7 @@ public:
 
     void upload(gfx::UploadPass&) override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
+    std::size_t getMemoryUse() const override;
 
     void setMask(TileMask&&) override;
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/actor/mailbox.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/optional.hpp>
@@ -49,6 +50,9 @@ public:
 
     virtual void setNecessity(TileNecessity) {}
 
+    // Sets the priority of the work done for this tile in the background, relative to other tiles.
+    virtual void setPriority(Mailbox::Priority) {}
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel();
 
@@ -80,6 +84,12 @@ public:
 
     virtual float getQueryPadding(const std::vector<const RenderLayer*>&);
 
+    // The approximate number of bytes used by the tile's buckets, feature index and atlases,
+    // including their uploaded buffers and textures.
+    virtual std::size_t getMemoryUse() const {
+        return 0;
+    }
+
     void setTriedCache();
 
     // Returns true when the tile source has received a first response, regardless of whether a load
@@ -3,16 +3,18 @@
 
 namespace mbgl {
 
+constexpr std::size_t TileCache::DefaultByteBudget;
+
 void TileCache::setSize(size_t size_) {
     size = size_;
+    evict();
+    assert(tiles.size() <= size);
+}
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
-    }
-
-    assert(orderedKeys.size() <= size);
+void TileCache::setByteBudget(size_t byteBudget_) {
+    byteBudget = byteBudget_;
+    evict();
+    assert(bytes <= byteBudget);
 }
 
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
@@ -20,27 +22,38 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
         return;
     }
 
+    const size_t tileBytes = tile->getMemoryUse();
+    if (tileBytes > byteBudget) {
+        return;
+    }
+
     // insert new or query existing tile
-    if (tiles.emplace(key, std::move(tile)).second) {
+    auto result = tiles.emplace(key, Entry());
+    Entry& entry = result.first->second;
+    if (result.second) {
+        entry.key = &result.first->first;
+        entry.tile = std::move(tile);
+        entry.bytes = tileBytes;
+        bytes += tileBytes;
+    } else {
         // remove existing tile key
-        orderedKeys.remove(key);
+        unlink(entry);
     }
 
     // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    link(entry);
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        pop(orderedKeys.front());
-    }
+    // purge oldest keys/tiles if necessary
+    evict();
 
-    assert(orderedKeys.size() <= size);
+    assert(tiles.size() <= size);
+    assert(bytes <= byteBudget);
 }
 
 Tile* TileCache::get(const OverscaledTileID& key) {
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        return it->second.get();
+        return it->second.tile.get();
     } else {
         return nullptr;
     }
@@ -52,10 +65,12 @@ std::unique_ptr<Tile> TileCache::pop(const OverscaledTileID& key) {
 
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        tile = std::move(it->second);
-        tiles.erase(it);
-        orderedKeys.remove(key);
+        tile = std::move(it->second.tile);
+        erase(it);
         assert(tile->isRenderable());
+        statistics.hits++;
+    } else {
+        statistics.misses++;
     }
 
     return tile;
@@ -66,8 +81,57 @@ bool TileCache::has(const OverscaledTileID& key) {
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
     tiles.clear();
+    newest = nullptr;
+    oldest = nullptr;
+    bytes = 0;
+}
+
+TileCacheStatistics TileCache::getStatistics() const {
+    TileCacheStatistics result = statistics;
+    result.tiles = tiles.size();
+    result.bytes = bytes;
+    return result;
+}
+
+void TileCache::link(Entry& entry) {
+    entry.newer = nullptr;
+    entry.older = newest;
+    if (newest) {
+        newest->newer = &entry;
+    } else {
+        oldest = &entry;
+    }
+    newest = &entry;
+}
+
+void TileCache::unlink(Entry& entry) {
+    if (entry.newer) {
+        entry.newer->older = entry.older;
+    } else {
+        newest = entry.older;
+    }
+    if (entry.older) {
+        entry.older->newer = entry.newer;
+    } else {
+        oldest = entry.newer;
+    }
+    entry.newer = nullptr;
+    entry.older = nullptr;
+}
+
+void TileCache::erase(std::unordered_map<OverscaledTileID, Entry>::iterator it) {
+    unlink(it->second);
+    bytes -= it->second.bytes;
+    tiles.erase(it);
+}
+
+void TileCache::evict() {
+    while (tiles.size() > size || bytes > byteBudget) {
+        assert(oldest);
+        erase(tiles.find(*oldest->key));
+        statistics.evictions++;
+    }
 }
 
 } // namespace mbgl
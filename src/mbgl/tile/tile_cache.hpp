@@ -2,31 +2,63 @@
 
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/renderer/tile_cache_statistics.hpp>
 
-
-#include <list>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
+// A least recently used cache of tiles that are no longer part of the tile pyramid. The cache
+// is bounded both by a number of tiles and by the approximate number of bytes the tiles use,
+// so that a few large vector tiles can't hold on to more memory than many small raster tiles.
+// Tiles are kept in an intrusive list threaded through the hash table entries, so that all
+// operations take constant time.
 class TileCache {
 public:
-    TileCache(size_t size_ = 0) : size(size_) {}
+    static constexpr std::size_t DefaultByteBudget = 64 * 1024 * 1024;
+
+    TileCache(size_t size_ = 0, size_t byteBudget_ = DefaultByteBudget)
+        : size(size_), byteBudget(byteBudget_) {}
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+    void setByteBudget(size_t);
+    size_t getByteBudget() const { return byteBudget; }
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> data);
     std::unique_ptr<Tile> pop(const OverscaledTileID& key);
     Tile* get(const OverscaledTileID& key);
     bool has(const OverscaledTileID& key);
     void clear();
 
+    // The approximate number of bytes used by all cached tiles, as measured when they were added.
+    size_t getBytes() const { return bytes; }
+
+    TileCacheStatistics getStatistics() const;
+
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    struct Entry {
+        const OverscaledTileID* key = nullptr;
+        std::unique_ptr<Tile> tile;
+        size_t bytes = 0;
+        Entry* newer = nullptr;
+        Entry* older = nullptr;
+    };
+
+    void link(Entry&);
+    void unlink(Entry&);
+    void erase(std::unordered_map<OverscaledTileID, Entry>::iterator);
+    void evict();
+
+    // Entries are never moved once they are inserted, so they can link to each other.
+    std::unordered_map<OverscaledTileID, Entry> tiles;
+    Entry* newest = nullptr;
+    Entry* oldest = nullptr;
 
     size_t size;
+    size_t byteBudget;
+    size_t bytes = 0;
+    TileCacheStatistics statistics;
 };
 
 } // namespace mbgl
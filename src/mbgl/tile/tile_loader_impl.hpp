@@ -2,6 +2,7 @@
 
 #include <mbgl/tile/tile_loader.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/payload.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/util/tileset.hpp>
 
@@ -26,6 +27,8 @@ TileLoader<T>::TileLoader(T& tile_,
         Resource::LoadingMethod::CacheOnly)),
       fileSource(parameters.fileSource) {
     assert(!request);
+    // Tiles inflate their data on their worker threads.
+    resource.acceptsCompressedData = true;
     if (fileSource->supportsCacheOnlyRequests()) {
         // When supported, the first request is always optional, even if the TileLoader
         // is marked as required. That way, we can let the first optional request continue
@@ -106,6 +109,9 @@ void TileLoader<T>::loadedData(const Response& res) {
         resource.priorExpires = res.expires;
         resource.priorEtag = res.etag;
         tile.setMetadata(res.modified, res.expires);
+        if (!res.noContent && res.data) {
+            PayloadStatistics::addTile();
+        }
         tile.setData(res.noContent ? nullptr : res.data);
     }
 }
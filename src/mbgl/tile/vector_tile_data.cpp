@@ -1,11 +1,110 @@
 #include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/tile/vector_tile_filter.hpp>
+#include <mbgl/storage/payload.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/hash.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 namespace mbgl {
 
+namespace {
+
+// Field and command identifiers from the vector tile specification.
+constexpr protozero::pbf_tag_type LayerKeysTag = 3;
+constexpr protozero::pbf_tag_type LayerValuesTag = 4;
+constexpr protozero::pbf_tag_type FeatureTagsTag = 2;
+constexpr protozero::pbf_tag_type FeatureGeometryTag = 4;
+constexpr uint32_t MoveToCommand = 1;
+constexpr uint32_t LineToCommand = 2;
+constexpr uint32_t ClosePathCommand = 7;
+
+} // namespace
+
+VectorTileLayerValues::VectorTileLayerValues(const protozero::data_view& layer) {
+    protozero::pbf_reader reader(layer);
+    while (reader.next()) {
+        switch (reader.tag()) {
+        case LayerKeysTag:
+            keys.push_back(reader.get_view());
+            break;
+        case LayerValuesTag:
+            encodedValues.push_back(reader.get_view());
+            break;
+        default:
+            reader.skip();
+            break;
+        }
+    }
+    values.resize(encodedValues.size());
+
+    keyIndices.reserve(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        // Keys are unique within a layer; should one repeat, the first one wins.
+        keyIndices.emplace(keys[i], static_cast<uint32_t>(i));
+    }
+}
+
+// FNV-1a, over the bytes of the key.
+std::size_t VectorTileLayerValues::KeyHash::operator()(const protozero::data_view& key) const {
+    std::size_t hash = 2166136261u;
+    for (std::size_t i = 0; i < key.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(key.data()[i])) * 16777619u;
+    }
+    return hash;
+}
+
+bool VectorTileLayerValues::KeyEqual::operator()(const protozero::data_view& a, const protozero::data_view& b) const {
+    return a.size() == b.size() && std::equal(a.data(), a.data() + a.size(), b.data());
+}
+
+Value VectorTileLayerValues::decode(const protozero::data_view& view) {
+    Value value;
+    protozero::pbf_reader reader(view);
+    while (reader.next()) {
+        switch (reader.tag()) {
+        case 1: value = reader.get_string(); break;
+        case 2: value = static_cast<double>(reader.get_float()); break;
+        case 3: value = reader.get_double(); break;
+        case 4: value = reader.get_int64(); break;
+        case 5: value = reader.get_uint64(); break;
+        case 6: value = reader.get_sint64(); break;
+        case 7: value = reader.get_bool(); break;
+        default: reader.skip(); break;
+        }
+    }
+    return value;
+}
+
+optional<uint32_t> VectorTileLayerValues::keyIndex(const std::string& key) const {
+    const auto it = keyIndices.find(protozero::data_view(key.data(), key.size()));
+    if (it == keyIndices.end()) {
+        return nullopt;
+    }
+    return it->second;
+}
+
+const Value* VectorTileLayerValues::value(uint32_t index) const {
+    if (index >= values.size()) {
+        return nullptr;
+    }
+    if (!values[index]) {
+        values[index] = decode(encodedValues[index]);
+    }
+    return &*values[index];
+}
+
 VectorTileFeature::VectorTileFeature(const mapbox::vector_tile::layer& layer,
-                                     const protozero::data_view& view)
-    : feature(view, layer) {
+                                     const VectorTileLayerValues& values_,
+                                     const protozero::data_view& view_)
+    : view(view_), feature(view_, layer), values(values_) {
+    protozero::pbf_reader reader(view);
+    while (reader.next(FeatureTagsTag)) {
+        tags = reader.get_packed_uint32();
+    }
 }
 
 FeatureType VectorTileFeature::getType() const {
@@ -22,12 +121,45 @@ FeatureType VectorTileFeature::getType() const {
 }
 
 optional<Value> VectorTileFeature::getValue(const std::string& key) const {
-    const optional<Value> value(feature.getValue(key));
-    return value->is<NullValue>() ? nullopt : std::move(value);
+    optional<Value> storage;
+    const Value* value = findValue(key, storage);
+    return value ? optional<Value>(*value) : nullopt;
+}
+
+// Tags are pairs of key and value indices. Looks the value up in the layer's interned values, so
+// that it is neither decoded nor copied. Null values are treated as missing.
+const Value* VectorTileFeature::findValue(const std::string& key, optional<Value>&) const {
+    const optional<uint32_t> keyIndex = values.keyIndex(key);
+    if (!keyIndex) {
+        return nullptr;
+    }
+    for (auto it = tags.begin(); it != tags.end(); ++it) {
+        const uint32_t tagKey = *it;
+        if (++it == tags.end()) {
+            break;
+        }
+        if (tagKey == *keyIndex) {
+            const Value* value = values.value(*it);
+            return value && !value->is<NullValue>() ? value : nullptr;
+        }
+    }
+    return nullptr;
 }
 
 std::unordered_map<std::string, Value> VectorTileFeature::getProperties() const {
-    return feature.getProperties();
+    std::unordered_map<std::string, Value> properties;
+    for (auto it = tags.begin(); it != tags.end(); ++it) {
+        const uint32_t tagKey = *it;
+        if (++it == tags.end()) {
+            break;
+        }
+        const Value* value = values.value(*it);
+        if (tagKey < values.keyCount() && value) {
+            const protozero::data_view& name = values.key(tagKey);
+            properties.emplace(std::string(name.data(), name.size()), *value);
+        }
+    }
+    return properties;
 }
 
 FeatureIdentifier VectorTileFeature::getID() const {
@@ -35,18 +167,82 @@ FeatureIdentifier VectorTileFeature::getID() const {
 }
 
 GeometryCollection VectorTileFeature::getGeometries() const {
+    GeometryCollection lines;
+    decodeGeometries(lines);
+    return lines;
+}
+
+// Decodes the geometry command stream straight from the feature's protobuf data. This matches
+// mapbox::vector_tile::feature::getGeometries(), but reuses the rings that are already allocated
+// in the given collection instead of building a new collection for every feature.
+void VectorTileFeature::decodeGeometries(GeometryCollection& lines) const {
     const float scale = float(util::EXTENT) / feature.getExtent();
-    auto lines = feature.getGeometries<GeometryCollection>(scale);
-    if (feature.getVersion() >= 2 || feature.getType() != mapbox::vector_tile::GeomType::POLYGON) {
-        return lines;
-    } else {
-        return fixupPolygons(lines);
+    const float maxCoordinate = std::numeric_limits<int16_t>::max();
+    const float minCoordinate = std::numeric_limits<int16_t>::min();
+
+    // Like the vector tile library, always start out with one, possibly empty, line.
+    std::size_t count = 1;
+    if (lines.empty()) {
+        lines.emplace_back();
+    }
+    lines[0].clear();
+
+    protozero::pbf_reader reader(view);
+    while (reader.next(FeatureGeometryTag)) {
+        const auto commands = reader.get_packed_uint32();
+        auto it = commands.begin();
+        const auto end = commands.end();
+
+        int32_t x = 0;
+        int32_t y = 0;
+        while (it != end) {
+            const uint32_t commandInteger = *it++;
+            const uint32_t command = commandInteger & 0x7;
+            uint32_t length = commandInteger >> 3;
+
+            if (command == MoveToCommand || command == LineToCommand) {
+                for (; length > 0 && it != end; --length) {
+                    if (command == MoveToCommand && !lines[count - 1].empty()) {
+                        if (count == lines.size()) {
+                            lines.emplace_back();
+                        }
+                        lines[count++].clear();
+                    }
+
+                    x += protozero::decode_zigzag32(*it++);
+                    if (it == end) {
+                        break;
+                    }
+                    y += protozero::decode_zigzag32(*it++);
+
+                    const float px = std::round(x * scale);
+                    const float py = std::round(y * scale);
+                    if (px <= maxCoordinate && px >= minCoordinate && py <= maxCoordinate && py >= minCoordinate) {
+                        lines[count - 1].emplace_back(static_cast<int16_t>(px), static_cast<int16_t>(py));
+                    }
+                }
+            } else if (command == ClosePathCommand) {
+                GeometryCoordinates& line = lines[count - 1];
+                if (!line.empty()) {
+                    line.push_back(line[0]);
+                }
+            } else {
+                throw std::runtime_error("unknown command");
+            }
+        }
+    }
+
+    lines.erase(lines.begin() + count, lines.end());
+
+    if (feature.getVersion() < 2 && feature.getType() == mapbox::vector_tile::GeomType::POLYGON) {
+        lines = fixupPolygons(lines);
     }
 }
 
 VectorTileLayer::VectorTileLayer(std::shared_ptr<const std::string> data_,
-                                 const protozero::data_view& view)
-    : data(std::move(data_)), layer(view) {
+                                 const protozero::data_view& view_,
+                                 std::shared_ptr<const VectorTileLayerValues> values_)
+    : data(std::move(data_)), view(view_), layer(view), values(std::move(values_)) {
 }
 
 std::size_t VectorTileLayer::featureCount() const {
@@ -54,7 +250,56 @@ std::size_t VectorTileLayer::featureCount() const {
 }
 
 std::unique_ptr<GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
-    return std::make_unique<VectorTileFeature>(layer, layer.getFeature(i));
+    return std::make_unique<VectorTileFeature>(layer, *values, layer.getFeature(i));
+}
+
+void VectorTileLayer::forEachFeature(const FeatureVisitor& visitor) const {
+    const std::size_t count = layer.featureCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        const VectorTileFeature feature(layer, *values, layer.getFeature(i));
+        if (!visitor(i, feature)) {
+            return;
+        }
+    }
+}
+
+void VectorTileLayer::forEachFeature(const style::Filter& filter, float zoom, const FeatureVisitor& visitor) const {
+    const optional<VectorTileFilter> compiled = VectorTileFilter::compile(filter, view);
+    if (!compiled) {
+        GeometryTileLayer::forEachFeature(filter, zoom, visitor);
+        return;
+    }
+
+    const std::size_t count = layer.featureCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        const protozero::data_view featureView = layer.getFeature(i);
+        if (!(*compiled)(featureView)) {
+            continue;
+        }
+        const VectorTileFeature feature(layer, *values, featureView);
+        if (!visitor(i, feature)) {
+            return;
+        }
+    }
+}
+
+void VectorTileLayer::forEachOwnedFeature(const style::Filter& filter, float zoom, const OwnedFeatureVisitor& visitor) const {
+    const optional<VectorTileFilter> compiled = VectorTileFilter::compile(filter, view);
+    if (!compiled) {
+        GeometryTileLayer::forEachOwnedFeature(filter, zoom, visitor);
+        return;
+    }
+
+    const std::size_t count = layer.featureCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        const protozero::data_view featureView = layer.getFeature(i);
+        if (!(*compiled)(featureView)) {
+            continue;
+        }
+        if (!visitor(i, std::make_unique<VectorTileFeature>(layer, *values, featureView))) {
+            return;
+        }
+    }
 }
 
 std::string VectorTileLayer::getName() const {
@@ -65,26 +310,50 @@ VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_) : data(
 }
 
 std::unique_ptr<GeometryTileData> VectorTileData::clone() const {
-    return std::make_unique<VectorTileData>(data);
+    // Clones are made on the worker thread, e.g. for the feature index of the tile. Inflating
+    // here lets the clone share the inflated data instead of inflating it again when queried.
+    return std::make_unique<VectorTileData>(getData());
 }
 
 std::unique_ptr<GeometryTileLayer> VectorTileData::getLayer(const std::string& name) const {
     if (!parsed) {
         // We're parsing this lazily so that we can construct VectorTileData objects on the main
         // thread without incurring the overhead of parsing immediately.
-        layers = mapbox::vector_tile::buffer(*data).getLayers();
+        layers = mapbox::vector_tile::buffer(*getData()).getLayers();
         parsed = true;
     }
 
     auto it = layers.find(name);
     if (it != layers.end()) {
-        return std::make_unique<VectorTileLayer>(data, it->second);
+        // All layer objects of a source layer share its values, which live as long as this
+        // object or the last of its layer objects.
+        std::shared_ptr<const VectorTileLayerValues>& values = layerValues[name];
+        if (!values) {
+            values = std::make_shared<VectorTileLayerValues>(it->second);
+        }
+        return std::make_unique<VectorTileLayer>(getData(), it->second, values);
     }
     return nullptr;
 }
 
+optional<uint64_t> VectorTileData::getDataHash() const {
+    if (!dataHash) {
+        dataHash = util::hash(*getData(), getData()->size());
+    }
+    return dataHash;
+}
+
 std::vector<std::string> VectorTileData::layerNames() const {
-    return mapbox::vector_tile::buffer(*data).layerNames();
+    return mapbox::vector_tile::buffer(*getData()).layerNames();
+}
+
+const std::shared_ptr<const std::string>& VectorTileData::getData() const {
+    if (!inflated) {
+        // Like parsing, inflating compressed data is deferred to the worker thread.
+        data = inflatePayload(std::move(data));
+        inflated = true;
+    }
+    return data;
 }
 
 } // namespace mbgl
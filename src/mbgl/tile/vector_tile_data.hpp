@@ -5,35 +5,87 @@
 
 #include <unordered_map>
 #include <functional>
+#include <memory>
 #include <utility>
+#include <vector>
 
 namespace mbgl {
 
+// The property keys and values of a vector tile layer. Vector tiles store each distinct value of
+// a layer once, and features refer to keys and values by their indices. Values are decoded on
+// first use and kept for as long as the tile data, so all features, and all style layers that
+// read the same source layer, share one copy of each value instead of decoding it again for
+// every lookup. Keys refer to the tile data and aren't copied at all.
+//
+// Like VectorTileData, which owns it, it must only be used by one thread at a time.
+class VectorTileLayerValues {
+public:
+    explicit VectorTileLayerValues(const protozero::data_view& layer);
+
+    static Value decode(const protozero::data_view& value);
+
+    std::size_t keyCount() const { return keys.size(); }
+    const protozero::data_view& key(uint32_t index) const { return keys[index]; }
+    optional<uint32_t> keyIndex(const std::string&) const;
+
+    // Returns null if the layer has no value with the given index.
+    const Value* value(uint32_t index) const;
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const protozero::data_view&) const;
+    };
+
+    struct KeyEqual {
+        bool operator()(const protozero::data_view&, const protozero::data_view&) const;
+    };
+
+    std::vector<protozero::data_view> keys;
+    // Indices of the keys, for looking up properties by name without scanning all keys.
+    std::unordered_map<protozero::data_view, uint32_t, KeyHash, KeyEqual> keyIndices;
+    std::vector<protozero::data_view> encodedValues;
+    mutable std::vector<optional<Value>> values;
+};
+
 class VectorTileFeature : public GeometryTileFeature {
 public:
-    VectorTileFeature(const mapbox::vector_tile::layer&, const protozero::data_view&);
+    VectorTileFeature(const mapbox::vector_tile::layer&, const VectorTileLayerValues&, const protozero::data_view&);
 
     FeatureType getType() const override;
     optional<Value> getValue(const std::string& key) const override;
+    const Value* findValue(const std::string& key, optional<Value>& storage) const override;
     std::unordered_map<std::string, Value> getProperties() const override;
     FeatureIdentifier getID() const override;
     GeometryCollection getGeometries() const override;
+    void decodeGeometries(GeometryCollection&) const override;
 
 private:
+    using Tags = protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator>;
+
+    protozero::data_view view;
     mapbox::vector_tile::feature feature;
+    const VectorTileLayerValues& values;
+    Tags tags;
 };
 
 class VectorTileLayer : public GeometryTileLayer {
 public:
-    VectorTileLayer(std::shared_ptr<const std::string> data, const protozero::data_view&);
+    VectorTileLayer(std::shared_ptr<const std::string> data,
+                    const protozero::data_view&,
+                    std::shared_ptr<const VectorTileLayerValues>);
 
     std::size_t featureCount() const override;
     std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override;
+    void forEachFeature(const FeatureVisitor&) const override;
+    void forEachFeature(const style::Filter&, float zoom, const FeatureVisitor&) const override;
+    void forEachOwnedFeature(const style::Filter&, float zoom, const OwnedFeatureVisitor&) const override;
     std::string getName() const override;
 
 private:
     std::shared_ptr<const std::string> data;
+    protozero::data_view view;
     mapbox::vector_tile::layer layer;
+    std::shared_ptr<const VectorTileLayerValues> values;
 };
 
 class VectorTileData : public GeometryTileData {
@@ -42,13 +94,19 @@ public:
 
     std::unique_ptr<GeometryTileData> clone() const override;
     std::unique_ptr<GeometryTileLayer> getLayer(const std::string& name) const override;
+    optional<uint64_t> getDataHash() const override;
 
     std::vector<std::string> layerNames() const;
 
 private:
-    std::shared_ptr<const std::string> data;
+    const std::shared_ptr<const std::string>& getData() const;
+
+    mutable std::shared_ptr<const std::string> data;
+    mutable bool inflated = false;
     mutable bool parsed = false;
     mutable std::map<std::string, const protozero::data_view> layers;
+    mutable std::map<std::string, std::shared_ptr<const VectorTileLayerValues>> layerValues;
+    mutable optional<uint64_t> dataHash;
 };
 
 } // namespace mbgl
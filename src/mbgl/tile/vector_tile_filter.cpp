@@ -0,0 +1,367 @@
+#include <mbgl/tile/vector_tile_filter.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/style/expression/value.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+using style::expression::Expression;
+using style::expression::Kind;
+using style::expression::Literal;
+using ExpressionValue = style::expression::Value;
+
+namespace {
+
+// Field identifiers from the vector tile specification.
+constexpr protozero::pbf_tag_type LayerKeysTag = 3;
+constexpr protozero::pbf_tag_type LayerValuesTag = 4;
+constexpr protozero::pbf_tag_type FeatureTagsTag = 2;
+constexpr protozero::pbf_tag_type FeatureTypeTag = 3;
+
+std::vector<const Expression*> children(const Expression& expression) {
+    std::vector<const Expression*> result;
+    expression.eachChild([&](const Expression& child) { result.push_back(&child); });
+    return result;
+}
+
+optional<ExpressionValue> literalValue(const Expression* expression) {
+    if (expression->getKind() != Kind::Literal) {
+        return nullopt;
+    }
+    return static_cast<const Literal*>(expression)->getValue();
+}
+
+optional<std::string> literalString(const Expression* expression) {
+    auto value = literalValue(expression);
+    if (!value || !value->is<std::string>()) {
+        return nullopt;
+    }
+    return value->get<std::string>();
+}
+
+// Returns the key of a ["get", key] expression that reads from the feature.
+optional<std::string> getKey(const Expression* expression) {
+    if (expression->getKind() != Kind::CompoundExpression || expression->getOperator() != "get") {
+        return nullopt;
+    }
+    auto args = children(*expression);
+    return args.size() == 1 ? literalString(args[0]) : nullopt;
+}
+
+template <class T>
+bool compare(const std::string& op, const T& lhs, const T& rhs) {
+    if (op == "filter-<") {
+        return lhs < rhs;
+    } else if (op == "filter->") {
+        return lhs > rhs;
+    } else if (op == "filter-<=") {
+        return lhs <= rhs;
+    } else {
+        return lhs >= rhs;
+    }
+}
+
+uint8_t typeMask(const std::string& type) {
+    if (type == "Unknown") {
+        return 1 << static_cast<uint8_t>(FeatureType::Unknown);
+    } else if (type == "Point") {
+        return 1 << static_cast<uint8_t>(FeatureType::Point);
+    } else if (type == "LineString") {
+        return 1 << static_cast<uint8_t>(FeatureType::LineString);
+    } else if (type == "Polygon") {
+        return 1 << static_cast<uint8_t>(FeatureType::Polygon);
+    }
+    return 0;
+}
+
+} // namespace
+
+class VectorTileFilter::Compiler {
+public:
+    explicit Compiler(const protozero::data_view& layer_) : layer(layer_) {}
+
+    optional<Node> compile(const Expression& expression) {
+        switch (expression.getKind()) {
+        case Kind::Literal: {
+            auto value = literalValue(&expression);
+            if (!value->is<bool>()) {
+                return nullopt;
+            }
+            return Node { value->get<bool>() ? Node::Op::True : Node::Op::False };
+        }
+        case Kind::All:
+            return compileChildren(Node::Op::All, expression);
+        case Kind::Any:
+            return compileChildren(Node::Op::Any, expression);
+        case Kind::Comparison:
+            return compileComparison(expression);
+        case Kind::CompoundExpression:
+            return compileCompound(expression);
+        default:
+            return nullopt;
+        }
+    }
+
+private:
+    optional<Node> compileChildren(Node::Op op, const Expression& expression) {
+        Node node { op };
+        for (const Expression* child : children(expression)) {
+            auto compiled = compile(*child);
+            if (!compiled) {
+                return nullopt;
+            }
+            node.children.push_back(std::move(*compiled));
+        }
+        return node;
+    }
+
+    optional<Node> compileComparison(const Expression& expression) {
+        const std::string op = expression.getOperator();
+        if (op != "==" && op != "!=") {
+            return nullopt;
+        }
+
+        auto args = children(expression);
+        if (args.size() != 2) {
+            return nullopt;
+        }
+
+        optional<std::string> key = getKey(args[0]);
+        optional<ExpressionValue> value = literalValue(args[1]);
+        if (!key || !value) {
+            key = getKey(args[1]);
+            value = literalValue(args[0]);
+        }
+
+        // A missing property evaluates to null, which equals a null literal.
+        if (!key || !value || !(value->is<std::string>() || value->is<double>() || value->is<bool>())) {
+            return nullopt;
+        }
+
+        Node node = propertyIn(*key, { *value });
+        if (op == "!=") {
+            return negate(std::move(node));
+        }
+        return node;
+    }
+
+    optional<Node> compileCompound(const Expression& expression) {
+        const std::string op = expression.getOperator();
+        auto args = children(expression);
+
+        if (op == "!") {
+            auto compiled = compile(*args.at(0));
+            if (!compiled) {
+                return nullopt;
+            }
+            return negate(std::move(*compiled));
+        } else if (op == "filter-==" || op == "filter-in") {
+            if (args.empty()) {
+                return nullopt;
+            }
+            optional<std::string> key = literalString(args[0]);
+            std::vector<ExpressionValue> values;
+            for (auto it = args.begin() + 1; it != args.end(); ++it) {
+                auto value = literalValue(*it);
+                if (!value) {
+                    return nullopt;
+                }
+                values.push_back(std::move(*value));
+            }
+            if (!key) {
+                return nullopt;
+            }
+            return propertyIn(*key, values);
+        } else if (op == "filter-has" || op == "has") {
+            optional<std::string> key = args.size() == 1 ? literalString(args[0]) : nullopt;
+            if (!key) {
+                return nullopt;
+            }
+            return propertyMatching(*key, [](const ExpressionValue&) { return true; });
+        } else if (op == "filter-<" || op == "filter->" || op == "filter-<=" || op == "filter->=") {
+            optional<std::string> key = args.size() == 2 ? literalString(args[0]) : nullopt;
+            optional<ExpressionValue> value = args.size() == 2 ? literalValue(args[1]) : nullopt;
+            if (!key || !value) {
+                return nullopt;
+            }
+            // The feature's value is on the left hand side, and must have the literal's type.
+            return propertyMatching(*key, [&](const ExpressionValue& lhs) {
+                if (lhs.is<double>() && value->is<double>()) {
+                    return compare(op, lhs.get<double>(), value->get<double>());
+                } else if (lhs.is<std::string>() && value->is<std::string>()) {
+                    return compare(op, lhs.get<std::string>(), value->get<std::string>());
+                }
+                return false;
+            });
+        } else if (op == "filter-type-==" || op == "filter-type-in") {
+            Node node { Node::Op::TypeIn };
+            for (const Expression* arg : args) {
+                optional<std::string> type = literalString(arg);
+                if (!type) {
+                    return nullopt;
+                }
+                node.types |= typeMask(*type);
+            }
+            return node;
+        }
+
+        return nullopt;
+    }
+
+    static Node negate(Node node) {
+        if (node.op == Node::Op::True || node.op == Node::Op::False) {
+            node.op = node.op == Node::Op::True ? Node::Op::False : Node::Op::True;
+            return node;
+        }
+        Node result { Node::Op::Not };
+        result.children.push_back(std::move(node));
+        return result;
+    }
+
+    // A feature matches if it has the key, and its value equals any of the given values.
+    Node propertyIn(const std::string& key, const std::vector<ExpressionValue>& values) {
+        return propertyMatching(key, [&](const ExpressionValue& value) {
+            return std::find(values.begin(), values.end(), value) != values.end();
+        });
+    }
+
+    // A feature matches if it has the key with a non-null value that satisfies the predicate.
+    template <class Predicate>
+    Node propertyMatching(const std::string& key, Predicate predicate) {
+        optional<uint32_t> index = keyIndex(key);
+        if (!index) {
+            return Node { Node::Op::False };
+        }
+
+        const std::vector<ExpressionValue>& table = valueTable();
+        Node node { Node::Op::In };
+        node.key = *index;
+        node.values.resize(table.size());
+        bool any = false;
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            // Null values are treated as missing properties, like VectorTileFeature::getValue() does.
+            if (!table[i].is<NullValue>() && predicate(table[i])) {
+                node.values[i] = any = true;
+            }
+        }
+        return any ? node : Node { Node::Op::False };
+    }
+
+    optional<uint32_t> keyIndex(const std::string& key) {
+        if (!keys) {
+            keys.emplace();
+            protozero::pbf_reader reader(layer);
+            while (reader.next(LayerKeysTag)) {
+                keys->push_back(reader.get_view());
+            }
+        }
+        for (std::size_t i = 0; i < keys->size(); ++i) {
+            const protozero::data_view& view = (*keys)[i];
+            if (view.size() == key.size() && std::equal(key.begin(), key.end(), view.data())) {
+                return static_cast<uint32_t>(i);
+            }
+        }
+        return nullopt;
+    }
+
+    // The layer's values, decoded once per compilation and converted the same way as
+    // feature properties are when they are evaluated by expressions.
+    const std::vector<ExpressionValue>& valueTable() {
+        if (!values) {
+            values.emplace();
+            protozero::pbf_reader reader(layer);
+            while (reader.next(LayerValuesTag)) {
+                values->push_back(style::expression::toExpressionValue(VectorTileLayerValues::decode(reader.get_view())));
+            }
+        }
+        return *values;
+    }
+
+    const protozero::data_view layer;
+    optional<std::vector<protozero::data_view>> keys;
+    optional<std::vector<ExpressionValue>> values;
+};
+
+optional<VectorTileFilter> VectorTileFilter::compile(const style::Filter& filter, const protozero::data_view& layer) {
+    if (!filter.expression) {
+        return VectorTileFilter(Node { Node::Op::True });
+    }
+
+    Compiler compiler(layer);
+    if (auto root = compiler.compile(**filter.expression)) {
+        return VectorTileFilter(std::move(*root));
+    }
+    return nullopt;
+}
+
+bool VectorTileFilter::operator()(const protozero::data_view& feature) const {
+    Tags tags;
+    FeatureType type = FeatureType::Unknown;
+
+    protozero::pbf_reader reader(feature);
+    while (reader.next()) {
+        switch (reader.tag()) {
+        case FeatureTagsTag:
+            tags = reader.get_packed_uint32();
+            break;
+        case FeatureTypeTag: {
+            const auto value = reader.get_enum();
+            type = value >= 1 && value <= 3 ? static_cast<FeatureType>(value) : FeatureType::Unknown;
+            break;
+        }
+        default:
+            reader.skip();
+            break;
+        }
+    }
+
+    return evaluate(root, type, tags);
+}
+
+bool VectorTileFilter::evaluate(const Node& node, FeatureType type, const Tags& tags) {
+    switch (node.op) {
+    case Node::Op::True:
+        return true;
+    case Node::Op::False:
+        return false;
+    case Node::Op::All:
+        for (const auto& child : node.children) {
+            if (!evaluate(child, type, tags)) {
+                return false;
+            }
+        }
+        return true;
+    case Node::Op::Any:
+        for (const auto& child : node.children) {
+            if (evaluate(child, type, tags)) {
+                return true;
+            }
+        }
+        return false;
+    case Node::Op::Not:
+        return !evaluate(node.children.front(), type, tags);
+    case Node::Op::TypeIn:
+        return node.types & (1 << static_cast<uint8_t>(type));
+    case Node::Op::In:
+        for (auto it = tags.begin(); it != tags.end();) {
+            const uint32_t key = *it++;
+            if (it == tags.end()) {
+                break;
+            }
+            const uint32_t value = *it++;
+            if (key == node.key) {
+                // Like VectorTileFeature::getValue(), only the first occurrence of a key counts.
+                return value < node.values.size() && node.values[value];
+            }
+        }
+        return false;
+    }
+    return false;
+}
+
+} // namespace mbgl
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <protozero/pbf_reader.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+namespace style {
+class Filter;
+} // namespace style
+
+// A filter that has been compiled against the key and value tables of one vector tile layer.
+// Property keys are resolved to key indices and constant values to the set of matching value
+// indices, so that evaluating e.g. `["==", "class", "motorway"]` for a feature only compares
+// integers from the feature's tags, without decoding any of its properties.
+//
+// Only a subset of filters can be compiled: boolean literals, `all`, `any`, `!`, `has`, the
+// legacy comparison, `in` and `$type` filters, and `==`/`!=` comparisons between
+// `["get", key]` and a string, number or boolean literal.
+class VectorTileFilter {
+public:
+    // Returns nullopt if the filter uses expressions that can't be compiled; evaluate those
+    // through the filter's expression instead.
+    static optional<VectorTileFilter> compile(const style::Filter&, const protozero::data_view& layer);
+
+    // Evaluates the filter for the given encoded feature of the layer.
+    bool operator()(const protozero::data_view& feature) const;
+
+private:
+    using Tags = protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator>;
+
+    struct Node {
+        enum class Op : uint8_t { True, False, All, Any, Not, In, TypeIn };
+
+        Op op;
+        uint32_t key = 0;
+        std::vector<bool> values;
+        uint8_t types = 0;
+        std::vector<Node> children;
+    };
+
+    class Compiler;
+
+    explicit VectorTileFilter(Node root_) : root(std::move(root_)) {}
+
+    static bool evaluate(const Node&, FeatureType, const Tags&);
+
+    Node root;
+};
+
+} // namespace mbgl
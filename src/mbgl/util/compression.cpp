@@ -6,6 +6,7 @@
 #include <zlib.h>
 #endif
 
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
@@ -71,7 +72,8 @@ std::string decompress(const std::string &raw) {
     memset(&inflate_stream, 0, sizeof(inflate_stream));
 
     // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
+    // Accept both zlib and gzip headers.
+    if (inflateInit2(&inflate_stream, MAX_WBITS + 32) != Z_OK) {
         throw std::runtime_error("failed to initialize inflate");
     }
 
@@ -100,5 +102,21 @@ std::string decompress(const std::string &raw) {
 
     return result;
 }
+
+bool isCompressed(const std::string& data) {
+    if (data.size() < 2) {
+        return false;
+    }
+    const auto first = static_cast<uint8_t>(data[0]);
+    const auto second = static_cast<uint8_t>(data[1]);
+    // gzip magic number
+    if (first == 0x1F && second == 0x8B) {
+        return true;
+    }
+    // zlib header: the deflate method with a window of at most 32 KiB, and a check value that
+    // makes the header a multiple of 31.
+    return (first & 0x0F) == Z_DEFLATED && (first >> 4) <= 7 && ((first << 8) | second) % 31 == 0;
+}
+
 } // namespace util
 } // namespace mbgl
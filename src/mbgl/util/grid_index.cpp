@@ -2,12 +2,70 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/math/minmax.hpp>
 
-#include <unordered_set>
 #include <cmath>
 
 namespace mbgl {
 
 
+template <class T>
+constexpr uint32_t GridIndex<T>::Cells::none;
+
+template <class T>
+GridIndex<T>::Cells::Cells(std::size_t count)
+    : offsets(count + 1, 0),
+      heads(count, none),
+      tails(count, none) {
+}
+
+template <class T>
+void GridIndex<T>::Cells::insert(uint32_t cell, uint32_t element) {
+    const auto node = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({ element, none });
+    if (tails[cell] == none) {
+        heads[cell] = node;
+    } else {
+        nodes[tails[cell]].next = node;
+    }
+    tails[cell] = node;
+}
+
+template <class T>
+void GridIndex<T>::Cells::update() {
+    // Rebuilding takes time proportional to the number of entries and cells, so rebuilding once
+    // the lists are that long keeps the cost per insertion constant.
+    if (nodes.size() >= elements.size() + heads.size()) {
+        rebuild();
+    }
+}
+
+template <class T>
+void GridIndex<T>::Cells::rebuild() {
+    std::vector<uint32_t> newOffsets(offsets.size());
+    std::vector<uint32_t> newElements;
+    newElements.reserve(elements.size() + nodes.size());
+
+    for (std::size_t cell = 0; cell < heads.size(); ++cell) {
+        newOffsets[cell] = static_cast<uint32_t>(newElements.size());
+        forEach(cell, [&](uint32_t element) {
+            newElements.push_back(element);
+            return false;
+        });
+    }
+    newOffsets.back() = static_cast<uint32_t>(newElements.size());
+
+    offsets = std::move(newOffsets);
+    elements = std::move(newElements);
+    std::fill(heads.begin(), heads.end(), none);
+    std::fill(tails.begin(), tails.end(), none);
+    nodes.clear();
+}
+
+template <class T>
+std::size_t GridIndex<T>::Cells::bytes() const {
+    return (offsets.capacity() + elements.capacity() + heads.capacity() + tails.capacity()) * sizeof(uint32_t) +
+           nodes.capacity() * sizeof(Node);
+}
+
 template <class T>
 GridIndex<T>::GridIndex(const float width_, const float height_, const int16_t cellSize_) :
     width(width_),
@@ -15,50 +73,85 @@ GridIndex<T>::GridIndex(const float width_, const float height_, const int16_t c
     xCellCount(std::ceil(width_ / cellSize_)),
     yCellCount(std::ceil(height_ / cellSize_)),
     xScale(xCellCount / width_),
-    yScale(yCellCount / height_)
-    {
-        boxCells.resize(xCellCount * yCellCount);
-        circleCells.resize(xCellCount * yCellCount);
-    }
+    yScale(yCellCount / height_),
+    boxCells(xCellCount * yCellCount),
+    circleCells(xCellCount * yCellCount)
+    {}
 
 template <class T>
 void GridIndex<T>::insert(T&& t, const BBox& bbox) {
-    size_t uid = boxElements.size();
-
-    auto cx1 = convertToXCellCoord(bbox.min.x);
-    auto cy1 = convertToYCellCoord(bbox.min.y);
-    auto cx2 = convertToXCellCoord(bbox.max.x);
-    auto cy2 = convertToYCellCoord(bbox.max.y);
-
-    int16_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            boxCells[cellIndex].push_back(uid);
+    insertBox(std::move(t), bbox);
+    boxCells.update();
+}
+
+template <class T>
+void GridIndex<T>::insert(T&& t, const BCircle& bcircle) {
+    insertCircle(std::move(t), bcircle);
+    circleCells.update();
+}
+
+template <class T>
+void GridIndex<T>::insert(std::vector<std::pair<T, BBox>>&& elements) {
+    const std::size_t size = boxData.size() + elements.size();
+    boxData.reserve(size);
+    boxMinX.reserve(size);
+    boxMinY.reserve(size);
+    boxMaxX.reserve(size);
+    boxMaxY.reserve(size);
+
+    for (auto& element : elements) {
+        insertBox(std::move(element.first), element.second);
+    }
+    boxCells.update();
+}
+
+template <class T>
+void GridIndex<T>::insert(std::vector<std::pair<T, BCircle>>&& elements) {
+    const std::size_t size = circleData.size() + elements.size();
+    circleData.reserve(size);
+    circleX.reserve(size);
+    circleY.reserve(size);
+    circleRadius.reserve(size);
+
+    for (auto& element : elements) {
+        insertCircle(std::move(element.first), element.second);
+    }
+    circleCells.update();
+}
+
+template <class T>
+void GridIndex<T>::insertBox(T&& t, const BBox& bbox) {
+    const auto uid = static_cast<uint32_t>(boxData.size());
+
+    const CellRange range = cellRange(bbox);
+    for (int32_t x = range.x1; x <= range.x2; ++x) {
+        for (int32_t y = range.y1; y <= range.y2; ++y) {
+            boxCells.insert(xCellCount * y + x, uid);
         }
     }
 
-    boxElements.emplace_back(t, bbox);
+    boxData.push_back(std::move(t));
+    boxMinX.push_back(bbox.min.x);
+    boxMinY.push_back(bbox.min.y);
+    boxMaxX.push_back(bbox.max.x);
+    boxMaxY.push_back(bbox.max.y);
 }
 
 template <class T>
-void GridIndex<T>::insert(T&& t, const BCircle& bcircle) {
-    size_t uid = circleElements.size();
-
-    auto cx1 = convertToXCellCoord(bcircle.center.x - bcircle.radius);
-    auto cy1 = convertToYCellCoord(bcircle.center.y - bcircle.radius);
-    auto cx2 = convertToXCellCoord(bcircle.center.x + bcircle.radius);
-    auto cy2 = convertToYCellCoord(bcircle.center.y + bcircle.radius);
-
-    int16_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            circleCells[cellIndex].push_back(uid);
+void GridIndex<T>::insertCircle(T&& t, const BCircle& bcircle) {
+    const auto uid = static_cast<uint32_t>(circleData.size());
+
+    const CellRange range = cellRange(convertToBox(bcircle));
+    for (int32_t x = range.x1; x <= range.x2; ++x) {
+        for (int32_t y = range.y1; y <= range.y2; ++y) {
+            circleCells.insert(xCellCount * y + x, uid);
         }
     }
 
-    circleElements.emplace_back(t, bcircle);
+    circleData.push_back(std::move(t));
+    circleX.push_back(bcircle.center.x);
+    circleY.push_back(bcircle.center.y);
+    circleRadius.push_back(bcircle.radius);
 }
 
 template <class T>
@@ -82,31 +175,13 @@ std::vector<std::pair<T, typename GridIndex<T>::BBox>> GridIndex<T>::queryWithBo
 }
 
 template <class T>
-bool GridIndex<T>::hitTest(const BBox& queryBBox, optional<std::function<bool(const T&)>> predicate) const {
-    bool hit = false;
-    query(queryBBox, [&](const T& t, const BBox&) -> bool {
-        if (!predicate || (*predicate)(t)) {
-            hit = true;
-            return true;
-        } else {
-            return false;
-        }
-    });
-    return hit;
+bool GridIndex<T>::hitTest(const BBox& queryBBox) const {
+    return hitTest(queryBBox, [](const T&) { return true; });
 }
 
 template <class T>
-bool GridIndex<T>::hitTest(const BCircle& queryBCircle, optional<std::function<bool(const T&)>> predicate) const {
-    bool hit = false;
-    query(queryBCircle, [&](const T& t, const BBox&) -> bool {
-        if (!predicate || (*predicate)(t)) {
-            hit = true;
-            return true;
-        } else {
-            return false;
-        }
-    });
-    return hit;
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle) const {
+    return hitTest(queryBCircle, [](const T&) { return true; });
 }
 
 template <class T>
@@ -126,129 +201,19 @@ typename GridIndex<T>::BBox GridIndex<T>::convertToBox(const BCircle& circle) co
 }
 
 template <class T>
-void GridIndex<T>::query(const BBox& queryBBox, std::function<bool (const T&, const BBox&)> resultFn) const {
-    std::unordered_set<size_t> seenBoxes;
-    std::unordered_set<size_t> seenCircles;
-    
-    if (noIntersection(queryBBox)) {
-        return;
-    } else if (completeIntersection(queryBBox)) {
-        for (auto& element : boxElements) {
-            if (resultFn(element.first, element.second)) {
-                return;
-            }
-        }
-        for (auto& element : circleElements) {
-            if (resultFn(element.first, convertToBox(element.second))) {
-                return;
-            }
-        }
-        return;
-    }
-
-    auto cx1 = convertToXCellCoord(queryBBox.min.x);
-    auto cy1 = convertToYCellCoord(queryBBox.min.y);
-    auto cx2 = convertToXCellCoord(queryBBox.max.x);
-    auto cy2 = convertToYCellCoord(queryBBox.max.y);
-
-    int16_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            // Look up other boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (seenBoxes.count(uid) == 0) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (boxesCollide(queryBBox, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
-            }
-            
-            // Look up circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (seenCircles.count(uid) == 0) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circleAndBoxCollide(bcircle, queryBBox)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
-            }
-        }
-    }
+typename GridIndex<T>::CellRange GridIndex<T>::cellRange(const BBox& bbox) const {
+    return { convertToXCellCoord(bbox.min.x), convertToYCellCoord(bbox.min.y),
+             convertToXCellCoord(bbox.max.x), convertToYCellCoord(bbox.max.y) };
 }
 
 template <class T>
-void GridIndex<T>::query(const BCircle& queryBCircle, std::function<bool (const T&, const BBox&)> resultFn) const {
-    std::unordered_set<size_t> seenBoxes;
-    std::unordered_set<size_t> seenCircles;
-
-    BBox queryBBox = convertToBox(queryBCircle);
-    if (noIntersection(queryBBox)) {
-        return;
-    } else if (completeIntersection(queryBBox)) {
-        for (auto& element : boxElements) {
-            if (resultFn(element.first, element.second)) {
-                return;
-            }
-        }
-        for (auto& element : circleElements) {
-            if (resultFn(element.first, convertToBox(element.second))) {
-                return;
-            }
-        }
-    }
+typename GridIndex<T>::BBox GridIndex<T>::boxAt(std::size_t i) const {
+    return BBox{{ boxMinX[i], boxMinY[i] }, { boxMaxX[i], boxMaxY[i] }};
+}
 
-    auto cx1 = convertToXCellCoord(queryBCircle.center.x - queryBCircle.radius);
-    auto cy1 = convertToYCellCoord(queryBCircle.center.y - queryBCircle.radius);
-    auto cx2 = convertToXCellCoord(queryBCircle.center.x + queryBCircle.radius);
-    auto cy2 = convertToYCellCoord(queryBCircle.center.y + queryBCircle.radius);
-
-    int16_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
-            // Look up boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (seenBoxes.count(uid) == 0) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (circleAndBoxCollide(queryBCircle, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
-            }
-            
-            // Look up other circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (seenCircles.count(uid) == 0) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circlesCollide(queryBCircle, bcircle)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
-            }
-        }
-    }
+template <class T>
+typename GridIndex<T>::BCircle GridIndex<T>::circleAt(std::size_t i) const {
+    return BCircle{{ circleX[i], circleY[i] }, circleRadius[i]};
 }
 
 template <class T>
@@ -302,9 +267,16 @@ bool GridIndex<T>::circleAndBoxCollide(const BCircle& circle, const BBox& box) c
 
 template <class T>
 bool GridIndex<T>::empty() const {
-    return boxElements.empty() && circleElements.empty();
+    return boxData.empty() && circleData.empty();
 }
 
+template <class T>
+std::size_t GridIndex<T>::bytes() const {
+    return (boxData.capacity() + circleData.capacity()) * sizeof(T) +
+           (boxMinX.capacity() + boxMinY.capacity() + boxMaxX.capacity() + boxMaxY.capacity() +
+            circleX.capacity() + circleY.capacity() + circleRadius.capacity()) * sizeof(float) +
+           boxCells.bytes() + circleCells.bytes();
+}
 
 template class GridIndex<IndexedSubfeature>;
 
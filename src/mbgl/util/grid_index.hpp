@@ -4,10 +4,11 @@
 #include <mapbox/geometry/box.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
+#include <limits>
 #include <vector>
-#include <functional>
 
 namespace mbgl {
 
@@ -51,6 +52,10 @@ constexpr bool operator!=(circle<T> const& lhs, circle<T> const& rhs)
  at least one cell. As long as the geometries are relatively
  uniformly distributed across the plane, this greatly reduces
  the number of comparisons necessary.
+
+ Geometries are stored as separate arrays of coordinates, so that
+ the comparisons read contiguous memory, and the cells share one
+ array of element indices; see Cells below. Queries don't allocate.
 */
 
 template <class T>
@@ -64,22 +69,103 @@ public:
 
     void insert(T&& t, const BBox&);
     void insert(T&& t, const BCircle&);
+
+    // Inserts many elements at once. The result is the same as inserting them one by one, in order.
+    void insert(std::vector<std::pair<T, BBox>>&&);
+    void insert(std::vector<std::pair<T, BCircle>>&&);
     
     std::vector<T> query(const BBox&) const;
     std::vector<std::pair<T,BBox>> queryWithBoxes(const BBox&) const;
-    
-    bool hitTest(const BBox&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
-    bool hitTest(const BCircle&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
+
+    // Calls `fn(const T&, const BBox&)` for the elements that intersect the box, in the same order
+    // as query(), until it returns true. Circles are passed with their bounding boxes.
+    template <class Fn>
+    void query(const BBox&, Fn&& fn) const;
+
+    bool hitTest(const BBox&) const;
+    bool hitTest(const BCircle&) const;
+
+    // Whether any element for which `predicate(const T&)` returns true intersects the geometry.
+    template <class Predicate>
+    bool hitTest(const BBox&, Predicate&& predicate) const;
+    template <class Predicate>
+    bool hitTest(const BCircle&, Predicate&& predicate) const;
     
     bool empty() const;
 
+    // The approximate number of bytes used by the index, not counting memory owned by elements.
+    std::size_t bytes() const;
+
 private:
+    // The elements that intersect each cell, in insertion order, as indices into the element
+    // arrays. Most of them are kept in one array, sorted by cell: the elements of cell `i` are
+    // `elements[offsets[i]]` up to `elements[offsets[i + 1]]`. Elements that were inserted after
+    // that array was built are appended to a linked list per cell, and are merged into the
+    // array once there are about as many of them as there are entries in the array.
+    class Cells {
+    public:
+        explicit Cells(std::size_t count);
+
+        void insert(uint32_t cell, uint32_t element);
+
+        // Merges the linked lists into the array if they have grown long enough.
+        void update();
+
+        // Calls `fn(uint32_t element)` for the elements of the cell until it returns true. Returns
+        // whether it did.
+        template <class Fn>
+        bool forEach(uint32_t cell, Fn&& fn) const;
+
+        std::size_t bytes() const;
+
+    private:
+        void rebuild();
+
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+        struct Node {
+            uint32_t element;
+            uint32_t next;
+        };
+
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> elements;
+
+        std::vector<uint32_t> heads;
+        std::vector<uint32_t> tails;
+        std::vector<Node> nodes;
+    };
+
+    struct CellRange {
+        int16_t x1;
+        int16_t y1;
+        int16_t x2;
+        int16_t y2;
+    };
+
     bool noIntersection(const BBox& queryBBox) const;
     bool completeIntersection(const BBox& queryBBox) const;
     BBox convertToBox(const BCircle& circle) const;
+    CellRange cellRange(const BBox&) const;
+
+    BBox boxAt(std::size_t i) const;
+    BCircle circleAt(std::size_t i) const;
 
-    void query(const BBox&, std::function<bool (const T&, const BBox&)>) const;
-    void query(const BCircle&, std::function<bool (const T&, const BBox&)>) const;
+    void insertBox(T&& t, const BBox&);
+    void insertCircle(T&& t, const BCircle&);
+
+    // Calls `fn(const T&, const BBox&)` for every element until it returns true.
+    template <class Fn>
+    bool forEachElement(Fn&& fn) const;
+
+    // Calls `fn(const T&, const BBox&)` for the elements in the cells of `range` that pass
+    // `collidesWithBox(i)` or `collidesWithCircle(i)`, until it returns true. Each element is
+    // visited in the first of its cells that are in `range`, so it is visited once.
+    template <class BoxTest, class CircleTest, class Fn>
+    void forEachInCells(const CellRange& range, BoxTest&& collidesWithBox, CircleTest&& collidesWithCircle, Fn&& fn) const;
+
+    template <class Fn>
+    void query(const BCircle&, Fn&& fn) const;
 
     int16_t convertToXCellCoord(const float x) const;
     int16_t convertToYCellCoord(const float y) const;
@@ -96,12 +182,159 @@ private:
     const double xScale;
     const double yScale;
 
-    std::vector<std::pair<T, BBox>> boxElements;
-    std::vector<std::pair<T, BCircle>> circleElements;
+    std::vector<T> boxData;
+    std::vector<float> boxMinX;
+    std::vector<float> boxMinY;
+    std::vector<float> boxMaxX;
+    std::vector<float> boxMaxY;
+
+    std::vector<T> circleData;
+    std::vector<float> circleX;
+    std::vector<float> circleY;
+    std::vector<float> circleRadius;
     
-    std::vector<std::vector<size_t>> boxCells;
-    std::vector<std::vector<size_t>> circleCells;
+    Cells boxCells;
+    Cells circleCells;
 
 };
 
+template <class T>
+template <class Fn>
+bool GridIndex<T>::Cells::forEach(uint32_t cell, Fn&& fn) const {
+    for (uint32_t i = offsets[cell]; i < offsets[cell + 1]; ++i) {
+        if (fn(elements[i])) {
+            return true;
+        }
+    }
+    for (uint32_t node = heads[cell]; node != none; node = nodes[node].next) {
+        if (fn(nodes[node].element)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class T>
+template <class Fn>
+bool GridIndex<T>::forEachElement(Fn&& fn) const {
+    for (std::size_t i = 0; i < boxData.size(); ++i) {
+        if (fn(boxData[i], boxAt(i))) {
+            return true;
+        }
+    }
+    for (std::size_t i = 0; i < circleData.size(); ++i) {
+        if (fn(circleData[i], convertToBox(circleAt(i)))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class T>
+template <class BoxTest, class CircleTest, class Fn>
+void GridIndex<T>::forEachInCells(const CellRange& range, BoxTest&& collidesWithBox, CircleTest&& collidesWithCircle, Fn&& fn) const {
+    for (int32_t x = range.x1; x <= range.x2; ++x) {
+        for (int32_t y = range.y1; y <= range.y2; ++y) {
+            const uint32_t cellIndex = xCellCount * y + x;
+
+            // Elements that were in an earlier cell of the range were already visited. Testing
+            // for that after the collision test is cheaper, since few elements collide.
+            auto firstVisit = [&](const BBox& bbox) {
+                return x == std::max<int32_t>(range.x1, convertToXCellCoord(bbox.min.x)) &&
+                       y == std::max<int32_t>(range.y1, convertToYCellCoord(bbox.min.y));
+            };
+
+            // Look up boxes
+            const bool boxDone = boxCells.forEach(cellIndex, [&](uint32_t uid) {
+                if (!collidesWithBox(uid)) {
+                    return false;
+                }
+                const BBox bbox = boxAt(uid);
+                return firstVisit(bbox) && fn(boxData[uid], bbox);
+            });
+            if (boxDone) {
+                return;
+            }
+
+            // Look up circles
+            const bool circleDone = circleCells.forEach(cellIndex, [&](uint32_t uid) {
+                if (!collidesWithCircle(uid)) {
+                    return false;
+                }
+                const BBox bbox = convertToBox(circleAt(uid));
+                return firstVisit(bbox) && fn(circleData[uid], bbox);
+            });
+            if (circleDone) {
+                return;
+            }
+        }
+    }
+}
+
+template <class T>
+template <class Fn>
+void GridIndex<T>::query(const BBox& queryBBox, Fn&& fn) const {
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        forEachElement(fn);
+        return;
+    }
+
+    forEachInCells(cellRange(queryBBox),
+        [&](uint32_t uid) {
+            return boxMinX[uid] <= queryBBox.max.x &&
+                   boxMinY[uid] <= queryBBox.max.y &&
+                   boxMaxX[uid] >= queryBBox.min.x &&
+                   boxMaxY[uid] >= queryBBox.min.y;
+        },
+        [&](uint32_t uid) {
+            return circleAndBoxCollide(circleAt(uid), queryBBox);
+        },
+        fn);
+}
+
+template <class T>
+template <class Fn>
+void GridIndex<T>::query(const BCircle& queryBCircle, Fn&& fn) const {
+    const BBox queryBBox = convertToBox(queryBCircle);
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        forEachElement(fn);
+        return;
+    }
+
+    forEachInCells(cellRange(queryBBox),
+        [&](uint32_t uid) {
+            return circleAndBoxCollide(queryBCircle, boxAt(uid));
+        },
+        [&](uint32_t uid) {
+            return circlesCollide(queryBCircle, circleAt(uid));
+        },
+        fn);
+}
+
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BBox& queryBBox, Predicate&& predicate) const {
+    bool hit = false;
+    query(queryBBox, [&](const T& t, const BBox&) -> bool {
+        hit = predicate(t);
+        return hit;
+    });
+    return hit;
+}
+
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle, Predicate&& predicate) const {
+    bool hit = false;
+    query(queryBCircle, [&](const T& t, const BBox&) -> bool {
+        hit = predicate(t);
+        return hit;
+    });
+    return hit;
+}
+
 } // namespace mbgl
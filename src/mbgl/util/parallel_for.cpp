@@ -0,0 +1,139 @@
+#include <mbgl/util/parallel_for.hpp>
+
+#include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+class Job {
+public:
+    Job(std::size_t count_, const std::function<void(std::size_t)>& fn_)
+        : count(count_), fn(fn_), remaining(count_) {}
+
+    // Claims and runs indices until there are none left.
+    void run() {
+        for (std::size_t i = next++; i < count; i = next++) {
+            fn(i);
+            if (--remaining == 0) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return remaining == 0; });
+    }
+
+private:
+    const std::size_t count;
+    const std::function<void(std::size_t)>& fn;
+    std::atomic<std::size_t> next { 0 };
+    std::atomic<std::size_t> remaining;
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+class HelperPool {
+public:
+    explicit HelperPool(std::size_t count) {
+        threads.reserve(count);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            threads.emplace_back([this, i]() {
+                platform::setCurrentThreadName(std::string{ "Helper " } + util::toString(i + 1));
+
+                while (true) {
+                    std::unique_lock<std::mutex> lock(mutex);
+
+                    cv.wait(lock, [this] {
+                        return !queue.empty() || terminate;
+                    });
+
+                    if (terminate) {
+                        return;
+                    }
+
+                    auto job = std::move(queue.front());
+                    queue.pop_front();
+                    lock.unlock();
+
+                    job->run();
+                }
+            });
+        }
+    }
+
+    ~HelperPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            terminate = true;
+        }
+
+        cv.notify_all();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::size_t size() const {
+        return threads.size();
+    }
+
+    // Asks `count` helpers to join the job. Helpers that get to it after all of its indices
+    // were claimed return right away.
+    void post(const std::shared_ptr<Job>& job, std::size_t count) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.insert(queue.end(), count, job);
+        }
+
+        cv.notify_all();
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::shared_ptr<Job>> queue;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool terminate { false };
+};
+
+HelperPool& helperPool() {
+    static HelperPool pool(std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 2u) - 1, 7));
+    return pool;
+}
+
+} // namespace
+
+void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn) {
+    if (count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    auto& pool = helperPool();
+    auto job = std::make_shared<Job>(count, fn);
+    pool.post(job, std::min(pool.size(), count - 1));
+    job->run();
+    job->wait();
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace mbgl {
+namespace util {
+
+// Calls `fn(i)` for every `i` in [0, count) and returns once all calls have returned. The
+// calling thread takes part in the work and is helped by a small pool of threads that is
+// shared by all callers and started on first use. Since the calling thread claims work
+// itself, it never waits for a helper that is busy with another caller's work.
+//
+// Calls may run concurrently and in any order, so `fn` may only write to state that belongs
+// to `i`. `fn` must not throw.
+void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+} // namespace util
+} // namespace mbgl
@@ -4,6 +4,8 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/platform/thread.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 ThreadPool::ThreadPool(std::size_t count) {
@@ -26,8 +28,13 @@ ThreadPool::ThreadPool(std::size_t count) {
                     return;
                 }
 
-                auto mailbox = queue.front();
-                queue.pop();
+                if (dirty) {
+                    rebuildQueue();
+                }
+
+                std::pop_heap(queue.begin(), queue.end());
+                auto mailbox = std::move(queue.back().mailbox);
+                queue.pop_back();
                 lock.unlock();
 
                 Mailbox::maybeReceive(mailbox);
@@ -50,12 +57,36 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    Mailbox::Priority priority = 0;
+    if (auto locked = mailbox.lock()) {
+        priority = locked->getPriority();
+    }
+
     {
         std::lock_guard<std::mutex> lock(mutex);
-        queue.push(mailbox);
+        queue.push_back({ priority, sequence++, std::move(mailbox) });
+        std::push_heap(queue.begin(), queue.end());
     }
 
     cv.notify_one();
 }
 
+void ThreadPool::reprioritize() {
+    // Camera changes usually reprioritize many mailboxes at once; defer the work
+    // until a worker picks the next mailbox.
+    std::lock_guard<std::mutex> lock(mutex);
+    dirty = true;
+}
+
+void ThreadPool::rebuildQueue() {
+    // Called with the mutex held.
+    for (auto& entry : queue) {
+        if (auto locked = entry.mailbox.lock()) {
+            entry.priority = locked->getPriority();
+        }
+    }
+    std::make_heap(queue.begin(), queue.end());
+    dirty = false;
+}
+
 } // namespace mbgl
@@ -4,9 +4,10 @@
 #include <mbgl/actor/scheduler.hpp>
 
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
 
 namespace mbgl {
 
@@ -16,10 +17,27 @@ public:
     ~ThreadPool() override;
 
     void schedule(std::weak_ptr<Mailbox>) override;
+    void reprioritize() override;
 
 private:
+    struct Entry {
+        Mailbox::Priority priority;
+        uint64_t sequence;
+        std::weak_ptr<Mailbox> mailbox;
+
+        // Orders the heap so that the highest priority, and then the oldest entry is on top.
+        bool operator<(const Entry& other) const {
+            return priority < other.priority ||
+                   (priority == other.priority && sequence > other.sequence);
+        }
+    };
+
+    void rebuildQueue();
+
     std::vector<std::thread> threads;
-    std::queue<std::weak_ptr<Mailbox>> queue;
+    std::vector<Entry> queue;
+    uint64_t sequence = 0;
+    bool dirty = false;
     std::mutex mutex;
     std::condition_variable cv;
     bool terminate{ false };
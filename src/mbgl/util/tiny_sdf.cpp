@@ -11,91 +11,140 @@ namespace tinysdf {
 
 static const double INF = 1e20;
 
-// 1D squared distance transform
-void edt1d(std::vector<double>& f,
-           std::vector<double>& d,
-           std::vector<int16_t>& v,
-           std::vector<double>& z,
-           uint32_t n) {
+// 1D squared distance transform of the n values in `grid` that start at `offset` and are
+// `stride` apart. `f` receives a copy of the input values; `g` caches f[v[k]] + v[k]²
+// for the parabolas of the lower envelope.
+void edt1d(double* grid,
+           uint32_t offset,
+           uint32_t stride,
+           uint32_t n,
+           double* f,
+           double* g,
+           int16_t* v,
+           double* z) {
     v[0] = 0;
     z[0] = -INF;
     z[1] = +INF;
+    f[0] = grid[offset];
+    g[0] = f[0];
 
     for (uint32_t q = 1, k = 0; q < n; q++) {
-        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        f[q] = grid[offset + q * stride];
+        const double fq = f[q] + q * q;
+        double s = (fq - g[k]) / (2 * q - 2 * v[k]);
         while (s <= z[k]) {
             k--;
-            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            s = (fq - g[k]) / (2 * q - 2 * v[k]);
         }
         k++;
         v[k] = q;
+        g[k] = fq;
         z[k] = s;
         z[k + 1] = +INF;
     }
 
     for (uint32_t q = 0, k = 0; q < n; q++) {
         while (z[k + 1] < q) k++;
-        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+        grid[offset + q * stride] = (q - v[k]) * (q - v[k]) + f[v[k]];
     }
 }
 
-
 // 2D Euclidean distance transform by Felzenszwalb & Huttenlocher https://cs.brown.edu/~pff/dt/
+// Columns outside of [x0, x1) and rows outside of [y0, y1) hold the same value in every cell,
+// which the transform along them wouldn't change, so they are skipped.
 void edt(std::vector<double>& data,
          uint32_t width,
          uint32_t height,
+         uint32_t x0,
+         uint32_t x1,
+         uint32_t y0,
+         uint32_t y1,
          std::vector<double>& f,
-         std::vector<double>& d,
+         std::vector<double>& g,
          std::vector<int16_t>& v,
          std::vector<double>& z) {
-    for (uint32_t x = 0; x < width; x++) {
-        for (uint32_t y = 0; y < height; y++) {
-            f[y] = data[y * width + x];
-        }
-        edt1d(f, d, v, z, height);
-        for (uint32_t y = 0; y < height; y++) {
-            data[y * width + x] = d[y];
-        }
+    for (uint32_t x = x0; x < x1; x++) {
+        edt1d(data.data(), x, width, height, f.data(), g.data(), v.data(), z.data());
     }
     for (uint32_t y = 0; y < height; y++) {
-        for (uint32_t x = 0; x < width; x++) {
-            f[x] = data[y * width + x];
+        if (y >= y0 && y < y1) {
+            edt1d(data.data(), y * width, 1, width, f.data(), g.data(), v.data(), z.data());
         }
-        edt1d(f, d, v, z, width);
         for (uint32_t x = 0; x < width; x++) {
-            data[y * width + x] = std::sqrt(d[x]);
+            data[y * width + x] = std::sqrt(data[y * width + x]);
         }
     }
 }
 
+// Rounds half away from zero like std::lround(), and clamps to [0, 255], without calling into
+// the math library for every pixel.
+inline uint8_t roundToAlpha(double value) {
+    if (!(value > 0.0)) {
+        return 0;
+    }
+    if (value >= 255.0) {
+        return 255;
+    }
+    // Subtracting the integer part is exact, which adding 0.5 wouldn't be.
+    const auto integer = static_cast<uint32_t>(value);
+    return static_cast<uint8_t>(value - integer >= 0.5 ? integer + 1 : integer);
+}
+
 } // namespace tinysdf
 
 AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff) {
-    uint32_t size = rasterInput.size.width * rasterInput.size.height;
-    uint32_t maxDimension = std::max(rasterInput.size.width, rasterInput.size.height);
-    
+    const uint32_t width = rasterInput.size.width;
+    const uint32_t height = rasterInput.size.height;
+    uint32_t size = width * height;
+    uint32_t maxDimension = std::max(width, height);
+
     AlphaImage sdf(rasterInput.size);
-    
+    if (size == 0) {
+        return sdf;
+    }
+
     // temporary arrays for the distance transform
     std::vector<double> gridOuter(size);
     std::vector<double> gridInner(size);
     std::vector<double> f(maxDimension);
-    std::vector<double> d(maxDimension);
+    std::vector<double> g(maxDimension);
     std::vector<double> z(maxDimension + 1);
     std::vector<int16_t> v(maxDimension);
-    
-    for (uint32_t i = 0; i < size; i++) {
-        double a = double(rasterInput.data[i]) / 255; // alpha value
-        gridOuter[i] = a == 1.0 ? 0.0 : a == 0.0 ? tinysdf::INF : std::pow(std::max(0.0, 0.5 - a), 2.0);
-        gridInner[i] = a == 1.0 ? tinysdf::INF : a == 0.0 ? 0.0 : std::pow(std::max(0.0, a - 0.5), 2.0);
+
+    // The bounds of the pixels that the glyph covers. Everywhere else, the outer grid is
+    // INF and the inner grid is 0.
+    uint32_t x0 = width, x1 = 0, y0 = height, y1 = 0;
+
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            const uint32_t i = y * width + x;
+            if (rasterInput.data[i] == 0) {
+                gridOuter[i] = tinysdf::INF;
+                gridInner[i] = 0.0;
+                continue;
+            }
+
+            x0 = std::min(x0, x);
+            x1 = std::max(x1, x + 1);
+            y0 = std::min(y0, y);
+            y1 = std::max(y1, y + 1);
+
+            double a = double(rasterInput.data[i]) / 255; // alpha value
+            const double outer = std::max(0.0, 0.5 - a);
+            const double inner = std::max(0.0, a - 0.5);
+            gridOuter[i] = a == 1.0 ? 0.0 : outer * outer;
+            gridInner[i] = a == 1.0 ? tinysdf::INF : inner * inner;
+        }
     }
 
-    tinysdf::edt(gridOuter, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
-    tinysdf::edt(gridInner, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
+    // Rows of the outer grid that the glyph doesn't cover still get the distance to it from
+    // the transform of the columns.
+    tinysdf::edt(gridOuter, width, height, x0, x1, 0, height, f, g, v, z);
+    tinysdf::edt(gridInner, width, height, x0, x1, y0, y1, f, g, v, z);
 
     for (uint32_t i = 0; i < size; i++) {
         double distance = gridOuter[i] - gridInner[i];
-        sdf.data[i] = std::max(0l, std::min(255l, ::lround(255.0 - 255.0 * (distance / radius + cutoff))));
+        sdf.data[i] = tinysdf::roundToAlpha(255.0 - 255.0 * (distance / radius + cutoff));
     }
 
     return sdf;
@@ -0,0 +1,222 @@
+#include <mbgl/util/transform_points.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define MBGL_TRANSFORM_POINTS_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+// GCC and Clang can compile AVX functions without enabling AVX for the whole file.
+#define MBGL_TRANSFORM_POINTS_AVX 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MBGL_TRANSFORM_POINTS_NEON 1
+#include <arm_neon.h>
+#endif
+
+#include <algorithm>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+// The matrix rows that are needed to compute x, y and w. transformMat4() computes each
+// component as `m0 * x + m4 * y + m8 * z + m12 * w`, from left to right. Since z is 0 and w is
+// 1, the last two terms are the same for every point, but they must still be added one after
+// the other to round the same way.
+struct Row {
+    Row(const mat4& m, std::size_t i)
+        : a(m[i]), b(m[i + 4]), c(m[i + 8] * 0.0), d(m[i + 12] * 1.0) {}
+
+    double apply(double x, double y) const {
+        return a * x + b * y + c + d;
+    }
+
+    double a;
+    double b;
+    double c;
+    double d;
+};
+
+void transformScalar(const Row (&rows)[3], std::size_t count, const float* x, const float* y,
+                     double* outX, double* outY, double* outW) {
+    for (std::size_t i = 0; i < count; ++i) {
+        outX[i] = rows[0].apply(x[i], y[i]);
+        outY[i] = rows[1].apply(x[i], y[i]);
+        outW[i] = rows[2].apply(x[i], y[i]);
+    }
+}
+
+// Runs `kernel` on blocks of `width` points. The last, partial block is padded with copies of
+// its last point, so that every point goes through the same instructions.
+template <std::size_t width, class Kernel>
+void transformBlocks(std::size_t count, const float* x, const float* y,
+                     double* outX, double* outY, double* outW, Kernel kernel) {
+    std::size_t i = 0;
+    for (; i + width <= count; i += width) {
+        kernel(x + i, y + i, outX + i, outY + i, outW + i);
+    }
+
+    const std::size_t rest = count - i;
+    if (rest > 0) {
+        float tailX[width];
+        float tailY[width];
+        double tailOutX[width];
+        double tailOutY[width];
+        double tailOutW[width];
+        for (std::size_t j = 0; j < width; ++j) {
+            tailX[j] = x[i + std::min(j, rest - 1)];
+            tailY[j] = y[i + std::min(j, rest - 1)];
+        }
+        kernel(tailX, tailY, tailOutX, tailOutY, tailOutW);
+        std::copy(tailOutX, tailOutX + rest, outX + i);
+        std::copy(tailOutY, tailOutY + rest, outY + i);
+        std::copy(tailOutW, tailOutW + rest, outW + i);
+    }
+}
+
+#if MBGL_TRANSFORM_POINTS_SSE2
+
+__m128d applySSE2(const Row& row, __m128d x, __m128d y) {
+    __m128d result = _mm_mul_pd(_mm_set1_pd(row.a), x);
+    result = _mm_add_pd(result, _mm_mul_pd(_mm_set1_pd(row.b), y));
+    result = _mm_add_pd(result, _mm_set1_pd(row.c));
+    return _mm_add_pd(result, _mm_set1_pd(row.d));
+}
+
+void transformSSE2(const Row (&rows)[3], std::size_t count, const float* x, const float* y,
+                   double* outX, double* outY, double* outW) {
+    transformBlocks<2>(count, x, y, outX, outY, outW,
+        [&](const float* bx, const float* by, double* bOutX, double* bOutY, double* bOutW) {
+            const __m128d px = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(bx))));
+            const __m128d py = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(by))));
+            _mm_storeu_pd(bOutX, applySSE2(rows[0], px, py));
+            _mm_storeu_pd(bOutY, applySSE2(rows[1], px, py));
+            _mm_storeu_pd(bOutW, applySSE2(rows[2], px, py));
+        });
+}
+
+#endif
+
+#if MBGL_TRANSFORM_POINTS_AVX
+
+__attribute__((target("avx")))
+__m256d applyAVX(const Row& row, __m256d x, __m256d y) {
+    __m256d result = _mm256_mul_pd(_mm256_set1_pd(row.a), x);
+    result = _mm256_add_pd(result, _mm256_mul_pd(_mm256_set1_pd(row.b), y));
+    result = _mm256_add_pd(result, _mm256_set1_pd(row.c));
+    return _mm256_add_pd(result, _mm256_set1_pd(row.d));
+}
+
+__attribute__((target("avx")))
+void transformAVXBlock(const Row (&rows)[3], const float* x, const float* y,
+                       double* outX, double* outY, double* outW) {
+    const __m256d px = _mm256_cvtps_pd(_mm_loadu_ps(x));
+    const __m256d py = _mm256_cvtps_pd(_mm_loadu_ps(y));
+    _mm256_storeu_pd(outX, applyAVX(rows[0], px, py));
+    _mm256_storeu_pd(outY, applyAVX(rows[1], px, py));
+    _mm256_storeu_pd(outW, applyAVX(rows[2], px, py));
+}
+
+void transformAVX(const Row (&rows)[3], std::size_t count, const float* x, const float* y,
+                  double* outX, double* outY, double* outW) {
+    transformBlocks<4>(count, x, y, outX, outY, outW,
+        [&](const float* bx, const float* by, double* bOutX, double* bOutY, double* bOutW) {
+            transformAVXBlock(rows, bx, by, bOutX, bOutY, bOutW);
+        });
+}
+
+#endif
+
+#if MBGL_TRANSFORM_POINTS_NEON
+
+float64x2_t applyNEON(const Row& row, float64x2_t x, float64x2_t y) {
+    float64x2_t result = vmulq_f64(vdupq_n_f64(row.a), x);
+    result = vaddq_f64(result, vmulq_f64(vdupq_n_f64(row.b), y));
+    result = vaddq_f64(result, vdupq_n_f64(row.c));
+    return vaddq_f64(result, vdupq_n_f64(row.d));
+}
+
+void transformNEON(const Row (&rows)[3], std::size_t count, const float* x, const float* y,
+                   double* outX, double* outY, double* outW) {
+    transformBlocks<2>(count, x, y, outX, outY, outW,
+        [&](const float* bx, const float* by, double* bOutX, double* bOutY, double* bOutW) {
+            const float64x2_t px = vcvt_f64_f32(vld1_f32(bx));
+            const float64x2_t py = vcvt_f64_f32(vld1_f32(by));
+            vst1q_f64(bOutX, applyNEON(rows[0], px, py));
+            vst1q_f64(bOutY, applyNEON(rows[1], px, py));
+            vst1q_f64(bOutW, applyNEON(rows[2], px, py));
+        });
+}
+
+#endif
+
+SIMD detectSIMD() {
+#if MBGL_TRANSFORM_POINTS_AVX
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+        return SIMD::AVX;
+    }
+#endif
+#if MBGL_TRANSFORM_POINTS_SSE2
+    return SIMD::SSE2;
+#elif MBGL_TRANSFORM_POINTS_NEON
+    return SIMD::NEON;
+#else
+    return SIMD::None;
+#endif
+}
+
+} // namespace
+
+SIMD bestSIMD() {
+    static const SIMD simd = detectSIMD();
+    return simd;
+}
+
+void transformPoints(const mat4& matrix, std::size_t count, const float* x, const float* y,
+                     double* outX, double* outY, double* outW, SIMD simd) {
+    const Row rows[3] = { { matrix, 0 }, { matrix, 1 }, { matrix, 3 } };
+
+    if (simd == SIMD::AVX && bestSIMD() != SIMD::AVX) {
+        simd = SIMD::None;
+    }
+
+    switch (simd) {
+#if MBGL_TRANSFORM_POINTS_AVX
+    case SIMD::AVX:
+        transformAVX(rows, count, x, y, outX, outY, outW);
+        return;
+#endif
+#if MBGL_TRANSFORM_POINTS_SSE2
+    case SIMD::SSE2:
+        transformSSE2(rows, count, x, y, outX, outY, outW);
+        return;
+#endif
+#if MBGL_TRANSFORM_POINTS_NEON
+    case SIMD::NEON:
+        transformNEON(rows, count, x, y, outX, outY, outW);
+        return;
+#endif
+    default:
+        transformScalar(rows, count, x, y, outX, outY, outW);
+        return;
+    }
+}
+
+TransformedPoints::TransformedPoints(const mat4& matrix_, const std::vector<Point<float>>& points)
+    : matrix(matrix_), x(points.size()), y(points.size()), w(points.size()) {
+    std::vector<float> pointsX;
+    std::vector<float> pointsY;
+    pointsX.reserve(points.size());
+    pointsY.reserve(points.size());
+    for (const auto& point : points) {
+        pointsX.push_back(point.x);
+        pointsY.push_back(point.y);
+    }
+
+    transformPoints(matrix, points.size(), pointsX.data(), pointsY.data(), x.data(), y.data(), w.data());
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/geometry.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+// Instruction sets that transformPoints() can use.
+enum class SIMD : uint8_t {
+    None,
+    SSE2,
+    AVX,
+    NEON,
+};
+
+// The widest instruction set that this CPU supports. It is detected on first use.
+SIMD bestSIMD();
+
+// Transforms the points (x[i], y[i], 0, 1) by `matrix`, and writes the x, y and w components
+// of the results. Every instruction set performs the same double precision operations in the
+// same order as matrix::transformMat4(), so the results don't depend on the instruction set.
+// This requires that neither is contracted into fused multiply-adds, so the build compiles
+// both with -ffp-contract=off. Instruction sets that the CPU doesn't support fall back to
+// scalar code.
+void transformPoints(const mat4& matrix, std::size_t count, const float* x, const float* y,
+                     double* outX, double* outY, double* outW, SIMD = bestSIMD());
+
+// Points in struct-of-arrays layout, transformed in one batch by transformPoints().
+class TransformedPoints {
+public:
+    TransformedPoints() = default;
+    TransformedPoints(const mat4& matrix, const std::vector<Point<float>>& points);
+
+    std::size_t size() const { return x.size(); }
+
+    mat4 matrix;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> w;
+};
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,236 @@
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/platform/thread.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+WorkStealingThreadPool::Deque::Array::Array(std::int64_t capacity_)
+    : capacity(capacity_),
+      tasks(std::make_unique<std::atomic<Task>[]>(capacity_)) {
+    assert((capacity & (capacity - 1)) == 0);
+}
+
+WorkStealingThreadPool::Task WorkStealingThreadPool::Deque::Array::get(std::int64_t i) const {
+    return tasks[i & (capacity - 1)].load(std::memory_order_relaxed);
+}
+
+void WorkStealingThreadPool::Deque::Array::put(std::int64_t i, Task task) {
+    tasks[i & (capacity - 1)].store(task, std::memory_order_relaxed);
+}
+
+WorkStealingThreadPool::Deque::Deque() {
+    arrays.push_back(std::make_unique<Array>(64));
+    array.store(arrays.back().get(), std::memory_order_relaxed);
+}
+
+WorkStealingThreadPool::Deque::~Deque() {
+    // Delete tasks that were never received.
+    Array* a = array.load(std::memory_order_relaxed);
+    const std::int64_t b = bottom.load(std::memory_order_relaxed);
+    for (std::int64_t t = top.load(std::memory_order_relaxed); t < b; ++t) {
+        delete a->get(t);
+    }
+}
+
+WorkStealingThreadPool::Deque::Array*
+WorkStealingThreadPool::Deque::grow(Array* old, std::int64_t b, std::int64_t t) {
+    arrays.push_back(std::make_unique<Array>(old->capacity * 2));
+    Array* a = arrays.back().get();
+    for (std::int64_t i = t; i < b; ++i) {
+        a->put(i, old->get(i));
+    }
+    array.store(a, std::memory_order_release);
+    return a;
+}
+
+void WorkStealingThreadPool::Deque::push(Task task) {
+    const std::int64_t b = bottom.load(std::memory_order_relaxed);
+    const std::int64_t t = top.load(std::memory_order_acquire);
+    Array* a = array.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1) {
+        a = grow(a, b, t);
+    }
+    a->put(b, task);
+    bottom.store(b + 1, std::memory_order_release);
+}
+
+WorkStealingThreadPool::Task WorkStealingThreadPool::Deque::pop() {
+    const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Array* a = array.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        // The deque was empty.
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task task = a->get(b);
+    if (t == b) {
+        // This was the last task; race against thieves for it.
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+WorkStealingThreadPool::Task WorkStealingThreadPool::Deque::steal() {
+    std::int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return nullptr;
+    }
+
+    Array* a = array.load(std::memory_order_acquire);
+    Task task = a->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        // Lost the race against the owner or another thief.
+        return nullptr;
+    }
+    return task;
+}
+
+bool WorkStealingThreadPool::Deque::empty() const {
+    return bottom.load(std::memory_order_acquire) <= top.load(std::memory_order_acquire);
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::size_t count) {
+    assert(count > 0);
+
+    // All workers must exist before any thread starts, because threads steal from each other.
+    workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        workers[i]->thread = std::thread([this, i]() {
+            platform::setCurrentThreadName(std::string{ "Worker " } + util::toString(i + 1));
+            platform::attachThread();
+
+            currentWorker.set(workers[i].get());
+            run(i);
+            currentWorker.set(nullptr);
+
+            platform::detachThread();
+        });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        terminate = true;
+    }
+
+    parkCondition.notify_all();
+
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+
+    for (Task task : injector) {
+        delete task;
+    }
+}
+
+void WorkStealingThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    Task task = new std::weak_ptr<Mailbox>(std::move(mailbox));
+
+    if (Worker* worker = currentWorker.get()) {
+        // Mailboxes scheduled from within the pool usually belong to actors that
+        // are sending to each other; keep them on this worker's deque.
+        worker->deque.push(task);
+    } else {
+        std::lock_guard<std::mutex> lock(injectorMutex);
+        injector.push_back(task);
+        injectorSize.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    wake();
+}
+
+void WorkStealingThreadPool::run(std::size_t index) {
+    while (!terminate.load(std::memory_order_acquire)) {
+        if (Task task = findTask(index)) {
+            std::unique_ptr<std::weak_ptr<Mailbox>> mailbox(task);
+            Mailbox::maybeReceive(*mailbox);
+        } else {
+            park();
+        }
+    }
+}
+
+WorkStealingThreadPool::Task WorkStealingThreadPool::findTask(std::size_t index) {
+    if (Task task = workers[index]->deque.pop()) {
+        return task;
+    }
+
+    if (injectorSize.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(injectorMutex);
+        if (!injector.empty()) {
+            Task task = injector.front();
+            injector.pop_front();
+            injectorSize.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+
+    const std::size_t count = workers.size();
+    for (std::size_t i = 1; i < count; ++i) {
+        if (Task task = workers[(index + i) % count]->deque.steal()) {
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+bool WorkStealingThreadPool::hasTask() const {
+    if (injectorSize.load(std::memory_order_seq_cst) > 0) {
+        return true;
+    }
+    for (const auto& worker : workers) {
+        if (!worker->deque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::park() {
+    std::unique_lock<std::mutex> lock(parkMutex);
+    sleepers.fetch_add(1, std::memory_order_seq_cst);
+
+    // Work may have been scheduled after findTask() gave up, but before we announced
+    // ourselves as sleeping. wake() takes parkMutex before notifying, so a notification
+    // can't get lost between this check and the wait.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!terminate && !hasTask()) {
+        parkCondition.wait(lock);
+    }
+
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void WorkStealingThreadPool::wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+        }
+        parkCondition.notify_one();
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+
+// A `Scheduler` that gives every worker thread its own deque of mailboxes. Workers
+// push and pop at the bottom of their own deque without taking a lock, and idle
+// workers steal from the top of other workers' deques. Mailboxes scheduled from
+// outside of the pool go to a shared injection queue. Workers that can't find any
+// work park on a condition variable until new work is scheduled.
+//
+// This keeps the guarantees documented in `Scheduler`: a mailbox is only ever
+// queued once at a time, so stealing never makes a mailbox receive concurrently.
+class WorkStealingThreadPool final : public Scheduler {
+public:
+    explicit WorkStealingThreadPool(std::size_t count);
+    ~WorkStealingThreadPool() override;
+
+    void schedule(std::weak_ptr<Mailbox>) override;
+
+private:
+    using Task = std::weak_ptr<Mailbox>*;
+
+    // Chase-Lev work-stealing deque. Only the owning worker calls push() and pop();
+    // any thread may call steal().
+    class Deque {
+    public:
+        Deque();
+        ~Deque();
+
+        void push(Task);
+        Task pop();
+        Task steal();
+        bool empty() const;
+
+    private:
+        struct Array {
+            explicit Array(std::int64_t capacity_);
+            Task get(std::int64_t i) const;
+            void put(std::int64_t i, Task);
+
+            const std::int64_t capacity;
+            std::unique_ptr<std::atomic<Task>[]> tasks;
+        };
+
+        Array* grow(Array*, std::int64_t bottom, std::int64_t top);
+
+        std::atomic<std::int64_t> top { 0 };
+        std::atomic<std::int64_t> bottom { 0 };
+        std::atomic<Array*> array;
+
+        // Arrays that were replaced while growing. A concurrent steal() may still be
+        // reading from them, so they are kept alive until the deque is destroyed.
+        std::vector<std::unique_ptr<Array>> arrays;
+    };
+
+    struct Worker {
+        Deque deque;
+        std::thread thread;
+    };
+
+    void run(std::size_t index);
+    Task findTask(std::size_t index);
+    bool hasTask() const;
+    void park();
+    void wake();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    util::ThreadLocal<Worker> currentWorker;
+
+    mutable std::mutex injectorMutex;
+    std::deque<Task> injector;
+    std::atomic<std::size_t> injectorSize { 0 };
+
+    std::mutex parkMutex;
+    std::condition_variable parkCondition;
+    std::atomic<std::size_t> sleepers { 0 };
+    std::atomic<bool> terminate { false };
+};
+
+} // namespace mbgl
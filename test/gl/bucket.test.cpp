@@ -8,6 +8,10 @@
 #include <mbgl/renderer/buckets/raster_bucket.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/style/expression/dsl.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/style/layers/fill_layer_properties.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/headless_backend.hpp>
@@ -40,6 +44,38 @@ namespace {
 
 PropertyMap properties;
 
+// Keeps the contents of the vertex buffers that are uploaded, in order.
+class VertexRecordingUploadPass final : public gfx::UploadPass {
+public:
+    std::vector<std::string> vertexBuffers;
+
+private:
+    class VertexBufferResource final : public gfx::VertexBufferResource {};
+    class IndexBufferResource final : public gfx::IndexBufferResource {};
+    class TextureResource final : public gfx::TextureResource {};
+
+    void pushDebugGroup(const char*) override {}
+    void popDebugGroup() override {}
+
+    std::unique_ptr<gfx::VertexBufferResource> createVertexBufferResource(const void* data, std::size_t size, const gfx::BufferUsageType) override {
+        vertexBuffers.emplace_back(static_cast<const char*>(data), size);
+        return std::make_unique<VertexBufferResource>();
+    }
+    void updateVertexBufferResource(gfx::VertexBufferResource&, const void*, std::size_t) override {}
+    void updateVertexBufferResourceSub(gfx::VertexBufferResource&, std::size_t, const void*, std::size_t) override {}
+
+    std::unique_ptr<gfx::IndexBufferResource> createIndexBufferResource(const void*, std::size_t, const gfx::BufferUsageType) override {
+        return std::make_unique<IndexBufferResource>();
+    }
+    void updateIndexBufferResource(gfx::IndexBufferResource&, const void*, std::size_t) override {}
+
+    std::unique_ptr<gfx::TextureResource> createTextureResource(Size, const void*, gfx::TexturePixelType, gfx::TextureChannelDataType) override {
+        return std::make_unique<TextureResource>();
+    }
+    void updateTextureResource(gfx::TextureResource&, Size, const void*, gfx::TexturePixelType, gfx::TextureChannelDataType) override {}
+    void updateTextureResourceSub(gfx::TextureResource&, uint16_t, uint16_t, Size, const void*, gfx::TexturePixelType, gfx::TextureChannelDataType) override {}
+};
+
 } // namespace
 
 TEST(Buckets, CircleBucket) {
@@ -84,6 +120,89 @@ TEST(Buckets, FillBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, FillBucketRestoreGeometry) {
+    style::Properties<>::PossiblyEvaluated layout;
+
+    FillBucket bucket { layout, {}, 5.0f, 1 };
+    GeometryCollection polygon { { { 0, 0 }, { 0, 1 }, { 1, 1 } } };
+    GeometryCollection square { { { 0, 0 }, { 0, 4 }, { 4, 4 }, { 4, 0 } } };
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, polygon, properties }, polygon, {}, PatternLayerMap());
+    const std::size_t firstFeatureEnd = bucket.vertices.elements();
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, square, properties }, square, {}, PatternLayerMap());
+
+    auto geometry = bucket.saveGeometry({ firstFeatureEnd, bucket.vertices.elements() });
+    EXPECT_LT(0u, geometry->bytes());
+
+    FillBucket restored { layout, {}, 5.0f, 1 };
+    const std::vector<std::size_t>& featureVertexEnds = restored.restoreGeometry(*geometry);
+    EXPECT_EQ((std::vector<std::size_t>{ firstFeatureEnd, bucket.vertices.elements() }), featureVertexEnds);
+    EXPECT_TRUE(restored.hasData());
+    EXPECT_EQ(bucket.vertices.vector(), restored.vertices.vector());
+    EXPECT_EQ(bucket.lines.vector(), restored.lines.vector());
+    EXPECT_EQ(bucket.triangles.vector(), restored.triangles.vector());
+    EXPECT_EQ(bucket.lineSegments, restored.lineSegments);
+    EXPECT_EQ(bucket.triangleSegments, restored.triangleSegments);
+}
+
+TEST(Buckets, FillBucketBatchPaintProperties) {
+    using namespace style;
+    using namespace style::expression::dsl;
+
+    // A source function, which is evaluated in batches, and a composite function, which is
+    // evaluated at two zoom levels.
+    FillLayer layer("fill", "source");
+    FillPaintProperties::PossiblyEvaluated paint;
+    paint.get<FillOpacity>() = PossiblyEvaluatedPropertyValue<float>(PropertyExpression<float>(
+        interpolate(linear(), number(get("population")), 0.0, literal(0.2), 100.0, literal(1.0))));
+    paint.get<FillColor>() = PossiblyEvaluatedPropertyValue<Color>(PropertyExpression<Color>(
+        interpolate(linear(), zoom(), 0.0, toColor(get("color")), 10.0, literal(Color::red()))));
+    Immutable<LayerProperties> layerProperties = makeMutable<FillLayerProperties>(
+        staticImmutableCast<FillLayer::Impl>(layer.baseImpl), CrossfadeParameters{ 1.0f, 1.0f, 1.0f }, paint);
+    const std::map<std::string, Immutable<LayerProperties>> layerPaintProperties { { "fill", layerProperties } };
+    style::Properties<>::PossiblyEvaluated layout;
+
+    // Features with different numbers of vertices, one of which has an invalid color.
+    const std::string colors[] = { "#336699", "red", "not a color" };
+    std::vector<StubGeometryTileFeature> features;
+    std::vector<GeometryCollection> geometries;
+    for (int16_t i = 0; i < 12; ++i) {
+        GeometryCollection polygon { { { 0, 0 }, { 0, int16_t(i + 1) }, { int16_t(i + 1), int16_t(i + 1) } } };
+        if (i % 2) {
+            polygon[0].emplace_back(int16_t(i + 1), 0);
+        }
+        geometries.push_back(polygon);
+        features.emplace_back(FeatureIdentifier {}, FeatureType::Polygon, polygon,
+                              PropertyMap { { "population", double(i * 10) }, { "color", colors[i % 3] } });
+    }
+
+    FillBucket perFeature { layout, layerPaintProperties, 5.0f, 1 };
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        perFeature.addFeature(features[i], geometries[i], {}, PatternLayerMap());
+    }
+
+    FillBucket batch { layout, layerPaintProperties, 5.0f, 1 };
+    const PatternLayerMap noPatterns;
+    std::vector<const GeometryTileFeature*> featurePointers;
+    std::vector<std::size_t> vertexEnds;
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        batch.addFeatureGeometry(features[i], geometries[i]);
+        featurePointers.push_back(&features[i]);
+        vertexEnds.push_back(batch.vertices.elements());
+    }
+    batch.addPaintProperties(featurePointers, vertexEnds, {}, std::vector<const PatternLayerMap*>(features.size(), &noPatterns));
+
+    EXPECT_EQ(perFeature.paintPropertyBinders.at("fill").statistics<FillOpacity>().max(),
+              batch.paintPropertyBinders.at("fill").statistics<FillOpacity>().max());
+
+    // The layout vertices, followed by the vertices of both data-driven paint properties.
+    VertexRecordingUploadPass perFeatureUpload;
+    perFeature.upload(perFeatureUpload);
+    VertexRecordingUploadPass batchUpload;
+    batch.upload(batchUpload);
+    EXPECT_EQ(3u, perFeatureUpload.vertexBuffers.size());
+    EXPECT_EQ(perFeatureUpload.vertexBuffers, batchUpload.vertexBuffers);
+}
+
 TEST(Buckets, LineBucket) {
     gl::HeadlessBackend backend({ 512, 256 });
     gfx::BackendScope scope { backend };
@@ -146,6 +265,48 @@ TEST(Buckets, SymbolBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, SymbolBucketDynamicDirtyRanges) {
+    SymbolBucket::Buffer buffer;
+    for (std::size_t glyphs : { 1, 2, 1, 40, 1 }) {
+        buffer.placedSymbols.emplace_back(Point<float>{ 0, 0 }, 0, 16.0f, 16.0f, std::array<float, 2>{{ 0, 0 }},
+                                          WritingModeType::Horizontal, GeometryCoordinates{}, std::vector<float>{});
+        buffer.placedSymbols.back().glyphOffsets.resize(glyphs);
+    }
+
+    const auto write = [&](int changedSymbol) {
+        buffer.dynamicVertices.clear();
+        for (std::size_t i = 0; i < buffer.placedSymbols.size(); ++i) {
+            const float x = int(i) == changedSymbol ? 1.0f : 0.0f;
+            for (std::size_t j = 0; j < buffer.placedSymbols[i].glyphOffsets.size() * 4; ++j) {
+                buffer.dynamicVertices.emplace_back(SymbolSDFIconProgram::dynamicLayoutVertex({ x, 0 }, 0));
+            }
+        }
+        buffer.updateDynamicDirtyRanges();
+    };
+
+    using Ranges = std::vector<std::pair<std::size_t, std::size_t>>;
+
+    // Nothing was uploaded yet.
+    write(-1);
+    EXPECT_TRUE(buffer.dynamicVerticesChanged);
+    EXPECT_EQ((Ranges{ { 0, 180 } }), buffer.dynamicDirtyRanges);
+
+    buffer.uploadedDynamicVertices = buffer.dynamicVertices;
+    write(-1);
+    EXPECT_EQ((Ranges{}), buffer.dynamicDirtyRanges);
+
+    write(1);
+    EXPECT_EQ((Ranges{ { 4, 12 } }), buffer.dynamicDirtyRanges);
+
+    // Runs that are close together are merged.
+    buffer.uploadedDynamicVertices = buffer.dynamicVertices;
+    write(2);
+    EXPECT_EQ((Ranges{ { 4, 16 } }), buffer.dynamicDirtyRanges);
+
+    write(4);
+    EXPECT_EQ((Ranges{ { 4, 12 }, { 176, 180 } }), buffer.dynamicDirtyRanges);
+}
+
 TEST(Buckets, RasterBucket) {
     gl::HeadlessBackend backend({ 512, 256 });
     gfx::BackendScope scope { backend };
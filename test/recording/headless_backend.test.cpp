@@ -0,0 +1,51 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/map_options.hpp>
+#include <mbgl/recording/headless_backend.hpp>
+#include <mbgl/storage/resource_options.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+TEST(RecordingHeadlessBackend, Render) {
+    util::RunLoop loop;
+
+    auto backend = std::make_unique<recording::HeadlessBackend>();
+    const recording::HeadlessBackend& recorder = *backend;
+    HeadlessFrontend frontend { { 256, 256 }, 1, std::move(backend) };
+
+    Map map(frontend, MapObserver::nullObserver(),
+            MapOptions().withMapMode(MapMode::Static).withSize(frontend.getSize()),
+            ResourceOptions().withCachePath(":memory:").withAssetPath("test/fixtures/api/assets"));
+    map.getStyle().loadJSON(util::read_file("test/fixtures/api/water.json"));
+    map.jumpTo(CameraOptions().withCenter(LatLng { 37.8, -122.5 }).withZoom(10.0));
+
+    // Nothing is drawn.
+    const PremultipliedImage image = frontend.render(map);
+    EXPECT_EQ(Size(256, 256), image.size);
+    EXPECT_TRUE(std::all_of(image.data.get(), image.data.get() + image.bytes(), [](uint8_t byte) { return byte == 0; }));
+
+    const recording::Statistics first = recorder.getStatistics();
+    EXPECT_EQ(1u, first.commandEncoders);
+    EXPECT_LT(0u, first.renderPasses);
+    EXPECT_LT(0u, first.drawCalls);
+    EXPECT_LT(0u, first.indices);
+    EXPECT_LT(0u, first.stateChanges);
+    EXPECT_LT(0u, first.bufferUploads);
+    EXPECT_LT(0u, first.bufferUploadBytes);
+
+    // The same frame draws the same again, and reuses the buffers it uploaded.
+    frontend.render(map);
+    const recording::Statistics second = recorder.getStatistics() - first;
+    EXPECT_EQ(1u, second.commandEncoders);
+    EXPECT_EQ(first.renderPasses, second.renderPasses);
+    EXPECT_EQ(first.drawCalls, second.drawCalls);
+    EXPECT_EQ(first.indices, second.indices);
+    EXPECT_GT(first.bufferUploads, second.bufferUploads);
+}
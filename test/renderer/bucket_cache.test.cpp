@@ -0,0 +1,110 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/renderer/bucket_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class TestEntry : public BucketCache::Entry {
+public:
+    explicit TestEntry(std::size_t bytes_) : size(bytes_) {}
+
+    std::size_t bytes() const override {
+        return size;
+    }
+
+private:
+    const std::size_t size;
+};
+
+BucketCache::Key key(uint64_t dataHash, uint8_t z = 0) {
+    return { dataHash, "layout", OverscaledTileID { z, 0, 0 }, 1.0f };
+}
+
+// The cache is shared by the whole process; reset it for every test.
+class ScopedCache {
+public:
+    ScopedCache() {
+        cache.clear();
+        cache.setMaximumSize(100);
+    }
+
+    ~ScopedCache() {
+        cache.clear();
+        cache.setMaximumSize(BucketCache::DefaultMaximumSize);
+    }
+
+    BucketCache& cache = BucketCache::get();
+};
+
+} // namespace
+
+TEST(BucketCache, FindInsert) {
+    ScopedCache scoped;
+    BucketCache& cache = scoped.cache;
+
+    EXPECT_FALSE(bool(cache.find(key(1))));
+
+    auto entry = std::make_shared<TestEntry>(10);
+    cache.insert(key(1), entry);
+    EXPECT_EQ(entry, cache.find(key(1)));
+    EXPECT_FALSE(bool(cache.find(key(1, 1))));
+    EXPECT_FALSE(bool(cache.find(key(2))));
+
+    BucketCache::Key other = key(1);
+    other.layoutKey = "other";
+    EXPECT_FALSE(bool(cache.find(other)));
+
+    EXPECT_EQ(10u, cache.getSize());
+    EXPECT_EQ(1u, cache.getStatistics().hits);
+    EXPECT_EQ(4u, cache.getStatistics().misses);
+}
+
+TEST(BucketCache, ReplaceEntry) {
+    ScopedCache scoped;
+    BucketCache& cache = scoped.cache;
+
+    cache.insert(key(1), std::make_shared<TestEntry>(10));
+    auto entry = std::make_shared<TestEntry>(20);
+    cache.insert(key(1), entry);
+    EXPECT_EQ(entry, cache.find(key(1)));
+    EXPECT_EQ(20u, cache.getSize());
+}
+
+TEST(BucketCache, EvictLeastRecentlyUsed) {
+    ScopedCache scoped;
+    BucketCache& cache = scoped.cache;
+
+    cache.insert(key(1), std::make_shared<TestEntry>(40));
+    cache.insert(key(2), std::make_shared<TestEntry>(40));
+
+    // Makes the second entry the least recently used one.
+    EXPECT_TRUE(bool(cache.find(key(1))));
+
+    cache.insert(key(3), std::make_shared<TestEntry>(40));
+    EXPECT_TRUE(bool(cache.find(key(1))));
+    EXPECT_FALSE(bool(cache.find(key(2))));
+    EXPECT_TRUE(bool(cache.find(key(3))));
+    EXPECT_EQ(80u, cache.getSize());
+    EXPECT_EQ(1u, cache.getStatistics().evictions);
+
+    // Entries stay valid while they're in use, even if they're evicted.
+    auto entry = cache.find(key(1));
+    cache.setMaximumSize(0);
+    EXPECT_EQ(0u, cache.getSize());
+    EXPECT_EQ(3u, cache.getStatistics().evictions);
+    EXPECT_FALSE(bool(cache.find(key(1))));
+    EXPECT_EQ(40u, entry->bytes());
+}
+
+TEST(BucketCache, IgnoreOversizedEntries) {
+    ScopedCache scoped;
+    BucketCache& cache = scoped.cache;
+
+    cache.insert(key(1), std::make_shared<TestEntry>(10));
+    cache.insert(key(2), std::make_shared<TestEntry>(101));
+    EXPECT_FALSE(bool(cache.find(key(2))));
+    EXPECT_TRUE(bool(cache.find(key(1))));
+    EXPECT_EQ(10u, cache.getSize());
+}
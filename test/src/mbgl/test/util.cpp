@@ -7,8 +7,11 @@
 #include <mapbox/pixelmatch.hpp>
 
 #include <csignal>
+#include <cstdlib>
 #include <future>
+#include <stdexcept>
 
+#include <dirent.h>
 #include <unistd.h>
 
 #define xstr(s) str(s)
@@ -88,6 +91,35 @@ Server::~Server() {
     }
 }
 
+namespace {
+
+std::string createTemporaryDirectory() {
+    const char* base = getenv("TMPDIR");
+    std::string path = std::string(base && *base ? base : "/tmp") + "/mbgl-test-XXXXXX";
+    if (!mkdtemp(&path[0])) {
+        throw std::runtime_error("Failed to create temporary directory " + path);
+    }
+    return path;
+}
+
+} // namespace
+
+TemporaryDirectory::TemporaryDirectory() : path(createTemporaryDirectory()) {
+}
+
+TemporaryDirectory::~TemporaryDirectory() {
+    if (DIR* dir = opendir(path.c_str())) {
+        while (const dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name != "." && name != "..") {
+                unlink((path + "/" + name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(path.c_str());
+}
+
 void checkImage(const std::string& base,
                 const PremultipliedImage& actual,
                 double imageThreshold,
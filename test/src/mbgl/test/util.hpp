@@ -54,6 +54,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 
 #include <gtest/gtest.h>
 
@@ -69,6 +70,16 @@ private:
     int fd = -1;
 };
 
+// Creates an empty directory for the files that a test writes, and removes it, along with the
+// files in it, when it goes out of scope.
+class TemporaryDirectory {
+public:
+    TemporaryDirectory();
+    ~TemporaryDirectory();
+
+    const std::string path;
+};
+
 void checkImage(const std::string& base,
                 const PremultipliedImage& actual,
                 double imageThreshold = 0,
@@ -0,0 +1,175 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/sqlite3.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <tuple>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string archivePath = "test/fixtures/storage/tiles.archive";
+const std::string mbtilesPath = "test/fixtures/storage/tiles.mbtiles";
+
+void append(std::string& archive, uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        archive.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+void appendEntry(std::string& archive, uint8_t z, uint32_t x, uint32_t y, uint64_t offset, uint32_t length) {
+    append(archive, z, 1);
+    append(archive, x, 3);
+    append(archive, y, 3);
+    append(archive, offset, 6);
+    append(archive, length, 4);
+}
+
+// Tile 1/1/0 shares the data of tile 1/0/0, and tile 1/0/1 is in a leaf directory.
+void writeClusteredArchive() {
+    const std::string metadata = R"({"name":"test","minzoom":0,"maxzoom":1})";
+    const std::string tile0 = "tile 0/0/0";
+    const std::string ocean = "ocean";
+    const std::string leaf = "tile 1/0/1";
+
+    const uint64_t rootOffset = 10 + metadata.size();
+    const uint64_t leafOffset = rootOffset + 3 * 17;
+    const uint64_t dataOffset = leafOffset + 2 * 17;
+
+    std::string archive = "PM";
+    append(archive, 2, 2);
+    append(archive, metadata.size(), 4);
+    append(archive, 3, 2);
+    archive += metadata;
+    appendEntry(archive, 0, 0, 0, dataOffset, tile0.size());
+    appendEntry(archive, 1, 0, 0, dataOffset + tile0.size(), ocean.size());
+    appendEntry(archive, 0x80 | 1, 1, 0, leafOffset, 2 * 17);
+    appendEntry(archive, 1, 1, 0, dataOffset + tile0.size(), ocean.size());
+    appendEntry(archive, 1, 0, 1, dataOffset + tile0.size() + ocean.size(), leaf.size());
+    archive += tile0 + ocean + leaf;
+
+    util::write_file(archivePath, archive);
+}
+
+// Tile 1/0/0 is stored in row 1, since MBTiles rows count from the south.
+void writeMBTiles() {
+    util::deleteFile(mbtilesPath);
+    auto db = mapbox::sqlite::Database::open(mbtilesPath, mapbox::sqlite::ReadWriteCreate);
+    db.exec("CREATE TABLE metadata (name TEXT, value TEXT)");
+    db.exec("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)");
+    db.exec("CREATE UNIQUE INDEX tile_index ON tiles (zoom_level, tile_column, tile_row)");
+    db.exec("INSERT INTO metadata VALUES ('name', 'test'), ('bounds', '-180,-85,180,85')");
+
+    mapbox::sqlite::Statement stmt{ db, "INSERT INTO tiles VALUES (?1, ?2, ?3, ?4)" };
+    for (const auto& tile : { std::make_tuple(0, 0, 0, "tile 0/0/0"), std::make_tuple(1, 0, 1, "tile 1/0/0") }) {
+        mapbox::sqlite::Query query{ stmt };
+        query.bind(1, std::get<0>(tile));
+        query.bind(2, std::get<1>(tile));
+        query.bind(3, std::get<2>(tile));
+        query.bindBlob(4, std::get<3>(tile), 10);
+        query.run();
+    }
+}
+
+Resource tile(const std::string& url, int32_t x, int32_t y, int8_t z) {
+    return Resource::tile(url + "?z={z}&x={x}&y={y}", 1.0, x, y, z, Tileset::Scheme::XYZ);
+}
+
+Response request(util::RunLoop& loop, FileSource& fs, const Resource& resource) {
+    Response response;
+    std::unique_ptr<AsyncRequest> req = fs.request(resource, [&](Response res) {
+        response = res;
+        loop.stop();
+    });
+    loop.run();
+    return response;
+}
+
+} // namespace
+
+TEST(MBTilesFileSource, AcceptsURL) {
+    EXPECT_TRUE(MBTilesFileSource::acceptsURL("mbtiles:///tiles.mbtiles"));
+    EXPECT_TRUE(MBTilesFileSource::acceptsURL("mbtiles://tiles.mbtiles?z=0&x=0&y=0"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("mbtile://tiles.mbtiles"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("file:///tiles.mbtiles"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL(""));
+}
+
+TEST(MBTilesFileSource, NonExistentFile) {
+    util::RunLoop loop;
+    MBTilesFileSource fs;
+
+    auto res = request(loop, fs, { Resource::Source, "mbtiles://test/fixtures/storage/nonexistent.mbtiles" });
+    ASSERT_NE(nullptr, res.error);
+    EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+}
+
+TEST(MBTilesFileSource, TEST_REQUIRES_WRITE(ClusteredArchive)) {
+    writeClusteredArchive();
+
+    util::RunLoop loop;
+    MBTilesFileSource fs;
+    const std::string url = "mbtiles://" + archivePath;
+
+    auto source = request(loop, fs, { Resource::Source, url });
+    ASSERT_EQ(nullptr, source.error);
+    ASSERT_TRUE(source.data.get());
+    EXPECT_NE(std::string::npos, source.data->find(R"("name":"test")"));
+    EXPECT_NE(std::string::npos, source.data->find(R"("tiles":[")" + url + R"(?z={z}&x={x}&y={y}"])"));
+
+    auto tile0 = request(loop, fs, tile(url, 0, 0, 0));
+    ASSERT_EQ(nullptr, tile0.error);
+    ASSERT_TRUE(tile0.data.get());
+    EXPECT_EQ("tile 0/0/0", *tile0.data);
+
+    auto leaf = request(loop, fs, tile(url, 0, 1, 1));
+    ASSERT_TRUE(leaf.data.get());
+    EXPECT_EQ("tile 1/0/1", *leaf.data);
+
+    // Tiles that are stored once are loaded once.
+    auto ocean = request(loop, fs, tile(url, 0, 0, 1));
+    auto sharedOcean = request(loop, fs, tile(url, 1, 0, 1));
+    ASSERT_TRUE(ocean.data.get());
+    EXPECT_EQ("ocean", *ocean.data);
+    EXPECT_EQ(ocean.data.get(), sharedOcean.data.get());
+
+    auto missing = request(loop, fs, tile(url, 1, 1, 1));
+    EXPECT_EQ(nullptr, missing.error);
+    EXPECT_TRUE(missing.noContent);
+    EXPECT_FALSE(missing.data.get());
+
+    util::deleteFile(archivePath);
+}
+
+TEST(MBTilesFileSource, TEST_REQUIRES_WRITE(MBTiles)) {
+    writeMBTiles();
+
+    util::RunLoop loop;
+    MBTilesFileSource fs;
+    const std::string url = "mbtiles://" + mbtilesPath;
+
+    auto source = request(loop, fs, { Resource::Source, url });
+    ASSERT_EQ(nullptr, source.error);
+    ASSERT_TRUE(source.data.get());
+    EXPECT_NE(std::string::npos, source.data->find(R"("minzoom":0,"maxzoom":1)"));
+    EXPECT_NE(std::string::npos, source.data->find(R"("bounds":[-180.0,-85.0,180.0,85.0])"));
+
+    auto tile0 = request(loop, fs, tile(url, 0, 0, 0));
+    ASSERT_TRUE(tile0.data.get());
+    EXPECT_EQ("tile 0/0/0", *tile0.data);
+
+    auto tile1 = request(loop, fs, tile(url, 0, 0, 1));
+    ASSERT_TRUE(tile1.data.get());
+    EXPECT_EQ("tile 1/0/0", *tile1.data);
+
+    auto missing = request(loop, fs, tile(url, 0, 1, 1));
+    EXPECT_TRUE(missing.noContent);
+
+    util::deleteFile(mbtilesPath);
+}
@@ -3,8 +3,10 @@
 #include <mbgl/test/sqlite3_test_fs.hpp>
 
 #include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/payload.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/util/compression.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/string.hpp>
 
@@ -26,6 +28,7 @@ static void deleteDatabaseFiles() {
     // Delete leftover journaling files as well.
     util::deleteFile(filename);
     util::deleteFile(filename + "-wal"s);
+    util::deleteFile(filename + "-shm"s);
     util::deleteFile(filename + "-journal"s);
 }
 
@@ -208,7 +211,7 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(SchemaVersion)) {
         OfflineDatabase db(filename);
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     OfflineDatabase db(filename);
     // Now try inserting and reading back to make sure we have a valid database.
@@ -368,6 +371,43 @@ TEST(OfflineDatabase, PutTile) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, GetCompressedTile) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:");
+
+    Resource resource = Resource::tile("http://example.com/{z}-{x}-{y}.vector.pbf", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    Response response;
+    response.data = std::make_shared<std::string>(1024, 'a');
+    EXPECT_FALSE(util::isCompressed(*response.data));
+    db.put(resource, response);
+
+    PayloadStatistics::reset();
+
+    auto inflated = db.get(resource);
+    ASSERT_TRUE(inflated && inflated->data);
+    EXPECT_EQ(*response.data, *inflated->data);
+
+    // The stored data is handed out as is to requestors that inflate it themselves.
+    resource.acceptsCompressedData = true;
+    auto compressed = db.get(resource);
+    ASSERT_TRUE(compressed && compressed->data);
+    EXPECT_TRUE(util::isCompressed(*compressed->data));
+    EXPECT_EQ(*response.data, *inflatePayload(compressed->data));
+
+    const auto statistics = PayloadStatistics::get();
+    EXPECT_EQ(2 * compressed->data->size(), statistics.copiedBytes);
+    EXPECT_EQ(2 * response.data->size(), statistics.inflatedBytes);
+
+    // Putting the compressed data again, e.g. after revalidating it, doesn't compress it twice.
+    EXPECT_EQ(compressed->data->size(), db.put(resource, *compressed).second);
+    resource.acceptsCompressedData = false;
+    auto revalidated = db.get(resource);
+    ASSERT_TRUE(revalidated && revalidated->data);
+    EXPECT_EQ(*response.data, *revalidated->data);
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, PutResourceNoContent) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -638,6 +678,40 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ConcurrentUse)) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(WriteAheadLogging)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    {
+        OfflineDatabase db(filename, util::DEFAULT_MAX_CACHE_SIZE,
+                           OfflineDatabase::JournalMode::WAL, OfflineDatabase::Synchronous::Normal);
+        EXPECT_EQ("wal", databaseJournalMode(filename));
+
+        auto putResult = db.put(fixture::tile, fixture::response);
+        EXPECT_TRUE(putResult.first);
+        EXPECT_EQ(0u, putResult.second);
+
+        db.flush();
+        auto getResult = db.get(fixture::tile);
+        ASSERT_TRUE(bool(getResult));
+        EXPECT_EQ("first", *getResult->data);
+
+        // Reads of committed resources don't wait for queued puts.
+        for (auto i = 0; i < 100; i++) {
+            db.put(fixture::resource, fixture::response);
+            EXPECT_TRUE(bool(db.get(fixture::tile)));
+        }
+    }
+
+    // Queued writes are committed when the database is closed.
+    OfflineDatabase db(filename);
+    auto getResult = db.get(fixture::resource);
+    ASSERT_TRUE(bool(getResult));
+    EXPECT_EQ("first", *getResult->data);
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 static std::shared_ptr<std::string> randomString(size_t size) {
     auto result = std::make_shared<std::string>(size, 0);
     std::mt19937 random;
@@ -723,6 +797,43 @@ TEST(OfflineDatabase, PutFailsWhenEvictionInsuffices) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+static int64_t databaseInteger(const std::string& path, const char* sql) {
+    mapbox::sqlite::Database db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt{ db, sql };
+    mapbox::sqlite::Query query{ stmt };
+    query.run();
+    return query.get<int64_t>(0);
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(PutEvictsIncrementally)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    {
+        OfflineDatabase db(filename, 1024 * 100);
+
+        Response response;
+        response.data = randomString(1024);
+
+        for (uint32_t i = 1; i <= 200; i++) {
+            db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+            db.put(Resource::tile("http://example.com/{z}", 1, i, 0, 0, Tileset::Scheme::XYZ), response);
+        }
+    }
+
+    // The running total matches the stored data, and puts kept the pages in use, which include
+    // the overhead of the data, below the maximum cache size without emptying the cache.
+    const int64_t storedSize = databaseInteger(filename, "SELECT value FROM metadata WHERE key = 'stored_size'");
+    EXPECT_EQ(databaseInteger(filename, "SELECT (SELECT sum(length(data)) FROM resources) + "
+                                        "(SELECT sum(length(data)) FROM tiles)"), storedSize);
+    const int64_t usedSize = databaseInteger(filename, "PRAGMA page_size") *
+                             (databasePageCount(filename) - databaseInteger(filename, "PRAGMA freelist_count"));
+    EXPECT_LE(usedSize, 1024 * 100);
+    EXPECT_GT(storedSize, 1024 * 50);
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, GetRegionCompletedStatus) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -954,7 +1065,7 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
     EXPECT_LT(databasePageCount(filename),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 
@@ -975,7 +1086,7 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     EXPECT_EQ(0u, log.uncheckedCount());
 }
@@ -994,7 +1105,7 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     // Journal mode should be DELETE after migration to v5.
     EXPECT_EQ("delete", databaseJournalMode(filename));
@@ -1020,7 +1131,7 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
                                          "expires", "modified", "etag", "data", "compressed",
@@ -1033,6 +1144,25 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, MigrateFromV6Schema) {
+    // sideload_sat.db is a v6 database with a region, which predates the stored size.
+    FixtureLog log;
+    deleteDatabaseFiles();
+    util::copyFile(filename, "test/fixtures/offline_database/sideload_sat.db");
+
+    {
+        OfflineDatabase db(filename);
+        EXPECT_TRUE(db.listRegions());
+    }
+
+    EXPECT_EQ(7, databaseUserVersion(filename));
+    EXPECT_EQ(databaseInteger(filename, "SELECT (SELECT ifnull(sum(length(data)), 0) FROM resources) + "
+                                        "(SELECT ifnull(sum(length(data)), 0) FROM tiles)"),
+              databaseInteger(filename, "SELECT value FROM metadata WHERE key = 'stored_size'"));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, DowngradeSchema) {
     // v999.db is a v999 database, it should be deleted
     // and recreated with the current schema.
@@ -1044,7 +1174,7 @@ TEST(OfflineDatabase, DowngradeSchema) {
         OfflineDatabase db(filename, 0);
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(7, databaseUserVersion(filename));
 
     EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
                                          "expires", "modified", "etag", "data", "compressed",
@@ -0,0 +1,134 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
+#include <mbgl/style/expression/parsing_context.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <rapidjson/document.h>
+
+using namespace mbgl;
+using namespace mbgl::style;
+using namespace mbgl::style::expression;
+
+using namespace std::string_literals;
+
+namespace {
+
+std::unique_ptr<Expression> parse(const std::string& json, type::Type type) {
+    rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> document;
+    document.Parse<0>(json.c_str());
+    assert(!document.HasParseError());
+    const JSValue* value = &document;
+    ParsingContext ctx(type);
+    ParseResult parsed = ctx.parseLayerPropertyExpression(conversion::Convertible(value));
+    return parsed ? std::move(*parsed) : nullptr;
+}
+
+const std::vector<StubGeometryTileFeature> features {
+    StubGeometryTileFeature(PropertyMap {}),
+    StubGeometryTileFeature(PropertyMap {{ "x", 0.0 }, { "name", "a"s }, { "flag", true }}),
+    StubGeometryTileFeature(PropertyMap {{ "x", 2.5 }, { "name", "b"s }, { "flag", false }}),
+    StubGeometryTileFeature(PropertyMap {{ "x", uint64_t(3) }, { "name", "c"s }}),
+    StubGeometryTileFeature(PropertyMap {{ "x", int64_t(-7) }, { "name", 1.0 }}),
+    StubGeometryTileFeature(PropertyMap {{ "x", "7"s }, { "flag", 1.0 }}),
+    StubGeometryTileFeature(PropertyMap {{ "x", 120.0 }, { "name", "a"s }}),
+};
+
+// Compares the compiled expression with evaluating the tree, for each feature at a few zoom levels.
+template <class T>
+void expectSameResults(const std::string& json, type::Type type) {
+    SCOPED_TRACE(json);
+    const std::unique_ptr<Expression> expression = parse(json, type);
+    ASSERT_TRUE(expression);
+    const std::unique_ptr<CompiledExpression> compiled = CompiledExpression::compile(*expression);
+    ASSERT_TRUE(compiled);
+
+    for (const optional<float> zoom : { optional<float>(), optional<float>(0.0f), optional<float>(10.5f), optional<float>(22.0f) }) {
+        for (const auto& feature : features) {
+            const EvaluationContext context(zoom, &feature, {});
+            const EvaluationResult expected = expression->evaluate(context);
+            T actual;
+            ASSERT_EQ(bool(expected), compiled->evaluate(context, actual));
+            if (expected) {
+                const optional<T> value = fromExpressionValue<T>(*expected);
+                ASSERT_TRUE(value);
+                EXPECT_EQ(*value, actual);
+            }
+        }
+    }
+
+    // Batch evaluation yields the same results, with the fallback for failed evaluations.
+    std::vector<const GeometryTileFeature*> featurePtrs;
+    for (const auto& feature : features) {
+        featurePtrs.push_back(&feature);
+    }
+    const T fallback {};
+    for (const optional<float> zoom : { optional<float>(), optional<float>(10.5f) }) {
+        std::vector<T> results;
+        compiled->evaluate(EvaluationContext(zoom, nullptr, {}), featurePtrs, results, fallback);
+        ASSERT_EQ(features.size(), results.size());
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            T expected = fallback;
+            compiled->evaluate(EvaluationContext(zoom, &features[i], {}), expected);
+            EXPECT_EQ(expected, T(results[i]));
+        }
+    }
+}
+
+} // namespace
+
+TEST(CompiledExpression, Arithmetic) {
+    expectSameResults<float>(R"(["+", ["get", "x"], 1])", type::Number);
+    expectSameResults<float>(R"(["*", ["number", ["get", "x"], 2], 3, 0.5])", type::Number);
+    expectSameResults<float>(R"(["-", ["get", "x"]])", type::Number);
+    expectSameResults<float>(R"(["/", ["get", "x"], ["-", ["get", "x"], 2.5]])", type::Number);
+    expectSameResults<float>(R"(["%", ["get", "x"], 2])", type::Number);
+    expectSameResults<float>(R"(["^", 2, ["get", "x"]])", type::Number);
+    expectSameResults<float>(R"(["min", ["get", "x"], 1, ["ln", 2]])", type::Number);
+    expectSameResults<float>(R"(["max", ["get", "x"], ["sqrt", 16]])", type::Number);
+    expectSameResults<float>(R"(["round", ["abs", ["get", "x"]]])", type::Number);
+    expectSameResults<float>(R"(["log2", ["+", 1, ["abs", ["get", "x"]]]])", type::Number);
+    expectSameResults<float>(R"(["to-number", ["get", "x"], 4])", type::Number);
+    expectSameResults<float>(R"(["let", "y", ["get", "x"], ["+", ["var", "y"], ["coalesce", ["var", "y"], 1]]])", type::Number);
+}
+
+TEST(CompiledExpression, Logic) {
+    expectSameResults<bool>(R"(["has", "flag"])", type::Boolean);
+    expectSameResults<bool>(R"(["==", ["get", "name"], "a"])", type::Boolean);
+    expectSameResults<bool>(R"(["!=", 3, ["get", "x"]])", type::Boolean);
+    expectSameResults<bool>(R"([">", ["get", "x"], 1])", type::Boolean);
+    expectSameResults<bool>(R"(["<=", ["number", ["get", "x"], 0], ["+", ["get", "x"], 1]])", type::Boolean);
+    expectSameResults<bool>(R"(["any", ["get", "flag"], ["==", ["get", "name"], "c"]])", type::Boolean);
+    expectSameResults<bool>(R"(["all", ["has", "x"], ["!", ["boolean", ["get", "flag"], false]]])", type::Boolean);
+    expectSameResults<bool>(R"(["all"])", type::Boolean);
+}
+
+TEST(CompiledExpression, Branches) {
+    expectSameResults<float>(R"(["case", ["==", ["get", "name"], "a"], 1, ["has", "flag"], ["get", "x"], 3])", type::Number);
+    expectSameResults<float>(R"(["match", ["get", "name"], "a", 1, ["b", "c"], 2, 3])", type::Number);
+    expectSameResults<float>(R"(["match", ["get", "x"], 0, 1, [3, -7], ["*", 2, ["get", "x"]], 2])", type::Number);
+    expectSameResults<float>(R"(["match", ["floor", ["number", ["get", "x"], 0]], 2, 1, 3, 2, 0])", type::Number);
+    expectSameResults<float>(R"(["step", ["get", "x"], 0, 1, 10, 3, 20])", type::Number);
+    expectSameResults<float>(R"(["step", ["zoom"], ["get", "x"], 10, ["*", 2, ["get", "x"]]])", type::Number);
+}
+
+TEST(CompiledExpression, Interpolate) {
+    expectSameResults<float>(R"(["interpolate", ["linear"], ["get", "x"], 0, 0, 100, 10])", type::Number);
+    expectSameResults<float>(R"(["interpolate", ["exponential", 2], ["zoom"], 0, ["get", "x"], 22, ["*", ["get", "x"], 10]])", type::Number);
+    expectSameResults<float>(R"(["interpolate", ["cubic-bezier", 0.4, 0, 0.6, 1], ["number", ["get", "x"], 1], 0, 1, 3, 2])", type::Number);
+    expectSameResults<Color>(R"(["interpolate", ["linear"], ["get", "x"], 0, "red", 10, "blue"])", type::Color);
+    expectSameResults<Color>(R"(["interpolate", ["linear"], ["zoom"], 0, ["rgb", ["get", "x"], 0, 0], 22, "blue"])", type::Color);
+}
+
+TEST(CompiledExpression, Color) {
+    expectSameResults<Color>(R"(["rgba", ["*", ["get", "x"], 10], 0, 0, 0.5])", type::Color);
+    expectSameResults<Color>(R"(["match", ["get", "name"], "a", "red", "green"])", type::Color);
+    expectSameResults<Color>(R"(["to-color", ["get", "name"], "black"])", type::Color);
+}
+
+TEST(CompiledExpression, NotCompiled) {
+    EXPECT_FALSE(CompiledExpression::compile(*parse(R"(["get", "name"])", type::String)));
+}
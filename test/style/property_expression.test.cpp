@@ -7,6 +7,8 @@
 #include <mbgl/style/expression/dsl.hpp>
 #include <mbgl/style/expression/format_section_override.hpp>
 
+#include <thread>
+
 using namespace mbgl;
 using namespace mbgl::style;
 using namespace mbgl::style::expression;
@@ -171,3 +173,46 @@ TEST(PropertyExpression, FormatSectionOverride) {
         EXPECT_TRUE(*override1 != *override4);
     }
 }
+
+TEST(PropertyExpression, MemoizedZoomEvaluation) {
+    PropertyExpression<float> expression(interpolate(linear(), zoom(), 0.0, literal(0.0), 10.0, literal(10.0)));
+    const PropertyExpression<float> copy = expression;
+    ZoomEvaluationStatistics& statistics = ZoomEvaluationStatistics::current();
+    const ZoomEvaluationStatistics before = statistics;
+
+    EXPECT_EQ(5.5f, expression.evaluateMemoized(5.5f));
+    EXPECT_EQ(1u, (statistics - before).misses);
+
+    // Copies share the cache, and results are cached for the exact zoom level.
+    EXPECT_EQ(5.5f, copy.evaluateMemoized(5.5f));
+    EXPECT_EQ(copy.evaluate(5.5001f), copy.evaluateMemoized(5.5001f));
+    EXPECT_EQ(1u, (statistics - before).hits);
+    EXPECT_EQ(2u, (statistics - before).misses);
+
+    EXPECT_FLOAT_EQ(0.55f, copy.memoizedInterpolationFactor({ 0.0f, 10.0f }, 5.5f));
+    EXPECT_FLOAT_EQ(0.55f, expression.memoizedInterpolationFactor({ 0.0f, 10.0f }, 5.5f));
+    EXPECT_FLOAT_EQ(0.5f, expression.memoizedInterpolationFactor({ 5.0f, 6.0f }, 5.5f));
+    EXPECT_EQ(expression.interpolationFactor({ 0.0f, 10.0f }, 5.5001f),
+              expression.memoizedInterpolationFactor({ 0.0f, 10.0f }, 5.5001f));
+    EXPECT_EQ(2u, (statistics - before).hits);
+    EXPECT_EQ(5u, (statistics - before).misses);
+
+    // A new expression starts with an empty cache.
+    PropertyExpression<float> other(interpolate(linear(), zoom(), 0.0, literal(0.0), 10.0, literal(20.0)));
+    EXPECT_EQ(11.0f, other.evaluateMemoized(5.5f));
+    EXPECT_EQ(6u, (statistics - before).misses);
+
+    // Expressions that don't depend on the zoom level aren't cached.
+    PropertyExpression<float> constant(literal(2.0));
+    EXPECT_EQ(2.0f, constant.evaluateMemoized(5.5f));
+    EXPECT_EQ(2u, (statistics - before).hits);
+    EXPECT_EQ(6u, (statistics - before).misses);
+
+    // Threads other than the first one that used the cache evaluate without it.
+    std::thread([&] {
+        const ZoomEvaluationStatistics threadBefore = ZoomEvaluationStatistics::current();
+        EXPECT_EQ(5.5f, copy.evaluateMemoized(5.5f));
+        EXPECT_EQ(0u, (ZoomEvaluationStatistics::current() - threadBefore).hits);
+        EXPECT_EQ(0u, (ZoomEvaluationStatistics::current() - threadBefore).misses);
+    }).join();
+}
@@ -0,0 +1,46 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/collision_index.hpp>
+#include <mbgl/map/transform.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+CollisionFeature boxFeature(float width, float height) {
+    return CollisionFeature(GeometryCoordinates{}, Anchor(0, 0, 0, 0), 0, height, 0, width, 1.0f, 0.0f,
+                            style::SymbolPlacementType::Point, IndexedSubfeature(0, "", "", 0), 1.0f, 0.0f);
+}
+
+CollisionIndex::Projection projectionAt(float x, float y) {
+    CollisionIndex::Projection projection;
+    projection.anchor = { x, y };
+    projection.tileToViewport = 1;
+    return projection;
+}
+
+} // namespace
+
+TEST(CollisionIndex, MarkChanged) {
+    Transform transform;
+    transform.resize({ 512, 512 });
+    CollisionIndex collisionIndex(transform.getState());
+
+    CollisionFeature changed = boxFeature(40, 10);
+    ASSERT_TRUE(collisionIndex.placeFeature(changed, projectionAt(300, 300), {}, false, false, nullopt, nullopt).first);
+
+    CollisionFeature neighbor = boxFeature(40, 10);
+    ASSERT_TRUE(collisionIndex.placeFeature(neighbor, projectionAt(345, 300), {}, false, false, nullopt, nullopt).first);
+    CollisionFeature distant = boxFeature(40, 10);
+    ASSERT_TRUE(collisionIndex.placeFeature(distant, projectionAt(100, 500), {}, false, false, nullopt, nullopt).first);
+
+    // Nothing was marked yet.
+    EXPECT_FALSE(collisionIndex.isChanged(changed.boxes.front(), 0));
+    EXPECT_FALSE(collisionIndex.isChanged(neighbor.boxes.front(), 0));
+
+    collisionIndex.markChanged(changed);
+    EXPECT_TRUE(collisionIndex.isChanged(changed.boxes.front(), 0));
+    EXPECT_TRUE(collisionIndex.isChanged(neighbor.boxes.front(), 0));
+    EXPECT_FALSE(collisionIndex.isChanged(distant.boxes.front(), 0));
+    EXPECT_TRUE(collisionIndex.isChanged(distant.boxes.front(), 200));
+}
@@ -0,0 +1,94 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_atlas.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const FontStackHash fontStack = FontStackHasher()({ "font-stack" });
+
+Immutable<Glyph> makeGlyph(GlyphID id, uint8_t value) {
+    Glyph glyph;
+    glyph.id = id;
+    glyph.bitmap = AlphaImage({ 8, 10 });
+    glyph.bitmap.fill(value);
+    glyph.metrics.width = 8;
+    glyph.metrics.height = 10;
+    return Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph)));
+}
+
+GlyphMap glyphMap(const std::vector<Immutable<Glyph>>& glyphs) {
+    GlyphMap result;
+    for (const auto& glyph : glyphs) {
+        result[fontStack].emplace(glyph->id, glyph);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(GlyphAtlas, ShareGlyphs) {
+    auto atlas = std::make_shared<GlyphAtlas>();
+    const auto a = makeGlyph(u'a', 1);
+    const auto b = makeGlyph(u'b', 2);
+
+    GlyphPositions first;
+    auto firstGlyphs = atlas->addGlyphs(glyphMap({ a, b }), first);
+    EXPECT_EQ(2u, atlas->getGlyphCount());
+
+    // The second tile references the glyph that the first one added.
+    GlyphPositions second;
+    auto secondGlyphs = atlas->addGlyphs(glyphMap({ a }), second);
+    EXPECT_EQ(2u, atlas->getGlyphCount());
+    EXPECT_EQ(first[fontStack].at(u'a').rect, second[fontStack].at(u'a').rect);
+
+    // Glyphs are padded by one pixel.
+    const Rect<uint16_t> rect = first[fontStack].at(u'b').rect;
+    EXPECT_EQ(10, rect.w);
+    EXPECT_EQ(12, rect.h);
+    const AlphaImage image = atlas->getAtlasImageForTests();
+    EXPECT_EQ(0, image.data[rect.y * image.stride() + rect.x]);
+    EXPECT_EQ(2, image.data[(rect.y + 1) * image.stride() + rect.x + 1]);
+
+    firstGlyphs.reset();
+    EXPECT_EQ(1u, atlas->getGlyphCount());
+    secondGlyphs.reset();
+    EXPECT_EQ(0u, atlas->getGlyphCount());
+}
+
+TEST(GlyphAtlas, ReuseSpace) {
+    auto atlas = std::make_shared<GlyphAtlas>();
+
+    GlyphPositions first;
+    auto firstGlyphs = atlas->addGlyphs(glyphMap({ makeGlyph(u'a', 1) }), first);
+    firstGlyphs.reset();
+
+    // The released glyph is cleared, and its space goes to the next one.
+    const Rect<uint16_t> rect = first[fontStack].at(u'a').rect;
+    EXPECT_EQ(0, atlas->getAtlasImageForTests().data[(rect.y + 1) * atlas->getPixelSize().width + rect.x + 1]);
+
+    GlyphPositions second;
+    auto secondGlyphs = atlas->addGlyphs(glyphMap({ makeGlyph(u'b', 2) }), second);
+    EXPECT_EQ(rect, second[fontStack].at(u'b').rect);
+}
+
+TEST(GlyphAtlas, ReloadedFont) {
+    auto atlas = std::make_shared<GlyphAtlas>();
+
+    GlyphPositions first;
+    auto firstGlyphs = atlas->addGlyphs(glyphMap({ makeGlyph(u'a', 1) }), first);
+
+    // A font stack that is loaded again with other bitmaps doesn't overwrite the glyphs
+    // that tiles still use.
+    GlyphPositions second;
+    auto secondGlyphs = atlas->addGlyphs(glyphMap({ makeGlyph(u'a', 3) }), second);
+    EXPECT_EQ(2u, atlas->getGlyphCount());
+    EXPECT_FALSE(first[fontStack].at(u'a').rect == second[fontStack].at(u'a').rect);
+
+    // The same bitmap is shared even though it is a different glyph object.
+    GlyphPositions third;
+    auto thirdGlyphs = atlas->addGlyphs(glyphMap({ makeGlyph(u'a', 3) }), third);
+    EXPECT_EQ(2u, atlas->getGlyphCount());
+    EXPECT_EQ(second[fontStack].at(u'a').rect, third[fontStack].at(u'a').rect);
+}
@@ -8,6 +8,8 @@
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
+
 using namespace mbgl;
 
 // Alpha channel rendering of '中'
@@ -254,6 +256,183 @@ TEST(GlyphManager, LoadLocalCJKGlyph) {
 }
 
 
+TEST(GlyphManager, TEST_REQUIRES_WRITE(LoadLocalCJKGlyphFromCache)) {
+    class CountingLocalGlyphRasterizer : public StubLocalGlyphRasterizer {
+    public:
+        Glyph rasterizeGlyph(const FontStack& fontStack, GlyphID glyphID) override {
+            rasterizations++;
+            return StubLocalGlyphRasterizer::rasterizeGlyph(fontStack, glyphID);
+        }
+
+        int rasterizations = 0;
+    };
+
+    const test::TemporaryDirectory directory;
+
+    util::RunLoop loop;
+    StubFileSource fileSource;
+
+    for (int run = 0; run < 2; run++) {
+        auto rasterizer = std::make_unique<CountingLocalGlyphRasterizer>();
+        const CountingLocalGlyphRasterizer& counter = *rasterizer;
+        GlyphManager glyphManager(std::move(rasterizer));
+        glyphManager.setLocalGlyphCache(directory.path, {});
+
+        StubGlyphRequestor requestor;
+        bool glyphsAvailable = false;
+        requestor.glyphsAvailable = [&] (GlyphMap glyphs) {
+            glyphsAvailable = true;
+
+            const auto& testPositions = glyphs.at(FontStackHasher()({{"Test Stack"}}));
+            ASSERT_EQ(testPositions.count(u'中'), 1u);
+
+            Immutable<Glyph> glyph = *testPositions.at(u'中');
+            EXPECT_EQ(glyph->metrics.advance, 24ul);
+            ASSERT_EQ(glyph->bitmap.size, Size(30, 30));
+            for (size_t i = 0; i < glyph->bitmap.bytes(); i++) {
+                EXPECT_EQ(glyph->bitmap.data[i], sdfBitmap[i]);
+            }
+        };
+
+        glyphManager.getGlyphs(requestor, GlyphDependencies { {{{"Test Stack"}}, {u'中'}} }, fileSource);
+        EXPECT_TRUE(glyphsAvailable);
+
+        // Only the first process rasterizes the glyph; the next one loads it from disk.
+        EXPECT_EQ(run == 0 ? 1 : 0, counter.rasterizations);
+    }
+}
+
+TEST(GlyphManager, PrefetchSeenRanges) {
+    GlyphManagerTest test;
+
+    std::vector<std::string> urls;
+    test.fileSource.glyphsResponse = [&] (const Resource& resource) {
+        urls.push_back(resource.url);
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    test.observer.glyphsError = [&] (const FontStack&, const GlyphRange&, std::exception_ptr) {
+        FAIL();
+        test.end();
+    };
+
+    test.requestor.glyphsAvailable = [&] (GlyphMap) {
+        test.end();
+    };
+
+    test.run(
+        "{fontstack}/{range}",
+        GlyphDependencies {
+            {{{"Regular Stack"}}, {u'a', u'Ж'}}
+        });
+
+    EXPECT_EQ(2u, urls.size());
+
+    // A font stack that is used for the first time gets the Cyrillic range too, although
+    // the requestor only needs Latin glyphs.
+    bool notified = false;
+    bool prefetched = false;
+    test.requestor.glyphsAvailable = [&] (GlyphMap glyphs) {
+        EXPECT_EQ(1u, glyphs.at(FontStackHasher()({{"Bold Stack"}})).count(u'a'));
+        notified = true;
+        if (prefetched) test.end();
+    };
+
+    test.observer.glyphsLoaded = [&] (const FontStack& fontStack, const GlyphRange& range) {
+        if (fontStack == FontStack {{"Bold Stack"}} && range == GlyphRange(1024, 1279)) {
+            prefetched = true;
+            if (notified) test.end();
+        }
+    };
+
+    test.glyphManager.getGlyphs(test.requestor, GlyphDependencies {
+        {{{"Bold Stack"}}, {u'a'}}
+    }, test.fileSource);
+    test.loop.run();
+
+    EXPECT_TRUE(notified);
+    ASSERT_EQ(4u, urls.size());
+    EXPECT_NE(std::find(urls.begin(), urls.end(), "Bold%20Stack/1024-1279"), urls.end());
+}
+
+TEST(GlyphManager, PrefetchFailure) {
+    GlyphManagerTest test;
+
+    unsigned failures = 0;
+    test.fileSource.glyphsResponse = [&] (const Resource& resource) {
+        Response response;
+        if (resource.url == "Bold%20Stack/1024-1279") {
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::NotFound,
+                "Failed by the test case");
+            ++failures;
+        } else {
+            response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        }
+        return response;
+    };
+
+    test.observer.glyphsError = [&] (const FontStack&, const GlyphRange&, std::exception_ptr) {
+        FAIL();
+        test.end();
+    };
+
+    test.requestor.glyphsAvailable = [&] (GlyphMap) {
+        test.end();
+    };
+
+    test.run(
+        "{fontstack}/{range}",
+        GlyphDependencies {
+            {{{"Regular Stack"}}, {u'a', u'Ж'}}
+        });
+
+    // Prefetching the Cyrillic range of a new font stack fails without reporting an error.
+    bool notified = false;
+    test.requestor.glyphsAvailable = [&] (GlyphMap) {
+        notified = true;
+    };
+
+    const auto respond = test.fileSource.glyphsResponse;
+    test.fileSource.glyphsResponse = [&] (const Resource& resource) {
+        // The stub file source keeps responding with errors; the first one was handled once
+        // there's a second one.
+        if (notified && failures > 0) {
+            test.end();
+        }
+        return respond(resource);
+    };
+
+    test.glyphManager.getGlyphs(test.requestor, GlyphDependencies {
+        {{{"Bold Stack"}}, {u'a'}}
+    }, test.fileSource);
+    test.loop.run();
+
+    EXPECT_TRUE(notified);
+    ASSERT_GT(failures, 0u);
+
+    // A requestor that needs the range gets the error.
+    test.fileSource.glyphsResponse = respond;
+    test.requestor.glyphsAvailable = [&] (GlyphMap) {
+        FAIL();
+        test.end();
+    };
+
+    test.observer.glyphsError = [&] (const FontStack& fontStack, const GlyphRange& range, std::exception_ptr error) {
+        EXPECT_EQ(fontStack, FontStack({"Bold Stack"}));
+        EXPECT_EQ(range, GlyphRange(1024, 1279));
+        EXPECT_EQ(util::toString(error), "Failed by the test case");
+        test.end();
+    };
+
+    test.glyphManager.getGlyphs(test.requestor, GlyphDependencies {
+        {{{"Bold Stack"}}, {u'Ж'}}
+    }, test.fileSource);
+    test.loop.run();
+}
+
 TEST(GlyphManager, LoadingInvalid) {
     GlyphManagerTest test;
 
@@ -0,0 +1,62 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_sdf_cache.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const FontStack fontStack{{ "Test Stack" }};
+const GlyphRange range{ 19968, 20223 };
+
+Immutable<Glyph> makeGlyph(GlyphID id) {
+    Glyph glyph;
+    glyph.id = id;
+    glyph.metrics.width = 24;
+    glyph.metrics.height = 24;
+    glyph.metrics.top = -8;
+    glyph.metrics.advance = 24;
+    glyph.bitmap = AlphaImage({ 30, 30 });
+    for (std::size_t i = 0; i < glyph.bitmap.bytes(); ++i) {
+        glyph.bitmap.data[i] = static_cast<uint8_t>(i);
+    }
+    return Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph)));
+}
+
+} // namespace
+
+TEST(GlyphSDFCache, TEST_REQUIRES_WRITE(StoreLoad)) {
+    const test::TemporaryDirectory directory;
+    GlyphSDFCache cache(directory.path, {}, 8, .25);
+
+    EXPECT_TRUE(cache.load(fontStack, range).empty());
+
+    const auto glyph = makeGlyph(u'中');
+    cache.store(fontStack, range, { glyph });
+
+    const std::vector<Glyph> glyphs = cache.load(fontStack, range);
+    ASSERT_EQ(1u, glyphs.size());
+    EXPECT_EQ(glyph->id, glyphs[0].id);
+    EXPECT_EQ(glyph->metrics, glyphs[0].metrics);
+    EXPECT_EQ(glyph->bitmap, glyphs[0].bitmap);
+
+    // Other font families and SDF parameters don't share the file.
+    EXPECT_TRUE(GlyphSDFCache(directory.path, std::string("PingFang"), 8, .25).load(fontStack, range).empty());
+    EXPECT_TRUE(GlyphSDFCache(directory.path, {}, 6, .25).load(fontStack, range).empty());
+}
+
+TEST(GlyphSDFCache, TEST_REQUIRES_WRITE(Corrupted)) {
+    const test::TemporaryDirectory directory;
+    GlyphSDFCache cache(directory.path, {}, 8, .25);
+    cache.store(fontStack, range, { makeGlyph(u'中') });
+
+    // A truncated file is ignored.
+    const std::string path = cache.path(fontStack, range);
+    const std::string data = util::read_file(path);
+    util::write_file(path, data.substr(0, data.size() - 1));
+    EXPECT_TRUE(cache.load(fontStack, range).empty());
+
+    util::write_file(path, "");
+    EXPECT_TRUE(cache.load(fontStack, range).empty());
+}
@@ -0,0 +1,103 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/util/constants.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const std::vector<std::string> fontStack{{"font-stack"}};
+
+GlyphMap glyphMap(uint32_t advance) {
+    Glyph glyph;
+    glyph.id = u'a';
+    glyph.metrics.advance = advance;
+    return {
+        { FontStackHasher()(fontStack), {{ u'a', Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph))) }} }
+    };
+}
+
+ShapingCache::Key key(const std::u16string& text, const GlyphMap& glyphs, float maxWidth = 10 * util::ONE_EM) {
+    return { TaggedString(text, SectionOptions(1.0, fontStack)), maxWidth, util::ONE_EM,
+             style::SymbolAnchorType::Center, style::TextJustifyType::Center, 0, { 0, 0 },
+             WritingModeType::Horizontal, glyphs };
+}
+
+std::shared_ptr<const Shaping> shaping(std::size_t glyphCount) {
+    auto result = std::make_shared<Shaping>();
+    for (std::size_t i = 0; i < glyphCount; ++i) {
+        result->positionedGlyphs.emplace_back(u'a', i, 0, false, 0, 1.0);
+    }
+    return result;
+}
+
+// The cache is shared by the whole process; reset it for every test.
+class ScopedCache {
+public:
+    ScopedCache() {
+        cache.clear();
+    }
+
+    ~ScopedCache() {
+        cache.clear();
+        cache.setMaximumSize(ShapingCache::DefaultMaximumSize);
+    }
+
+    ShapingCache& cache = ShapingCache::get();
+};
+
+} // namespace
+
+TEST(ShapingCache, Key) {
+    const GlyphMap glyphs = glyphMap(10);
+    EXPECT_TRUE(key(u"aaa", glyphs) == key(u"aaa", glyphs));
+    EXPECT_FALSE(key(u"aaa", glyphs) == key(u"aa", glyphs));
+    EXPECT_FALSE(key(u"aaa", glyphs) == key(u"aaa", glyphs, 5 * util::ONE_EM));
+
+    // Fonts with the same name but other glyphs are told apart.
+    EXPECT_FALSE(key(u"aaa", glyphs) == key(u"aaa", glyphMap(12)));
+    EXPECT_FALSE(key(u"aaa", glyphs) == key(u"aaa", GlyphMap()));
+}
+
+TEST(ShapingCache, FindInsert) {
+    ScopedCache scoped;
+    ShapingCache& cache = scoped.cache;
+    const GlyphMap glyphs = glyphMap(10);
+
+    EXPECT_FALSE(bool(cache.find(key(u"aaa", glyphs))));
+
+    auto entry = shaping(3);
+    cache.insert(key(u"aaa", glyphs), entry);
+    EXPECT_EQ(entry, cache.find(key(u"aaa", glyphs)));
+    EXPECT_FALSE(bool(cache.find(key(u"aaa", glyphMap(12)))));
+
+    EXPECT_EQ(1u, cache.getStatistics().hits);
+    EXPECT_EQ(2u, cache.getStatistics().misses);
+}
+
+TEST(ShapingCache, EvictLeastRecentlyUsed) {
+    ScopedCache scoped;
+    ShapingCache& cache = scoped.cache;
+    const GlyphMap glyphs = glyphMap(10);
+
+    cache.insert(key(u"a", glyphs), shaping(1));
+    const std::size_t entrySize = cache.getSize();
+    cache.setMaximumSize(2 * entrySize);
+
+    cache.insert(key(u"b", glyphs), shaping(1));
+    EXPECT_TRUE(bool(cache.find(key(u"a", glyphs))));
+    cache.insert(key(u"c", glyphs), shaping(1));
+
+    EXPECT_TRUE(bool(cache.find(key(u"a", glyphs))));
+    EXPECT_FALSE(bool(cache.find(key(u"b", glyphs))));
+    EXPECT_TRUE(bool(cache.find(key(u"c", glyphs))));
+    EXPECT_EQ(1u, cache.getStatistics().evictions);
+    EXPECT_EQ(2 * entrySize, cache.getSize());
+
+    // A maximum size of 0 disables the cache.
+    cache.setMaximumSize(0);
+    cache.insert(key(u"a", glyphs), shaping(1));
+    EXPECT_FALSE(bool(cache.find(key(u"a", glyphs))));
+    EXPECT_EQ(0u, cache.getSize());
+}
@@ -0,0 +1,88 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile(const OverscaledTileID& id_, std::size_t bytes_, bool renderable_ = true)
+        : Tile(Kind::Geometry, id_), bytes(bytes_) {
+        renderable = renderable_;
+    }
+
+    void upload(gfx::UploadPass&) override {}
+    Bucket* getBucket(const style::Layer::Impl&) const override { return nullptr; }
+    std::size_t getMemoryUse() const override { return bytes; }
+
+    const std::size_t bytes;
+};
+
+void add(TileCache& cache, const OverscaledTileID& id, std::size_t bytes) {
+    cache.add(id, std::make_unique<StubTile>(id, bytes));
+}
+
+} // namespace
+
+TEST(TileCache, EvictLeastRecentlyUsedBySize) {
+    TileCache cache(2);
+    const OverscaledTileID a { 1, 0, 0 }, b { 1, 0, 1 }, c { 1, 1, 0 };
+
+    add(cache, a, 10);
+    add(cache, b, 10);
+    add(cache, a, 10); // Marks a as most recently used; the existing tile is kept.
+    add(cache, c, 10);
+
+    EXPECT_TRUE(cache.has(a));
+    EXPECT_FALSE(cache.has(b));
+    EXPECT_TRUE(cache.has(c));
+    EXPECT_EQ(20u, cache.getBytes());
+    EXPECT_EQ(1u, cache.getStatistics().evictions);
+}
+
+TEST(TileCache, EvictLeastRecentlyUsedByBytes) {
+    TileCache cache(10, 100);
+    const OverscaledTileID a { 1, 0, 0 }, b { 1, 0, 1 }, c { 1, 1, 0 }, d { 1, 1, 1 };
+
+    add(cache, a, 40);
+    add(cache, b, 40);
+    add(cache, c, 40);
+    EXPECT_FALSE(cache.has(a));
+    EXPECT_EQ(80u, cache.getBytes());
+
+    // Tiles that exceed the budget on their own aren't cached.
+    add(cache, d, 101);
+    EXPECT_FALSE(cache.has(d));
+    EXPECT_TRUE(cache.has(b));
+
+    cache.setByteBudget(50);
+    EXPECT_FALSE(cache.has(b));
+    EXPECT_TRUE(cache.has(c));
+    EXPECT_EQ(40u, cache.getBytes());
+    EXPECT_EQ(2u, cache.getStatistics().evictions);
+}
+
+TEST(TileCache, Statistics) {
+    TileCache cache(10);
+    const OverscaledTileID a { 1, 0, 0 }, b { 1, 0, 1 };
+
+    add(cache, a, 10);
+    add(cache, b, 20);
+    cache.add(b, std::make_unique<StubTile>(b, 20, false));
+
+    EXPECT_TRUE(bool(cache.pop(a)));
+    EXPECT_FALSE(bool(cache.pop(a)));
+
+    const TileCacheStatistics statistics = cache.getStatistics();
+    EXPECT_EQ(1u, statistics.hits);
+    EXPECT_EQ(1u, statistics.misses);
+    EXPECT_EQ(0u, statistics.evictions);
+    EXPECT_EQ(1u, statistics.tiles);
+    EXPECT_EQ(20u, statistics.bytes);
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getBytes());
+    EXPECT_FALSE(cache.has(b));
+}
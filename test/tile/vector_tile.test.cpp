@@ -2,12 +2,19 @@
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/tile/vector_tile.hpp>
 #include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/tile/vector_tile_filter.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
 
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/storage/payload.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/query.hpp>
@@ -104,3 +111,181 @@ TEST(VectorTileData, ParseResults) {
 
     ASSERT_EQ(feature->getValue("invalid"), nullopt);
 }
+
+TEST(VectorTileData, CloneCompressed) {
+    const auto data = util::read_file("test/fixtures/map/issue12432/0-0-0.mvt");
+    VectorTileData compressed(std::make_shared<std::string>(util::compress(data)));
+
+    PayloadStatistics::reset();
+
+    // Clones share the inflated data, so it's inflated only once, no matter which of them is
+    // read first.
+    std::unique_ptr<GeometryTileData> clone = compressed.clone();
+    ASSERT_TRUE(clone->getLayer("water"));
+    ASSERT_TRUE(compressed.getLayer("water"));
+    ASSERT_TRUE(compressed.clone()->getLayer("admin"));
+    EXPECT_EQ(data.size(), PayloadStatistics::get().inflatedBytes);
+}
+
+TEST(VectorTileData, DecodeGeometries) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    const auto referenceLayers = mapbox::vector_tile::buffer(*data).getLayers();
+    VectorTileData tile(data);
+
+    // Reused across all features, like GeometryTileWorker does.
+    GeometryCollection geometries;
+
+    for (const auto& name : tile.layerNames()) {
+        std::unique_ptr<GeometryTileLayer> layer = tile.getLayer(name);
+        const mapbox::vector_tile::layer reference(referenceLayers.at(name));
+
+        std::size_t visited = 0;
+        layer->forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+            EXPECT_EQ(visited++, i);
+
+            const mapbox::vector_tile::feature expected(reference.getFeature(i), reference);
+            feature.decodeGeometries(geometries);
+            EXPECT_EQ(expected.getGeometries<GeometryCollection>(float(util::EXTENT) / expected.getExtent()), geometries);
+            EXPECT_EQ(feature.getGeometries(), geometries);
+            return true;
+        });
+        EXPECT_EQ(layer->featureCount(), visited);
+    }
+}
+
+TEST(VectorTileData, InternedValues) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    const auto referenceLayers = mapbox::vector_tile::buffer(*data).getLayers();
+    VectorTileData tile(data);
+
+    for (const auto& name : tile.layerNames()) {
+        std::unique_ptr<GeometryTileLayer> layer = tile.getLayer(name);
+        const mapbox::vector_tile::layer reference(referenceLayers.at(name));
+
+        for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+            const std::unique_ptr<GeometryTileFeature> feature = layer->getFeature(i);
+            const mapbox::vector_tile::feature expected(reference.getFeature(i), reference);
+            const auto properties = expected.getProperties();
+            EXPECT_EQ(properties, feature->getProperties());
+
+            for (const auto& property : properties) {
+                optional<Value> storage;
+                const Value* value = feature->findValue(property.first, storage);
+                if (property.second.is<NullValue>()) {
+                    EXPECT_EQ(nullptr, value);
+                    continue;
+                }
+                ASSERT_NE(nullptr, value);
+                EXPECT_EQ(property.second, *value);
+                EXPECT_EQ(property.second, *feature->getValue(property.first));
+                // Features hold their values, and don't copy them.
+                EXPECT_FALSE(storage);
+            }
+
+            optional<Value> storage;
+            EXPECT_EQ(nullptr, feature->findValue("invalid", storage));
+        }
+    }
+
+    // Layer objects of the same source layer share the decoded values.
+    auto motorway = [&](const GeometryTileLayer& layer) -> const Value* {
+        for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+            optional<Value> storage;
+            const Value* value = layer.getFeature(i)->findValue("class", storage);
+            if (value && *value == Value(std::string("motorway"))) {
+                return value;
+            }
+        }
+        return nullptr;
+    };
+    const std::unique_ptr<GeometryTileLayer> road = tile.getLayer("road");
+    const Value* value = motorway(*road);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(value, motorway(*tile.getLayer("road")));
+}
+
+TEST(VectorTileData, FilterFeatures) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    const auto layerViews = mapbox::vector_tile::buffer(*data).getLayers();
+    VectorTileData tile(data);
+
+    const auto parse = [](const char* json) {
+        style::conversion::Error error;
+        optional<style::Filter> filter = style::conversion::convertJSON<style::Filter>(json, error);
+        EXPECT_TRUE(bool(filter)) << json << ": " << error.message;
+        return *filter;
+    };
+
+    // Filters that are evaluated on the encoded features.
+    const std::vector<const char*> compiled = {
+        R"(["==", "class", "motorway"])",
+        R"(["!=", "class", "motorway"])",
+        R"(["in", "class", "motorway", "trunk", "primary"])",
+        R"(["!in", "class", "wood", "scrub"])",
+        R"(["has", "name"])",
+        R"(["!has", "name_en"])",
+        R"(["==", "$type", "Polygon"])",
+        R"(["in", "$type", "Point", "LineString"])",
+        R"(["==", "$type", "Unknown"])",
+        R"(["in", "$type", "Unknown", "Polygon"])",
+        R"(["==", "disputed", 0])",
+        R"(["<=", "scalerank", 2])",
+        R"([">", "localrank", 1])",
+        R"([">=", "name", "O"])",
+        R"(["all", ["==", "$type", "LineString"], ["in", "class", "motorway", "trunk"], ["!=", "structure", "tunnel"]])",
+        R"(["any", ["==", "oneway", "true"], ["==", "structure", "bridge"]])",
+        R"(["==", ["get", "class"], "park"])",
+        R"(["!=", ["get", "type"], "city"])",
+        R"(["==", "nonexistent", "value"])",
+    };
+
+    // Filters that fall back to evaluating the expression for every feature.
+    const std::vector<const char*> fallback = {
+        R"(["all", ["==", ["get", "maki"], "park"], ["<=", ["get", "scalerank"], 3]])",
+        R"(["match", ["get", "class"], ["wood", "grass"], true, false])",
+        R"(["==", ["zoom"], 10])",
+    };
+
+    for (const auto& name : tile.layerNames()) {
+        std::unique_ptr<GeometryTileLayer> layer = tile.getLayer(name);
+
+        for (const char* json : compiled) {
+            EXPECT_TRUE(bool(VectorTileFilter::compile(parse(json), layerViews.at(name)))) << json;
+        }
+        for (const char* json : fallback) {
+            EXPECT_FALSE(bool(VectorTileFilter::compile(parse(json), layerViews.at(name)))) << json;
+        }
+
+        for (const auto& list : { compiled, fallback }) {
+            for (const char* json : list) {
+                const style::Filter filter = parse(json);
+
+                std::vector<std::size_t> expected;
+                layer->forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+                    if (filter(style::expression::EvaluationContext { 10.0f, &feature })) {
+                        expected.push_back(i);
+                    }
+                    return true;
+                });
+
+                std::vector<std::size_t> actual;
+                layer->forEachFeature(filter, 10.0f, [&](std::size_t i, const GeometryTileFeature& feature) {
+                    EXPECT_TRUE(filter(style::expression::EvaluationContext { 10.0f, &feature })) << name << ": " << json;
+                    actual.push_back(i);
+                    return true;
+                });
+
+                EXPECT_EQ(expected, actual) << name << ": " << json;
+
+                std::vector<std::size_t> owned;
+                layer->forEachOwnedFeature(filter, 10.0f, [&](std::size_t i, std::unique_ptr<GeometryTileFeature> feature) {
+                    EXPECT_TRUE(filter(style::expression::EvaluationContext { 10.0f, feature.get() })) << name << ": " << json;
+                    owned.push_back(i);
+                    return true;
+                });
+
+                EXPECT_EQ(expected, owned) << name << ": " << json;
+            }
+        }
+    }
+}
@@ -3,6 +3,8 @@
 
 #include <mbgl/test/util.hpp>
 
+#include <algorithm>
+
 using namespace mbgl;
 
 TEST(GridIndex, IndexesFeatures) {
@@ -51,3 +53,49 @@ TEST(GridIndex, CircleBox) {
     EXPECT_EQ(grid.query({{0, 80}, {20, 100}}), (std::vector<int16_t>{2}));
 }
 
+
+TEST(GridIndex, HitTestPredicate) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{50, 50}, 10});
+    grid.insert(1, {{40, 40}, {45, 45}});
+
+    EXPECT_TRUE(grid.hitTest({{41, 41}, {42, 42}}, [](int16_t key) { return key == 1; }));
+    EXPECT_FALSE(grid.hitTest({{41, 41}, {42, 42}}, [](int16_t key) { return key == 0; }));
+    EXPECT_TRUE(grid.hitTest({{55, 55}, 2}, [](int16_t key) { return key == 0; }));
+    EXPECT_FALSE(grid.hitTest({{55, 55}, 2}, [](int16_t key) { return key == 1; }));
+}
+
+TEST(GridIndex, BulkInsert) {
+    GridIndex<int16_t> incremental(100, 100, 10);
+    GridIndex<int16_t> bulk(100, 100, 10);
+    std::vector<std::pair<int16_t, GridIndex<int16_t>::BBox>> boxes;
+    std::vector<std::pair<int16_t, GridIndex<int16_t>::BCircle>> circles;
+
+    // Enough elements to merge the cells several times.
+    for (int16_t i = 0; i < 2000; ++i) {
+        const float x = (i * 37) % 110 - 5;
+        const float y = (i * 53) % 110 - 5;
+        if (i % 3) {
+            incremental.insert(int16_t(i), {{x, y}, {x + i % 17, y + i % 13}});
+            boxes.emplace_back(i, GridIndex<int16_t>::BBox{{x, y}, {x + i % 17, y + i % 13}});
+        } else {
+            incremental.insert(int16_t(i), {{x, y}, float(i % 11)});
+            circles.emplace_back(i, GridIndex<int16_t>::BCircle{{x, y}, float(i % 11)});
+        }
+    }
+    bulk.insert(std::move(boxes));
+    bulk.insert(std::move(circles));
+
+    for (float x = -10; x < 110; x += 7) {
+        for (float y = -10; y < 110; y += 11) {
+            const auto result = incremental.query({{x, y}, {x + 12, y + 5}});
+            EXPECT_EQ(result, bulk.query({{x, y}, {x + 12, y + 5}}));
+
+            // Every element is listed once.
+            auto sorted = result;
+            std::sort(sorted.begin(), sorted.end());
+            EXPECT_EQ(sorted.end(), std::unique(sorted.begin(), sorted.end()));
+        }
+    }
+    EXPECT_EQ(2000u, bulk.query({{-1000, -1000}, {1000, 1000}}).size());
+}
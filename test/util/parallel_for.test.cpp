@@ -0,0 +1,53 @@
+#include <mbgl/util/parallel_for.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(ParallelFor, CallsEveryIndexOnce) {
+    for (std::size_t count : { 0, 1, 2, 1000 }) {
+        std::vector<std::atomic<int>> calls(count);
+        util::parallelFor(count, [&](std::size_t i) {
+            ++calls[i];
+        });
+
+        for (auto& call : calls) {
+            EXPECT_EQ(1, call);
+        }
+    }
+}
+
+TEST(ParallelFor, Nested) {
+    std::atomic<std::size_t> sum { 0 };
+    util::parallelFor(16, [&](std::size_t i) {
+        util::parallelFor(16, [&](std::size_t j) {
+            sum += i * 16 + j;
+        });
+    });
+
+    EXPECT_EQ(256u * 255u / 2u, sum);
+}
+
+TEST(ParallelFor, ConcurrentCallers) {
+    std::atomic<std::size_t> calls { 0 };
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 4; ++i) {
+        callers.emplace_back([&] {
+            for (int j = 0; j < 50; ++j) {
+                util::parallelFor(100, [&](std::size_t) {
+                    ++calls;
+                });
+            }
+        });
+    }
+
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    EXPECT_EQ(4u * 50u * 100u, calls);
+}
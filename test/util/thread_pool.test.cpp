@@ -0,0 +1,75 @@
+#include <mbgl/util/thread_pool.hpp>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/test/util.hpp>
+
+#include <future>
+#include <mutex>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+class Recorder {
+public:
+    Recorder(ActorRef<Recorder>, int id_, std::mutex& mutex_, std::vector<int>& order_)
+        : id(id_), mutex(mutex_), order(order_) {}
+
+    void block(std::shared_future<void> future) {
+        future.wait();
+    }
+
+    void record() {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(id);
+    }
+
+    void done(std::promise<void> promise) {
+        promise.set_value();
+    }
+
+private:
+    const int id;
+    std::mutex& mutex;
+    std::vector<int>& order;
+};
+
+} // namespace
+
+TEST(ThreadPool, HigherPriorityMailboxesFirst) {
+    ThreadPool pool(1);
+
+    std::mutex mutex;
+    std::vector<int> order;
+
+    // Keep the only worker busy while the other mailboxes are queued.
+    std::promise<void> unblock;
+    Actor<Recorder> blocker(pool, -1, std::ref(mutex), std::ref(order));
+    blocker.self().invoke(&Recorder::block, unblock.get_future().share());
+
+    Actor<Recorder> low(pool, 0, std::ref(mutex), std::ref(order));
+    Actor<Recorder> medium(pool, 1, std::ref(mutex), std::ref(order));
+    Actor<Recorder> high(pool, 2, std::ref(mutex), std::ref(order));
+    Actor<Recorder> last(pool, 3, std::ref(mutex), std::ref(order));
+    low.setPriority(-1);
+    high.setPriority(1);
+    last.setPriority(-2);
+
+    low.self().invoke(&Recorder::record);
+    medium.self().invoke(&Recorder::record);
+    high.self().invoke(&Recorder::record);
+    last.self().invoke(&Recorder::record);
+
+    // Reprioritizing a queued mailbox reorders it.
+    low.setPriority(2);
+
+    std::promise<void> done;
+    auto future = done.get_future();
+    last.self().invoke(&Recorder::done, std::move(done));
+
+    unblock.set_value();
+    future.get();
+
+    EXPECT_EQ((std::vector<int>{ 0, 2, 1, 3 }), order);
+}
@@ -0,0 +1,67 @@
+#include <mbgl/util/transform_points.hpp>
+
+#include <mbgl/test/util.hpp>
+#include <mbgl/util/mat4.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+mat4 cameraMatrix() {
+    mat4 matrix;
+    matrix::perspective(matrix, 0.6435011087932844, 1.5, 1, 10000);
+    matrix::translate(matrix, matrix, 0, 0, -750);
+    matrix::rotate_x(matrix, matrix, 1.0);
+    matrix::rotate_z(matrix, matrix, 0.3);
+    matrix::translate(matrix, matrix, -1234.5, -678.25, 0);
+    matrix::scale(matrix, matrix, 1.0 / 7, 1.0 / 7, 1);
+    return matrix;
+}
+
+// transformPoints() and transformMat4() are built with -ffp-contract=off, so they round the
+// same way and the results are bit-identical.
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+} // namespace
+
+TEST(TransformPoints, MatchesTransformMat4) {
+    const mat4 matrix = cameraMatrix();
+
+    // Odd counts exercise the padded last block of every instruction set.
+    std::vector<float> x, y;
+    for (int i = 0; i < 1001; ++i) {
+        x.push_back(std::fmod(i * 97.3f, 8192.0f) - 2048.0f);
+        y.push_back(std::fmod(i * 31.7f, 8192.0f) - 2048.0f);
+    }
+
+    for (auto simd : { util::SIMD::None, util::SIMD::SSE2, util::SIMD::AVX, util::SIMD::NEON }) {
+        std::vector<double> outX(x.size()), outY(x.size()), outW(x.size());
+        util::transformPoints(matrix, x.size(), x.data(), y.data(), outX.data(), outY.data(), outW.data(), simd);
+
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            vec4 p = {{ x[i], y[i], 0, 1 }};
+            matrix::transformMat4(p, p, matrix);
+            EXPECT_TRUE(sameBits(p[0], outX[i])) << "point " << i;
+            EXPECT_TRUE(sameBits(p[1], outY[i])) << "point " << i;
+            EXPECT_TRUE(sameBits(p[3], outW[i])) << "point " << i;
+        }
+    }
+}
+
+TEST(TransformPoints, TransformedPoints) {
+    const mat4 matrix = cameraMatrix();
+    const util::TransformedPoints points(matrix, { { 0, 0 }, { 4096, 4096 }, { 8192, -100 } });
+    ASSERT_EQ(3u, points.size());
+
+    vec4 p = {{ 4096, 4096, 0, 1 }};
+    matrix::transformMat4(p, p, matrix);
+    EXPECT_TRUE(sameBits(p[0], points.x[1]));
+    EXPECT_TRUE(sameBits(p[1], points.y[1]));
+    EXPECT_TRUE(sameBits(p[3], points.w[1]));
+}
@@ -0,0 +1,102 @@
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(WorkStealingThreadPool, MessagesAreReceivedInOrder) {
+    struct Test {
+        Test(ActorRef<Test>) {}
+
+        void receive(int value) {
+            EXPECT_EQ(expected++, value);
+        }
+
+        void done(std::promise<void> promise) {
+            promise.set_value();
+        }
+
+        int expected = 0;
+    };
+
+    WorkStealingThreadPool pool(4);
+
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 16; ++i) {
+        actors.push_back(std::make_unique<Actor<Test>>(pool));
+    }
+
+    for (auto& actor : actors) {
+        for (int value = 0; value < 1000; ++value) {
+            actor->self().invoke(&Test::receive, value);
+        }
+        std::promise<void> promise;
+        futures.push_back(promise.get_future());
+        actor->self().invoke(&Test::done, std::move(promise));
+    }
+
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+TEST(WorkStealingThreadPool, MessagesSentFromWorkers) {
+    // Actors that send messages to each other from within the pool schedule onto
+    // the sending worker's own queue; idle workers must steal them.
+
+    struct Test {
+        Test(ActorRef<Test> self_, std::atomic<int>& count_, std::promise<void>& promise_)
+            : self(std::move(self_)), count(count_), promise(promise_) {}
+
+        void bounce(int remaining) {
+            if (remaining == 0) {
+                if (--count == 0) {
+                    promise.set_value();
+                }
+                return;
+            }
+            self.invoke(&Test::bounce, remaining - 1);
+        }
+
+        ActorRef<Test> self;
+        std::atomic<int>& count;
+        std::promise<void>& promise;
+    };
+
+    WorkStealingThreadPool pool(8);
+
+    const int actorCount = 64;
+    std::atomic<int> count { actorCount };
+    std::promise<void> promise;
+    auto future = promise.get_future();
+
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+    for (int i = 0; i < actorCount; ++i) {
+        actors.push_back(std::make_unique<Actor<Test>>(pool, std::ref(count), std::ref(promise)));
+        actors.back()->self().invoke(&Test::bounce, 100);
+    }
+
+    future.get();
+    EXPECT_EQ(0, count);
+}
+
+TEST(WorkStealingThreadPool, BackgroundScheduler) {
+    Scheduler::SetBackgroundFactory([] { return std::make_shared<WorkStealingThreadPool>(4); });
+    {
+        auto scheduler = Scheduler::GetBackground();
+        EXPECT_NE(nullptr, dynamic_cast<WorkStealingThreadPool*>(scheduler.get()));
+    }
+
+    Scheduler::SetBackgroundFactory({});
+    {
+        auto scheduler = Scheduler::GetBackground();
+        EXPECT_EQ(nullptr, dynamic_cast<WorkStealingThreadPool*>(scheduler.get()));
+    }
+}